@@ -127,6 +127,9 @@ namespace dmDDF
 
     /// Store pointers as offset from base address. Needed when serializing entire messages (copy)
     const uint32_t OPTION_OFFSET_POINTERS = (1 << 0);
+    /// Let bytes fields point into the input buffer instead of copying them. The input buffer must then outlive the message,
+    /// and the bytes are not guaranteed to be aligned. Ignored together with OPTION_OFFSET_POINTERS
+    const uint32_t OPTION_NO_COPY_BYTES   = (1 << 1);
 
     /**
      * Internal. Do not use.
@@ -346,6 +346,19 @@ namespace dmDDF
     {
         assert((Type) field->m_Type == TYPE_BYTES);
 
+        uint32_t options = load_context->GetOptions();
+        if ((options & OPTION_NO_COPY_BYTES) && !(options & OPTION_OFFSET_POINTERS))
+        {
+            if (!m_DryRun)
+            {
+                RepeatedField* repeated_field = (RepeatedField*) &m_Start[field->m_Offset];
+                assert(repeated_field->m_ArrayCount == 0);
+                repeated_field->m_Array = (uintptr_t) buffer;
+                repeated_field->m_ArrayCount = buffer_len;
+            }
+            return;
+        }
+
         // Always alloc
         char* bytes_buf = load_context->AllocBytes(buffer_len);
 
@@ -561,6 +561,35 @@ TEST(Bytes, Load)
     dmDDF::FreeMessage(message);
 }
 
+TEST(Bytes, LoadNoCopy)
+{
+    TestDDF::Bytes bytes;
+    bytes.set_pad("..");
+    bytes.set_data((void*) "foo", 3);
+    std::string msg_str = bytes.SerializeAsString();
+    const char* msg_buf = msg_str.c_str();
+    uint32_t msg_buf_size = msg_str.size();
+    void* message;
+
+    dmDDF::Result e = dmDDF::LoadMessage((void*) msg_buf, msg_buf_size, &DUMMY::TestDDF_Bytes_DESCRIPTOR, &message, dmDDF::OPTION_NO_COPY_BYTES, 0);
+    ASSERT_EQ(dmDDF::RESULT_OK, e);
+
+    DUMMY::TestDDF::Bytes* msg = (DUMMY::TestDDF::Bytes*) message;
+    ASSERT_EQ((uint32_t) 3, msg->m_Data.m_Count);
+    ASSERT_EQ(0, memcmp("foo", msg->m_Data.m_Data, 3));
+
+    // The data is referenced from the input buffer
+    ASSERT_GE((const char*) msg->m_Data.m_Data, msg_buf);
+    ASSERT_LT((const char*) msg->m_Data.m_Data, msg_buf + msg_buf_size);
+
+    std::string msg_str2;
+    e = DDFSaveToString(message, &DUMMY::TestDDF_Bytes_DESCRIPTOR, msg_str2);
+    ASSERT_EQ(dmDDF::RESULT_OK, e);
+    ASSERT_EQ(msg_str, msg_str2);
+
+    dmDDF::FreeMessage(message);
+}
+
 TEST(Material, Load)
 {
     TestDDF::MaterialDesc material_desc;
@@ -24,40 +24,60 @@ namespace dmEasing
         return GetValue(Curve(type), t);
     }
 
-    float GetValue(Curve curve, float t)
+    static inline const float* GetLookup(const Curve& curve, int* sample_count)
     {
-        t = dmMath::Clamp(t, 0.0f, 1.0f);
-        int sample_count;
-        int index1, index2;
-        float val1, val2;
-        float* lookup;
-
         if (curve.type == dmEasing::TYPE_FLOAT_VECTOR)
         {
-            sample_count = curve.vector->size;
-            lookup       = curve.vector->values;
-
-            if (sample_count == 0)
-            {
-                return 0.0f;
-            } else if (sample_count == 1) {
-                return lookup[0];
-            }
-
-        } else {
-            sample_count = EASING_SAMPLES; // 64 samples for built in curves
-            lookup       = EASING_LOOKUP;
-            lookup      += curve.type * (EASING_SAMPLES + 1); // NOTE: + 1 as the last sample is duplicated
+            *sample_count = curve.vector->size;
+            return curve.vector->values;
         }
+        *sample_count = EASING_SAMPLES; // 64 samples for built in curves
+        return EASING_LOOKUP + curve.type * (EASING_SAMPLES + 1); // NOTE: + 1 as the last sample is duplicated
+    }
 
-        index1 = (int) (t * (sample_count-1));
-        index2 = dmMath::Min(index1 + 1, sample_count-1);
+    static inline float Sample(const float* lookup, int sample_count, float t)
+    {
+        t = dmMath::Clamp(t, 0.0f, 1.0f);
+        int index1 = (int) (t * (sample_count-1));
+        int index2 = dmMath::Min(index1 + 1, sample_count-1);
 
-        val1 = lookup[index1];
-        val2 = lookup[index2];
+        float val1 = lookup[index1];
+        float val2 = lookup[index2];
 
         float diff = (t - index1 * (1.0f / (sample_count-1))) * (sample_count-1);
         return val1 * (1.0f - diff) + val2 * diff;
     }
+
+    float GetValue(Curve curve, float t)
+    {
+        int sample_count;
+        const float* lookup = GetLookup(curve, &sample_count);
+        if (sample_count == 0)
+        {
+            return 0.0f;
+        } else if (sample_count == 1) {
+            return lookup[0];
+        }
+        return Sample(lookup, sample_count, t);
+    }
+
+    void GetValues(const Curve& curve, const float* t, float* out, uint32_t count)
+    {
+        int sample_count;
+        const float* lookup = GetLookup(curve, &sample_count);
+        if (sample_count < 2)
+        {
+            float value = sample_count == 0 ? 0.0f : lookup[0];
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                out[i] = value;
+            }
+            return;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            out[i] = Sample(lookup, sample_count, t[i]);
+        }
+    }
 }
 
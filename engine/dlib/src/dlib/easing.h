@@ -103,6 +103,15 @@ namespace dmEasing
      */
     float GetValue(Type type, float t);
     float GetValue(Curve curve, float t);
+
+    /**
+     * Easing-curve evaluation of several values at once
+     * @param curve curve
+     * @param t times in the range [0,1]
+     * @param out [out] curve values
+     * @param count number of values
+     */
+    void GetValues(const Curve& curve, const float* t, float* out, uint32_t count);
 }
 
 #endif // DM_EASING
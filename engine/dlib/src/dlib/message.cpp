@@ -23,6 +23,7 @@
 #include <dlib/mutex.h>
 #include <dlib/static_assert.h>
 #include <dlib/spinlock.h>
+#include <dlib/thread.h>
 
 namespace dmMessage
 {
@@ -106,12 +107,43 @@ namespace dmMessage
         return ret;
     }
 
+    /*
+     * Pages used by SOCKET_FLAG_SINGLE_CONSUMER sockets. Each posting thread allocates
+     * messages from its own current page, and each message is prefixed with a pointer
+     * to its page.
+     * m_RefCount is decremented by the dispatcher for every dispatched message, and is
+     * incremented by m_MessageCount when the owning thread retires the page. The page
+     * can be reused by whoever brings the count back to zero.
+     */
+    struct ThreadPage
+    {
+        uint8_t         m_Memory[DM_MESSAGE_ALIGNMENT + DM_MESSAGE_PAGE_SIZE];
+        uint32_t        m_Current;
+        uint32_t        m_MessageCount;
+        int32_atomic_t  m_RefCount;
+        ThreadPage*     m_NextPage;
+    };
+
+    struct ThreadPageCache
+    {
+        ThreadPage*      m_CurrentPage;
+        ThreadPage*      m_FreePages;
+        // Link to the next cache, used for cleanup
+        ThreadPageCache* m_Next;
+    };
+
+    // Max number of pages moved from the shared free list into a thread cache at once
+    const uint32_t THREAD_PAGE_BATCH_SIZE = 8;
+
     struct MessageSocket
     {
         uint32_t        m_RefCount; // Is protected by "g_MessageContext->m_Spinlock"
         dmhash_t        m_NameHash;
         Message*        m_Header;
         Message*        m_Tail;
+        // Lock-free stack of posted messages, newest first. Only used for SOCKET_FLAG_SINGLE_CONSUMER
+        void* volatile  m_LockFreeHeader;
+        uint32_t        m_Flags;
         const char*     m_Name;
         dmMutex::HMutex m_Mutex;
         dmConditionVariable::HConditionVariable m_Condition;
@@ -124,18 +156,208 @@ namespace dmMessage
     {
         dmHashTable64<MessageSocket> m_Sockets;
         dmSpinlock::lock_t m_Spinlock;
+
+        dmThread::TlsKey   m_ThreadPageCacheKey;
+        // The fields below are protected by m_PageSpinlock
+        ThreadPageCache*   m_ThreadPageCaches;
+        ThreadPage*        m_FreeThreadPages;
+        dmSpinlock::lock_t m_PageSpinlock;
     };
 
     MessageContext* g_MessageContext = 0;
 
+    static void DM_TLS_DESTRUCTOR_CALL DeleteThreadPageCache(void* value);
+
     static MessageContext* Create(uint32_t max_sockets)
     {
         MessageContext* ctx = new MessageContext;
         ctx->m_Sockets.SetCapacity(max_sockets, max_sockets);
         dmSpinlock::Init(&ctx->m_Spinlock);
+        ctx->m_ThreadPageCacheKey = dmThread::AllocTls(DeleteThreadPageCache);
+        ctx->m_ThreadPageCaches = 0;
+        ctx->m_FreeThreadPages = 0;
+        dmSpinlock::Init(&ctx->m_PageSpinlock);
         return ctx;
     }
 
+    static void DeletePages(ThreadPage* page)
+    {
+        while (page)
+        {
+            ThreadPage* next = page->m_NextPage;
+            delete page;
+            page = next;
+        }
+    }
+
+    // Retire the current page. If all its messages are already dispatched it can be reused directly.
+    static void RetireThreadPage(ThreadPageCache* cache)
+    {
+        ThreadPage* page = cache->m_CurrentPage;
+        if (page)
+        {
+            // The page must not be touched after the add unless we brought the count to zero
+            int32_t message_count = (int32_t) page->m_MessageCount;
+            if (dmAtomicAdd32(&page->m_RefCount, message_count) == -message_count)
+            {
+                page->m_NextPage = cache->m_FreePages;
+                cache->m_FreePages = page;
+            }
+            cache->m_CurrentPage = 0;
+        }
+    }
+
+    static void Destroy(MessageContext* ctx)
+    {
+        // Freed first, as it might delete thread page caches (see dmThread::AllocTls)
+        dmThread::FreeTls(ctx->m_ThreadPageCacheKey);
+
+        ThreadPageCache* cache = ctx->m_ThreadPageCaches;
+        while (cache)
+        {
+            ThreadPageCache* next = cache->m_Next;
+            // Pages still referenced by undispatched messages are not freed
+            RetireThreadPage(cache);
+            DeletePages(cache->m_FreePages);
+            delete cache;
+            cache = next;
+        }
+        DeletePages(ctx->m_FreeThreadPages);
+        delete ctx;
+    }
+
+    static ThreadPageCache* GetThreadPageCache()
+    {
+        dmThread::TlsKey key = g_MessageContext->m_ThreadPageCacheKey;
+        ThreadPageCache* cache = (ThreadPageCache*) dmThread::GetTlsValue(key);
+        if (cache == 0)
+        {
+            cache = new ThreadPageCache;
+            cache->m_CurrentPage = 0;
+            cache->m_FreePages = 0;
+            dmThread::SetTlsValue(key, cache);
+
+            DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_PageSpinlock);
+            cache->m_Next = g_MessageContext->m_ThreadPageCaches;
+            g_MessageContext->m_ThreadPageCaches = cache;
+        }
+        return cache;
+    }
+
+    // Called when a thread that has posted to a single consumer socket exits. The pages of the thread are
+    // moved to the shared free list, and the current page is moved there once its messages are dispatched
+    static void DM_TLS_DESTRUCTOR_CALL DeleteThreadPageCache(void* value)
+    {
+        ThreadPageCache* cache = (ThreadPageCache*) value;
+        RetireThreadPage(cache);
+
+        {
+            DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_PageSpinlock);
+            ThreadPage* page = cache->m_FreePages;
+            while (page)
+            {
+                ThreadPage* next = page->m_NextPage;
+                page->m_NextPage = g_MessageContext->m_FreeThreadPages;
+                g_MessageContext->m_FreeThreadPages = page;
+                page = next;
+            }
+
+            ThreadPageCache** prev = &g_MessageContext->m_ThreadPageCaches;
+            while (*prev != cache)
+            {
+                prev = &(*prev)->m_Next;
+            }
+            *prev = cache->m_Next;
+        }
+        delete cache;
+    }
+
+    // Called by the dispatcher when 'count' messages in the page have been dispatched
+    static void ReleaseThreadPage(ThreadPage* page, int32_t count)
+    {
+        if (dmAtomicSub32(&page->m_RefCount, count) == count)
+        {
+            DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_PageSpinlock);
+            page->m_NextPage = g_MessageContext->m_FreeThreadPages;
+            g_MessageContext->m_FreeThreadPages = page;
+        }
+    }
+
+    static void AllocateNewThreadPage(ThreadPageCache* cache)
+    {
+        RetireThreadPage(cache);
+
+        if (cache->m_FreePages == 0)
+        {
+            // Move a batch of pages released by the dispatchers into this cache
+            DM_SPINLOCK_SCOPED_LOCK(g_MessageContext->m_PageSpinlock);
+            for (uint32_t i = 0; i < THREAD_PAGE_BATCH_SIZE && g_MessageContext->m_FreeThreadPages; ++i)
+            {
+                ThreadPage* free_page = g_MessageContext->m_FreeThreadPages;
+                g_MessageContext->m_FreeThreadPages = free_page->m_NextPage;
+                free_page->m_NextPage = cache->m_FreePages;
+                cache->m_FreePages = free_page;
+            }
+        }
+
+        ThreadPage* page;
+        if (cache->m_FreePages)
+        {
+            page = cache->m_FreePages;
+            cache->m_FreePages = page->m_NextPage;
+        }
+        else
+        {
+            page = new ThreadPage;
+            page->m_RefCount = 0;
+        }
+
+        page->m_Current = 0;
+        page->m_MessageCount = 0;
+        page->m_NextPage = 0;
+        cache->m_CurrentPage = page;
+    }
+
+    static Message* AllocateThreadMessage(ThreadPageCache* cache, uint32_t size)
+    {
+        // Room for the page pointer, while keeping the alignment of the message
+        size += DM_MESSAGE_ALIGNMENT + DM_MESSAGE_ALIGNMENT-1;
+        size &= ~(DM_MESSAGE_ALIGNMENT-1);
+        assert(size <= sizeof(((ThreadPage*)0)->m_Memory));
+
+        ThreadPage* page = cache->m_CurrentPage;
+        if (page == 0 || (sizeof(page->m_Memory) - page->m_Current) < size)
+        {
+            AllocateNewThreadPage(cache);
+            page = cache->m_CurrentPage;
+        }
+
+        uint8_t* ret = &page->m_Memory[page->m_Current];
+        page->m_Current += size;
+        page->m_MessageCount++;
+        *(ThreadPage**) ret = page;
+        return (Message*) (ret + DM_MESSAGE_ALIGNMENT);
+    }
+
+    static inline ThreadPage* GetThreadPage(Message* message)
+    {
+        return *(ThreadPage**) ((uintptr_t) message - DM_MESSAGE_ALIGNMENT);
+    }
+
+    // Reverses a list of messages, turning the newest first stack into a queue
+    static Message* ReverseMessages(Message* message)
+    {
+        Message* prev = 0;
+        while (message)
+        {
+            Message* next = message->m_Next;
+            message->m_Next = prev;
+            prev = message;
+            message = next;
+        }
+        return prev;
+    }
+
     // Until the Create/Destroy functions are exposed:
     // The context is created on demand, and we also need to destroy it automatically
     struct ContextDestroyer
@@ -144,13 +366,18 @@ namespace dmMessage
         {
             if (g_MessageContext)
             {
-                delete g_MessageContext;
+                Destroy(g_MessageContext);
                 g_MessageContext = 0;
             }
         }
     } g_ContextDestroyer;
 
     Result NewSocket(const char* name, HSocket* socket)
+    {
+        return NewSocket(name, socket, 0);
+    }
+
+    Result NewSocket(const char* name, HSocket* socket, uint32_t flags)
     {
         if (g_MessageContext == 0)
         {
@@ -180,6 +407,8 @@ namespace dmMessage
         s.m_RefCount = 1;
         s.m_Header = 0;
         s.m_Tail = 0;
+        s.m_LockFreeHeader = 0;
+        s.m_Flags = flags;
         s.m_NameHash = name_hash;
         s.m_Name = strdup(name);
         s.m_Mutex = dmMutex::New();
@@ -203,6 +432,18 @@ namespace dmMessage
             message_object = message_object->m_Next;
         }
 
+        message_object = ReverseMessages((Message*) dmAtomicStorePtr(&s->m_LockFreeHeader, 0));
+        while (message_object)
+        {
+            if (message_object->m_DestroyCallback)
+            {
+                message_object->m_DestroyCallback(message_object);
+            }
+            Message* next = message_object->m_Next;
+            ReleaseThreadPage(GetThreadPage(message_object), 1);
+            message_object = next;
+        }
+
         free((void*) s->m_Name);
 
         MemoryPage* p = s->m_Allocator.m_FreePages;
@@ -344,6 +585,11 @@ namespace dmMessage
         if (s != 0)
         {
             bool has_messages;
+            if (s->m_Flags & SOCKET_FLAG_SINGLE_CONSUMER)
+            {
+                has_messages = dmAtomicGetPtr(&s->m_LockFreeHeader) != 0;
+            }
+            else
             {
                 DM_MUTEX_SCOPED_LOCK(s->m_Mutex);
                 has_messages = s->m_Header != 0;
@@ -359,6 +605,50 @@ namespace dmMessage
         memset((void*)&url, 0, sizeof(URL));
     }
 
+    static void InitMessage(Message* new_message, const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data, uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback)
+    {
+        if (sender != 0x0)
+        {
+            new_message->m_Sender = *sender;
+        }
+        else
+        {
+            ResetURL(new_message->m_Sender);
+        }
+        new_message->m_Receiver = *receiver;
+        new_message->m_Id = message_id;
+        new_message->m_UserData = user_data;
+        new_message->m_Descriptor = descriptor;
+        new_message->m_DataSize = message_data_size;
+        new_message->m_Next = 0;
+        new_message->m_DestroyCallback = destroy_callback;
+        memcpy(&new_message->m_Data[0], message_data, message_data_size);
+    }
+
+    static void PostLockFree(MessageSocket* s, const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data, uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback)
+    {
+        Message* new_message = AllocateThreadMessage(GetThreadPageCache(), sizeof(Message) + message_data_size);
+        InitMessage(new_message, sender, receiver, message_id, user_data, descriptor, message_data, message_data_size, destroy_callback);
+
+        // Push onto the lock-free stack. The dispatcher restores the posting order
+        void* prev = dmAtomicGetPtr(&s->m_LockFreeHeader);
+        for (;;)
+        {
+            new_message->m_Next = (Message*) prev;
+            void* current = dmAtomicCompareStorePtr(&s->m_LockFreeHeader, new_message, prev);
+            if (current == prev)
+                break;
+            prev = current;
+        }
+
+        if (prev == 0)
+        {
+            // Wake up a blocking dispatcher. The lock orders this with the check in the dispatcher
+            DM_MUTEX_SCOPED_LOCK(s->m_Mutex);
+            dmConditionVariable::Signal(s->m_Condition);
+        }
+    }
+
     Result Post(const URL* sender, const URL* receiver, dmhash_t message_id, uintptr_t user_data, uintptr_t descriptor, const void* message_data, uint32_t message_data_size, MessageDestroyCallback destroy_callback)
     {
         DM_PROFILE(Message, "Post")
@@ -375,27 +665,19 @@ namespace dmMessage
             return RESULT_SOCKET_NOT_FOUND;
         }
 
+        if (s->m_Flags & SOCKET_FLAG_SINGLE_CONSUMER)
+        {
+            PostLockFree(s, sender, receiver, message_id, user_data, descriptor, message_data, message_data_size, destroy_callback);
+            ReleaseSocket(s);
+            return RESULT_OK;
+        }
+
         dmMutex::Lock(s->m_Mutex);
 
         MemoryAllocator* allocator = &s->m_Allocator;
         uint32_t data_size = sizeof(Message) + message_data_size;
         Message *new_message = (Message *) AllocateMessage(allocator, data_size);
-        if (sender != 0x0)
-        {
-            new_message->m_Sender = *sender;
-        }
-        else
-        {
-            ResetURL(new_message->m_Sender);
-        }
-        new_message->m_Receiver = *receiver;
-        new_message->m_Id = message_id;
-        new_message->m_UserData = user_data;
-        new_message->m_Descriptor = descriptor;
-        new_message->m_DataSize = message_data_size;
-        new_message->m_Next = 0;
-        new_message->m_DestroyCallback = destroy_callback;
-        memcpy(&new_message->m_Data[0], message_data, message_data_size);
+        InitMessage(new_message, sender, receiver, message_id, user_data, descriptor, message_data, message_data_size, destroy_callback);
 
         bool is_first_message = !s->m_Header;
 
@@ -453,6 +735,62 @@ namespace dmMessage
         return profiler_string;
     }
 
+    static uint32_t DispatchLockFree(MessageSocket* s, DispatchCallback dispatch_callback, void* user_ptr, bool blocking)
+    {
+        Message* message_object = (Message*) dmAtomicStorePtr(&s->m_LockFreeHeader, 0);
+        if (!message_object)
+        {
+            if (!blocking)
+            {
+                return 0;
+            }
+            DM_MUTEX_SCOPED_LOCK(s->m_Mutex);
+            while ((message_object = (Message*) dmAtomicStorePtr(&s->m_LockFreeHeader, 0)) == 0)
+            {
+                dmConditionVariable::Wait(s->m_Condition, s->m_Mutex);
+            }
+        }
+
+        uint32_t profiler_hash = 0;
+        const char* profiler_string = GetProfilerString(s->m_Name, &profiler_hash);
+        DM_PROFILE_DYN(Message, profiler_string, profiler_hash);
+
+        message_object = ReverseMessages(message_object);
+
+        // Pages are released once per run of messages from the same page
+        ThreadPage* page = 0;
+        int32_t page_message_count = 0;
+        uint32_t dispatch_count = 0;
+        while (message_object)
+        {
+            dispatch_callback(message_object, user_ptr);
+            if (message_object->m_DestroyCallback) {
+                message_object->m_DestroyCallback(message_object);
+            }
+
+            Message* next = message_object->m_Next;
+            ThreadPage* message_page = GetThreadPage(message_object);
+            if (message_page != page)
+            {
+                if (page)
+                {
+                    ReleaseThreadPage(page, page_message_count);
+                }
+                page = message_page;
+                page_message_count = 0;
+            }
+            ++page_message_count;
+            message_object = next;
+            dispatch_count++;
+        }
+        if (page)
+        {
+            ReleaseThreadPage(page, page_message_count);
+        }
+
+        return dispatch_count;
+    }
+
     uint32_t InternalDispatch(HSocket socket, DispatchCallback dispatch_callback, void* user_ptr, bool blocking)
     {
         MessageSocket* s = AcquireSocket(socket);
@@ -461,6 +799,13 @@ namespace dmMessage
             return 0;
         }
 
+        if (s->m_Flags & SOCKET_FLAG_SINGLE_CONSUMER)
+        {
+            uint32_t dispatch_count = DispatchLockFree(s, dispatch_callback, user_ptr, blocking);
+            ReleaseSocket(s);
+            return dispatch_count;
+        }
+
         dmMutex::Lock(s->m_Mutex);
 
         MemoryAllocator* allocator = &s->m_Allocator;
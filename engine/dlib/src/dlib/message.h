@@ -137,6 +137,25 @@ namespace dmMessage
      */
     Result NewSocket(const char* name, HSocket* socket);
 
+    /**
+     * Socket flags
+     */
+    enum SocketFlag
+    {
+        /// The socket is only dispatched from one thread at a time. Posting to
+        /// it is lock-free and message payloads are allocated from per-thread pages
+        SOCKET_FLAG_SINGLE_CONSUMER = 1,
+    };
+
+    /**
+     * Create a new socket
+     * @param name Socket name. Its length must be more than 0 and it cannot contain the characters '#' or ':' (@see ParseURL)
+     * @param socket Socket handle (out value)
+     * @param flags Combination of SocketFlag
+     * @return RESULT_OK on success
+     */
+    Result NewSocket(const char* name, HSocket* socket, uint32_t flags);
+
     /**
      * Delete a socket
      * @note  The socket must not have any pending messages
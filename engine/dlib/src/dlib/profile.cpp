@@ -50,10 +50,40 @@ namespace dmProfile
         dmArray<Sample>      m_Samples;
         dmArray<CounterData> m_CountersData;
         dmArray<ScopeData>   m_ScopesData;
+        uint64_t             m_BeginTick;
         uint32_t             m_ScopeCount;
         uint32_t             m_CounterCount;
     };
 
+    // A sample as recorded by its thread, see ThreadBuffer
+    struct ThreadSample
+    {
+        const char* m_Name;
+        Scope*      m_Scope;
+        uint64_t    m_Start;
+        uint32_t    m_Elapsed;
+        uint32_t    m_NameHash;
+        // Order in which the scopes were entered on the thread
+        uint32_t    m_Sequence;
+    };
+
+    // Ring buffer of the samples recorded by a single thread. Samples are written when the
+    // scope ends, by the owning thread only, and are read by Begin() on the main thread.
+    // If the reader falls behind, new samples are dropped instead of blocking the thread.
+    // When the thread exits the buffer is marked as dead, and Begin() frees it once drained.
+    struct ThreadBuffer
+    {
+        ThreadSample*  m_Samples;
+        ThreadBuffer*  m_Next;
+        uint32_t       m_Capacity; // Power of two
+        int32_atomic_t m_Write;
+        int32_atomic_t m_Read;
+        int32_atomic_t m_Dropped;
+        int32_atomic_t m_Dead;
+        uint32_t       m_Sequence;
+        uint16_t       m_ThreadId;
+    };
+
     // Default profile if not dmProfile::Initialize is invoked
     Profile g_EmptyProfile;
 
@@ -68,6 +98,8 @@ namespace dmProfile
     dmStringPool::HPool g_StringPool = 0;
 
     uint32_t g_BeginTime = 0;
+    uint64_t g_InitTick = 0;
+    uint32_t g_MaxSamples = 0;
     uint64_t g_TicksPerSecond = 1000000;
     float g_FrameTime = 0.0f;
     float g_MaxFrameTime = 0.0f;
@@ -79,9 +111,16 @@ namespace dmProfile
     bool g_Paused = false;
     dmSpinlock::lock_t g_ProfileLock;
 
-    dmThread::TlsKey g_TlsKey = dmThread::AllocTls();
+    static void DM_TLS_DESTRUCTOR_CALL ThreadBufferDestructor(void* value);
+
+    dmThread::TlsKey g_TlsKey = dmThread::AllocTls(ThreadBufferDestructor);
     int32_atomic_t g_ThreadCount = 0;
 
+    // All thread buffers, pushed lock-free when a thread records its first sample
+    ThreadBuffer* volatile g_ThreadBuffers = 0;
+    // Scratch memory used when moving thread samples into the active profile
+    dmArray<ThreadSample> g_CollectedSamples;
+
     // Used when out of scopes in order to remove conditional branches
     ScopeData g_DummyScopeData;
     Scope g_DummyScope = { "foo", 0u, 0, &g_DummyScopeData };
@@ -96,6 +135,35 @@ namespace dmProfile
 
     InitSpinLocks g_InitSpinlocks;
 
+    // Called when a thread that has recorded samples exits
+    static void DM_TLS_DESTRUCTOR_CALL ThreadBufferDestructor(void* value)
+    {
+        ThreadBuffer* buffer = (ThreadBuffer*) value;
+        dmAtomicStore32(&buffer->m_Dead, 1);
+    }
+
+    static void DeleteThreadBuffer(ThreadBuffer* buffer)
+    {
+        delete [] buffer->m_Samples;
+        delete buffer;
+    }
+
+    // Free all thread buffers. The tls key is replaced, as the threads still have pointers to
+    // the old buffers, and they allocate new buffers on their next sample.
+    static void DeleteThreadBuffers()
+    {
+        // Freed first, as it might call the destructor (see dmThread::AllocTls)
+        dmThread::FreeTls(g_TlsKey);
+        ThreadBuffer* buffer = (ThreadBuffer*) dmAtomicStorePtr((void* volatile*) &g_ThreadBuffers, 0);
+        while (buffer)
+        {
+            ThreadBuffer* next = buffer->m_Next;
+            DeleteThreadBuffer(buffer);
+            buffer = next;
+        }
+        g_TlsKey = dmThread::AllocTls(ThreadBufferDestructor);
+    }
+
     void Initialize(uint32_t max_scopes, uint32_t max_samples, uint32_t max_counters)
     {
         if (!dLib::IsDebugMode())
@@ -119,6 +187,11 @@ namespace dmProfile
             g_Scopes.SetSize(0);
         }
 
+        g_MaxSamples = max_samples;
+
+        // Discard old samples, and make the threads allocate buffers for the new max_samples
+        DeleteThreadBuffers();
+
         g_FreeProfiles.SetCapacity(PROFILE_BUFFER_COUNT);
         g_FreeProfiles.SetSize(0); // Could be > 0 if Initialized is called again after Finalize
 
@@ -178,7 +251,9 @@ namespace dmProfile
         // Set g_BeginTime even if we haven't started since threads may calculate scopes outside of
         // engine Begin()/End() of profiles which happens in Engine::Step() - just so we don't get
         // totally crazy numbers if this happens
-        g_BeginTime = GetNowTicks();
+        g_InitTick = GetNowTicks();
+        g_BeginTime = g_InitTick;
+        g_ActiveProfile->m_BeginTick = g_InitTick;
         g_IsInitialized = true;
     }
 
@@ -198,6 +273,8 @@ namespace dmProfile
 
         g_CountersTable.Clear();
         g_Counters.SetCapacity(0);
+        g_CollectedSamples.SetCapacity(0);
+        DeleteThreadBuffers();
 
         g_ActiveProfile = &g_EmptyProfile;
 
@@ -314,6 +391,115 @@ namespace dmProfile
         }
     }
 
+    struct ThreadSampleSequenceSorter
+    {
+        bool operator()(const ThreadSample& a, const ThreadSample& b) const
+        {
+            return (int32_t)(a.m_Sequence - b.m_Sequence) < 0;
+        }
+    };
+
+    // Unlink a buffer from g_ThreadBuffers. 'prev' is the preceding buffer, or null if it was the first
+    // buffer when the list was read. Threads may push new buffers at the head concurrently.
+    static void UnlinkThreadBuffer(ThreadBuffer* prev, ThreadBuffer* buffer)
+    {
+        if (prev == 0)
+        {
+            if (dmAtomicCompareStorePtr((void* volatile*) &g_ThreadBuffers, buffer->m_Next, buffer) == buffer)
+            {
+                return;
+            }
+            // New buffers were pushed in front of it
+            prev = (ThreadBuffer*) dmAtomicGetPtr((void* volatile*) &g_ThreadBuffers);
+            while (prev->m_Next != buffer)
+            {
+                prev = prev->m_Next;
+            }
+        }
+        prev->m_Next = buffer->m_Next;
+    }
+
+    static void CollectBufferSamples(Profile* profile, ThreadBuffer* buffer)
+    {
+        uint32_t read = (uint32_t) buffer->m_Read;
+        uint32_t write = (uint32_t) dmAtomicAdd32(&buffer->m_Write, 0);
+        uint32_t count = write - read;
+        if (dmAtomicStore32(&buffer->m_Dropped, 0) != 0)
+        {
+            g_OutOfSamples = true;
+        }
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (g_CollectedSamples.Capacity() < count)
+        {
+            g_CollectedSamples.SetCapacity(count);
+        }
+        g_CollectedSamples.SetSize(count);
+        uint32_t mask = buffer->m_Capacity - 1;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            g_CollectedSamples[i] = buffer->m_Samples[(read + i) & mask];
+        }
+        dmAtomicAdd32(&buffer->m_Read, (int32_t) count);
+
+        std::sort(g_CollectedSamples.Begin(), g_CollectedSamples.End(), ThreadSampleSequenceSorter());
+
+        if (count > g_MaxSamples)
+        {
+            count = g_MaxSamples;
+            g_OutOfSamples = true;
+        }
+
+        dmArray<Sample>& samples = profile->m_Samples;
+        if (samples.Remaining() < count)
+        {
+            samples.OffsetCapacity(dmMath::Max(count, samples.Capacity() / 2));
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const ThreadSample& thread_sample = g_CollectedSamples[i];
+            Sample sample;
+            sample.m_Name = thread_sample.m_Name;
+            sample.m_Scope = thread_sample.m_Scope;
+            // Scopes entered before the frame began are clamped to the start of the frame
+            sample.m_Start = thread_sample.m_Start > profile->m_BeginTick ? (uint32_t)(thread_sample.m_Start - profile->m_BeginTick) : 0;
+            sample.m_Elapsed = thread_sample.m_Elapsed;
+            sample.m_NameHash = thread_sample.m_NameHash;
+            sample.m_ThreadId = buffer->m_ThreadId;
+            sample.m_Pad = 0;
+            samples.Push(sample);
+        }
+    }
+
+    // Move the samples recorded by all threads since the last call into the profile.
+    // The samples of each thread are kept together, in the order their scopes were entered.
+    // Buffers of exited threads are freed once drained.
+    static void CollectThreadSamples(Profile* profile)
+    {
+        ThreadBuffer* prev = 0;
+        ThreadBuffer* buffer = (ThreadBuffer*) dmAtomicGetPtr((void* volatile*) &g_ThreadBuffers);
+        while (buffer)
+        {
+            ThreadBuffer* next = buffer->m_Next;
+            // Read before draining, so that no samples are written after it
+            bool dead = dmAtomicAdd32(&buffer->m_Dead, 0) != 0;
+            CollectBufferSamples(profile, buffer);
+            if (dead)
+            {
+                UnlinkThreadBuffer(prev, buffer);
+                DeleteThreadBuffer(buffer);
+            }
+            else
+            {
+                prev = buffer;
+            }
+            buffer = next;
+        }
+    }
+
     static void CalculateScopeProfile(Profile* profile)
     {
         // First pass is to determine count of active threads
@@ -351,6 +537,8 @@ namespace dmProfile
 
         dmSpinlock::Lock(&g_ProfileLock);
 
+        g_OutOfSamples = false;
+        CollectThreadSamples(g_ActiveProfile);
         CalculateScopeProfile(g_ActiveProfile);
 
         Profile* ret = g_ActiveProfile;
@@ -394,10 +582,10 @@ namespace dmProfile
 
         profile->m_Samples.SetSize(0);
 
-        g_BeginTime = GetNowTicks();
+        profile->m_BeginTick = GetNowTicks();
+        g_BeginTime = (uint32_t) profile->m_BeginTick;
 
         g_OutOfScopes = false;
-        g_OutOfSamples = false;
         g_OutOfCounters = false;
 
         dmSpinlock::Unlock(&g_ProfileLock);
@@ -458,56 +646,29 @@ namespace dmProfile
         }
     }
 
-    // Used when out of samples in order to remove conditional branches
-    Sample g_DummySample = { "OUT_OF_SAMPLES", 0, 0, 0, 0 };
-
-    static Sample* AllocateNewSample()
-    {
-        // NOTE: We can't take the spinlock if paused
-        // as it might already been taken in dmProfile:Begin()
-        // A deadlock case occur in dmMessage::Post if http-server is logging
-        // TODO: Use mutex instead?
-        if (g_Paused)
-        {
-            return &g_DummySample;
-        }
-
-        DM_SPINLOCK_SCOPED_LOCK(g_ProfileLock)
-        Profile* profile = g_ActiveProfile;
-
-        bool full = profile->m_Samples.Full();
-        if (full)
-        {
-            g_OutOfSamples = true;
-            return &g_DummySample;
-        }
-        profile->m_Samples.SetSize(profile->m_Samples.Size() + 1);
-        Sample* ret = profile->m_Samples.End() - 1;
-        return ret;
-    }
-
-    Sample* AllocateSample()
+    // Called the first time a thread records a sample
+    static ThreadBuffer* NewThreadBuffer()
     {
-        Sample* ret = AllocateNewSample();
-        if (ret == &g_DummySample)
+        ThreadBuffer* buffer = new ThreadBuffer;
+        memset(buffer, 0, sizeof(ThreadBuffer));
+        uint32_t capacity = 1;
+        while (capacity < g_MaxSamples)
         {
-            return ret;
+            capacity <<= 1;
         }
+        buffer->m_Samples = new ThreadSample[capacity];
+        buffer->m_Capacity = capacity;
+        buffer->m_ThreadId = (uint16_t) dmAtomicIncrement32(&g_ThreadCount);
 
-        void* tls_data = dmThread::GetTlsValue(g_TlsKey);
-        if (tls_data == 0)
+        ThreadBuffer* head;
+        do
         {
-            // NOTE: We store thread_id + 1. Otherwise we can't differentiate between thread-id 0 and not initialized
-            int32_t next_thread_id = dmAtomicIncrement32(&g_ThreadCount) + 1;
-            void* thread_id = (void*)((uintptr_t)next_thread_id);
-            dmThread::SetTlsValue(g_TlsKey, thread_id);
-            tls_data = thread_id;
-        }
-        intptr_t thread_id = ((intptr_t)tls_data) - 1;
-        assert(thread_id >= 0);
+            head = (ThreadBuffer*) dmAtomicGetPtr((void* volatile*) &g_ThreadBuffers);
+            buffer->m_Next = head;
+        } while (dmAtomicCompareStorePtr((void* volatile*) &g_ThreadBuffers, buffer, head) != head);
 
-        ret->m_ThreadId = thread_id;
-        return ret;
+        dmThread::SetTlsValue(g_TlsKey, buffer);
+        return buffer;
     }
 
     const char* Internalize(const char* string, uint32_t string_length, uint32_t string_hash)
@@ -622,9 +783,9 @@ namespace dmProfile
             return;
         }
 
-        DM_SPINLOCK_SCOPED_LOCK(g_ProfileLock)
-        Profile* profile = g_ActiveProfile;
-        profile->m_CountersData[counter_index].m_Value += amount;
+        // NOTE: No lock here, an add racing with Begin() may end up in the previous frame
+        Profile* profile = (Profile*) dmAtomicGetPtr((void* volatile*) &g_ActiveProfile);
+        dmAtomicAdd32(&profile->m_CountersData[counter_index].m_Value, (int32_t) amount);
     }
 
     float GetFrameTime()
@@ -777,6 +938,80 @@ namespace dmProfile
         }
     }
 
+    // Writes the string as a quoted JSON string
+    static void WriteJsonString(const char* str, void* context, void (*write_fn)(void* context, const char* data, uint32_t size))
+    {
+        char buffer[128];
+        uint32_t n = 0;
+        buffer[n++] = '"';
+        for (const char* c = str; *c; ++c)
+        {
+            if (n + 8 > sizeof(buffer))
+            {
+                write_fn(context, buffer, n);
+                n = 0;
+            }
+            unsigned char ch = (unsigned char) *c;
+            if (ch == '"' || ch == '\\')
+            {
+                buffer[n++] = '\\';
+                buffer[n++] = ch;
+            }
+            else if (ch < 0x20)
+            {
+                n += dmSnPrintf(buffer + n, sizeof(buffer) - n, "\\u%04x", ch);
+            }
+            else
+            {
+                buffer[n++] = ch;
+            }
+        }
+        buffer[n++] = '"';
+        write_fn(context, buffer, n);
+    }
+
+    void WriteChromeTrace(HProfile profile, void* context, void (*write_fn)(void* context, const char* data, uint32_t size))
+    {
+        const char* header = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        write_fn(context, header, (uint32_t) strlen(header));
+
+        char buffer[256];
+        double micros_per_tick = 1000000.0 / g_TicksPerSecond;
+        uint64_t begin_tick = profile->m_BeginTick - dmMath::Min(profile->m_BeginTick, g_InitTick);
+        bool first = true;
+
+        uint32_t n = profile->m_Samples.Size();
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            const Sample* sample = &profile->m_Samples[i];
+            int len = dmSnPrintf(buffer, sizeof(buffer), "%s{\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"cat\":",
+                                 first ? "" : ",\n", (uint32_t) sample->m_ThreadId,
+                                 (begin_tick + sample->m_Start) * micros_per_tick, sample->m_Elapsed * micros_per_tick);
+            write_fn(context, buffer, (uint32_t) len);
+            WriteJsonString(sample->m_Scope->m_Name, context, write_fn);
+            write_fn(context, ",\"name\":", 8);
+            WriteJsonString(sample->m_Name, context, write_fn);
+            write_fn(context, "}", 1);
+            first = false;
+        }
+
+        // Counters are reported once per frame, at the start of the frame
+        n = profile->m_CounterCount;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            const CounterData* counter_data = &profile->m_CountersData[i];
+            int len = dmSnPrintf(buffer, sizeof(buffer), "%s{\"ph\":\"C\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"args\":{\"value\":%d},\"name\":",
+                                 first ? "" : ",\n", begin_tick * micros_per_tick, (int32_t) counter_data->m_Value);
+            write_fn(context, buffer, (uint32_t) len);
+            WriteJsonString(counter_data->m_Counter->m_Name, context, write_fn);
+            write_fn(context, "}", 1);
+            first = false;
+        }
+
+        const char* footer = "\n]}\n";
+        write_fn(context, footer, (uint32_t) strlen(footer));
+    }
+
     uint32_t GetTickSinceBegin()
     {
         uint64_t now = GetNowTicks();
@@ -802,24 +1037,57 @@ namespace dmProfile
 
     void ProfileScope::StartScope(uint32_t scope_index, const char* name, uint32_t name_hash)
     {
+        if (!g_IsInitialized)
+        {
+            m_Buffer = 0;
+            return;
+        }
+
+        ThreadBuffer* buffer = (ThreadBuffer*) dmThread::GetTlsValue(g_TlsKey);
+        if (buffer == 0)
+        {
+            buffer = NewThreadBuffer();
+        }
+        m_Buffer = buffer;
+        m_Scope = &g_Scopes[scope_index];
+        m_Name = name;
+        m_NameHash = name_hash;
+        m_Sequence = buffer->m_Sequence++;
         m_StartTick = GetNowTicks();
-        Sample* s = AllocateSample();
-        s->m_Name = name;
-        s->m_Scope = &g_Scopes[scope_index];
-        s->m_NameHash = name_hash;
-        s->m_Start = (uint32_t)(m_StartTick - g_BeginTime);
-        m_Sample = s;
     }
 
     void ProfileScope::EndScope()
     {
         uint64_t end = GetNowTicks();
-        m_Sample->m_Elapsed = (uint32_t)(end - m_StartTick);
-        if (m_Sample->m_Elapsed > (dmProfile::GetTicksPerSecond() * 2))
+        uint32_t elapsed = (uint32_t)(end - m_StartTick);
+        if (elapsed > (dmProfile::GetTicksPerSecond() * 2))
+        {
+            double elapsed_s = (double)(elapsed) / dmProfile::GetTicksPerSecond();
+            dmLogWarning("Profiler %s.%s took %.3lf seconds", m_Scope->m_Name, m_Name, elapsed_s);
+        }
+
+        if (g_Paused)
+        {
+            return;
+        }
+
+        ThreadBuffer* buffer = m_Buffer;
+        uint32_t write = (uint32_t) buffer->m_Write;
+        uint32_t read = (uint32_t) dmAtomicAdd32(&buffer->m_Read, 0);
+        if (write - read >= buffer->m_Capacity)
         {
-            double elapsed_s = (double)(m_Sample->m_Elapsed) / dmProfile::GetTicksPerSecond();
-            dmLogWarning("Profiler %s.%s took %.3lf seconds", m_Sample->m_Scope->m_Name, m_Sample->m_Name, elapsed_s);
+            dmAtomicIncrement32(&buffer->m_Dropped);
+            return;
         }
 
+        ThreadSample* sample = &buffer->m_Samples[write & (buffer->m_Capacity - 1)];
+        sample->m_Name = m_Name;
+        sample->m_Scope = m_Scope;
+        sample->m_Start = m_StartTick;
+        sample->m_Elapsed = elapsed;
+        sample->m_NameHash = m_NameHash;
+        sample->m_Sequence = m_Sequence;
+        // Publishes the sample to the reader
+        dmAtomicIncrement32(&buffer->m_Write);
     }
 } // namespace dmProfile
@@ -181,7 +181,7 @@ namespace dmProfile
     /**
      * Initialize profiler
      * @param max_scopes Maximum scopes
-     * @param max_samples Maximum samples
+     * @param max_samples Maximum samples per thread and frame. Each thread records into its own buffer of this size.
      * @param max_counters Maximum counters
      */
     void Initialize(uint32_t max_scopes, uint32_t max_samples, uint32_t max_counters);
@@ -273,12 +273,6 @@ namespace dmProfile
      */
     uint32_t AllocateScope(const char* name);
 
-    /**
-     * Internal function
-     * @return #Sample
-     */
-    Sample* AllocateSample();
-
     /**
      * Create an internalized string. Use this function in DM_PROFILE if the
      * name isn't valid for the life-time of the application
@@ -318,6 +312,16 @@ namespace dmProfile
      */
     void AddCounterIndex(uint32_t counter_index, uint32_t amount);
 
+    /**
+     * Write the samples and counters of a profile snapshot as Chrome Trace Event JSON,
+     * viewable in chrome://tracing or Perfetto. Timestamps are in microseconds since the
+     * profiler was initialized, so the output of consecutive frames can be merged.
+     * @param profile Profile snapshot
+     * @param context User context
+     * @param write_fn Called with consecutive chunks of the JSON document
+     */
+    void WriteChromeTrace(HProfile profile, void* context, void (*write_fn)(void* context, const char* data, uint32_t size));
+
     /**
      * Get time for the frame total
      * @return Total frame time
@@ -338,7 +342,7 @@ namespace dmProfile
 
     /**
      * Check of out of sample resources
-     * @return True if out of sample resources
+     * @return True if any thread recorded more than max_samples samples during the last frame
      */
     bool IsOutOfSamples();
 
@@ -347,11 +351,18 @@ namespace dmProfile
 
     uint64_t GetNowTicks();
 
+    /// Internal, do not use.
+    struct ThreadBuffer;
+
     /// Internal, do not use.
     struct ProfileScope
     {
-        Sample* m_Sample;
-        uint64_t m_StartTick;
+        ThreadBuffer* m_Buffer;
+        Scope*        m_Scope;
+        const char*   m_Name;
+        uint64_t      m_StartTick;
+        uint32_t      m_NameHash;
+        uint32_t      m_Sequence;
         inline ProfileScope(uint32_t scope_index, const char* name, uint32_t name_hash)
         {
             if (scope_index != 0xffffffffu)
@@ -360,13 +371,13 @@ namespace dmProfile
             }
             else
             {
-                m_Sample = 0;
+                m_Buffer = 0;
             }
         }
 
         inline ~ProfileScope()
         {
-            if (m_Sample)
+            if (m_Buffer)
             {
                 EndScope();
             }
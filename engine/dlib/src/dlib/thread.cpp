@@ -11,7 +11,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include <assert.h>
-#include <dmsdk/dlib/thread.h>
+#include "thread.h"
 
 #if defined(_WIN32)
 #include <stdlib.h>
@@ -91,9 +91,14 @@ namespace dmThread
     }
 
     TlsKey AllocTls()
+    {
+        return AllocTls(0);
+    }
+
+    TlsKey AllocTls(TlsDestructor destructor)
     {
         pthread_key_t key;
-        int ret = pthread_key_create(&key, 0);
+        int ret = pthread_key_create(&key, destructor);
         assert(ret == 0);
         return key;
     }
@@ -178,26 +183,35 @@ namespace dmThread
         assert(ret == WAIT_OBJECT_0);
     }
 
+    // Fiber local storage is used since it, unlike TlsAlloc, supports destructors.
+    // It behaves as thread local storage for threads that don't use fibers.
     TlsKey AllocTls()
     {
-        return TlsAlloc();
+        return AllocTls(0);
+    }
+
+    TlsKey AllocTls(TlsDestructor destructor)
+    {
+        DWORD key = FlsAlloc(destructor);
+        assert(key != FLS_OUT_OF_INDEXES);
+        return key;
     }
 
     void FreeTls(TlsKey key)
     {
-        BOOL ret = TlsFree(key);
+        BOOL ret = FlsFree(key);
         assert(ret);
     }
 
     void SetTlsValue(TlsKey key, void* value)
     {
-        BOOL ret = TlsSetValue(key, value);
+        BOOL ret = FlsSetValue(key, value);
         assert(ret);
     }
 
     void* GetTlsValue(TlsKey key)
     {
-        return TlsGetValue(key);
+        return FlsGetValue(key);
     }
 
     Thread GetCurrentThread()
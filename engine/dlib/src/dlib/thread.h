@@ -15,4 +15,28 @@
 
 #include <dmsdk/dlib/thread.h>
 
+#if defined(_WIN32)
+#define DM_TLS_DESTRUCTOR_CALL WINAPI
+#else
+#define DM_TLS_DESTRUCTOR_CALL
+#endif
+
+namespace dmThread
+{
+    /**
+     * Thread local storage destructor. Declare with DM_TLS_DESTRUCTOR_CALL.
+     * @param value Value of the key in the exiting thread, never null
+     */
+    typedef void (DM_TLS_DESTRUCTOR_CALL *TlsDestructor)(void* value);
+
+    /**
+     * Allocate thread local storage key with a destructor. The destructor is called
+     * when a thread with a non-null value for the key exits.
+     * NOTE: On Windows the destructor is also called for the remaining values when the key is freed
+     * @param destructor Destructor
+     * @return Key
+     */
+    TlsKey AllocTls(TlsDestructor destructor);
+}
+
 #endif // DM_THREAD_H
@@ -0,0 +1,190 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <assert.h>
+#include "worker_pool.h"
+#include "array.h"
+#include "atomic.h"
+#include "thread.h"
+#include "mutex.h"
+#include "condition_variable.h"
+#include "math.h"
+#include "profile.h"
+
+namespace dmWorkerPool
+{
+    // Number of chunks per thread, to balance uneven work between the threads
+    const uint32_t CHUNKS_PER_THREAD = 4;
+
+    struct WorkerPool
+    {
+        dmMutex::HMutex                         m_Mutex;
+        dmConditionVariable::HConditionVariable m_WorkCond;
+        dmConditionVariable::HConditionVariable m_DoneCond;
+        dmArray<dmThread::Thread>               m_Threads;
+
+        // The current work, written by the issuing thread with the mutex held
+        RangeFunction                           m_Function;
+        void*                                   m_Context;
+        uint32_t                                m_Count;
+        uint32_t                                m_ChunkSize;
+        uint32_t                                m_ChunkCount;
+        int32_atomic_t                          m_NextChunk;
+        // Incremented for each new work, so the workers can tell new work from old
+        uint32_t                                m_Generation;
+        // Number of workers currently processing chunks
+        uint32_t                                m_ActiveWorkers;
+        bool                                    m_Shutdown;
+    };
+
+    static void ProcessChunks(WorkerPool* pool)
+    {
+        while (true)
+        {
+            uint32_t chunk = (uint32_t) dmAtomicIncrement32(&pool->m_NextChunk);
+            if (chunk >= pool->m_ChunkCount)
+                break;
+            uint32_t start = chunk * pool->m_ChunkSize;
+            uint32_t end = dmMath::Min(start + pool->m_ChunkSize, pool->m_Count);
+            pool->m_Function(pool->m_Context, start, end);
+        }
+    }
+
+    static void WorkerThread(void* arg)
+    {
+        WorkerPool* pool = (WorkerPool*) arg;
+        uint32_t generation = 0;
+        while (true)
+        {
+            {
+                dmMutex::ScopedLock lk(pool->m_Mutex);
+                while (!pool->m_Shutdown && pool->m_Generation == generation)
+                {
+                    dmConditionVariable::Wait(pool->m_WorkCond, pool->m_Mutex);
+                }
+                if (pool->m_Shutdown)
+                {
+                    return;
+                }
+                generation = pool->m_Generation;
+
+                // Only take part if there is anything left to do. Once all chunks are taken,
+                // the issuing thread may return and start new work at any time.
+                if ((uint32_t) dmAtomicAdd32(&pool->m_NextChunk, 0) >= pool->m_ChunkCount)
+                {
+                    continue;
+                }
+                pool->m_ActiveWorkers++;
+            }
+
+            ProcessChunks(pool);
+
+            {
+                dmMutex::ScopedLock lk(pool->m_Mutex);
+                pool->m_ActiveWorkers--;
+                if (pool->m_ActiveWorkers == 0)
+                {
+                    dmConditionVariable::Signal(pool->m_DoneCond);
+                }
+            }
+        }
+    }
+
+    HWorkerPool New(uint32_t worker_count, const char* name)
+    {
+#if defined(__EMSCRIPTEN__)
+        worker_count = 0;
+#endif
+        WorkerPool* pool      = new WorkerPool;
+        pool->m_Mutex         = dmMutex::New();
+        pool->m_WorkCond      = dmConditionVariable::New();
+        pool->m_DoneCond      = dmConditionVariable::New();
+        pool->m_Function      = 0;
+        pool->m_Context       = 0;
+        pool->m_Count         = 0;
+        pool->m_ChunkSize     = 0;
+        pool->m_ChunkCount    = 0;
+        pool->m_NextChunk     = 0;
+        pool->m_Generation    = 0;
+        pool->m_ActiveWorkers = 0;
+        pool->m_Shutdown      = false;
+
+        pool->m_Threads.SetCapacity(worker_count);
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            pool->m_Threads.Push(dmThread::New(&WorkerThread, 0x80000, pool, name));
+        }
+        return pool;
+    }
+
+    void Delete(HWorkerPool pool)
+    {
+        {
+            dmMutex::ScopedLock lk(pool->m_Mutex);
+            pool->m_Shutdown = true;
+            dmConditionVariable::Broadcast(pool->m_WorkCond);
+        }
+        for (uint32_t i = 0; i < pool->m_Threads.Size(); ++i)
+        {
+            dmThread::Join(pool->m_Threads[i]);
+        }
+        dmConditionVariable::Delete(pool->m_DoneCond);
+        dmConditionVariable::Delete(pool->m_WorkCond);
+        dmMutex::Delete(pool->m_Mutex);
+        delete pool;
+    }
+
+    uint32_t GetWorkerCount(HWorkerPool pool)
+    {
+        return pool ? pool->m_Threads.Size() : 0;
+    }
+
+    void ParallelFor(HWorkerPool pool, RangeFunction fn, void* context, uint32_t count, uint32_t min_chunk_size)
+    {
+        if (count == 0)
+            return;
+
+        const uint32_t thread_count = GetWorkerCount(pool) + 1;
+        uint32_t chunk_size = (count + thread_count * CHUNKS_PER_THREAD - 1) / (thread_count * CHUNKS_PER_THREAD);
+        chunk_size = dmMath::Max(chunk_size, dmMath::Max(min_chunk_size, 1U));
+
+        if (thread_count == 1 || chunk_size >= count)
+        {
+            fn(context, 0, count);
+            return;
+        }
+
+        DM_PROFILE(WorkerPool, "ParallelFor");
+
+        {
+            dmMutex::ScopedLock lk(pool->m_Mutex);
+            assert(pool->m_ActiveWorkers == 0);
+            pool->m_Function   = fn;
+            pool->m_Context    = context;
+            pool->m_Count      = count;
+            pool->m_ChunkSize  = chunk_size;
+            pool->m_ChunkCount = (count + chunk_size - 1) / chunk_size;
+            pool->m_NextChunk  = 0;
+            pool->m_Generation++;
+            dmConditionVariable::Broadcast(pool->m_WorkCond);
+        }
+
+        ProcessChunks(pool);
+
+        // All chunks are taken at this point, wait for the workers still processing theirs
+        dmMutex::ScopedLock lk(pool->m_Mutex);
+        while (pool->m_ActiveWorkers > 0)
+        {
+            dmConditionVariable::Wait(pool->m_DoneCond, pool->m_Mutex);
+        }
+    }
+}
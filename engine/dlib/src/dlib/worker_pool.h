@@ -0,0 +1,71 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_WORKER_POOL_H
+#define DM_WORKER_POOL_H
+
+#include <stdint.h>
+
+/**
+ * A pool of worker threads used to split data parallel work (e.g. a loop over independent items)
+ * across the available cores. The calling thread always participates in the work, and the call
+ * returns once all items are processed.
+ */
+namespace dmWorkerPool
+{
+    typedef struct WorkerPool* HWorkerPool;
+
+    /**
+     * Processes the items in the range [start, end)
+     * @param context User context
+     * @param start First item
+     * @param end One past the last item
+     */
+    typedef void (*RangeFunction)(void* context, uint32_t start, uint32_t end);
+
+    /**
+     * Create a new worker pool
+     * @note On platforms without thread support, no worker threads are created
+     * @param worker_count Number of worker threads. With zero workers all work is done on the calling thread
+     * @param name Name of the worker threads
+     * @return Worker pool handle
+     */
+    HWorkerPool New(uint32_t worker_count, const char* name);
+
+    /**
+     * Stop the worker threads and delete the pool
+     * @param pool Worker pool handle
+     */
+    void Delete(HWorkerPool pool);
+
+    /**
+     * Get the number of worker threads
+     * @param pool Worker pool handle. May be 0
+     * @return Number of worker threads, not counting the calling thread
+     */
+    uint32_t GetWorkerCount(HWorkerPool pool);
+
+    /**
+     * Process the items [0, count) in chunks of at least min_chunk_size items, using the worker threads
+     * and the calling thread. Returns when all items are processed.
+     * @note The function is called concurrently from several threads, and must only touch data owned by the range
+     * @note Only one thread at a time may issue work to a pool
+     * @param pool Worker pool handle. If 0, all items are processed on the calling thread
+     * @param fn Function processing a range of items
+     * @param context User context passed to fn
+     * @param count Number of items
+     * @param min_chunk_size Minimum number of items per call to fn
+     */
+    void ParallelFor(HWorkerPool pool, RangeFunction fn, void* context, uint32_t count, uint32_t min_chunk_size);
+}
+
+#endif // DM_WORKER_POOL_H
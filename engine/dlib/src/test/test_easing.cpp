@@ -106,6 +106,42 @@ TEST(dmEasing, CurstomCurve)
     }
 }
 
+TEST(dmEasing, GetValues)
+{
+    float t[101];
+    float values[101];
+    for (int i = 0; i <= 100; ++i) {
+        t[i] = i / 50.0f - 0.5f;
+    }
+
+    for (int type = 0; type < dmEasing::TYPE_FLOAT_VECTOR; ++type) {
+        dmEasing::Curve curve((dmEasing::Type) type);
+        dmEasing::GetValues(curve, t, values, 101);
+        for (int i = 0; i <= 100; ++i) {
+            ASSERT_EQ(dmEasing::GetValue(curve, t[i]), values[i]);
+        }
+    }
+
+    dmVMath::FloatVector vector(3);
+    vector.values[0] = 0.0f;
+    vector.values[1] = 0.25f;
+    vector.values[2] = 1.0f;
+    dmEasing::Curve curve(dmEasing::TYPE_FLOAT_VECTOR);
+    curve.vector = &vector;
+    dmEasing::GetValues(curve, t, values, 101);
+    for (int i = 0; i <= 100; ++i) {
+        ASSERT_EQ(dmEasing::GetValue(curve, t[i]), values[i]);
+    }
+
+    dmVMath::FloatVector vector_single(1);
+    vector_single.values[0] = 0.7f;
+    curve.vector = &vector_single;
+    dmEasing::GetValues(curve, t, values, 101);
+    for (int i = 0; i <= 100; ++i) {
+        ASSERT_EQ(0.7f, values[i]);
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
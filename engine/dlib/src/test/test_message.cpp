@@ -460,6 +460,236 @@ TEST(dmMessage, MessagePostDispatch)
     ASSERT_EQ(7011, g_PostDistpatchCalled);
 }
 
+struct OrderMessage
+{
+    uint32_t m_Producer;
+    uint32_t m_Sequence;
+};
+
+struct OrderContext
+{
+    uint32_t m_Next[8];
+    uint32_t m_Count;
+    bool     m_InOrder;
+};
+
+void HandleOrderMessage(dmMessage::Message *message_object, void *user_ptr)
+{
+    OrderContext* ctx = (OrderContext*) user_ptr;
+    OrderMessage* m = (OrderMessage*) message_object->m_Data;
+    ctx->m_InOrder = ctx->m_InOrder && m->m_Sequence == ctx->m_Next[m->m_Producer];
+    ctx->m_Next[m->m_Producer] = m->m_Sequence + 1;
+    ctx->m_Count++;
+}
+
+TEST(dmMessage, SingleConsumerPost)
+{
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket, dmMessage::SOCKET_FLAG_SINGLE_CONSUMER));
+    ASSERT_FALSE(dmMessage::HasMessages(receiver.m_Socket));
+
+    OrderContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.m_InOrder = true;
+    // Enough messages to cycle through several pages
+    for (uint32_t iter = 0; iter < 64; ++iter)
+    {
+        for (uint32_t i = 0; i < 300; ++i)
+        {
+            OrderMessage m = {0, iter * 300 + i};
+            ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, m_HashMessage1, 0, 0x0, &m, sizeof(m), 0));
+        }
+        ASSERT_TRUE(dmMessage::HasMessages(receiver.m_Socket));
+        ASSERT_EQ(300u, dmMessage::Dispatch(receiver.m_Socket, HandleOrderMessage, &ctx));
+        ASSERT_FALSE(dmMessage::HasMessages(receiver.m_Socket));
+    }
+    ASSERT_TRUE(ctx.m_InOrder);
+    ASSERT_EQ(64u * 300u, ctx.m_Count);
+
+    ASSERT_EQ(0u, dmMessage::Dispatch(receiver.m_Socket, HandleOrderMessage, &ctx));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
+
+TEST(dmMessage, SingleConsumerIntegrity)
+{
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket, dmMessage::SOCKET_FLAG_SINGLE_CONSUMER));
+
+    const uint32_t MESSAGE_SIZES[] = {
+        0, 1, 7, 33, 513,
+        dmMessage::DM_MESSAGE_MAX_DATA_SIZE / 2 + 1,
+        dmMessage::DM_MESSAGE_MAX_DATA_SIZE};
+
+    char msg[dmMessage::DM_MESSAGE_MAX_DATA_SIZE];
+    for (uint32_t n = 0; n < (sizeof(MESSAGE_SIZES) / sizeof(uint32_t)); ++n)
+    {
+        uint32_t size = MESSAGE_SIZES[n];
+        for (uint32_t iter = 0; iter < 15; ++iter)
+        {
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                msg[i] = rand() % 255;
+            }
+            dmhash_t hash = dmHashBuffer64(msg, size);
+
+            ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, hash, 0, 0x0, msg, size, 0));
+        }
+        ASSERT_EQ(15u, dmMessage::Dispatch(receiver.m_Socket, HandleIntegrityMessage, 0));
+    }
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
+
+TEST(dmMessage, SingleConsumerDestroyCallback)
+{
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket, dmMessage::SOCKET_FLAG_SINGLE_CONSUMER));
+    uint32_t sent = 42;
+    uint32_t received = 0;
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, 0, (uintptr_t)&sent, 0x0, 0x0, 0, CustomMessageDestroyCallback));
+    ASSERT_EQ(1u, dmMessage::Dispatch(receiver.m_Socket, HandleUserDataMessage, (void*)&received));
+    ASSERT_EQ(42u, received);
+    ASSERT_EQ(42, g_PostDistpatchCalled);
+
+    // Pending messages are destroyed with the socket
+    g_PostDistpatchCalled = 0;
+    sent = 7011;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, 0, (uintptr_t)&sent, 0x0, 0x0, 0, CustomMessageDestroyCallback));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+    ASSERT_EQ(7011, g_PostDistpatchCalled);
+}
+
+struct PostOrderThreadContext
+{
+    dmMessage::URL* m_Receiver;
+    uint32_t        m_Producer;
+    uint32_t        m_Count;
+};
+
+void PostOrderThread(void* arg)
+{
+    PostOrderThreadContext* ctx = (PostOrderThreadContext*) arg;
+    for (uint32_t i = 0; i < ctx->m_Count; ++i)
+    {
+        OrderMessage m = {ctx->m_Producer, i};
+        dmMessage::Post(0x0, ctx->m_Receiver, m_HashMessage1, 0, 0x0, &m, sizeof(m), 0);
+    }
+}
+
+// Posts 'count' messages from each of 'producer_count' threads and dispatches them on this thread
+static uint64_t PostFromThreads(dmMessage::URL* receiver, uint32_t producer_count, uint32_t count, bool blocking, OrderContext* ctx)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->m_InOrder = true;
+
+    PostOrderThreadContext thread_ctx[8];
+    dmThread::Thread threads[8];
+    uint64_t start = dmTime::GetTime();
+    for (uint32_t i = 0; i < producer_count; ++i)
+    {
+        thread_ctx[i].m_Receiver = receiver;
+        thread_ctx[i].m_Producer = i;
+        thread_ctx[i].m_Count = count;
+        threads[i] = dmThread::New(&PostOrderThread, 0xf0000, (void*) &thread_ctx[i], "post");
+    }
+
+    while (ctx->m_Count < producer_count * count)
+    {
+        if (blocking)
+            dmMessage::DispatchBlocking(receiver->m_Socket, HandleOrderMessage, ctx);
+        else
+            dmMessage::Dispatch(receiver->m_Socket, HandleOrderMessage, ctx);
+    }
+    uint64_t end = dmTime::GetTime();
+
+    for (uint32_t i = 0; i < producer_count; ++i)
+    {
+        dmThread::Join(threads[i]);
+    }
+    return end - start;
+}
+
+TEST(dmMessage, SingleConsumerThreads)
+{
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket, dmMessage::SOCKET_FLAG_SINGLE_CONSUMER));
+
+    OrderContext ctx;
+    for (uint32_t blocking = 0; blocking < 2; ++blocking)
+    {
+        PostFromThreads(&receiver, 4, 20000, blocking != 0, &ctx);
+        ASSERT_TRUE(ctx.m_InOrder);
+        ASSERT_EQ(4u * 20000u, ctx.m_Count);
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            ASSERT_EQ(20000u, ctx.m_Next[i]);
+        }
+    }
+
+    ASSERT_EQ(0u, dmMessage::Dispatch(receiver.m_Socket, HandleOrderMessage, &ctx));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
+
+TEST(dmMessage, SingleConsumerExitedThreads)
+{
+    dmMessage::URL receiver;
+    dmMessage::ResetURL(receiver);
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket, dmMessage::SOCKET_FLAG_SINGLE_CONSUMER));
+
+    // The pages of exited threads are kept until their messages are dispatched, and are then reused
+    OrderContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.m_InOrder = true;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        PostOrderThreadContext thread_ctx;
+        thread_ctx.m_Receiver = &receiver;
+        thread_ctx.m_Producer = i % 4;
+        thread_ctx.m_Count = 1000;
+        dmThread::Thread thread = dmThread::New(&PostOrderThread, 0xf0000, (void*) &thread_ctx, "post");
+        dmThread::Join(thread);
+
+        memset(ctx.m_Next, 0, sizeof(ctx.m_Next));
+        ASSERT_EQ(1000u, dmMessage::Dispatch(receiver.m_Socket, HandleOrderMessage, &ctx));
+        ASSERT_TRUE(ctx.m_InOrder);
+        ASSERT_EQ(1000u, ctx.m_Next[i % 4]);
+    }
+
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+}
+
+TEST(dmMessage, BenchThreads)
+{
+    const uint32_t count = 100000;
+    const uint32_t producer_counts[] = {1, 4};
+    const char* mode_names[] = {"locked", "single consumer"};
+    const uint32_t mode_flags[] = {0, dmMessage::SOCKET_FLAG_SINGLE_CONSUMER};
+
+    for (uint32_t mode = 0; mode < 2; ++mode)
+    {
+        dmMessage::URL receiver;
+        dmMessage::ResetURL(receiver);
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::NewSocket("my_socket", &receiver.m_Socket, mode_flags[mode]));
+
+        for (uint32_t p = 0; p < sizeof(producer_counts) / sizeof(producer_counts[0]); ++p)
+        {
+            uint32_t producer_count = producer_counts[p];
+            OrderContext ctx;
+            uint64_t elapsed = PostFromThreads(&receiver, producer_count, count, false, &ctx);
+            ASSERT_TRUE(ctx.m_InOrder);
+            uint32_t total = producer_count * count;
+            printf("Post+Dispatch %-15s %u producer(s): %f ms (%f Mmsg/s)\n", mode_names[mode], producer_count,
+                    elapsed / 1000.0f, total / (float)elapsed);
+        }
+
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::DeleteSocket(receiver.m_Socket));
+    }
+}
 
 int main(int argc, char **argv)
 {
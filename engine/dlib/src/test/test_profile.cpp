@@ -11,6 +11,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include <stdint.h>
+#include <string.h>
 #include <vector>
 #include <map>
 #include <string>
@@ -481,6 +482,137 @@ TEST(dmProfile, DynamicScope)
     dmProfile::Finalize();
 }
 
+TEST(dmProfile, ThreadProfileOverflow)
+{
+    dmProfile::Initialize(128, 1024, 16);
+
+    dmProfile::HProfile profile = dmProfile::Begin();
+    dmProfile::Release(profile);
+    // Each thread has its own buffer, the samples of one thread must not starve the other
+    dmThread::Thread t1 = dmThread::New(ProfileThread, 0xf0000, 0, "p1");
+    dmThread::Join(t1);
+    {
+        DM_PROFILE(Y, "main")
+    }
+
+    std::vector<dmProfile::Sample> samples;
+    profile = dmProfile::Begin();
+    dmProfile::IterateSamples(profile, &samples, false, &ProfileSampleCallback);
+    dmProfile::Release(profile);
+
+    ASSERT_TRUE(dmProfile::IsOutOfSamples());
+    ASSERT_EQ(1024U + 1U, samples.size());
+    uint32_t main_count = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        if (strcmp(samples[i].m_Name, "main") == 0)
+            ++main_count;
+    }
+    ASSERT_EQ(1U, main_count);
+
+    // The next frame starts over
+    profile = dmProfile::Begin();
+    dmProfile::Release(profile);
+    ASSERT_FALSE(dmProfile::IsOutOfSamples());
+
+    dmProfile::Finalize();
+}
+
+void ShortProfileThread(void* arg)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        DM_PROFILE(X, "a")
+    }
+}
+
+TEST(dmProfile, ExitedThreads)
+{
+    dmProfile::Initialize(128, 1024, 16);
+
+    dmProfile::HProfile profile = dmProfile::Begin();
+    dmProfile::Release(profile);
+    // The buffers of exited threads are drained and then freed
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        dmThread::Thread t1 = dmThread::New(ShortProfileThread, 0xf0000, 0, "p1");
+        dmThread::Join(t1);
+
+        std::vector<dmProfile::Sample> samples;
+        profile = dmProfile::Begin();
+        dmProfile::IterateSamples(profile, &samples, false, &ProfileSampleCallback);
+        dmProfile::Release(profile);
+        ASSERT_EQ(100U, samples.size());
+        ASSERT_FALSE(dmProfile::IsOutOfSamples());
+    }
+
+    dmProfile::Finalize();
+}
+
+TEST(dmProfile, ReinitializeMaxSamples)
+{
+    dmProfile::Initialize(128, 16, 16);
+    dmProfile::Release(dmProfile::Begin());
+    {
+        DM_PROFILE(X, "a")
+    }
+    dmProfile::Release(dmProfile::Begin());
+    dmProfile::Finalize();
+
+    // The thread buffers are reallocated for the new number of samples
+    dmProfile::Initialize(128, 1024, 16);
+    dmProfile::Release(dmProfile::Begin());
+    for (int i = 0; i < 1000; ++i)
+    {
+        DM_PROFILE(X, "a")
+    }
+    std::vector<dmProfile::Sample> samples;
+    dmProfile::HProfile profile = dmProfile::Begin();
+    dmProfile::IterateSamples(profile, &samples, false, &ProfileSampleCallback);
+    dmProfile::Release(profile);
+    ASSERT_EQ(1000U, samples.size());
+    ASSERT_FALSE(dmProfile::IsOutOfSamples());
+
+    dmProfile::Finalize();
+}
+
+static void ChromeTraceWrite(void* context, const char* data, uint32_t size)
+{
+    std::string* out = (std::string*) context;
+    out->append(data, size);
+}
+
+TEST(dmProfile, ChromeTrace)
+{
+    dmProfile::Initialize(128, 1024, 16);
+
+    dmProfile::HProfile profile = dmProfile::Begin();
+    dmProfile::Release(profile);
+    {
+        DM_PROFILE(A, "a")
+        {
+            DM_PROFILE(B, "b \"quoted\"")
+        }
+        DM_COUNTER("c1", 3);
+    }
+    dmThread::Thread t1 = dmThread::New(CounterThread, 0xf0000, 0, "c1");
+    dmThread::Join(t1);
+
+    std::string json;
+    profile = dmProfile::Begin();
+    dmProfile::WriteChromeTrace(profile, &json, ChromeTraceWrite);
+    dmProfile::Release(profile);
+
+    ASSERT_EQ(0U, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    ASSERT_NE(std::string::npos, json.find("\"ph\":\"X\""));
+    ASSERT_NE(std::string::npos, json.find("\"cat\":\"A\",\"name\":\"a\"}"));
+    ASSERT_NE(std::string::npos, json.find("\"cat\":\"B\",\"name\":\"b \\\"quoted\\\"\"}"));
+    ASSERT_NE(std::string::npos, json.find("\"args\":{\"value\":2003},\"name\":\"c1\"}"));
+    ASSERT_EQ(json.size() - 4, json.rfind("\n]}\n"));
+
+    dmProfile::Finalize();
+}
+
 #else
 #endif
 
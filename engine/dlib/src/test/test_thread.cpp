@@ -96,6 +96,40 @@ TEST(Thread, Tls)
     dmThread::FreeTls(g_TlsKey);
 }
 
+int32_atomic_t g_TlsDestructorCount = 0;
+
+static void DM_TLS_DESTRUCTOR_CALL TlsDestructor(void* value)
+{
+    assert(value == &g_TlsData[0]);
+    dmAtomicIncrement32(&g_TlsDestructorCount);
+}
+
+static void TlsDestructorThreadFunction(void* arg)
+{
+    if (arg)
+    {
+        dmThread::SetTlsValue(g_TlsKey, &g_TlsData[0]);
+    }
+}
+
+TEST(Thread, TlsDestructor)
+{
+    g_TlsKey = dmThread::AllocTls(TlsDestructor);
+
+    // Only called for threads that have set a value
+    dmThread::Thread t1 = dmThread::New(&TlsDestructorThreadFunction, 0x80000, (void*) 1, "t1");
+    dmThread::Thread t2 = dmThread::New(&TlsDestructorThreadFunction, 0x80000, (void*) 0, "t2");
+    dmThread::Thread t3 = dmThread::New(&TlsDestructorThreadFunction, 0x80000, (void*) 1, "t3");
+
+    dmThread::Join(t1);
+    dmThread::Join(t2);
+    dmThread::Join(t3);
+
+    ASSERT_EQ(2, g_TlsDestructorCount);
+
+    dmThread::FreeTls(g_TlsKey);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
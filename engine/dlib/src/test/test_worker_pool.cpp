@@ -0,0 +1,119 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdint.h>
+#include <string.h>
+#define JC_TEST_IMPLEMENTATION
+#include <jc_test/jc_test.h>
+#include "../dlib/worker_pool.h"
+#include "../dlib/atomic.h"
+
+struct RangeContext
+{
+    uint32_t*       m_Values;
+    int32_atomic_t  m_Calls;
+    uint32_t        m_MinChunkSize;
+    uint32_t        m_Count;
+    bool            m_ChunkSizeOk;
+};
+
+static void ProcessRange(void* _ctx, uint32_t start, uint32_t end)
+{
+    RangeContext* ctx = (RangeContext*) _ctx;
+    dmAtomicIncrement32(&ctx->m_Calls);
+    // Only the last chunk may be smaller than the min chunk size
+    if (end - start < ctx->m_MinChunkSize && end != ctx->m_Count)
+        ctx->m_ChunkSizeOk = false;
+    for (uint32_t i = start; i < end; ++i)
+    {
+        ctx->m_Values[i] += i;
+    }
+}
+
+static void TestParallelFor(dmWorkerPool::HWorkerPool pool, uint32_t count, uint32_t min_chunk_size)
+{
+    uint32_t* values = new uint32_t[count + 1];
+    memset(values, 0, sizeof(uint32_t) * (count + 1));
+
+    RangeContext ctx;
+    ctx.m_Values = values;
+    ctx.m_Calls = 0;
+    ctx.m_MinChunkSize = min_chunk_size;
+    ctx.m_Count = count;
+    ctx.m_ChunkSizeOk = true;
+
+    dmWorkerPool::ParallelFor(pool, ProcessRange, &ctx, count, min_chunk_size);
+
+    // Every item visited exactly once
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(i, values[i]);
+    }
+    ASSERT_EQ(0u, values[count]);
+    ASSERT_TRUE(ctx.m_ChunkSizeOk);
+    if (count == 0)
+    {
+        ASSERT_EQ(0, ctx.m_Calls);
+    }
+
+    delete[] values;
+}
+
+TEST(dmWorkerPool, NoPool)
+{
+    TestParallelFor(0, 0, 1);
+    TestParallelFor(0, 1, 1);
+    TestParallelFor(0, 1000, 16);
+}
+
+TEST(dmWorkerPool, NoWorkers)
+{
+    dmWorkerPool::HWorkerPool pool = dmWorkerPool::New(0, "test_worker");
+    ASSERT_EQ(0u, dmWorkerPool::GetWorkerCount(pool));
+    TestParallelFor(pool, 1000, 16);
+    dmWorkerPool::Delete(pool);
+}
+
+TEST(dmWorkerPool, ParallelFor)
+{
+    dmWorkerPool::HWorkerPool pool = dmWorkerPool::New(3, "test_worker");
+#if !defined(__EMSCRIPTEN__)
+    ASSERT_EQ(3u, dmWorkerPool::GetWorkerCount(pool));
+#endif
+    const uint32_t counts[] = {0, 1, 2, 3, 15, 16, 17, 1000, 65535};
+    const uint32_t chunk_sizes[] = {1, 7, 64, 100000};
+    for (uint32_t c = 0; c < sizeof(counts)/sizeof(counts[0]); ++c)
+    {
+        for (uint32_t s = 0; s < sizeof(chunk_sizes)/sizeof(chunk_sizes[0]); ++s)
+        {
+            TestParallelFor(pool, counts[c], chunk_sizes[s]);
+        }
+    }
+    dmWorkerPool::Delete(pool);
+}
+
+TEST(dmWorkerPool, ManyCalls)
+{
+    // Back to back work, to catch workers waking up late for previous work
+    dmWorkerPool::HWorkerPool pool = dmWorkerPool::New(4, "test_worker");
+    for (uint32_t i = 0; i < 2000; ++i)
+    {
+        TestParallelFor(pool, 64 + (i % 32), 1);
+    }
+    dmWorkerPool::Delete(pool);
+}
+
+int main(int argc, char **argv)
+{
+    jc_test_init(&argc, argv);
+    return jc_test_run_all();
+}
@@ -217,6 +217,7 @@ namespace dmEngine
     {
         m_EngineService = engine_service;
         m_Register = dmGameObject::NewRegister();
+        m_WorkerPool = 0;
         m_InputBuffer.SetCapacity(64);
 
         m_PhysicsContext.m_Context3D = 0x0;
@@ -269,6 +270,9 @@ namespace dmEngine
 
         dmGameObject::DeleteRegister(engine->m_Register);
 
+        if (engine->m_WorkerPool)
+            dmWorkerPool::Delete(engine->m_WorkerPool);
+
         UnloadBootstrapContent(engine);
 
         dmSound::Finalize();
@@ -757,6 +761,7 @@ namespace dmEngine
         dmResource::NewFactoryParams params;
         params.m_MaxResources = max_resources;
         params.m_Flags = 0;
+        params.m_LoadThreadCount = dmConfigFile::GetInt(engine->m_Config, "resource.load_thread_count", 2);
 
         dmResourceArchive::ClearArchiveLoaders(); // in case we've rebooted
         dmResourceArchive::RegisterDefaultArchiveLoader();
@@ -850,6 +855,13 @@ namespace dmEngine
         }
         dmGameObject::SetInputStackDefaultCapacity(engine->m_Register, dmConfigFile::GetInt(engine->m_Config, dmGameObject::COLLECTION_MAX_INPUT_STACK_ENTRIES_KEY, dmGameObject::DEFAULT_MAX_INPUT_STACK_CAPACITY));
 
+        int32_t worker_thread_count = dmConfigFile::GetInt(engine->m_Config, "engine.worker_thread_count", 0);
+        if (worker_thread_count > 0)
+        {
+            engine->m_WorkerPool = dmWorkerPool::New((uint32_t) worker_thread_count, "engine_worker");
+            dmGameObject::SetWorkerPool(engine->m_Register, engine->m_WorkerPool);
+        }
+
         dmRender::RenderContextParams render_params;
         render_params.m_MaxRenderTypes = 16;
         render_params.m_MaxInstances = (uint32_t) dmConfigFile::GetInt(engine->m_Config, "graphics.max_draw_calls", 1024);
@@ -870,6 +882,7 @@ namespace dmEngine
         engine->m_ParticleFXContext.m_RenderContext = engine->m_RenderContext;
         engine->m_ParticleFXContext.m_MaxParticleFXCount = dmConfigFile::GetInt(engine->m_Config, dmParticle::MAX_INSTANCE_COUNT_KEY, 64);
         engine->m_ParticleFXContext.m_MaxParticleCount = dmConfigFile::GetInt(engine->m_Config, dmParticle::MAX_PARTICLE_COUNT_KEY, 1024);
+        engine->m_ParticleFXContext.m_WorkerPool = engine->m_WorkerPool;
         engine->m_ParticleFXContext.m_Debug = false;
 
         dmInput::NewContextParams input_params;
@@ -907,6 +920,7 @@ namespace dmEngine
         engine->m_GuiContext.m_GuiContext = dmGui::NewContext(&gui_params);
         engine->m_GuiContext.m_RenderContext = engine->m_RenderContext;
         engine->m_GuiContext.m_ScriptContext = engine->m_GuiScriptContext;
+        engine->m_GuiContext.m_WorkerPool = engine->m_WorkerPool;
         engine->m_GuiContext.m_MaxGuiComponents = dmConfigFile::GetInt(engine->m_Config, "gui.max_count", 64);
         engine->m_GuiContext.m_MaxParticleFXCount = dmConfigFile::GetInt(engine->m_Config, "gui.max_particlefx_count", 64);
         engine->m_GuiContext.m_MaxParticleCount = dmConfigFile::GetInt(engine->m_Config, "gui.max_particle_count", 1024);
@@ -932,6 +946,18 @@ namespace dmEngine
         }
         physics_params.m_ContactImpulseLimit = dmConfigFile::GetFloat(engine->m_Config, "physics.contact_impulse_limit", 0.0f);
         physics_params.m_AllowDynamicTransforms = dmConfigFile::GetInt(engine->m_Config, "physics.allow_dynamic_transforms", 0) ? 1 : 0;
+        physics_params.m_WorkerPool = engine->m_WorkerPool;
+        int32_t physics_fixed_update_frequency = dmConfigFile::GetInt(engine->m_Config, "physics.fixed_update_frequency", 0);
+        physics_params.m_FixedTimeStep = physics_fixed_update_frequency > 0 ? 1.0f / physics_fixed_update_frequency : 0.0f;
+        int32_t physics_max_fixed_timesteps = dmConfigFile::GetInt(engine->m_Config, "physics.max_fixed_timesteps", 2);
+        if (physics_max_fixed_timesteps < 1)
+        {
+            dmLogWarning("Physics max fixed timesteps must be at least 1 and has been clamped.");
+            physics_max_fixed_timesteps = 1;
+        }
+        physics_params.m_MaxFixedTimeSteps = physics_max_fixed_timesteps;
+        physics_params.m_VelocityIterations = dmConfigFile::GetInt(engine->m_Config, "physics.velocity_iterations", 10);
+        physics_params.m_PositionIterations = dmConfigFile::GetInt(engine->m_Config, "physics.position_iterations", 10);
         if (dmStrCaseCmp(physics_type, "3D") == 0)
         {
             engine->m_PhysicsContext.m_3D = true;
@@ -969,6 +995,7 @@ namespace dmEngine
 #endif
 
         engine->m_SpriteContext.m_RenderContext = engine->m_RenderContext;
+        engine->m_SpriteContext.m_WorkerPool = engine->m_WorkerPool;
         engine->m_SpriteContext.m_MaxSpriteCount = dmConfigFile::GetInt(engine->m_Config, "sprite.max_count", 128);
         engine->m_SpriteContext.m_Subpixels = dmConfigFile::GetInt(engine->m_Config, "sprite.subpixels", 1);
 
@@ -1497,6 +1524,21 @@ bail:
 
 
                     dmMessage::Dispatch(engine->m_SystemSocket, Dispatch, engine);
+
+                    // Collect the garbage of the frame here, within the budget set in game.project
+                    if (engine->m_SharedScriptContext) {
+                        dmScript::StepGarbageCollector(engine->m_SharedScriptContext);
+                    } else {
+                        if (engine->m_GOScriptContext) {
+                            dmScript::StepGarbageCollector(engine->m_GOScriptContext);
+                        }
+                        if (engine->m_RenderScriptContext) {
+                            dmScript::StepGarbageCollector(engine->m_RenderScriptContext);
+                        }
+                        if (engine->m_GuiScriptContext) {
+                            dmScript::StepGarbageCollector(engine->m_GuiScriptContext);
+                        }
+                    }
                 }
 
                 DM_COUNTER("Lua.Refs", dmScript::GetLuaRefCount());
@@ -18,6 +18,7 @@
 #include <dlib/configfile.h>
 #include <dlib/hashtable.h>
 #include <dlib/message.h>
+#include <dlib/worker_pool.h>
 
 #include <resource/resource.h>
 
@@ -115,6 +116,7 @@ namespace dmEngine
         bool                                        m_Alive;
 
         dmGameObject::HRegister                     m_Register;
+        dmWorkerPool::HWorkerPool                   m_WorkerPool;
         dmGameObject::HCollection                   m_MainCollection;
         dmArray<dmGameObject::InputAction>          m_InputBuffer;
 
@@ -947,6 +947,30 @@ namespace dmEngineService
         r = SendString(request, "ENDD"); CHECK_RESULT(r);
     }
 
+    static void ProfileWriteTrace(void* context, const char* data, uint32_t size)
+    {
+        dmWebServer::Send((dmWebServer::Request*)context, data, size);
+    }
+
+    // The current frame in Chrome Trace Event format
+    static void HttpProfileSendTrace(void* user_ctx, dmWebServer::Request* request)
+    {
+        HEngineService engine_service = (HEngineService)user_ctx;
+        if (!engine_service->m_Profile)
+        {
+            dmWebServer::SetStatusCode(request, 500);
+            const char* msg = "Error. The profiler was not active!";
+            dmWebServer::Send(request, msg, strlen(msg));
+            return;
+        }
+
+        dmWebServer::SendAttribute(request, "Content-Type", "application/json");
+        dmWebServer::SendAttribute(request, "Access-Control-Allow-Origin", "*");
+        dmWebServer::SendAttribute(request, "Cache-Control", "no-store");
+
+        dmProfile::WriteChromeTrace(engine_service->m_Profile, request, ProfileWriteTrace);
+    }
+
 
 #undef CHECK_RESULT_BOOL
 
@@ -984,6 +1008,11 @@ namespace dmEngineService
         frame_params.m_Userdata = engine_service;
         dmWebServer::AddHandler(engine_service->m_WebServer, "/profile_frame", &frame_params);
 
+        dmWebServer::HandlerParams trace_params;
+        trace_params.m_Handler = HttpProfileSendTrace;
+        trace_params.m_Userdata = engine_service;
+        dmWebServer::AddHandler(engine_service->m_WebServer, "/profile_trace", &trace_params);
+
         dmWebServer::HandlerParams scenegraph_params;
         scenegraph_params.m_Handler = HttpSceneGraphRequestCallback;
         scenegraph_params.m_Userdata = regist;
@@ -0,0 +1,264 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Headless frame time benchmark
+//
+// Boots the engine with the null graphics, sound and hid backends, steps a collection
+// a fixed number of frames and writes the time spent per profiler scope and sample as JSON.
+// Vsync is forced on, which makes the engine step with a fixed dt without ever blocking
+// on the null backend.
+//
+// Usage:
+//   bench_engine [--frames=N] [--warmup=N] [--output=FILE] [--collection=/main/main.collectionc] [engine args] game.projectc
+//
+// Example, from engine/engine:
+//   ./build/default/src/test/bench_engine --frames=600 --collection=/sprite/sprite.collectionc --config=dmengine.unload_builtins=0 src/test/build/default/game.projectc
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <dlib/dstrings.h>
+#include <dlib/log.h>
+#include <dlib/profile.h>
+#include <dlib/time.h>
+#include "../engine.h"
+#include "../engine_private.h"
+
+struct BenchStats
+{
+    BenchStats() : m_Total(0), m_Max(0), m_Count(0) {}
+    double   m_Total;   // ms, summed over all measured frames
+    double   m_Max;     // ms, the most expensive frame
+    uint64_t m_Count;   // occurrences, summed over all measured frames
+};
+
+typedef std::map<std::string, BenchStats> BenchStatsMap;
+
+struct BenchContext
+{
+    BenchContext()
+    : m_Frames(600)
+    , m_Warmup(60)
+    , m_Frame(0)
+    , m_Output(0)
+    {}
+
+    uint32_t            m_Frames;
+    uint32_t            m_Warmup;
+    uint32_t            m_Frame;
+    const char*         m_Output;
+    std::string         m_Collection;
+    std::vector<double> m_FrameTimes;
+    BenchStatsMap       m_Scopes;
+    BenchStatsMap       m_Samples;
+    // Per frame scratch
+    BenchStatsMap       m_FrameSamples;
+};
+
+static BenchContext g_Bench;
+
+static void AddStats(BenchStatsMap& map, const std::string& key, double ms, uint32_t count)
+{
+    BenchStats& stats = map[key];
+    stats.m_Total += ms;
+    stats.m_Max = std::max(stats.m_Max, ms);
+    stats.m_Count += count;
+}
+
+static void BenchScopeCallback(void* context, const dmProfile::ScopeData* scope_data)
+{
+    if (scope_data->m_Count == 0)
+        return;
+    double ms = scope_data->m_Elapsed * 1000.0 / dmProfile::GetTicksPerSecond();
+    AddStats(g_Bench.m_Scopes, scope_data->m_Scope->m_Name, ms, scope_data->m_Count);
+}
+
+static void BenchSampleCallback(void* context, const dmProfile::Sample* sample)
+{
+    std::string key = std::string(sample->m_Scope->m_Name) + "." + sample->m_Name;
+    BenchStats& stats = g_Bench.m_FrameSamples[key];
+    stats.m_Total += sample->m_Elapsed * 1000.0 / dmProfile::GetTicksPerSecond();
+    stats.m_Count++;
+}
+
+static void BenchEngineInitialize(void* ctx)
+{
+    dmEngineInitialize();
+}
+
+static void BenchEngineFinalize(void* ctx)
+{
+    dmEngineFinalize();
+}
+
+static dmEngine::HEngine BenchEngineCreate(int argc, char** argv)
+{
+    return dmEngineCreate(argc, argv);
+}
+
+static void BenchEngineDestroy(dmEngine::HEngine engine)
+{
+    dmEngineDestroy(engine);
+}
+
+static dmEngine::UpdateResult BenchEngineUpdate(dmEngine::HEngine engine)
+{
+    uint64_t start = dmTime::GetTime();
+    dmEngine::UpdateResult result = dmEngineUpdate(engine);
+    uint64_t end = dmTime::GetTime();
+
+    // The engine begins a new profile at the start of each step. Begin one here as well,
+    // so that the returned profile holds exactly the frame that was just stepped.
+    dmProfile::HProfile profile = dmProfile::Begin();
+    if (g_Bench.m_Frame >= g_Bench.m_Warmup)
+    {
+        g_Bench.m_FrameTimes.push_back((end - start) / 1000.0);
+        dmProfile::IterateScopeData(profile, 0, false, BenchScopeCallback);
+
+        g_Bench.m_FrameSamples.clear();
+        dmProfile::IterateSamples(profile, 0, false, BenchSampleCallback);
+        for (BenchStatsMap::iterator it = g_Bench.m_FrameSamples.begin(); it != g_Bench.m_FrameSamples.end(); ++it)
+        {
+            AddStats(g_Bench.m_Samples, it->first, it->second.m_Total, (uint32_t) it->second.m_Count);
+        }
+    }
+    dmProfile::Release(profile);
+
+    ++g_Bench.m_Frame;
+    if (result == dmEngine::RESULT_OK && g_Bench.m_Frame >= g_Bench.m_Warmup + g_Bench.m_Frames)
+    {
+        return dmEngine::RESULT_EXIT;
+    }
+    return result;
+}
+
+static void BenchEngineGetResult(dmEngine::HEngine engine, int* run_action, int* exit_code, int* argc, char*** argv)
+{
+    dmEngineGetResult(engine, run_action, exit_code, argc, argv);
+}
+
+static void WriteStats(FILE* f, const char* name, const BenchStatsMap& map, uint32_t frame_count)
+{
+    fprintf(f, "  \"%s\": {\n", name);
+    for (BenchStatsMap::const_iterator it = map.begin(); it != map.end(); ++it)
+    {
+        const BenchStats& stats = it->second;
+        fprintf(f, "    \"%s\": {\"mean_ms\": %.4f, \"max_ms\": %.4f, \"count_per_frame\": %.2f}%s\n",
+                it->first.c_str(), stats.m_Total / frame_count, stats.m_Max, (double) stats.m_Count / frame_count,
+                std::distance(it, map.end()) > 1 ? "," : "");
+    }
+    fprintf(f, "  }");
+}
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+static void WriteReport(FILE* f)
+{
+    std::vector<double> sorted = g_Bench.m_FrameTimes;
+    std::sort(sorted.begin(), sorted.end());
+    uint32_t frame_count = (uint32_t) sorted.size();
+    double total = 0;
+    for (uint32_t i = 0; i < frame_count; ++i)
+    {
+        total += sorted[i];
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"collection\": \"%s\",\n", g_Bench.m_Collection.c_str());
+    fprintf(f, "  \"frames\": %u,\n", frame_count);
+    fprintf(f, "  \"warmup_frames\": %u,\n", g_Bench.m_Warmup);
+    fprintf(f, "  \"frame_ms\": {\"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"max\": %.4f},\n",
+            total / frame_count, sorted[0], Percentile(sorted, 0.5), Percentile(sorted, 0.95), sorted[frame_count - 1]);
+    WriteStats(f, "scopes", g_Bench.m_Scopes, frame_count);
+    fprintf(f, ",\n");
+    WriteStats(f, "samples", g_Bench.m_Samples, frame_count);
+    fprintf(f, "\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<char*> engine_argv;
+    std::vector<std::string> owned_args;
+    owned_args.reserve(argc + 2);
+
+    engine_argv.push_back(argv[0]);
+    owned_args.push_back("--config=display.vsync=1");
+    engine_argv.push_back((char*) owned_args.back().c_str());
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        if (strncmp(arg, "--frames=", 9) == 0)
+            g_Bench.m_Frames = (uint32_t) strtoul(arg + 9, 0, 10);
+        else if (strncmp(arg, "--warmup=", 9) == 0)
+            g_Bench.m_Warmup = (uint32_t) strtoul(arg + 9, 0, 10);
+        else if (strncmp(arg, "--output=", 9) == 0)
+            g_Bench.m_Output = arg + 9;
+        else if (strncmp(arg, "--collection=", 13) == 0)
+        {
+            g_Bench.m_Collection = arg + 13;
+            owned_args.push_back(std::string("--config=bootstrap.main_collection=") + g_Bench.m_Collection);
+            engine_argv.push_back((char*) owned_args.back().c_str());
+        }
+        else
+            engine_argv.push_back(argv[i]);
+    }
+
+    if (g_Bench.m_Frames == 0)
+    {
+        fprintf(stderr, "bench_engine: --frames must be at least 1\n");
+        return 1;
+    }
+
+    dmEngine::RunLoopParams params;
+    params.m_Argc = (int) engine_argv.size();
+    params.m_Argv = &engine_argv[0];
+    params.m_AppCtx = 0;
+    params.m_AppCreate = BenchEngineInitialize;
+    params.m_AppDestroy = BenchEngineFinalize;
+    params.m_EngineCreate = (dmEngine::EngineCreate)BenchEngineCreate;
+    params.m_EngineDestroy = (dmEngine::EngineDestroy)BenchEngineDestroy;
+    params.m_EngineUpdate = (dmEngine::EngineUpdate)BenchEngineUpdate;
+    params.m_EngineGetResult = (dmEngine::EngineGetResult)BenchEngineGetResult;
+    int exit_code = dmEngine::RunLoop(&params);
+
+    if (g_Bench.m_FrameTimes.size() < g_Bench.m_Frames)
+    {
+        fprintf(stderr, "bench_engine: the engine exited after %u of %u frames (exit code %d)\n",
+                (uint32_t) g_Bench.m_FrameTimes.size(), g_Bench.m_Frames, exit_code);
+        return exit_code != 0 ? exit_code : 1;
+    }
+
+    FILE* f = stdout;
+    if (g_Bench.m_Output)
+    {
+        f = fopen(g_Bench.m_Output, "wb");
+        if (!f)
+        {
+            fprintf(stderr, "bench_engine: could not open '%s' for writing\n", g_Bench.m_Output);
+            return 1;
+        }
+    }
+    WriteReport(f);
+    if (f != stdout)
+        fclose(f);
+    return exit_code;
+}
@@ -13,12 +13,14 @@
 #include <new>
 #include <algorithm>
 #include <stdio.h>
+#include <dlib/align.h>
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
 #include <dlib/hashtable.h>
 #include <dlib/message.h>
 #include <dlib/hash.h>
 #include <dlib/array.h>
+#include <dlib/atomic.h>
 #include <dlib/index_pool.h>
 #include <dlib/profile.h>
 #include <dlib/math.h>
@@ -164,6 +166,7 @@ namespace dmGameObject
         m_DefaultInputStackCapacity = DEFAULT_MAX_INPUT_STACK_CAPACITY;
         m_Mutex = dmMutex::New();
         m_SocketToCollection.SetCapacity(15, 17);
+        m_WorkerPool = 0;
     }
 
     Register::~Register()
@@ -196,6 +199,11 @@ namespace dmGameObject
         m_InstanceIndices.SetCapacity(max_instances);
         m_WorldTransforms.SetCapacity(max_instances);
         m_WorldTransforms.SetSize(max_instances);
+        m_PrevTransforms.SetCapacity(max_instances);
+        m_PrevTransforms.SetSize(max_instances);
+        m_TransformFlags.SetCapacity(max_instances);
+        m_TransformFlags.SetSize(max_instances);
+        m_UpdatedTransformCount = 0;
         m_IDToInstance.SetCapacity(dmMath::Max(1U, max_instances/3), max_instances);
         m_InputFocusStack.SetCapacity(max_input_stack_entries);
         m_NameHash = 0;
@@ -221,6 +229,7 @@ namespace dmGameObject
 
         memset(&m_Instances[0], 0, sizeof(Instance*) * max_instances);
         memset(&m_WorldTransforms[0], 0xcc, sizeof(dmTransform::Transform) * max_instances);
+        memset(&m_TransformFlags[0], 0, sizeof(uint8_t) * max_instances);
         memset(&m_LevelIndices[0], 0, sizeof(m_LevelIndices));
         memset(&m_ComponentInstanceCount[0], 0, sizeof(uint32_t) * MAX_COMPONENT_TYPES);
     }
@@ -246,6 +255,12 @@ namespace dmGameObject
         regist->m_DefaultInputStackCapacity = capacity;
     }
 
+    void SetWorkerPool(HRegister regist, dmWorkerPool::HWorkerPool pool)
+    {
+        assert(regist != 0x0);
+        regist->m_WorkerPool = pool;
+    }
+
     static uint32_t GetInputStackDefaultCapacity(HRegister regist)
     {
         assert(regist != 0x0);
@@ -320,7 +335,8 @@ namespace dmGameObject
         dmMessage::HSocket* sockets[] = {&collection->m_ComponentSocket, &collection->m_FrameSocket};
         for (int i = 0; i < 2; ++i)
         {
-            dmMessage::Result result = dmMessage::NewSocket(socket_names[i], sockets[i]);
+            // Collection sockets are only dispatched from the main thread
+            dmMessage::Result result = dmMessage::NewSocket(socket_names[i], sockets[i], dmMessage::SOCKET_FLAG_SINGLE_CONSUMER);
             if (result != dmMessage::RESULT_OK)
             {
                 if (result == dmMessage::RESULT_SOCKET_EXISTS)
@@ -624,6 +640,9 @@ namespace dmGameObject
         level.SetSize(level_index + 1);
         level[level_index] = instance->m_Index;
         instance->m_LevelIndex = level_index;
+
+        // The parent (or depth) changed, so the world transform can't be reused
+        collection->m_TransformFlags[instance->m_Index] |= TRANSFORM_FLAG_FORCE_UPDATE;
     }
 
     static HInstance AllocInstance(Prototype* proto, const char* prototype_name) {
@@ -2070,6 +2089,34 @@ namespace dmGameObject
         bool m_Success;
     };
 
+    static void FlushMessageBatches(DispatchMessagesContext* context);
+
+    // Copy the message, which is only valid during the dispatch, and defer it to FlushMessageBatches
+    static void AddToMessageBatch(Collection* collection, Instance* instance, uintptr_t* component_instance_data, uint32_t type_index, const dmMessage::Message* message)
+    {
+        uint32_t size = DM_ALIGN(sizeof(dmMessage::Message) + message->m_DataSize, 16);
+        dmArray<uint8_t>& data = collection->m_MessageBatchData;
+        uint32_t offset = data.Size();
+        if (data.Remaining() < size)
+        {
+            data.OffsetCapacity(dmMath::Max(size, data.Capacity()));
+        }
+        data.SetSize(offset + size);
+        memcpy(data.Begin() + offset, message, sizeof(dmMessage::Message) + message->m_DataSize);
+
+        dmArray<MessageBatchEntry>& entries = collection->m_MessageBatchEntries;
+        if (entries.Full())
+        {
+            entries.OffsetCapacity(dmMath::Max(64U, entries.Capacity()));
+        }
+        MessageBatchEntry entry;
+        entry.m_Instance = instance;
+        entry.m_UserData = component_instance_data;
+        entry.m_Offset = offset;
+        entry.m_TypeIndex = type_index;
+        entries.Push(entry);
+    }
+
     void DispatchMessagesFunction(dmMessage::Message* message, void* user_ptr)
     {
         DispatchMessagesContext* context = (DispatchMessagesContext*) user_ptr;
@@ -2110,6 +2157,14 @@ namespace dmGameObject
         if (message->m_Descriptor != 0)
         {
             dmDDF::Descriptor* descriptor = (dmDDF::Descriptor*)message->m_Descriptor;
+            if (descriptor == dmGameObjectDDF::AcquireInputFocus::m_DDFDescriptor
+                    || descriptor == dmGameObjectDDF::ReleaseInputFocus::m_DDFDescriptor
+                    || descriptor == dmGameObjectDDF::RequestTransform::m_DDFDescriptor
+                    || descriptor == dmGameObjectDDF::SetParent::m_DDFDescriptor)
+            {
+                // Handled immediately by the instance, deliver the messages posted before it first
+                FlushMessageBatches(context);
+            }
             if (descriptor == dmGameObjectDDF::AcquireInputFocus::m_DDFDescriptor)
             {
                 dmGameObject::AcquireInputFocus(collection, instance);
@@ -2222,7 +2277,13 @@ namespace dmGameObject
             ComponentType* component_type = component->m_Type;
             assert(component_type);
 
-            if (component_type->m_OnMessageFunction)
+            if (component_type->m_OnMessageBatchFunction == 0 || message->m_DestroyCallback)
+            {
+                // Delivered immediately, deliver the messages posted before it first to keep the posting order
+                FlushMessageBatches(context);
+            }
+
+            if (component_type->m_OnMessageFunction || component_type->m_OnMessageBatchFunction)
             {
                 // TODO: Not optimal way to find index of component instance data
                 uint32_t next_component_instance_data = 0;
@@ -2241,6 +2302,11 @@ namespace dmGameObject
                 {
                     component_instance_data = &instance->m_ComponentInstanceUserData[next_component_instance_data];
                 }
+                if (component_type->m_OnMessageBatchFunction && message->m_DestroyCallback == 0)
+                {
+                    AddToMessageBatch(collection, instance, component_instance_data, component->m_TypeIndex, message);
+                }
+                else if (component_type->m_OnMessageFunction)
                 {
                     DM_PROFILE(GameObject, "OnMessageFunction");
                     ComponentOnMessageParams params;
@@ -2262,6 +2328,9 @@ namespace dmGameObject
         }
         else // broadcast
         {
+            // Components with batched messages must see them before the broadcast
+            FlushMessageBatches(context);
+
             uint32_t next_component_instance_data = 0;
             for (uint32_t i = 0; i < prototype->m_ComponentCount; ++i)
             {
@@ -2300,6 +2369,80 @@ namespace dmGameObject
         }
     }
 
+    // Deliver the messages collected by AddToMessageBatch, one ComponentsOnMessageBatch call per component type.
+    // The messages are grouped by type with a stable counting sort, so the posting order is kept within each type.
+    static void FlushMessageBatches(DispatchMessagesContext* context)
+    {
+        Collection* collection = context->m_Collection;
+        dmArray<MessageBatchEntry>& entries = collection->m_MessageBatchEntries;
+        uint32_t entry_count = entries.Size();
+        if (entry_count == 0)
+        {
+            return;
+        }
+
+        DM_PROFILE(GameObject, "OnMessageBatchFunction");
+
+        uint32_t type_offsets[MAX_COMPONENT_TYPES + 1];
+        memset(type_offsets, 0, sizeof(type_offsets));
+        for (uint32_t i = 0; i < entry_count; ++i)
+        {
+            type_offsets[entries[i].m_TypeIndex + 1]++;
+        }
+        for (uint32_t i = 0; i < MAX_COMPONENT_TYPES; ++i)
+        {
+            type_offsets[i + 1] += type_offsets[i];
+        }
+
+        dmArray<ComponentOnMessageParams>& params = collection->m_MessageBatchParams;
+        if (params.Capacity() < entry_count)
+        {
+            params.SetCapacity(entry_count);
+        }
+        params.SetSize(entry_count);
+
+        uint32_t type_ends[MAX_COMPONENT_TYPES];
+        memcpy(type_ends, type_offsets, sizeof(type_ends));
+        uint8_t* data = collection->m_MessageBatchData.Begin();
+        for (uint32_t i = 0; i < entry_count; ++i)
+        {
+            const MessageBatchEntry& entry = entries[i];
+            ComponentOnMessageParams& p = params[type_ends[entry.m_TypeIndex]++];
+            p.m_Instance = entry.m_Instance;
+            p.m_World = collection->m_ComponentWorlds[entry.m_TypeIndex];
+            p.m_Context = collection->m_Register->m_ComponentTypes[entry.m_TypeIndex].m_Context;
+            p.m_UserData = entry.m_UserData;
+            p.m_Message = (dmMessage::Message*) (data + entry.m_Offset);
+        }
+
+        // The batch functions may post new messages, but those end up in the sockets and not here
+        uint32_t type_count = collection->m_Register->m_ComponentTypeCount;
+        for (uint32_t i = 0; i < type_count; ++i)
+        {
+            uint16_t type_index = collection->m_Register->m_ComponentTypesOrder[i];
+            uint32_t start = type_offsets[type_index];
+            uint32_t end = type_offsets[type_index + 1];
+            if (start == end)
+            {
+                continue;
+            }
+            ComponentType* component_type = &collection->m_Register->m_ComponentTypes[type_index];
+            ComponentsOnMessageBatchParams batch_params;
+            batch_params.m_Collection = collection->m_HCollection;
+            batch_params.m_World = collection->m_ComponentWorlds[type_index];
+            batch_params.m_Context = component_type->m_Context;
+            batch_params.m_Messages = &params[start];
+            batch_params.m_MessageCount = end - start;
+            UpdateResult res = component_type->m_OnMessageBatchFunction(batch_params);
+            if (res != UPDATE_RESULT_OK)
+                context->m_Success = false;
+        }
+
+        entries.SetSize(0);
+        params.SetSize(0);
+        collection->m_MessageBatchData.SetSize(0);
+    }
+
     static bool DispatchMessages(Collection* collection, dmMessage::HSocket* sockets, uint32_t socket_count)
     {
         DM_PROFILE(GameObject, "DispatchMessages");
@@ -2324,6 +2467,7 @@ namespace dmGameObject
                     UpdateTransforms(collection);
                 }
                 uint32_t message_count = dmMessage::Dispatch(sockets[i], &DispatchMessagesFunction, (void*) &ctx);
+                FlushMessageBatches(&ctx);
                 if (message_count)
                 {
                     collection->m_DirtyTransforms = true;
@@ -2353,67 +2497,132 @@ namespace dmGameObject
         }
     }
 
-    void UpdateTransforms(Collection* collection)
+    static inline bool TransformEquals(const dmTransform::Transform& a, const dmTransform::Transform& b)
     {
-        DM_PROFILE(GameObject, "UpdateTransforms");
+        const uint32_t* ra = (const uint32_t*) a.GetRotationPtr();
+        const uint32_t* rb = (const uint32_t*) b.GetRotationPtr();
+        return ra[0] == rb[0] && ra[1] == rb[1] && ra[2] == rb[2] && ra[3] == rb[3] &&
+               Vec3Equals((const uint32_t*) a.GetPositionPtr(), (const uint32_t*) b.GetPositionPtr()) &&
+               Vec3Equals((const uint32_t*) a.GetScalePtr(), (const uint32_t*) b.GetScalePtr());
+    }
 
-        // Calculate world transforms
-        // First root-level instances
-        dmArray<uint16_t>& root_level = collection->m_LevelIndices[0];
-        uint32_t root_count = root_level.Size();
-        for (uint32_t i = 0; i < root_count; ++i)
+    // Smallest number of instances in a level handed to a worker in one go
+    static const uint32_t TRANSFORM_PARALLEL_MIN_CHUNK = 512;
+
+    struct UpdateTransformsContext
+    {
+        Collection*     m_Collection;
+        const uint16_t* m_Level;
+        int32_atomic_t  m_UpdatedCount;
+    };
+
+    // Returns true if the world transform of the instance needs to be recalculated,
+    // i.e. if it moved in the hierarchy, its local transform changed or its parent was recalculated
+    static inline bool CheckTransformDirty(Collection* collection, Instance* instance, uint16_t index, uint16_t parent_index)
+    {
+        CheckEuler(instance);
+        uint8_t* flags = collection->m_TransformFlags.Begin();
+        dmTransform::Transform& prev = collection->m_PrevTransforms[index];
+        bool dirty = (flags[index] & TRANSFORM_FLAG_FORCE_UPDATE) ||
+                     (parent_index != INVALID_INSTANCE_INDEX && (flags[parent_index] & TRANSFORM_FLAG_UPDATED)) ||
+                     !TransformEquals(prev, instance->m_Transform);
+        if (dirty)
         {
-            uint16_t index = root_level[i];
-            Instance* instance = collection->m_Instances[index];
-            CheckEuler(instance);
-            collection->m_WorldTransforms[index] = dmTransform::ToMatrix4(instance->m_Transform);
-            uint16_t parent_index = instance->m_Parent;
-            assert(parent_index == INVALID_INSTANCE_INDEX);
+            prev = instance->m_Transform;
+            flags[index] = TRANSFORM_FLAG_UPDATED;
+        }
+        else
+        {
+            flags[index] = 0;
         }
+        return dirty;
+    }
 
+    static void UpdateRootTransforms(void* _ctx, uint32_t start, uint32_t end)
+    {
+        UpdateTransformsContext* ctx = (UpdateTransformsContext*) _ctx;
+        Collection* collection = ctx->m_Collection;
+        Instance** instances = collection->m_Instances.Begin();
+        Matrix4* world_transforms = collection->m_WorldTransforms.Begin();
+        const uint16_t* level = ctx->m_Level;
+        int32_t updated_count = 0;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            uint16_t index = level[i];
+            Instance* instance = instances[index];
+            assert(instance->m_Parent == INVALID_INSTANCE_INDEX);
+            if (!CheckTransformDirty(collection, instance, index, INVALID_INSTANCE_INDEX))
+                continue;
+            world_transforms[index] = dmTransform::ToMatrix4(instance->m_Transform);
+            ++updated_count;
+        }
+        dmAtomicAdd32(&ctx->m_UpdatedCount, updated_count);
+    }
 
-        if (collection->m_ScaleAlongZ) {
-            for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
-            {
-                dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
-                uint32_t instance_count = level.Size();
-                for (uint32_t i = 0; i < instance_count; ++i)
-                {
-                    uint16_t index = level[i];
-                    Instance* instance = collection->m_Instances[index];
-                    CheckEuler(instance);
-                    Matrix4* trans = &collection->m_WorldTransforms[index];
+    template <bool SCALE_ALONG_Z>
+    static void UpdateChildTransforms(void* _ctx, uint32_t start, uint32_t end)
+    {
+        UpdateTransformsContext* ctx = (UpdateTransformsContext*) _ctx;
+        Collection* collection = ctx->m_Collection;
+        Instance** instances = collection->m_Instances.Begin();
+        Matrix4* world_transforms = collection->m_WorldTransforms.Begin();
+        const uint16_t* level = ctx->m_Level;
+        int32_t updated_count = 0;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            uint16_t index = level[i];
+            Instance* instance = instances[index];
 
-                    uint16_t parent_index = instance->m_Parent;
-                    assert(parent_index != INVALID_INSTANCE_INDEX);
+            uint16_t parent_index = instance->m_Parent;
+            assert(parent_index != INVALID_INSTANCE_INDEX);
 
-                    Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
-                    Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
-                    *trans = *parent_trans * own;
-                }
-            }
-        } else {
-            for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
-            {
-                dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
-                uint32_t instance_count = level.Size();
-                for (uint32_t i = 0; i < instance_count; ++i)
-                {
-                    uint16_t index = level[i];
-                    Instance* instance = collection->m_Instances[index];
-                    CheckEuler(instance);
-                    Matrix4* trans = &collection->m_WorldTransforms[index];
+            if (!CheckTransformDirty(collection, instance, index, parent_index))
+                continue;
 
-                    uint16_t parent_index = instance->m_Parent;
-                    assert(parent_index != INVALID_INSTANCE_INDEX);
+            const Matrix4& parent_trans = world_transforms[parent_index];
+            Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
+            if (SCALE_ALONG_Z)
+                world_transforms[index] = parent_trans * own;
+            else
+                world_transforms[index] = dmTransform::MulNoScaleZ(parent_trans, own);
+            ++updated_count;
+        }
+        dmAtomicAdd32(&ctx->m_UpdatedCount, updated_count);
+    }
 
-                    Matrix4* parent_trans = &collection->m_WorldTransforms[parent_index];
-                    Matrix4 own = dmTransform::ToMatrix4(instance->m_Transform);
-                    *trans = dmTransform::MulNoScaleZ(*parent_trans, own);
-                }
-            }
+    void UpdateTransforms(Collection* collection)
+    {
+        DM_PROFILE(GameObject, "UpdateTransforms");
+
+        // Instances within a level only depend on the level above, so each level
+        // can be split across the worker pool. Levels are processed in order.
+        // Only instances whose local transform changed, or whose parent was
+        // recalculated, get a new world transform.
+        dmWorkerPool::HWorkerPool pool = collection->m_Register->m_WorkerPool;
+        UpdateTransformsContext ctx;
+        ctx.m_Collection = collection;
+        ctx.m_UpdatedCount = 0;
+
+        // First root-level instances
+        dmArray<uint16_t>& root_level = collection->m_LevelIndices[0];
+        ctx.m_Level = root_level.Begin();
+        dmWorkerPool::ParallelFor(pool, UpdateRootTransforms, &ctx, root_level.Size(), TRANSFORM_PARALLEL_MIN_CHUNK);
+
+        dmWorkerPool::RangeFunction update_children = collection->m_ScaleAlongZ ? UpdateChildTransforms<true> : UpdateChildTransforms<false>;
+        for (uint32_t level_i = 1; level_i < MAX_HIERARCHICAL_DEPTH; ++level_i)
+        {
+            dmArray<uint16_t>& level = collection->m_LevelIndices[level_i];
+            uint32_t instance_count = level.Size();
+            // A level can only be populated if the level above it is
+            if (instance_count == 0)
+                break;
+            ctx.m_Level = level.Begin();
+            dmWorkerPool::ParallelFor(pool, update_children, &ctx, instance_count, TRANSFORM_PARALLEL_MIN_CHUNK);
         }
 
+        collection->m_UpdatedTransformCount = (uint32_t) ctx.m_UpdatedCount;
+        DM_COUNTER("TransformsUpdated", collection->m_UpdatedTransformCount);
+
         collection->m_DirtyTransforms = false;
     }
 
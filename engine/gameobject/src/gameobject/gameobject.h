@@ -21,6 +21,7 @@
 #include <dlib/hashtable.h>
 #include <dlib/message.h>
 #include <dlib/transform.h>
+#include <dlib/worker_pool.h>
 
 #include <ddf/ddf.h>
 
@@ -430,6 +431,35 @@ namespace dmGameObject
      */
     typedef UpdateResult (*ComponentOnMessage)(const ComponentOnMessageParams& params);
 
+    /**
+     * Parameters to ComponentsOnMessageBatch callback.
+     */
+    struct ComponentsOnMessageBatchParams
+    {
+        /// Collection handle
+        HCollection m_Collection;
+        /// Component world
+        void* m_World;
+        /// User context
+        void* m_Context;
+        /// Messages to components of this type, in the order they were posted
+        const ComponentOnMessageParams* m_Messages;
+        /// Number of messages
+        uint32_t m_MessageCount;
+    };
+
+    /**
+     * Component on-message batch function. Optional. If set, messages sent to a single
+     * component of this type are collected while a socket is dispatched, and are passed
+     * here in one call per world. Consecutive messages to batched component types are
+     * collected, and are delivered before any message that is handled immediately, so the
+     * posting order is kept. Broadcast messages, and messages with a destroy callback, are
+     * still sent to the ComponentOnMessage function.
+     * @param params Input parameters
+     * @return UPDATE_RESULT_OK on success
+     */
+    typedef UpdateResult (*ComponentsOnMessageBatch)(const ComponentsOnMessageBatchParams& params);
+
     /**
      * Parameters to ComponentOnInput callback.
      */
@@ -562,6 +592,7 @@ namespace dmGameObject
         ComponentsRender        m_RenderFunction;
         ComponentsPostUpdate    m_PostUpdateFunction;
         ComponentOnMessage      m_OnMessageFunction;
+        ComponentsOnMessageBatch m_OnMessageBatchFunction;
         ComponentOnInput        m_OnInputFunction;
         ComponentOnReload       m_OnReloadFunction;
         ComponentSetProperties  m_SetPropertiesFunction;
@@ -610,6 +641,14 @@ namespace dmGameObject
      */
     void SetInputStackDefaultCapacity(HRegister regist, uint32_t capacity);
 
+    /**
+     * Set worker pool used to parallelize per-collection work, such as transform updates.
+     * The pool is not owned by the register and must outlive it. Pass 0x0 to run serially.
+     * @param regist Register
+     * @param pool Worker pool, or 0x0
+     */
+    void SetWorkerPool(HRegister regist, dmWorkerPool::HWorkerPool pool);
+
     /**
      * Delete a component type register
      * @param regist Register to delete
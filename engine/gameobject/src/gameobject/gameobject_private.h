@@ -214,14 +214,37 @@ namespace dmGameObject
 
         dmHashTable64<Collection*>  m_SocketToCollection;
 
+        // Optional worker pool, not owned by the register
+        dmWorkerPool::HWorkerPool   m_WorkerPool;
+
         Register();
         ~Register();
     };
 
+    // Message deferred to a component type with a ComponentsOnMessageBatch function
+    struct MessageBatchEntry
+    {
+        Instance*  m_Instance;
+        uintptr_t* m_UserData;
+        // Offset of the message copy in Collection::m_MessageBatchData
+        uint32_t   m_Offset;
+        uint32_t   m_TypeIndex;
+    };
+
     // Max hierarchical depth
     // depth is interpreted as up to <depth> levels of child nodes including root-nodes
     // Must be greater than zero
     const uint32_t MAX_HIERARCHICAL_DEPTH = 128;
+
+    // Per instance flags in Collection::m_TransformFlags
+    enum TransformFlag
+    {
+        // World transform must be recalculated, e.g. after the instance moved in the hierarchy
+        TRANSFORM_FLAG_FORCE_UPDATE = 1,
+        // World transform was recalculated in the last UpdateTransforms
+        TRANSFORM_FLAG_UPDATED      = 2,
+    };
+
     struct Collection
     {
         Collection(dmResource::HFactory factory, HRegister regist, uint32_t max_instances, uint32_t max_input_stack_entries);
@@ -263,10 +286,22 @@ namespace dmGameObject
 
         // Array of world transforms. Calculated using m_LevelIndices above
         dmArray<Matrix4>         m_WorldTransforms;
+        // Local transforms the world transforms were last calculated from.
+        // Used to only recalculate the world transforms of instances that moved
+        dmArray<dmTransform::Transform> m_PrevTransforms;
+        // Array of TransformFlag per instance
+        dmArray<uint8_t>         m_TransformFlags;
+        // Number of world transforms recalculated by the last UpdateTransforms
+        uint32_t                 m_UpdatedTransformCount;
 
         // Identifier to Instance mapping
         dmHashTable64<Instance*> m_IDToInstance;
 
+        // Messages collected for batched dispatch, see DispatchMessages
+        dmArray<uint8_t>                  m_MessageBatchData;
+        dmArray<MessageBatchEntry>        m_MessageBatchEntries;
+        dmArray<ComponentOnMessageParams> m_MessageBatchParams;
+
         // Stack keeping track of which instance has the input focus
         dmArray<Instance*>       m_InputFocusStack;
 
@@ -398,6 +398,36 @@ namespace dmGameObject
         return instance;
     }
 
+    // Like ResolveInstance(L, 1), but also accepts an existing vector3 as second argument that the result is written to
+    static Instance* ResolveInstanceOutVector3(lua_State* L, Vectormath::Aos::Vector3** out)
+    {
+        *out = 0;
+        if (lua_isnoneornil(L, 2))
+        {
+            lua_settop(L, 1);
+            return ResolveInstance(L, 1);
+        }
+
+        lua_settop(L, 2);
+        *out = dmScript::CheckVector3(L, 2);
+        // ResolveInstance expects the id to be the last argument
+        lua_insert(L, 1);
+        return ResolveInstance(L, 2);
+    }
+
+    static void PushOutVector3(lua_State* L, Vectormath::Aos::Vector3* out, const Vectormath::Aos::Vector3& v)
+    {
+        if (out)
+        {
+            *out = v;
+            lua_pushvalue(L, 1);
+        }
+        else
+        {
+            dmScript::PushVector3(L, v);
+        }
+    }
+
     static Result GetComponentUserData(HInstance instance, dmhash_t component_id, uint32_t* component_type, uintptr_t* user_data)
     {
         // TODO: We should probably not store user-data sparse.
@@ -724,6 +754,7 @@ namespace dmGameObject
      * @name go.get_position
      * @replaces request_transform transform_response
      * @param [id] [type:string|hash|url] optional id of the game object instance to get the position for, by default the instance of the calling script
+     * @param [out] [type:vector3] optional vector to store the position in, instead of creating a new one
      * @return position [type:vector3] instance position
      * @examples
      *
@@ -738,11 +769,24 @@ namespace dmGameObject
      * ```lua
      * local pos = go.get_position("my_gameobject")
      * ```
+     *
+     * Reuse the same vector every frame to avoid creating garbage:
+     *
+     * ```lua
+     * function init(self)
+     *     self.position = vmath.vector3()
+     * end
+     *
+     * function update(self, dt)
+     *     go.get_position(nil, self.position)
+     * end
+     * ```
      */
     int Script_GetPosition(lua_State* L)
     {
-        Instance* instance = ResolveInstance(L, 1);
-        dmScript::PushVector3(L, Vectormath::Aos::Vector3(dmGameObject::GetPosition(instance)));
+        Vectormath::Aos::Vector3* out;
+        Instance* instance = ResolveInstanceOutVector3(L, &out);
+        PushOutVector3(L, out, Vectormath::Aos::Vector3(dmGameObject::GetPosition(instance)));
         return 1;
     }
 
@@ -1106,6 +1150,7 @@ namespace dmGameObject
      *
      * @name go.get_world_position
      * @param [id] [type:string|hash|url] optional id of the game object instance to get the world position for, by default the instance of the calling script
+     * @param [out] [type:vector3] optional vector to store the world position in, instead of creating a new one
      * @return position [type:vector3] instance world position
      * @examples
      *
@@ -1123,8 +1168,9 @@ namespace dmGameObject
      */
     int Script_GetWorldPosition(lua_State* L)
     {
-        Instance* instance = ResolveInstance(L, 1);
-        dmScript::PushVector3(L, Vectormath::Aos::Vector3(dmGameObject::GetWorldPosition(instance)));
+        Vectormath::Aos::Vector3* out;
+        Instance* instance = ResolveInstanceOutVector3(L, &out);
+        PushOutVector3(L, out, Vectormath::Aos::Vector3(dmGameObject::GetWorldPosition(instance)));
         return 1;
     }
 
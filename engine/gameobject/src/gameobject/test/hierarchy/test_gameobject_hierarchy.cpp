@@ -20,6 +20,7 @@
 #include <dlib/dstrings.h>
 #include <dlib/time.h>
 #include <dlib/log.h>
+#include <dlib/worker_pool.h>
 #include <resource/resource.h>
 #include "../gameobject.h"
 #include "../gameobject_private.h"
@@ -1037,6 +1038,131 @@ TEST_F(HierarchyTest, TestIterateHierarchy)
 
 }
 
+// Builds chains of instances 'depth' levels deep until 'count' instances are created.
+// A depth of 1 gives a flat hierarchy of root instances only.
+static void CreateTransformHierarchy(dmGameObject::HCollection collection, uint32_t count, uint32_t depth, dmArray<dmGameObject::HInstance>& instances)
+{
+    instances.SetCapacity(count);
+    dmGameObject::HInstance parent = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmGameObject::HInstance instance = dmGameObject::New(collection, "/go.goc");
+        dmGameObject::SetPosition(instance, Point3(1.0f + (i % 7), 2.0f, (float)(i % 3)));
+        dmGameObject::SetRotation(instance, Quat::rotationZ(0.01f * (i % 13)));
+        dmGameObject::SetScale(instance, Vector3(1.0f, 1.0f + 0.001f * (i % 5), 1.0f));
+        if (i % depth != 0)
+            dmGameObject::SetParent(instance, parent);
+        parent = instance;
+        instances.Push(instance);
+    }
+}
+
+// Returns the average time in microseconds. If 'moving' is set, all world transforms are recalculated each iteration
+static double TimeUpdateTransforms(dmGameObject::Collection* collection, uint32_t iterations, bool moving)
+{
+    uint64_t time = 0;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        if (moving)
+            memset(collection->m_TransformFlags.Begin(), dmGameObject::TRANSFORM_FLAG_FORCE_UPDATE, collection->m_TransformFlags.Size());
+        uint64_t start = dmTime::GetTime();
+        dmGameObject::UpdateTransforms(collection);
+        time += dmTime::GetTime() - start;
+    }
+    return time / (double)iterations;
+}
+
+static void BenchUpdateTransforms(dmGameObject::HRegister regist, dmResource::HFactory factory, const char* name, uint32_t count, uint32_t depth)
+{
+    const uint32_t iterations = 50;
+
+    dmGameObject::HCollection collection = dmGameObject::NewCollection(name, factory, regist, count);
+    ASSERT_NE((dmGameObject::HCollection)0, collection);
+    dmArray<dmGameObject::HInstance> instances;
+    CreateTransformHierarchy(collection, count, depth, instances);
+
+    dmGameObject::SetWorkerPool(regist, 0);
+    double serial_time = TimeUpdateTransforms(collection->m_Collection, iterations, true);
+    double static_time = TimeUpdateTransforms(collection->m_Collection, iterations, false);
+    ASSERT_EQ(0U, collection->m_Collection->m_UpdatedTransformCount);
+
+    dmArray<Matrix4> serial_result;
+    serial_result.SetCapacity(count);
+    for (uint32_t i = 0; i < count; ++i)
+        serial_result.Push(dmGameObject::GetWorldMatrix(instances[i]));
+
+    dmWorkerPool::HWorkerPool pool = dmWorkerPool::New(3, "bench_worker");
+    dmGameObject::SetWorkerPool(regist, pool);
+    double parallel_time = TimeUpdateTransforms(collection->m_Collection, iterations, true);
+    ASSERT_EQ(count, collection->m_Collection->m_UpdatedTransformCount);
+    dmGameObject::SetWorkerPool(regist, 0);
+    dmWorkerPool::Delete(pool);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Matrix4 world = dmGameObject::GetWorldMatrix(instances[i]);
+        ASSERT_EQ(0, memcmp(&serial_result[i], &world, sizeof(Matrix4)));
+    }
+
+    printf("UpdateTransforms %-6s %6u instances, depth %3u: serial %.3f ms, 3 workers %.3f ms, static %.3f ms\n", name, count, depth,
+            serial_time / 1000.0, parallel_time / 1000.0, static_time / 1000.0);
+
+    dmGameObject::DeleteCollection(collection);
+    dmGameObject::PostUpdate(regist);
+}
+
+TEST_F(HierarchyTest, TestUpdateTransformsDirtySubtree)
+{
+    dmGameObject::HInstance root = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::HInstance parent = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::HInstance child = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::HInstance grandchild = dmGameObject::New(m_Collection, "/go.goc");
+    dmGameObject::SetParent(child, parent);
+    dmGameObject::SetParent(grandchild, child);
+    dmGameObject::SetPosition(parent, Point3(1, 0, 0));
+    dmGameObject::SetPosition(child, Point3(0, 2, 0));
+    dmGameObject::SetPosition(grandchild, Point3(0, 0, 3));
+
+    dmGameObject::Collection* collection = m_Collection->m_Collection;
+
+    dmGameObject::UpdateTransforms(collection);
+    ASSERT_EQ(4U, collection->m_UpdatedTransformCount);
+    ASSERT_NEAR(0.0f, length(dmGameObject::GetWorldPosition(grandchild) - Point3(1, 2, 3)), EPSILON);
+
+    // Nothing moved
+    dmGameObject::UpdateTransforms(collection);
+    ASSERT_EQ(0U, collection->m_UpdatedTransformCount);
+
+    // Only the moved subtree is recalculated
+    dmGameObject::SetPosition(child, Point3(0, 4, 0));
+    dmGameObject::UpdateTransforms(collection);
+    ASSERT_EQ(2U, collection->m_UpdatedTransformCount);
+    ASSERT_NEAR(0.0f, length(dmGameObject::GetWorldPosition(child) - Point3(1, 4, 0)), EPSILON);
+    ASSERT_NEAR(0.0f, length(dmGameObject::GetWorldPosition(grandchild) - Point3(1, 4, 3)), EPSILON);
+
+    dmGameObject::SetPosition(parent, Point3(2, 0, 0));
+    dmGameObject::UpdateTransforms(collection);
+    ASSERT_EQ(3U, collection->m_UpdatedTransformCount);
+    ASSERT_NEAR(0.0f, length(dmGameObject::GetWorldPosition(grandchild) - Point3(2, 4, 3)), EPSILON);
+
+    // Reparenting recalculates the moved instance even if its local transform is unchanged
+    dmGameObject::SetParent(grandchild, root);
+    dmGameObject::UpdateTransforms(collection);
+    ASSERT_EQ(1U, collection->m_UpdatedTransformCount);
+    ASSERT_NEAR(0.0f, length(dmGameObject::GetWorldPosition(grandchild) - Point3(0, 0, 3)), EPSILON);
+
+    dmGameObject::Delete(m_Collection, grandchild, false);
+    dmGameObject::Delete(m_Collection, child, false);
+    dmGameObject::Delete(m_Collection, parent, false);
+    dmGameObject::Delete(m_Collection, root, false);
+}
+
+TEST_F(HierarchyTest, BenchUpdateTransforms)
+{
+    BenchUpdateTransforms(m_Register, m_Factory, "flat", 16384, 1);
+    BenchUpdateTransforms(m_Register, m_Factory, "deep", 16384, 64);
+}
+
 #undef EPSILON
 
 int main(int argc, char **argv)
@@ -49,6 +49,7 @@ protected:
         assert(dmMessage::NewSocket("@system", &m_Socket) == dmMessage::RESULT_OK);
 
         m_MessageTargetCounter = 0;
+        m_MessageTargetBatchCount = 0;
 
         dmResource::Result e = dmResource::RegisterType(m_Factory, "mt", this, 0, ResMessageTargetCreate, 0, ResMessageTargetDestroy, 0);
         ASSERT_EQ(dmResource::RESULT_OK, e);
@@ -93,6 +94,7 @@ protected:
     static dmGameObject::CreateResult CompMessageTargetCreate(const dmGameObject::ComponentCreateParams& params);
     static dmGameObject::CreateResult CompMessageTargetDestroy(const dmGameObject::ComponentDestroyParams& params);
     static dmGameObject::UpdateResult CompMessageTargetOnMessage(const dmGameObject::ComponentOnMessageParams& params);
+    static dmGameObject::UpdateResult CompMessageTargetOnMessageBatch(const dmGameObject::ComponentsOnMessageBatchParams& params);
 
 public:
     dmGameObject::UpdateContext m_UpdateContext;
@@ -105,6 +107,8 @@ public:
     std::map<uint32_t, uint32_t> m_MessageMap;
 
     uint32_t m_MessageTargetCounter;
+    uint32_t m_MessageTargetBatchCount;
+    dmArray<uint32_t> m_MessageTargetBatchValues;
     dmGameObject::ModuleContext m_ModuleContext;
 };
 
@@ -184,6 +188,26 @@ dmGameObject::UpdateResult MessageTest::CompMessageTargetOnMessage(const dmGameO
     return dmGameObject::UPDATE_RESULT_OK;
 }
 
+dmGameObject::UpdateResult MessageTest::CompMessageTargetOnMessageBatch(const dmGameObject::ComponentsOnMessageBatchParams& params)
+{
+    MessageTest* self = (MessageTest*) params.m_Context;
+    assert(params.m_Context == params.m_World);
+    self->m_MessageTargetBatchCount++;
+    for (uint32_t i = 0; i < params.m_MessageCount; ++i)
+    {
+        const dmGameObject::ComponentOnMessageParams& p = params.m_Messages[i];
+        if (p.m_Message->m_Descriptor != (uintptr_t) TestGameObjectDDF::TestDataMessage::m_DDFDescriptor)
+        {
+            return dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+        }
+        TestGameObjectDDF::TestDataMessage* ddf = (TestGameObjectDDF::TestDataMessage*) p.m_Message->m_Data;
+        // The broadcast below must not have been delivered yet
+        self->m_MessageTargetBatchValues.OffsetCapacity(1);
+        self->m_MessageTargetBatchValues.Push(ddf->m_Value + self->m_MessageTargetCounter * 100);
+    }
+    return dmGameObject::UPDATE_RESULT_OK;
+}
+
 void DispatchCallback(dmMessage::Message *message, void* user_ptr)
 {
     MessageTest* test = (MessageTest*)user_ptr;
@@ -198,6 +222,10 @@ void DispatchCallback(dmMessage::Message *message, void* user_ptr)
     }
 }
 
+static void MessageTestDestroyCallback(dmMessage::Message* message)
+{
+}
+
 TEST_F(MessageTest, TestPostNamedTo)
 {
     dmGameObject::HInstance instance = dmGameObject::New(m_Collection, "/test_onmessage.goc");
@@ -268,6 +296,74 @@ TEST_F(MessageTest, TestComponentMessage)
     dmGameObject::Delete(m_Collection, go, false);
 }
 
+TEST_F(MessageTest, TestComponentMessageBatch)
+{
+    dmResource::ResourceType resource_type;
+    ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetTypeFromExtension(m_Factory, "mt", &resource_type));
+    dmGameObject::ComponentType* mt_type = dmGameObject::FindComponentType(m_Register, resource_type, 0x0);
+    ASSERT_NE((void*) 0, (void*) mt_type);
+    mt_type->m_OnMessageBatchFunction = CompMessageTargetOnMessageBatch;
+
+    dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/component_broadcast_message.goc");
+    ASSERT_NE((void*) 0, (void*) go);
+    ASSERT_EQ(dmGameObject::RESULT_OK, dmGameObject::SetIdentifier(m_Collection, go, "test_instance"));
+
+    dmMessage::URL receiver;
+    receiver.m_Socket = dmGameObject::GetMessageSocket(m_Collection);
+    receiver.m_Path = dmGameObject::GetIdentifier(go);
+    receiver.m_Fragment = dmHashString64("mt1");
+
+    dmhash_t message_id = TestGameObjectDDF::TestDataMessage::m_DDFDescriptor->m_NameHash;
+    uintptr_t descriptor = (uintptr_t) TestGameObjectDDF::TestDataMessage::m_DDFDescriptor;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        TestGameObjectDDF::TestDataMessage ddf;
+        ddf.m_Value = i + 1;
+        ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, descriptor, &ddf, sizeof(ddf), 0));
+    }
+
+    // Broadcast, handled by OnMessage after the batched messages
+    dmMessage::URL broadcast = receiver;
+    broadcast.m_Fragment = 0;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &broadcast, TestGameObjectDDF::TestMessage::m_DDFDescriptor->m_NameHash, 0, 0, 0x0, 0, 0));
+
+    TestGameObjectDDF::TestDataMessage ddf;
+    ddf.m_Value = 4;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, descriptor, &ddf, sizeof(ddf), 0));
+
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+
+    ASSERT_EQ(2U, m_MessageTargetCounter);
+    ASSERT_EQ(2U, m_MessageTargetBatchCount);
+    ASSERT_EQ(4U, m_MessageTargetBatchValues.Size());
+    ASSERT_EQ(1U, m_MessageTargetBatchValues[0]);
+    ASSERT_EQ(2U, m_MessageTargetBatchValues[1]);
+    ASSERT_EQ(3U, m_MessageTargetBatchValues[2]);
+    ASSERT_EQ(204U, m_MessageTargetBatchValues[3]);
+
+    // Messages with a destroy callback still go through OnMessage
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, dmHashString64("dec"), 0, 0, 0x0, 0, MessageTestDestroyCallback));
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(1U, m_MessageTargetCounter);
+    ASSERT_EQ(2U, m_MessageTargetBatchCount);
+
+    // Messages posted before a message to a component type without a batch function are delivered before it
+    dmMessage::URL script_receiver = receiver;
+    script_receiver.m_Fragment = dmHashString64("script");
+    ddf.m_Value = 5;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, descriptor, &ddf, sizeof(ddf), 0));
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &script_receiver, dmHashString64("test"), 0, 0, 0x0, 0, 0));
+    ddf.m_Value = 6;
+    ASSERT_EQ(dmMessage::RESULT_OK, dmMessage::Post(0x0, &receiver, message_id, 0, descriptor, &ddf, sizeof(ddf), 0));
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+    ASSERT_EQ(4U, m_MessageTargetBatchCount);
+    ASSERT_EQ(6U, m_MessageTargetBatchValues.Size());
+    ASSERT_EQ(105U, m_MessageTargetBatchValues[4]);
+    ASSERT_EQ(106U, m_MessageTargetBatchValues[5]);
+
+    dmGameObject::Delete(m_Collection, go, false);
+}
+
 TEST_F(MessageTest, TestComponentMessageFail)
 {
     dmGameObject::HInstance go = dmGameObject::New(m_Collection, "/component_message.goc");
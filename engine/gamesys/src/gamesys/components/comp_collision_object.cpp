@@ -131,14 +131,23 @@ namespace dmGameSystem
         world_transform = dmGameObject::GetWorldTransform(instance);
     }
 
+    static void GetWorldTransforms(dmPhysics::WorldTransformEntry* entries, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dmPhysics::WorldTransformEntry& entry = entries[i];
+            if (!entry.m_UserData)
+                continue;
+            CollisionComponent* component = (CollisionComponent*)entry.m_UserData;
+            entry.m_WorldTransform = dmGameObject::GetWorldTransform(component->m_Instance);
+        }
+    }
+
     // TODO: Allow the SetWorldTransform to have a physics context which we can check instead!!
     static int g_NumPhysicsTransformsUpdated = 0;
 
-    static void SetWorldTransform(void* user_data, const Vectormath::Aos::Point3& position, const Vectormath::Aos::Quat& rotation)
+    static inline void SetComponentTransform(CollisionComponent* component, const Vectormath::Aos::Point3& position, const Vectormath::Aos::Quat& rotation)
     {
-        if (!user_data)
-            return;
-        CollisionComponent* component = (CollisionComponent*)user_data;
         dmGameObject::HInstance instance = component->m_Instance;
         if (component->m_3D)
         {
@@ -153,15 +162,36 @@ namespace dmGameSystem
             dmGameObject::SetPosition(instance, p);
         }
         dmGameObject::SetRotation(instance, rotation);
+    }
+
+    static void SetWorldTransform(void* user_data, const Vectormath::Aos::Point3& position, const Vectormath::Aos::Quat& rotation)
+    {
+        if (!user_data)
+            return;
+        SetComponentTransform((CollisionComponent*)user_data, position, rotation);
         ++g_NumPhysicsTransformsUpdated;
     }
 
+    static void SetWorldTransforms(const dmPhysics::WorldTransformEntry* entries, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const dmPhysics::WorldTransformEntry& entry = entries[i];
+            if (!entry.m_UserData)
+                continue;
+            SetComponentTransform((CollisionComponent*)entry.m_UserData, Vectormath::Aos::Point3(entry.m_WorldTransform.GetTranslation()), entry.m_WorldTransform.GetRotation());
+            ++g_NumPhysicsTransformsUpdated;
+        }
+    }
+
     dmGameObject::CreateResult CompCollisionObjectNewWorld(const dmGameObject::ComponentNewWorldParams& params)
     {
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
         dmPhysics::NewWorldParams world_params;
         world_params.m_GetWorldTransformCallback = GetWorldTransform;
         world_params.m_SetWorldTransformCallback = SetWorldTransform;
+        world_params.m_GetWorldTransformsCallback = GetWorldTransforms;
+        world_params.m_SetWorldTransformsCallback = SetWorldTransforms;
 
         dmPhysics::HWorld2D world2D;
         dmPhysics::HWorld3D world3D;
@@ -1120,6 +1150,20 @@ namespace dmGameSystem
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
+    dmGameObject::UpdateResult CompCollisionObjectOnMessageBatch(const dmGameObject::ComponentsOnMessageBatchParams& params)
+    {
+        // A failing message must not drop the rest of the batch
+        dmGameObject::UpdateResult result = dmGameObject::UPDATE_RESULT_OK;
+        for (uint32_t i = 0; i < params.m_MessageCount; ++i)
+        {
+            if (CompCollisionObjectOnMessage(params.m_Messages[i]) != dmGameObject::UPDATE_RESULT_OK)
+            {
+                result = dmGameObject::UPDATE_RESULT_UNKNOWN_ERROR;
+            }
+        }
+        return result;
+    }
+
     void CompCollisionObjectOnReload(const dmGameObject::ComponentOnReloadParams& params)
     {
         PhysicsContext* physics_context = (PhysicsContext*)params.m_Context;
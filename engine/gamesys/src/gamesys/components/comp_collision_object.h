@@ -40,6 +40,8 @@ namespace dmGameSystem
 
     dmGameObject::UpdateResult CompCollisionObjectOnMessage(const dmGameObject::ComponentOnMessageParams& params);
 
+    dmGameObject::UpdateResult CompCollisionObjectOnMessageBatch(const dmGameObject::ComponentsOnMessageBatchParams& params);
+
     void CompCollisionObjectOnReload(const dmGameObject::ComponentOnReloadParams& params);
 
     dmGameObject::PropertyResult CompCollisionObjectGetProperty(const dmGameObject::ComponentGetPropertyParams& params, dmGameObject::PropertyDesc& out_value);
@@ -20,6 +20,7 @@
 #include <dlib/profile.h>
 #include <dlib/dstrings.h>
 #include <dlib/trig_lookup.h>
+#include <dlib/worker_pool.h>
 #include <graphics/graphics.h>
 #include <graphics/graphics_util.h>
 #include <render/render.h>
@@ -100,6 +101,7 @@ namespace dmGameSystem
         }
 
         gui_world->m_Components.SetCapacity(gui_context->m_MaxGuiComponents);
+        gui_world->m_WorkerPool = gui_context->m_WorkerPool;
 
         dmGraphics::VertexElement ve[] =
         {
@@ -1056,6 +1058,289 @@ namespace dmGameSystem
         gui_world->m_ClientVertexBuffer.SetSize(vb_end - gui_world->m_ClientVertexBuffer.Begin());
     }
 
+    // Largest number of nodes in a vertex job
+    static const uint32_t VERTEX_JOB_MAX_NODES = 256;
+
+    static void PushVertexJob(GuiWorld* gui_world, dmGui::HScene scene, dmGui::NodeType node_type, const dmGui::RenderEntry* entries,
+                              const Matrix4* node_transforms, const float* node_opacities, uint32_t node_count,
+                              dmGraphics::HTexture texture, float org_width, float org_height, uint32_t vertex_count)
+    {
+        if (gui_world->m_VertexJobs.Full())
+        {
+            gui_world->m_VertexJobs.OffsetCapacity(64);
+        }
+
+        dmArray<BoxVertex>& vertex_buffer = gui_world->m_ClientVertexBuffer;
+        if (vertex_buffer.Remaining() < vertex_count) {
+            vertex_buffer.OffsetCapacity(dmMath::Max(128U, vertex_count));
+        }
+
+        GuiVertexJob job;
+        job.m_Scene = scene;
+        job.m_NodeType = node_type;
+        job.m_Entries = entries;
+        job.m_NodeTransforms = node_transforms;
+        job.m_NodeOpacities = node_opacities;
+        job.m_NodeCount = node_count;
+        job.m_Texture = texture;
+        job.m_OrgWidth = org_width;
+        job.m_OrgHeight = org_height;
+        job.m_VertexStart = vertex_buffer.Size();
+        job.m_VertexCount = vertex_count;
+        gui_world->m_VertexJobs.Push(job);
+
+        vertex_buffer.SetSize(vertex_buffer.Size() + vertex_count);
+    }
+
+    // Number of vertices written by GenerateBoxNodeVertices
+    static uint32_t GetBoxNodeVertexCount(dmGui::HScene scene, dmGui::HNode node, dmGraphics::HTexture texture)
+    {
+        if (dmGui::GetNodeIsBone(scene, node)) {
+            return 0;
+        }
+
+        bool manually_set_texture = dmGui::GetNodeFlipbookAnimUV(scene, node) == 0;
+        bool use_slice_nine = sum(dmGui::GetNodeSlice9(scene, node)) != 0;
+        if ((!use_slice_nine && manually_set_texture) || !texture) {
+            return 6;
+        }
+
+        if (!use_slice_nine)
+        {
+            dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
+            dmGameSystemDDF::TextureSet* texture_set_ddf = anim_desc ? (dmGameSystemDDF::TextureSet*)anim_desc->m_TextureSet : 0;
+            if (texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0)
+            {
+                int32_t frame_index = texture_set_ddf->m_FrameIndices[dmGui::GetNodeAnimationFrame(scene, node)];
+                return texture_set_ddf->m_Geometries.m_Data[frame_index].m_Indices.m_Count;
+            }
+        }
+
+        return 6*9;
+    }
+
+    static BoxVertex* GenerateBoxNodeVertices(dmGui::HScene scene, dmGui::HNode node, dmGraphics::HTexture texture, float org_width, float org_height,
+                                              const Matrix4& transform, float opacity, BoxVertex* vb)
+    {
+        if (dmGui::GetNodeIsBone(scene, node)) {
+            return vb;
+        }
+
+        // pre-multiplied alpha
+        const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
+        Vector4 pm_color(color.getXYZ(), opacity);
+
+        // default not uv_rotated texture coords
+        const float default_tc[6] = {0, 0, 0, 1, 1, 1};
+        const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
+
+        // tc equals 0 when texture is set from lua script directly with gui.set_texture(...) method
+        bool manually_set_texture = tc == 0;
+        if (manually_set_texture) {
+            tc = default_tc;
+        }
+
+        Vector4 slice9 = dmGui::GetNodeSlice9(scene, node);
+        bool use_slice_nine = sum(slice9) != 0;
+
+        // render simple quad ignoring 9-slicing
+        if ((!use_slice_nine && manually_set_texture) || !texture)
+        {
+            BoxVertex v00;
+            v00.SetColor(pm_color);
+            v00.SetPosition(transform * Vectormath::Aos::Point3(0, 0, 0));
+            v00.SetUV(0, 0);
+
+            BoxVertex v10;
+            v10.SetColor(pm_color);
+            v10.SetPosition(transform * Vectormath::Aos::Point3(1, 0, 0));
+            v10.SetUV(1, 0);
+
+            BoxVertex v01;
+            v01.SetColor(pm_color);
+            v01.SetPosition(transform * Vectormath::Aos::Point3(0, 1, 0));
+            v01.SetUV(0, 1);
+
+            BoxVertex v11;
+            v11.SetColor(pm_color);
+            v11.SetPosition(transform * Vectormath::Aos::Point3(1, 1, 0));
+            v11.SetUV(1, 1);
+
+            *vb++ = v00;
+            *vb++ = v10;
+            *vb++ = v11;
+            *vb++ = v00;
+            *vb++ = v11;
+            *vb++ = v01;
+            return vb;
+        }
+
+        dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
+        dmGameSystemDDF::TextureSet* texture_set_ddf = anim_desc ? (dmGameSystemDDF::TextureSet*)anim_desc->m_TextureSet : 0;
+        bool use_geometries = texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0;
+
+        bool flip_u = false;
+        bool flip_v = false;
+        if (!manually_set_texture)
+            GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
+
+        // render using geometries without 9-slicing
+        if (!use_slice_nine && use_geometries)
+        {
+            int32_t frame_index = dmGui::GetNodeAnimationFrame(scene, node);
+            frame_index = texture_set_ddf->m_FrameIndices[frame_index];
+
+            const dmGameSystemDDF::SpriteGeometry* geometry = &texture_set_ddf->m_Geometries.m_Data[frame_index];
+
+            const Matrix4& w = transform;
+
+            // NOTE: The original rendering code is from the comp_sprite.cpp.
+            // Compare with that one if you do any changes to either.
+            uint32_t num_points = geometry->m_Vertices.m_Count / 2;
+
+            const float* points = geometry->m_Vertices.m_Data;
+            const float* uvs = geometry->m_Uvs.m_Data;
+
+            // Depending on the sprite is flipped or not, we loop the vertices forward or backward
+            // to respect face winding (and backface culling)
+            int reverse = (int)flip_u ^ (int)flip_v;
+
+            float scaleX = flip_u ? -1 : 1;
+            float scaleY = flip_v ? -1 : 1;
+
+            // Since we don't use an index buffer, we duplicate the vertices manually
+            uint32_t index_count = geometry->m_Indices.m_Count;
+            for (uint32_t index = 0; index < index_count; ++index)
+            {
+                uint32_t i = geometry->m_Indices.m_Data[index];
+                i = reverse ? (num_points - i - 1) : i;
+
+                const float* point = &points[i * 2];
+                const float* uv = &uvs[i * 2];
+                // COnvert from range [-0.5,+0.5] to [0.0, 1.0]
+                float x = point[0] * scaleX + 0.5f;
+                float y = point[1] * scaleY + 0.5f;
+
+                Vector4 p = w * Point3(x, y, 0.0f);
+                *vb++ = BoxVertex(p, uv[0], uv[1], pm_color);
+            }
+            return vb;
+        }
+
+        // render 9-sliced node
+
+        //   0 1     2 3
+        // 0 *-*-----*-*
+        //   | |  y  | |
+        // 1 *-*-----*-*
+        //   | |     | |
+        //   |x|     |z|
+        //   | |     | |
+        // 2 *-*-----*-*
+        //   | |  w  | |
+        // 3 *-*-----*-*
+        float us[4], vs[4], xs[4], ys[4];
+
+        // v are '1-v'
+        xs[0] = ys[0] = 0;
+        xs[3] = ys[3] = 1;
+
+        // disable slice9 computation below a certain dimension
+        // (avoid div by zero)
+        const float s9_min_dim = 0.001f;
+
+        const float su = 1.0f / org_width;
+        const float sv = 1.0f / org_height;
+
+        Point3 size = dmGui::GetNodeSize(scene, node);
+        const float sx = size.getX() > s9_min_dim ? 1.0f / size.getX() : 0;
+        const float sy = size.getY() > s9_min_dim ? 1.0f / size.getY() : 0;
+
+        static const uint32_t uvIndex[2][4] = {{0,1,2,3}, {3,2,1,0}};
+        bool uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
+        if(uv_rotated)
+        {
+            const uint32_t *uI = flip_v ? uvIndex[1] : uvIndex[0];
+            const uint32_t *vI = flip_u ? uvIndex[1] : uvIndex[0];
+            us[uI[0]] = tc[0];
+            us[uI[1]] = tc[0] + (su * slice9.getW());
+            us[uI[2]] = tc[2] - (su * slice9.getY());
+            us[uI[3]] = tc[2];
+            vs[vI[0]] = tc[1];
+            vs[vI[1]] = tc[1] - (sv * slice9.getX());
+            vs[vI[2]] = tc[5] + (sv * slice9.getZ());
+            vs[vI[3]] = tc[5];
+        }
+        else
+        {
+            const uint32_t *uI = flip_u ? uvIndex[1] : uvIndex[0];
+            const uint32_t *vI = flip_v ? uvIndex[1] : uvIndex[0];
+            us[uI[0]] = tc[0];
+            us[uI[1]] = tc[0] + (su * slice9.getX());
+            us[uI[2]] = tc[4] - (su * slice9.getZ());
+            us[uI[3]] = tc[4];
+            vs[vI[0]] = tc[1];
+            vs[vI[1]] = tc[1] + (sv * slice9.getW());
+            vs[vI[2]] = tc[3] - (sv * slice9.getY());
+            vs[vI[3]] = tc[3];
+        }
+
+        xs[1] = sx * slice9.getX();
+        xs[2] = 1 - sx * slice9.getZ();
+        ys[1] = sy * slice9.getW();
+        ys[2] = 1 - sy * slice9.getY();
+
+        Vectormath::Aos::Vector4 pts[4][4];
+        for (int y=0;y<4;y++)
+        {
+            for (int x=0;x<4;x++)
+            {
+                pts[y][x] = (transform * Vectormath::Aos::Point3(xs[x], ys[y], 0));
+            }
+        }
+
+        BoxVertex v00, v10, v01, v11;
+        v00.SetColor(pm_color);
+        v10.SetColor(pm_color);
+        v01.SetColor(pm_color);
+        v11.SetColor(pm_color);
+        for (int y=0;y<3;y++)
+        {
+            for (int x=0;x<3;x++)
+            {
+                const int x0 = x;
+                const int x1 = x+1;
+                const int y0 = y;
+                const int y1 = y+1;
+                v00.SetPosition(pts[y0][x0]);
+                v10.SetPosition(pts[y0][x1]);
+                v01.SetPosition(pts[y1][x0]);
+                v11.SetPosition(pts[y1][x1]);
+                if(uv_rotated)
+                {
+                    v00.SetUV(us[y0], vs[x0]);
+                    v10.SetUV(us[y0], vs[x1]);
+                    v01.SetUV(us[y1], vs[x0]);
+                    v11.SetUV(us[y1], vs[x1]);
+                }
+                else
+                {
+                    v00.SetUV(us[x0], vs[y0]);
+                    v10.SetUV(us[x1], vs[y0]);
+                    v01.SetUV(us[x0], vs[y1]);
+                    v11.SetUV(us[x1], vs[y1]);
+                }
+                *vb++ = v00;
+                *vb++ = v10;
+                *vb++ = v11;
+                *vb++ = v00;
+                *vb++ = v11;
+                *vb++ = v01;
+            }
+        }
+        return vb;
+    }
+
     void RenderBoxNodes(dmGui::HScene scene,
                         const dmGui::RenderEntry* entries,
                         const Matrix4* node_transforms,
@@ -1084,9 +1369,6 @@ namespace dmGameSystem
 
         ApplyStencilClipping(gui_context, stencil_scopes[0], ro);
 
-        const int verts_per_node = 6*9;
-        const uint32_t max_total_vertices = verts_per_node * node_count;
-
         dmGui::BlendMode blend_mode = dmGui::GetNodeBlendMode(scene, first_node);
         SetBlendMode(ro, blend_mode);
         ro.m_SetBlendFactors = 1;
@@ -1103,263 +1385,243 @@ namespace dmGameSystem
         else
             ro.m_Textures[0] = gui_world->m_WhiteTexture;
 
-        if (gui_world->m_ClientVertexBuffer.Remaining() < (max_total_vertices)) {
-            gui_world->m_ClientVertexBuffer.OffsetCapacity(dmMath::Max(128U, max_total_vertices));
-        }
-
         // 9-slice values are specified with reference to the original graphics and not by
         // the possibly stretched texture.
         float org_width = (float)dmGraphics::GetOriginalTextureWidth(ro.m_Textures[0]);
         float org_height = (float)dmGraphics::GetOriginalTextureHeight(ro.m_Textures[0]);
         assert(org_width > 0 && org_height > 0);
 
-        int rendered_vert_count = 0;
-        for (uint32_t i = 0; i < node_count; ++i)
+        // The vertices are only counted and reserved here, they are generated at the end of RenderNodes
+        for (uint32_t job_start = 0; job_start < node_count; )
         {
-            const dmGui::HNode node = entries[i].m_Node;
-
-            if (dmGui::GetNodeIsBone(scene, node)) {
-                continue;
-            }
-
-            // pre-multiplied alpha
-            const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
-            Vector4 pm_color(color.getXYZ(), node_opacities[i]);
-
-            // default not uv_rotated texture coords
-            const float default_tc[6] = {0, 0, 0, 1, 1, 1};
-            const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
-
-            // tc equals 0 when texture is set from lua script directly with gui.set_texture(...) method
-            bool manually_set_texture = tc == 0;
-            if (manually_set_texture) {
-                tc = default_tc;
+            uint32_t job_end = job_start + dmMath::Min(node_count - job_start, VERTEX_JOB_MAX_NODES);
+            uint32_t vertex_count = 0;
+            for (uint32_t i = job_start; i < job_end; ++i)
+            {
+                vertex_count += GetBoxNodeVertexCount(scene, entries[i].m_Node, texture);
             }
+            PushVertexJob(gui_world, scene, node_type, entries + job_start, node_transforms + job_start, node_opacities + job_start,
+                          job_end - job_start, texture, org_width, org_height, vertex_count);
+            job_start = job_end;
+        }
 
-            Vector4 slice9 = dmGui::GetNodeSlice9(scene, node);
-            bool use_slice_nine = sum(slice9) != 0;
+        ro.m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - ro.m_VertexStart;
+    }
 
-            // render simple quad ignoring 9-slicing
-            if ((!use_slice_nine && manually_set_texture) || !texture)
-            {
-                BoxVertex v00;
-                v00.SetColor(pm_color);
-                v00.SetPosition(node_transforms[i] * Vectormath::Aos::Point3(0, 0, 0));
-                v00.SetUV(0, 0);
-
-                BoxVertex v10;
-                v10.SetColor(pm_color);
-                v10.SetPosition(node_transforms[i] * Vectormath::Aos::Point3(1, 0, 0));
-                v10.SetUV(1, 0);
-
-                BoxVertex v01;
-                v01.SetColor(pm_color);
-                v01.SetPosition(node_transforms[i] * Vectormath::Aos::Point3(0, 1, 0));
-                v01.SetUV(0, 1);
-
-                BoxVertex v11;
-                v11.SetColor(pm_color);
-                v11.SetPosition(node_transforms[i] * Vectormath::Aos::Point3(1, 1, 0));
-                v11.SetUV(1, 1);
-
-                gui_world->m_ClientVertexBuffer.Push(v00);
-                gui_world->m_ClientVertexBuffer.Push(v10);
-                gui_world->m_ClientVertexBuffer.Push(v11);
-                gui_world->m_ClientVertexBuffer.Push(v00);
-                gui_world->m_ClientVertexBuffer.Push(v11);
-                gui_world->m_ClientVertexBuffer.Push(v01);
-
-                rendered_vert_count += 6;
-                continue;
-            }
+    // Computes max vertices required in the vertex buffer to draw a pie node with a
+    // given number of perimeter vertices in its configuration.
+    inline uint32_t ComputeRequiredVertices(uint32_t perimeter_vertices)
+    {
+        // 1.  Minimum is capped to 4
+        // 2a. There will always be one extra needed to complete a full fill.
+        //     I.e. an 8-gon will need 9 vertices around, where the first and last
+        //     overlap. (+1)
+        // 2b. If the shape has rectangular bounds and pass through all four corners,
+        //     there will be 4 vertices inserted around the loop. (+4)
+        // 3.  Each vertex around the perimeter has its twin along the inside (*2)
+        // 4.  To draw all pie nodes in one draw call as a strip, each pie adds two
+        //     doubled vertices to tie it together (+2)
+        return 2 * (dmMath::Max<uint32_t>(perimeter_vertices, 4) + 5) + 2;
+    }
 
-            dmGui::TextureSetAnimDesc* anim_desc = dmGui::GetNodeTextureSet(scene, node);
-            dmGameSystemDDF::TextureSet* texture_set_ddf = anim_desc ? (dmGameSystemDDF::TextureSet*)anim_desc->m_TextureSet : 0;
-            bool use_geometries = texture_set_ddf && texture_set_ddf->m_Geometries.m_Count > 0;
+    static const float PIE_PI = 3.1415926535f;
 
-            bool flip_u = false;
-            bool flip_v = false;
-            if (!manually_set_texture)
-                GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
+    struct PieNodeShape
+    {
+        float               m_AngleStep;
+        float               m_StopAngle;
+        uint32_t            m_Generate;
+        dmGui::PieBounds    m_OuterBounds;
+        bool                m_Backwards;
+    };
 
-            // render using geometries without 9-slicing
-            if (!use_slice_nine && use_geometries)
-            {
-                int32_t frame_index = dmGui::GetNodeAnimationFrame(scene, node);
-                frame_index = texture_set_ddf->m_FrameIndices[frame_index];
+    // Returns false if nothing should be drawn for the node
+    static bool GetPieNodeShape(dmGui::HScene scene, dmGui::HNode node, PieNodeShape& shape)
+    {
+        const Point3 size = dmGui::GetNodeSize(scene, node);
+        if (dmGui::GetNodeIsBone(scene, node) || dmMath::Abs(size.getX()) < 0.001f)
+            return false;
 
-                const dmGameSystemDDF::SpriteGeometry* geometry = &texture_set_ddf->m_Geometries.m_Data[frame_index];
+        const uint32_t perimeterVertices = dmMath::Max<uint32_t>(4, dmGui::GetNodePerimeterVertices(scene, node));
+        shape.m_OuterBounds = dmGui::GetNodeOuterBounds(scene, node);
+        shape.m_AngleStep = PIE_PI * 2.0f / (float)perimeterVertices;
 
-                const Matrix4& w = node_transforms[i];
+        float stopAngle = dmGui::GetNodePieFillAngle(scene, node);
+        shape.m_Backwards = false;
+        if (stopAngle < 0)
+        {
+            stopAngle = -stopAngle;
+            shape.m_Backwards = true;
+        }
 
-                // NOTE: The original rendering code is from the comp_sprite.cpp.
-                // Compare with that one if you do any changes to either.
-                uint32_t num_points = geometry->m_Vertices.m_Count / 2;
+        shape.m_StopAngle = dmMath::Min(360.0f, stopAngle) * PIE_PI / 180.0f;
 
-                const float* points = geometry->m_Vertices.m_Data;
-                const float* uvs = geometry->m_Uvs.m_Data;
+        // 1. Division computes number of cirlce segments needed, and we need 1 more
+        // vertex than that (1 lone segment = 2 perimeter vertices).
+        // 2. Round up because 48 deg fill drawn with 45 deg segmenst should be be rendered
+        // as 45+3. (Set limit to if segment exceeds more than 1/1000 to allow for some
+        // floating point imprecision)
+        shape.m_Generate = floorf(shape.m_StopAngle / shape.m_AngleStep + 0.999f) + 1;
+        return true;
+    }
 
-                // Depending on the sprite is flipped or not, we loop the vertices forward or backward
-                // to respect face winding (and backface culling)
-                int reverse = (int)flip_u ^ (int)flip_v;
+    // Number of vertices written by GeneratePieNodeVertices. Follows the same steps around the
+    // perimeter, including the extra vertices inserted at the corners of rectangular bounds.
+    static uint32_t GetPieNodeVertexCount(dmGui::HScene scene, dmGui::HNode node)
+    {
+        PieNodeShape shape;
+        if (!GetPieNodeShape(scene, node, shape))
+            return 0;
 
-                float scaleX = flip_u ? -1 : 1;
-                float scaleY = flip_v ? -1 : 1;
+        uint32_t steps = shape.m_Generate;
+        if (shape.m_OuterBounds == dmGui::PIEBOUNDS_RECTANGLE)
+        {
+            float lastAngle = 0;
+            float nextCorner = 0.25f * PIE_PI;
+            for (uint32_t j = 0; j != shape.m_Generate; j++)
+            {
+                float a;
+                if (j == (shape.m_Generate-1))
+                    a = shape.m_StopAngle;
+                else
+                    a = shape.m_AngleStep * j;
 
-                // Since we don't use an index buffer, we duplicate the vertices manually
-                uint32_t index_count = geometry->m_Indices.m_Count;
-                for (uint32_t index = 0; index < index_count; ++index)
+                if (lastAngle < nextCorner && a >= nextCorner)
                 {
-                    uint32_t i = geometry->m_Indices.m_Data[index];
-                    i = reverse ? (num_points - i - 1) : i;
-
-                    const float* point = &points[i * 2];
-                    const float* uv = &uvs[i * 2];
-                    // COnvert from range [-0.5,+0.5] to [0.0, 1.0]
-                    float x = point[0] * scaleX + 0.5f;
-                    float y = point[1] * scaleY + 0.5f;
-
-                    Vector4 p = w * Point3(x, y, 0.0f);
-                    BoxVertex v(p, uv[0], uv[1], pm_color);
-                    gui_world->m_ClientVertexBuffer.Push(v);
+                    a = nextCorner;
+                    nextCorner += 0.50f * PIE_PI;
+                    --j;
+                    ++steps;
                 }
 
-                rendered_vert_count += index_count;
-                continue;
+                lastAngle = a;
             }
+        }
+
+        uint32_t vertex_count = 2 * steps + 2;
+        assert(vertex_count <= ComputeRequiredVertices(dmGui::GetNodePerimeterVertices(scene, node)));
+        return vertex_count;
+    }
 
-            // render 9-sliced node
-
-            //   0 1     2 3
-            // 0 *-*-----*-*
-            //   | |  y  | |
-            // 1 *-*-----*-*
-            //   | |     | |
-            //   |x|     |z|
-            //   | |     | |
-            // 2 *-*-----*-*
-            //   | |  w  | |
-            // 3 *-*-----*-*
-            float us[4], vs[4], xs[4], ys[4];
-
-            // v are '1-v'
-            xs[0] = ys[0] = 0;
-            xs[3] = ys[3] = 1;
-
-            // disable slice9 computation below a certain dimension
-            // (avoid div by zero)
-            const float s9_min_dim = 0.001f;
-
-            const float su = 1.0f / org_width;
-            const float sv = 1.0f / org_height;
-
-            Point3 size = dmGui::GetNodeSize(scene, node);
-            const float sx = size.getX() > s9_min_dim ? 1.0f / size.getX() : 0;
-            const float sy = size.getY() > s9_min_dim ? 1.0f / size.getY() : 0;
-
-            static const uint32_t uvIndex[2][4] = {{0,1,2,3}, {3,2,1,0}};
-            bool uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
-            if(uv_rotated)
+    static BoxVertex* GeneratePieNodeVertices(dmGui::HScene scene, dmGui::HNode node, const Matrix4& transform, float opacity, BoxVertex* vb)
+    {
+        PieNodeShape shape;
+        if (!GetPieNodeShape(scene, node, shape))
+            return vb;
+
+        const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
+
+        // Pre-multiplied alpha
+        Vector4 pm_color(color.getXYZ(), opacity);
+
+        const Point3 size = dmGui::GetNodeSize(scene, node);
+        const float innerMultiplier = dmGui::GetNodeInnerRadius(scene, node) / size.getX();
+        const dmGui::PieBounds outerBounds = shape.m_OuterBounds;
+        const float ad = shape.m_AngleStep;
+        const float stopAngle = shape.m_StopAngle;
+        const bool backwards = shape.m_Backwards;
+        const uint32_t generate = shape.m_Generate;
+
+        float lastAngle = 0;
+        float nextCorner = 0.25f * PIE_PI; // upper right rectangle corner at 45 deg
+        bool first = true;
+
+        float u0,su,v0,sv;
+        bool uv_rotated;
+        const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
+        if(tc)
+        {
+            bool flip_u, flip_v;
+            GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
+            uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
+            if(uv_rotated ? flip_v : flip_u)
+            {
+                su = -(tc[4] - tc[0]);
+                u0 = tc[0] - su;
+            }
+            else
+            {
+                u0 = tc[0];
+                su = tc[4] - u0;
+            }
+            uint32_t v0i = uv_rotated ? 1 : 3;
+            uint32_t v1i = uv_rotated ? 5 : 1;
+            if(uv_rotated ? flip_u : flip_v)
             {
-                const uint32_t *uI = flip_v ? uvIndex[1] : uvIndex[0];
-                const uint32_t *vI = flip_u ? uvIndex[1] : uvIndex[0];
-                us[uI[0]] = tc[0];
-                us[uI[1]] = tc[0] + (su * slice9.getW());
-                us[uI[2]] = tc[2] - (su * slice9.getY());
-                us[uI[3]] = tc[2];
-                vs[vI[0]] = tc[1];
-                vs[vI[1]] = tc[1] - (sv * slice9.getX());
-                vs[vI[2]] = tc[5] + (sv * slice9.getZ());
-                vs[vI[3]] = tc[5];
+                sv = -(tc[v1i] - tc[v0i]);
+                v0 = tc[v0i] - sv;
             }
             else
             {
-                const uint32_t *uI = flip_u ? uvIndex[1] : uvIndex[0];
-                const uint32_t *vI = flip_v ? uvIndex[1] : uvIndex[0];
-                us[uI[0]] = tc[0];
-                us[uI[1]] = tc[0] + (su * slice9.getX());
-                us[uI[2]] = tc[4] - (su * slice9.getZ());
-                us[uI[3]] = tc[4];
-                vs[vI[0]] = tc[1];
-                vs[vI[1]] = tc[1] + (sv * slice9.getW());
-                vs[vI[2]] = tc[3] - (sv * slice9.getY());
-                vs[vI[3]] = tc[3];
+                v0 = tc[v0i];
+                sv = tc[v1i] - v0;
             }
+        }
+        else
+        {
+            uv_rotated = false;
+            u0 = 0.0f;
+            su = 1.0f;
+            v0 = 1.0f;
+            sv = -1.0f;
+        }
 
-            xs[1] = sx * slice9.getX();
-            xs[2] = 1 - sx * slice9.getZ();
-            ys[1] = sy * slice9.getW();
-            ys[2] = 1 - sy * slice9.getY();
+        for (uint32_t j = 0; j != generate; j++)
+        {
+            float a;
+            if (j == (generate-1))
+                a = stopAngle;
+            else
+                a = ad * j;
 
-            const Matrix4* transform = &node_transforms[i];
-            Vectormath::Aos::Vector4 pts[4][4];
-            for (int y=0;y<4;y++)
+            if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
             {
-                for (int x=0;x<4;x++)
+                // insert extra vertex (and ignore == case)
+                if (lastAngle < nextCorner && a >= nextCorner)
                 {
-                    pts[y][x] = (*transform * Vectormath::Aos::Point3(xs[x], ys[y], 0));
+                    a = nextCorner;
+                    nextCorner += 0.50f * PIE_PI;
+                    --j;
                 }
+
+                lastAngle = a;
             }
 
-            BoxVertex v00, v10, v01, v11;
-            v00.SetColor(pm_color);
-            v10.SetColor(pm_color);
-            v01.SetColor(pm_color);
-            v11.SetColor(pm_color);
-            for (int y=0;y<3;y++)
+            const float s = dmTrigLookup::Sin(backwards ? -a : a);
+            const float c = dmTrigLookup::Cos(backwards ? -a : a);
+
+            // make inner vertex
+            float u = 0.5f + innerMultiplier * c;
+            float v = 0.5f + innerMultiplier * s;
+            BoxVertex vInner(transform * Vectormath::Aos::Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
+
+            // make outer vertex
+            float d;
+            if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
+                d = 0.5f / dmMath::Max(dmMath::Abs(s), dmMath::Abs(c));
+            else
+                d = 0.5f;
+
+            u = 0.5f + d * c;
+            v = 0.5f + d * s;
+            BoxVertex vOuter(transform * Vectormath::Aos::Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
+
+            // both inner & outer are doubled at first / last entry to generate degenerate triangles
+            // for the triangle strip, allowing more than one pie to be chained together in the same
+            // drawcall.
+            if (first)
             {
-                for (int x=0;x<3;x++)
-                {
-                    const int x0 = x;
-                    const int x1 = x+1;
-                    const int y0 = y;
-                    const int y1 = y+1;
-                    v00.SetPosition(pts[y0][x0]);
-                    v10.SetPosition(pts[y0][x1]);
-                    v01.SetPosition(pts[y1][x0]);
-                    v11.SetPosition(pts[y1][x1]);
-                    if(uv_rotated)
-                    {
-                        v00.SetUV(us[y0], vs[x0]);
-                        v10.SetUV(us[y0], vs[x1]);
-                        v01.SetUV(us[y1], vs[x0]);
-                        v11.SetUV(us[y1], vs[x1]);
-                    }
-                    else
-                    {
-                        v00.SetUV(us[x0], vs[y0]);
-                        v10.SetUV(us[x1], vs[y0]);
-                        v01.SetUV(us[x0], vs[y1]);
-                        v11.SetUV(us[x1], vs[y1]);
-                    }
-                    gui_world->m_ClientVertexBuffer.Push(v00);
-                    gui_world->m_ClientVertexBuffer.Push(v10);
-                    gui_world->m_ClientVertexBuffer.Push(v11);
-                    gui_world->m_ClientVertexBuffer.Push(v00);
-                    gui_world->m_ClientVertexBuffer.Push(v11);
-                    gui_world->m_ClientVertexBuffer.Push(v01);
-                }
+                *vb++ = vInner;
+                first = false;
             }
-            rendered_vert_count += verts_per_node;
-        }
 
-        ro.m_VertexCount = rendered_vert_count;
-    }
+            *vb++ = vInner;
+            *vb++ = vOuter;
 
-    // Computes max vertices required in the vertex buffer to draw a pie node with a
-    // given number of perimeter vertices in its configuration.
-    inline uint32_t ComputeRequiredVertices(uint32_t perimeter_vertices)
-    {
-        // 1.  Minimum is capped to 4
-        // 2a. There will always be one extra needed to complete a full fill.
-        //     I.e. an 8-gon will need 9 vertices around, where the first and last
-        //     overlap. (+1)
-        // 2b. If the shape has rectangular bounds and pass through all four corners,
-        //     there will be 4 vertices inserted around the loop. (+4)
-        // 3.  Each vertex around the perimeter has its twin along the inside (*2)
-        // 4.  To draw all pie nodes in one draw call as a strip, each pie adds two
-        //     doubled vertices to tie it together (+2)
-        return 2 * (dmMath::Max<uint32_t>(perimeter_vertices, 4) + 5) + 2;
+            if (j == generate-1)
+                *vb++ = vOuter;
+        }
+        return vb;
     }
 
     void RenderPieNodes(dmGui::HScene scene,
@@ -1407,158 +1669,48 @@ namespace dmGameSystem
         else
             ro.m_Textures[0] = gui_world->m_WhiteTexture;
 
-        uint32_t max_total_vertices = 0;
-        for (uint32_t i = 0; i < node_count; ++i)
-        {
-            max_total_vertices += ComputeRequiredVertices(dmGui::GetNodePerimeterVertices(scene, entries[i].m_Node));
-        }
-
-        if (gui_world->m_ClientVertexBuffer.Remaining() < max_total_vertices) {
-            gui_world->m_ClientVertexBuffer.OffsetCapacity(dmMath::Max(128U, max_total_vertices));
-        }
-
-        for (uint32_t i = 0; i < node_count; ++i)
+        // The vertices are only counted and reserved here, they are generated at the end of RenderNodes
+        for (uint32_t job_start = 0; job_start < node_count; )
         {
-            const dmGui::HNode node = entries[i].m_Node;
-            const Point3 size = dmGui::GetNodeSize(scene, node);
-
-            if (dmGui::GetNodeIsBone(scene, node) || dmMath::Abs(size.getX()) < 0.001f)
-                continue;
-
-            const Vector4& color = dmGui::GetNodeProperty(scene, node, dmGui::PROPERTY_COLOR);
-
-            // Pre-multiplied alpha
-            Vector4 pm_color(color.getXYZ(), node_opacities[i]);
-
-            const uint32_t perimeterVertices = dmMath::Max<uint32_t>(4, dmGui::GetNodePerimeterVertices(scene, node));
-            const float innerMultiplier = dmGui::GetNodeInnerRadius(scene, node) / size.getX();
-            const dmGui::PieBounds outerBounds = dmGui::GetNodeOuterBounds(scene, node);
-
-            const float PI = 3.1415926535f;
-            const float ad = PI * 2.0f / (float)perimeterVertices;
-
-            float stopAngle = dmGui::GetNodePieFillAngle(scene, node);
-            bool backwards = false;
-            if (stopAngle < 0)
+            uint32_t job_end = job_start + dmMath::Min(node_count - job_start, VERTEX_JOB_MAX_NODES);
+            uint32_t vertex_count = 0;
+            for (uint32_t i = job_start; i < job_end; ++i)
             {
-                stopAngle = -stopAngle;
-                backwards = true;
+                vertex_count += GetPieNodeVertexCount(scene, entries[i].m_Node);
             }
+            PushVertexJob(gui_world, scene, node_type, entries + job_start, node_transforms + job_start, node_opacities + job_start,
+                          job_end - job_start, texture, 0.0f, 0.0f, vertex_count);
+            job_start = job_end;
+        }
 
-            stopAngle = dmMath::Min(360.0f, stopAngle) * PI / 180.0f;
-
-            // 1. Division computes number of cirlce segments needed, and we need 1 more
-            // vertex than that (1 lone segment = 2 perimeter vertices).
-            // 2. Round up because 48 deg fill drawn with 45 deg segmenst should be be rendered
-            // as 45+3. (Set limit to if segment exceeds more than 1/1000 to allow for some
-            // floating point imprecision)
-            const uint32_t generate = floorf(stopAngle / ad + 0.999f) + 1;
-
-            float lastAngle = 0;
-            float nextCorner = 0.25f * PI; // upper right rectangle corner at 45 deg
-            bool first = true;
-
-            float u0,su,v0,sv;
-            bool uv_rotated;
-            const float* tc = dmGui::GetNodeFlipbookAnimUV(scene, node);
-            if(tc)
-            {
-                bool flip_u, flip_v;
-                GetNodeFlipbookAnimUVFlip(scene, node, flip_u, flip_v);
-                uv_rotated = tc[0] != tc[2] && tc[3] != tc[5];
-                if(uv_rotated ? flip_v : flip_u)
-                {
-                    su = -(tc[4] - tc[0]);
-                    u0 = tc[0] - su;
-                }
-                else
-                {
-                    u0 = tc[0];
-                    su = tc[4] - u0;
-                }
-                uint32_t v0i = uv_rotated ? 1 : 3;
-                uint32_t v1i = uv_rotated ? 5 : 1;
-                if(uv_rotated ? flip_u : flip_v)
-                {
-                    sv = -(tc[v1i] - tc[v0i]);
-                    v0 = tc[v0i] - sv;
-                }
-                else
-                {
-                    v0 = tc[v0i];
-                    sv = tc[v1i] - v0;
-                }
-            }
-            else
-            {
-                uv_rotated = false;
-                u0 = 0.0f;
-                su = 1.0f;
-                v0 = 1.0f;
-                sv = -1.0f;
-            }
+        ro.m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - ro.m_VertexStart;
+    }
 
-            uint32_t sizeBefore = gui_world->m_ClientVertexBuffer.Size();
-            for (uint32_t j = 0; j != generate; j++)
+    static void GenerateVertexDataRange(void* context, uint32_t start, uint32_t end)
+    {
+        GuiWorld* gui_world = (GuiWorld*) context;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            const GuiVertexJob& job = gui_world->m_VertexJobs[i];
+            BoxVertex* vb_begin = gui_world->m_ClientVertexBuffer.Begin() + job.m_VertexStart;
+            BoxVertex* vb_end = vb_begin;
+            for (uint32_t n = 0; n < job.m_NodeCount; ++n)
             {
-                float a;
-                if (j == (generate-1))
-                    a = stopAngle;
+                if (job.m_NodeType == dmGui::NODE_TYPE_BOX)
+                    vb_end = GenerateBoxNodeVertices(job.m_Scene, job.m_Entries[n].m_Node, job.m_Texture, job.m_OrgWidth, job.m_OrgHeight, job.m_NodeTransforms[n], job.m_NodeOpacities[n], vb_end);
                 else
-                    a = ad * j;
-
-                if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
-                {
-                    // insert extra vertex (and ignore == case)
-                    if (lastAngle < nextCorner && a >= nextCorner)
-                    {
-                        a = nextCorner;
-                        nextCorner += 0.50f * PI;
-                        --j;
-                    }
-
-                    lastAngle = a;
-                }
-
-                const float s = dmTrigLookup::Sin(backwards ? -a : a);
-                const float c = dmTrigLookup::Cos(backwards ? -a : a);
-
-                // make inner vertex
-                float u = 0.5f + innerMultiplier * c;
-                float v = 0.5f + innerMultiplier * s;
-                BoxVertex vInner(node_transforms[i] * Vectormath::Aos::Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
-
-                // make outer vertex
-                float d;
-                if (outerBounds == dmGui::PIEBOUNDS_RECTANGLE)
-                    d = 0.5f / dmMath::Max(dmMath::Abs(s), dmMath::Abs(c));
-                else
-                    d = 0.5f;
-
-                u = 0.5f + d * c;
-                v = 0.5f + d * s;
-                BoxVertex vOuter(node_transforms[i] * Vectormath::Aos::Point3(u,v,0), u0 + ((uv_rotated ? v : u) * su), v0 + ((uv_rotated ? u : 1-v) * sv), pm_color);
-
-                // both inner & outer are doubled at first / last entry to generate degenerate triangles
-                // for the triangle strip, allowing more than one pie to be chained together in the same
-                // drawcall.
-                if (first)
-                {
-                    gui_world->m_ClientVertexBuffer.Push(vInner);
-                    first = false;
-                }
-
-                gui_world->m_ClientVertexBuffer.Push(vInner);
-                gui_world->m_ClientVertexBuffer.Push(vOuter);
-
-                if (j == generate-1)
-                    gui_world->m_ClientVertexBuffer.Push(vOuter);
+                    vb_end = GeneratePieNodeVertices(job.m_Scene, job.m_Entries[n].m_Node, job.m_NodeTransforms[n], job.m_NodeOpacities[n], vb_end);
             }
-
-            assert((gui_world->m_ClientVertexBuffer.Size() - sizeBefore) <= ComputeRequiredVertices(dmGui::GetNodePerimeterVertices(scene, entries[i].m_Node)));
+            assert((uint32_t)(vb_end - vb_begin) == job.m_VertexCount);
         }
+    }
 
-        ro.m_VertexCount = gui_world->m_ClientVertexBuffer.Size() - ro.m_VertexStart;
+    // Runs the box and pie node vertex jobs, on the worker pool if there is one
+    static void GenerateVertexData(GuiWorld* gui_world)
+    {
+        DM_PROFILE(Gui, "GenerateVertexData");
+        dmWorkerPool::ParallelFor(gui_world->m_WorkerPool, GenerateVertexDataRange, gui_world, gui_world->m_VertexJobs.Size(), 1);
+        gui_world->m_VertexJobs.SetSize(0);
     }
 
     void RenderNodes(dmGui::HScene scene,
@@ -1681,6 +1833,8 @@ namespace dmGameSystem
             }
         }
 
+        GenerateVertexData(gui_world);
+
         dmGraphics::SetVertexBufferData(gui_world->m_VertexBuffer,
                                         gui_world->m_ClientVertexBuffer.Size() * sizeof(BoxVertex),
                                         gui_world->m_ClientVertexBuffer.Begin(),
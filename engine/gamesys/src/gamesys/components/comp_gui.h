@@ -79,6 +79,22 @@ namespace dmGameSystem
         uint32_t m_SortOrder;
     };
 
+    // A range of box or pie nodes whose vertices are generated in one go, into a reserved part of the client vertex buffer
+    struct GuiVertexJob
+    {
+        dmGui::HScene                    m_Scene;
+        const dmGui::RenderEntry*        m_Entries;
+        const Vectormath::Aos::Matrix4*  m_NodeTransforms;
+        const float*                     m_NodeOpacities;
+        dmGraphics::HTexture             m_Texture;
+        float                            m_OrgWidth;
+        float                            m_OrgHeight;
+        uint32_t                         m_NodeCount;
+        uint32_t                         m_VertexStart;     // Offset, since the client vertex buffer may grow before the job is run
+        uint32_t                         m_VertexCount;
+        dmGui::NodeType                  m_NodeType;
+    };
+
     struct GuiWorld
     {
         dmArray<GuiRenderObject>         m_GuiRenderObjects;
@@ -86,6 +102,8 @@ namespace dmGameSystem
         dmGraphics::HVertexDeclaration   m_VertexDeclaration;
         dmGraphics::HVertexBuffer        m_VertexBuffer;
         dmArray<BoxVertex>               m_ClientVertexBuffer;
+        dmArray<GuiVertexJob>            m_VertexJobs;
+        dmWorkerPool::HWorkerPool        m_WorkerPool;
         dmGraphics::HTexture             m_WhiteTexture;
         dmParticle::HParticleContext     m_ParticleContext;
         uint32_t                         m_MaxParticleFXCount;
@@ -755,10 +755,8 @@ namespace dmGameSystem
         component->m_ReHash = 1;
     }
 
-    dmGameObject::UpdateResult CompModelOnMessage(const dmGameObject::ComponentOnMessageParams& params)
+    static void HandleMessage(ModelComponent* component, const dmGameObject::ComponentOnMessageParams& params)
     {
-        ModelWorld* world = (ModelWorld*)params.m_World;
-        ModelComponent* component = world->m_Components.Get(*params.m_UserData);
         if (params.m_Message->m_Id == dmGameObjectDDF::Enable::m_DDFDescriptor->m_NameHash)
         {
             component->m_Enabled = 1;
@@ -807,6 +805,25 @@ namespace dmGameSystem
                 }
             }
         }
+    }
+
+    dmGameObject::UpdateResult CompModelOnMessage(const dmGameObject::ComponentOnMessageParams& params)
+    {
+        ModelWorld* world = (ModelWorld*)params.m_World;
+        ModelComponent* component = world->m_Components.Get(*params.m_UserData);
+        HandleMessage(component, params);
+        return dmGameObject::UPDATE_RESULT_OK;
+    }
+
+    dmGameObject::UpdateResult CompModelOnMessageBatch(const dmGameObject::ComponentsOnMessageBatchParams& params)
+    {
+        ModelWorld* world = (ModelWorld*)params.m_World;
+        const dmGameObject::ComponentOnMessageParams* messages = params.m_Messages;
+        for (uint32_t i = 0; i < params.m_MessageCount; ++i)
+        {
+            ModelComponent* component = world->m_Components.Get(*messages[i].m_UserData);
+            HandleMessage(component, messages[i]);
+        }
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
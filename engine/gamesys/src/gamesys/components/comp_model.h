@@ -44,6 +44,8 @@ namespace dmGameSystem
 
     dmGameObject::UpdateResult CompModelOnMessage(const dmGameObject::ComponentOnMessageParams& params);
 
+    dmGameObject::UpdateResult CompModelOnMessageBatch(const dmGameObject::ComponentsOnMessageBatchParams& params);
+
     void CompModelOnReload(const dmGameObject::ComponentOnReloadParams& params);
 
     dmGameObject::PropertyResult CompModelGetProperty(const dmGameObject::ComponentGetPropertyParams& params, dmGameObject::PropertyDesc& out_value);
@@ -67,6 +67,7 @@ namespace dmGameSystem
         dmParticle::HParticleContext m_ParticleContext;
         dmGraphics::HVertexBuffer m_VertexBuffer;
         dmArray<dmParticle::Vertex> m_VertexBufferData;
+        dmArray<dmParticle::EmitterRenderData*> m_BatchRenderData;
         dmGraphics::HVertexDeclaration m_VertexDeclaration;
         uint32_t m_EmitterCount;
         float m_DT;
@@ -82,6 +83,7 @@ namespace dmGameSystem
         world->m_Context = ctx;
         uint32_t particle_fx_count = ctx->m_MaxParticleFXCount;
         world->m_ParticleContext = dmParticle::CreateContext(particle_fx_count, ctx->m_MaxParticleCount);
+        dmParticle::SetWorkerPool(world->m_ParticleContext, ctx->m_WorkerPool);
         world->m_Components.SetCapacity(particle_fx_count);
         world->m_RenderObjects.SetCapacity(particle_fx_count);
         world->m_Prototypes.SetCapacity(particle_fx_count);
@@ -236,11 +238,18 @@ namespace dmGameSystem
         uint32_t vb_size = vb_size_init;
         uint32_t vb_max_size =  dmParticle::GetVertexBufferSize(pfx_context->m_MaxParticleCount, dmParticle::PARTICLE_GO);
 
+        dmArray<dmParticle::EmitterRenderData*>& batch = pfx_world->m_BatchRenderData;
+        uint32_t batch_count = end - begin;
+        if (batch.Capacity() < batch_count)
+        {
+            batch.SetCapacity(batch_count);
+        }
+        batch.SetSize(0);
         for (uint32_t *i = begin; i != end; ++i)
         {
-            const dmParticle::EmitterRenderData* emitter_render_data = (dmParticle::EmitterRenderData*) buf[*i].m_UserData;
-            dmParticle::GenerateVertexData(particle_context, pfx_world->m_DT, emitter_render_data->m_Instance, emitter_render_data->m_EmitterIndex, Vector4(1,1,1,1), (void*)vertex_buffer.Begin(), vb_max_size, &vb_size, dmParticle::PARTICLE_GO);
+            batch.Push((dmParticle::EmitterRenderData*) buf[*i].m_UserData);
         }
+        dmParticle::GenerateVertexDataBatch(particle_context, pfx_world->m_DT, batch.Begin(), batch_count, Vector4(1,1,1,1), (void*)vertex_buffer.Begin(), vb_max_size, &vb_size, dmParticle::PARTICLE_GO);
 
         vb_end = (vb_begin + (vb_size - vb_size_init) / sizeof(dmParticle::Vertex));
 
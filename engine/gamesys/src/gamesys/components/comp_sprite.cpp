@@ -24,6 +24,7 @@
 #include <dlib/dstrings.h>
 #include <dlib/object_pool.h>
 #include <dlib/math.h>
+#include <dlib/worker_pool.h>
 #include <graphics/graphics.h>
 #include <render/render.h>
 #include <gameobject/gameobject_ddf.h>
@@ -86,6 +87,35 @@ namespace dmGameSystem
         float v;
     };
 
+    // Per sprite record of the instanced path (materials with VERTEX_SPACE_INSTANCE).
+    // The vertex program reconstructs the corners of the unit quad from it.
+    struct SpriteInstance
+    {
+        float m_WorldX[3];      // World matrix column 0
+        float m_WorldY[3];      // World matrix column 1
+        float m_WorldT[3];      // World matrix column 3
+        float m_TexCoord[4];    // Texture coordinate at the quad center (xy) and its delta along local x (zw)
+        float m_TexCoordY[2];   // Texture coordinate delta along local y
+    };
+
+    // Used when the graphics context lacks instancing, each sprite is expanded to 6 of these
+    struct SpriteInstanceVertex
+    {
+        float           m_Position[2];
+        SpriteInstance  m_Instance;
+    };
+
+    // A range of sprites whose vertices are generated in one go, into a reserved part of the vertex and index buffers
+    struct SpriteVertexJob
+    {
+        SpriteVertex*               m_Vertices;
+        uint8_t*                    m_Indices;
+        TextureSetResource*         m_TextureSet;
+        dmRender::RenderListEntry*  m_Buf;
+        uint32_t*                   m_Begin;
+        uint32_t*                   m_End;
+    };
+
     struct SpriteWorld
     {
         dmObjectPool<SpriteComponent>   m_Components;
@@ -97,9 +127,20 @@ namespace dmGameSystem
         dmGraphics::HIndexBuffer        m_IndexBuffer;
         uint8_t*                        m_IndexBufferData;
         uint8_t*                        m_IndexBufferWritePtr;
+        dmArray<SpriteVertexJob>        m_VertexJobs;
+        dmWorkerPool::HWorkerPool       m_WorkerPool;
+        // Instanced path, allocated the first time a sprite with an instanced material is rendered
+        dmGraphics::HVertexDeclaration  m_QuadVertexDeclaration;
+        dmGraphics::HVertexDeclaration  m_InstanceDeclaration;
+        dmGraphics::HVertexBuffer       m_QuadVertexBuffer;
+        dmGraphics::HIndexBuffer        m_QuadIndexBuffer;
+        dmGraphics::HVertexBuffer       m_InstanceBuffer;
+        uint8_t*                        m_InstanceBufferData;       // SpriteInstance, or SpriteInstanceVertex without instancing support
+        uint8_t*                        m_InstanceBufferWritePtr;
         uint8_t                         m_Is16BitIndex : 1;
         uint8_t                         m_UseGeometries : 1;
         uint8_t                         m_ReallocBuffers : 1;
+        uint8_t                         m_InstancingSupported : 1;
     };
 
     DM_GAMESYS_PROP_VECTOR3(SPRITE_PROP_SCALE, scale, false);
@@ -113,6 +154,23 @@ namespace dmGameSystem
     static float GetPlaybackRate(SpriteComponent* component);
     static void SetPlaybackRate(SpriteComponent* component, float playback_rate);
 
+    // Texture coordinate lookup per flip mode (none, h, v, hv)
+    static const int tex_coord_order[] = {
+        0,1,2,2,3,0,
+        3,2,1,1,0,3,    //h
+        1,0,3,3,2,1,    //v
+        2,3,0,0,1,2     //hv
+    };
+
+    // Corners of the unit quad, in the order of the quad vertices of CreateVertexData
+    static const float quad_positions[] = {
+        -0.5f, -0.5f,
+        -0.5f,  0.5f,
+         0.5f,  0.5f,
+         0.5f, -0.5f,
+    };
+    static const uint16_t quad_indices[] = {0, 1, 2, 2, 3, 0};
+
     template<typename T>
     void fillIndices(T* index, uint32_t indices_count) {
         for(uint32_t i = 0, v = 0; i < indices_count; i += 6, v += 4)
@@ -169,6 +227,41 @@ namespace dmGameSystem
         sprite_world->m_ReallocBuffers = 0;
     }
 
+    static void AllocateInstanceBuffers(SpriteWorld* sprite_world, dmGraphics::HContext graphics_context)
+    {
+        // The per instance streams, in the layout of SpriteInstance
+        dmGraphics::VertexElement instance_ve[] =
+        {
+                {"position", 0, 2, dmGraphics::TYPE_FLOAT, false},
+                {"instance_world_x", 1, 3, dmGraphics::TYPE_FLOAT, false},
+                {"instance_world_y", 2, 3, dmGraphics::TYPE_FLOAT, false},
+                {"instance_world_t", 3, 3, dmGraphics::TYPE_FLOAT, false},
+                {"instance_texcoord", 4, 4, dmGraphics::TYPE_FLOAT, false},
+                {"instance_texcoord_y", 5, 2, dmGraphics::TYPE_FLOAT, false},
+        };
+
+        uint32_t max_sprite_count = sprite_world->m_Components.Capacity();
+        uint32_t memsize;
+        if (sprite_world->m_InstancingSupported)
+        {
+            sprite_world->m_QuadVertexDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, instance_ve, 1);
+            sprite_world->m_QuadVertexBuffer = dmGraphics::NewVertexBuffer(graphics_context, sizeof(quad_positions), quad_positions, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+            sprite_world->m_QuadIndexBuffer = dmGraphics::NewIndexBuffer(graphics_context, sizeof(quad_indices), quad_indices, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+            sprite_world->m_InstanceDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, instance_ve + 1, DM_ARRAY_SIZE(instance_ve) - 1);
+            memsize = sizeof(SpriteInstance) * max_sprite_count;
+        }
+        else
+        {
+            // The quad corner and the instance streams are interleaved per vertex
+            sprite_world->m_InstanceDeclaration = dmGraphics::NewVertexDeclaration(graphics_context, instance_ve, DM_ARRAY_SIZE(instance_ve));
+            memsize = sizeof(SpriteInstanceVertex) * DM_ARRAY_SIZE(quad_indices) * max_sprite_count;
+        }
+
+        sprite_world->m_InstanceBuffer = dmGraphics::NewVertexBuffer(graphics_context, 0, 0x0, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+        sprite_world->m_InstanceBufferData = (uint8_t*) malloc(memsize);
+        sprite_world->m_InstanceBufferWritePtr = sprite_world->m_InstanceBufferData;
+    }
+
     dmGameObject::CreateResult CompSpriteNewWorld(const dmGameObject::ComponentNewWorldParams& params)
     {
         SpriteContext* sprite_context = (SpriteContext*)params.m_Context;
@@ -191,9 +284,19 @@ namespace dmGameSystem
         sprite_world->m_VertexBufferData = 0;
         sprite_world->m_IndexBuffer = 0;
         sprite_world->m_IndexBufferData = 0;
+        sprite_world->m_WorkerPool = sprite_context->m_WorkerPool;
+
+        sprite_world->m_QuadVertexDeclaration = 0;
+        sprite_world->m_InstanceDeclaration = 0;
+        sprite_world->m_QuadVertexBuffer = 0;
+        sprite_world->m_QuadIndexBuffer = 0;
+        sprite_world->m_InstanceBuffer = 0;
+        sprite_world->m_InstanceBufferData = 0;
+        sprite_world->m_InstanceBufferWritePtr = 0;
 
         sprite_world->m_UseGeometries = 0;
         sprite_world->m_ReallocBuffers = 1;
+        sprite_world->m_InstancingSupported = dmGraphics::IsInstancingSupported(dmRender::GetGraphicsContext(render_context));
 
         *params.m_World = sprite_world;
         return dmGameObject::CREATE_RESULT_OK;
@@ -208,6 +311,19 @@ namespace dmGameSystem
         dmGraphics::DeleteIndexBuffer(sprite_world->m_IndexBuffer);
         free(sprite_world->m_IndexBufferData);
 
+        if (sprite_world->m_InstanceBuffer)
+        {
+            if (sprite_world->m_QuadVertexDeclaration)
+            {
+                dmGraphics::DeleteVertexDeclaration(sprite_world->m_QuadVertexDeclaration);
+                dmGraphics::DeleteVertexBuffer(sprite_world->m_QuadVertexBuffer);
+                dmGraphics::DeleteIndexBuffer(sprite_world->m_QuadIndexBuffer);
+            }
+            dmGraphics::DeleteVertexDeclaration(sprite_world->m_InstanceDeclaration);
+            dmGraphics::DeleteVertexBuffer(sprite_world->m_InstanceBuffer);
+            free(sprite_world->m_InstanceBufferData);
+        }
+
         delete sprite_world;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -472,13 +588,6 @@ namespace dmGameSystem
         }
         else // original path using quads
         {
-            static int tex_coord_order[] = {
-                0,1,2,2,3,0,
-                3,2,1,1,0,3,    //h
-                1,0,3,3,2,1,    //v
-                2,3,0,0,1,2     //hv
-            };
-
             const float* tex_coords = (const float*) texture_set->m_TextureSet->m_TexCoords.m_Data;
 
             for (uint32_t *i = begin;i != end; ++i)
@@ -546,6 +655,193 @@ namespace dmGameSystem
         *ib_where = indices;
     }
 
+    // Largest number of sprites in a vertex job
+    static const uint32_t VERTEX_JOB_MAX_SPRITES = 256;
+
+    static void PushVertexJob(SpriteWorld* sprite_world, TextureSetResource* texture_set, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
+    {
+        if (sprite_world->m_VertexJobs.Full())
+        {
+            sprite_world->m_VertexJobs.OffsetCapacity(64);
+        }
+        SpriteVertexJob job;
+        job.m_Vertices = sprite_world->m_VertexBufferWritePtr;
+        job.m_Indices = sprite_world->m_IndexBufferWritePtr;
+        job.m_TextureSet = texture_set;
+        job.m_Buf = buf;
+        job.m_Begin = begin;
+        job.m_End = end;
+        sprite_world->m_VertexJobs.Push(job);
+    }
+
+    // Reserves the vertices and indices of a batch and splits it into jobs. The vertices are generated
+    // at the end of the dispatch, see GenerateVertexData.
+    static void ReserveVertexData(SpriteWorld* sprite_world, TextureSetResource* texture_set, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
+    {
+        DM_PROFILE(Sprite, "ReserveVertexData");
+
+        uint32_t index_type_size = sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
+
+        dmGameSystemDDF::TextureSet* texture_set_ddf = texture_set->m_TextureSet;
+        dmGameSystemDDF::TextureSetAnimation* animations = texture_set_ddf->m_Animations.m_Data;
+        uint32_t* frame_indices = texture_set_ddf->m_FrameIndices.m_Data;
+        const dmGameSystemDDF::SpriteGeometry* geometries = texture_set_ddf->m_Geometries.m_Data;
+
+        for (uint32_t* job_begin = begin; job_begin != end; )
+        {
+            uint32_t* job_end = job_begin + dmMath::Min<uint32_t>(end - job_begin, VERTEX_JOB_MAX_SPRITES);
+            PushVertexJob(sprite_world, texture_set, buf, job_begin, job_end);
+
+            if (sprite_world->m_UseGeometries)
+            {
+                for (uint32_t* i = job_begin; i != job_end; ++i)
+                {
+                    const SpriteComponent* component = (SpriteComponent*) buf[*i].m_UserData;
+                    const dmGameSystemDDF::TextureSetAnimation* animation_ddf = &animations[component->m_AnimationID];
+                    uint32_t frame_index = frame_indices[animation_ddf->m_Start + component->m_CurrentAnimationFrame];
+                    const dmGameSystemDDF::SpriteGeometry* geometry = &geometries[frame_index];
+                    sprite_world->m_VertexBufferWritePtr += geometry->m_Vertices.m_Count / 2;
+                    sprite_world->m_IndexBufferWritePtr += geometry->m_Indices.m_Count * index_type_size;
+                }
+            }
+            else
+            {
+                sprite_world->m_VertexBufferWritePtr += (job_end - job_begin) * 4;
+                sprite_world->m_IndexBufferWritePtr += (job_end - job_begin) * 6 * index_type_size;
+            }
+            job_begin = job_end;
+        }
+    }
+
+    static void GenerateVertexDataRange(void* context, uint32_t start, uint32_t end)
+    {
+        SpriteWorld* sprite_world = (SpriteWorld*) context;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            SpriteVertexJob& job = sprite_world->m_VertexJobs[i];
+            CreateVertexData(sprite_world, &job.m_Vertices, &job.m_Indices, job.m_TextureSet, job.m_Buf, job.m_Begin, job.m_End);
+        }
+    }
+
+    // Runs the vertex jobs of the frame, on the worker pool if there is one
+    static void GenerateVertexData(SpriteWorld* sprite_world)
+    {
+        DM_PROFILE(Sprite, "GenerateVertexData");
+        dmWorkerPool::ParallelFor(sprite_world->m_WorkerPool, GenerateVertexDataRange, sprite_world, sprite_world->m_VertexJobs.Size(), 1);
+        sprite_world->m_VertexJobs.SetSize(0);
+    }
+
+    static void CreateInstanceData(SpriteWorld* sprite_world, TextureSetResource* texture_set, dmRender::RenderListEntry* buf, uint32_t* begin, uint32_t* end)
+    {
+        DM_PROFILE(Sprite, "CreateInstanceData");
+
+        dmGameSystemDDF::TextureSetAnimation* animations = texture_set->m_TextureSet->m_Animations.m_Data;
+        const float* tex_coords = (const float*) texture_set->m_TextureSet->m_TexCoords.m_Data;
+        uint8_t* write_ptr = sprite_world->m_InstanceBufferWritePtr;
+
+        for (uint32_t *i = begin;i != end; ++i)
+        {
+            const SpriteComponent* component = (SpriteComponent*) buf[*i].m_UserData;
+
+            dmGameSystemDDF::TextureSetAnimation* animation_ddf = &animations[component->m_AnimationID];
+
+            // Trimmed frames (geometries) are drawn as their quads
+            uint32_t frame_index = animation_ddf->m_Start + component->m_CurrentAnimationFrame;
+            const float* tc = &tex_coords[frame_index * 4 * 2];
+            uint32_t flip_flag = 0;
+            if (animation_ddf->m_FlipHorizontal ^ component->m_FlipHorizontal)
+            {
+                flip_flag = 1;
+            }
+            if (animation_ddf->m_FlipVertical ^ component->m_FlipVertical)
+            {
+                flip_flag |= 2;
+            }
+
+            // Texture coordinates of the four quad corners, see CreateVertexData
+            const int* tex_lookup = &tex_coord_order[flip_flag * 6];
+            const float* uv0 = &tc[tex_lookup[0] * 2];
+            const float* uv1 = &tc[tex_lookup[1] * 2];
+            const float* uv2 = &tc[tex_lookup[2] * 2];
+            const float* uv3 = &tc[tex_lookup[4] * 2];
+
+            const Matrix4& w = component->m_World;
+            const Vector4 x = w.getCol0();
+            const Vector4 y = w.getCol1();
+            const Vector4 t = w.getCol3();
+
+            // The frame is a parallelogram in texture space (possibly rotated in the atlas),
+            // which makes the texture coordinate affine in the local quad position.
+            SpriteInstance instance;
+            instance.m_WorldX[0] = x.getX();
+            instance.m_WorldX[1] = x.getY();
+            instance.m_WorldX[2] = x.getZ();
+            instance.m_WorldY[0] = y.getX();
+            instance.m_WorldY[1] = y.getY();
+            instance.m_WorldY[2] = y.getZ();
+            instance.m_WorldT[0] = t.getX();
+            instance.m_WorldT[1] = t.getY();
+            instance.m_WorldT[2] = t.getZ();
+            instance.m_TexCoord[0] = (uv0[0] + uv2[0]) * 0.5f;
+            instance.m_TexCoord[1] = (uv0[1] + uv2[1]) * 0.5f;
+            instance.m_TexCoord[2] = uv3[0] - uv0[0];
+            instance.m_TexCoord[3] = uv3[1] - uv0[1];
+            instance.m_TexCoordY[0] = uv1[0] - uv0[0];
+            instance.m_TexCoordY[1] = uv1[1] - uv0[1];
+
+            if (sprite_world->m_InstancingSupported)
+            {
+                memcpy(write_ptr, &instance, sizeof(SpriteInstance));
+                write_ptr += sizeof(SpriteInstance);
+            }
+            else
+            {
+                SpriteInstanceVertex* vertices = (SpriteInstanceVertex*) write_ptr;
+                for (uint32_t v = 0; v < DM_ARRAY_SIZE(quad_indices); ++v)
+                {
+                    vertices[v].m_Position[0] = quad_positions[quad_indices[v] * 2];
+                    vertices[v].m_Position[1] = quad_positions[quad_indices[v] * 2 + 1];
+                    vertices[v].m_Instance = instance;
+                }
+                write_ptr += sizeof(SpriteInstanceVertex) * DM_ARRAY_SIZE(quad_indices);
+            }
+        }
+
+        sprite_world->m_InstanceBufferWritePtr = write_ptr;
+    }
+
+    static void RenderBatchInstanced(SpriteWorld* sprite_world, dmRender::HRenderContext render_context, dmRender::RenderObject& ro, TextureSetResource* texture_set, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
+    {
+        if (!sprite_world->m_InstanceBuffer)
+        {
+            AllocateInstanceBuffers(sprite_world, dmRender::GetGraphicsContext(render_context));
+        }
+
+        uint32_t offset = sprite_world->m_InstanceBufferWritePtr - sprite_world->m_InstanceBufferData;
+        CreateInstanceData(sprite_world, texture_set, buf, begin, end);
+
+        if (sprite_world->m_InstancingSupported)
+        {
+            ro.m_VertexDeclaration = sprite_world->m_QuadVertexDeclaration;
+            ro.m_VertexBuffer = sprite_world->m_QuadVertexBuffer;
+            ro.m_IndexBuffer = sprite_world->m_QuadIndexBuffer;
+            ro.m_IndexType = dmGraphics::TYPE_UNSIGNED_SHORT;
+            ro.m_VertexStart = 0;
+            ro.m_VertexCount = DM_ARRAY_SIZE(quad_indices);
+            ro.m_InstanceDeclaration = sprite_world->m_InstanceDeclaration;
+            ro.m_InstanceBuffer = sprite_world->m_InstanceBuffer;
+            ro.m_InstanceOffset = offset;
+            ro.m_InstanceCount = end - begin;
+        }
+        else
+        {
+            ro.m_VertexDeclaration = sprite_world->m_InstanceDeclaration;
+            ro.m_VertexBuffer = sprite_world->m_InstanceBuffer;
+            ro.m_VertexStart = offset / sizeof(SpriteInstanceVertex);
+            ro.m_VertexCount = (end - begin) * DM_ARRAY_SIZE(quad_indices);
+        }
+    }
+
     static void RenderBatch(SpriteWorld* sprite_world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
     {
         DM_PROFILE(Sprite, "RenderBatch");
@@ -560,35 +856,37 @@ namespace dmGameSystem
         dmRender::RenderObject& ro = *sprite_world->m_RenderObjects.End();
         sprite_world->m_RenderObjects.SetSize(sprite_world->m_RenderObjects.Size()+1);
 
-        // Fill in vertex buffer
-        SpriteVertex* vb_begin = sprite_world->m_VertexBufferWritePtr;
-        uint8_t* ib_begin = (uint8_t*)sprite_world->m_IndexBufferWritePtr;
-        SpriteVertex* vb_iter = vb_begin;
-        uint8_t* ib_iter = ib_begin;
-        CreateVertexData(sprite_world, &vb_iter, &ib_iter, texture_set, buf, begin, end);
-
-        sprite_world->m_VertexBufferWritePtr = vb_iter;
-        sprite_world->m_IndexBufferWritePtr = ib_iter;
-
         ro.Init();
-        ro.m_VertexDeclaration = sprite_world->m_VertexDeclaration;
-        ro.m_VertexBuffer = sprite_world->m_VertexBuffer;
-        ro.m_IndexBuffer = sprite_world->m_IndexBuffer;
         ro.m_Material = GetMaterial(first, resource);
         ro.m_Textures[0] = texture_set->m_Texture;
         ro.m_PrimitiveType = dmGraphics::PRIMITIVE_TRIANGLES;
-        ro.m_IndexType = sprite_world->m_Is16BitIndex ? dmGraphics::TYPE_UNSIGNED_SHORT : dmGraphics::TYPE_UNSIGNED_INT;
 
-        // offset in bytes into element buffer
-        uint32_t index_offset = ib_begin - sprite_world->m_IndexBufferData;
+        if (dmRender::GetMaterialVertexSpace(ro.m_Material) == dmRenderDDF::MaterialDesc::VERTEX_SPACE_INSTANCE)
+        {
+            RenderBatchInstanced(sprite_world, render_context, ro, texture_set, buf, begin, end);
+        }
+        else
+        {
+            // Reserve the vertex buffer range, it's filled in at the end of the dispatch
+            uint8_t* ib_begin = (uint8_t*)sprite_world->m_IndexBufferWritePtr;
+            ReserveVertexData(sprite_world, texture_set, buf, begin, end);
+
+            ro.m_VertexDeclaration = sprite_world->m_VertexDeclaration;
+            ro.m_VertexBuffer = sprite_world->m_VertexBuffer;
+            ro.m_IndexBuffer = sprite_world->m_IndexBuffer;
+            ro.m_IndexType = sprite_world->m_Is16BitIndex ? dmGraphics::TYPE_UNSIGNED_SHORT : dmGraphics::TYPE_UNSIGNED_INT;
 
-        // num elements = Number of bytes / sizeof(index_type)
-        uint32_t index_type_size = sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
-        uint32_t num_elements = ((uint8_t*)sprite_world->m_IndexBufferWritePtr - (uint8_t*)ib_begin) / index_type_size;
+            // offset in bytes into element buffer
+            uint32_t index_offset = ib_begin - sprite_world->m_IndexBufferData;
+
+            // num elements = Number of bytes / sizeof(index_type)
+            uint32_t index_type_size = sprite_world->m_Is16BitIndex ? sizeof(uint16_t) : sizeof(uint32_t);
+            uint32_t num_elements = ((uint8_t*)sprite_world->m_IndexBufferWritePtr - (uint8_t*)ib_begin) / index_type_size;
 
-        // // These should be named "element" or "index" (as opposed to vertex)
-        ro.m_VertexStart = index_offset;
-        ro.m_VertexCount = num_elements;
+            // // These should be named "element" or "index" (as opposed to vertex)
+            ro.m_VertexStart = index_offset;
+            ro.m_VertexCount = num_elements;
+        }
 
         const dmRender::Constant* constants = first->m_RenderConstants.m_RenderConstants;
         uint32_t size = first->m_RenderConstants.m_ConstantCount;
@@ -849,9 +1147,13 @@ namespace dmGameSystem
             case dmRender::RENDER_LIST_OPERATION_BEGIN:
                 world->m_VertexBufferWritePtr = world->m_VertexBufferData;
                 world->m_IndexBufferWritePtr = world->m_IndexBufferData;
+                world->m_InstanceBufferWritePtr = world->m_InstanceBufferData;
+                world->m_VertexJobs.SetSize(0);
                 world->m_RenderObjects.SetSize(0);
                 break;
             case dmRender::RENDER_LIST_OPERATION_END:
+                GenerateVertexData(world);
+
                 dmGraphics::SetVertexBufferData(world->m_VertexBuffer, sizeof(SpriteVertex) * (world->m_VertexBufferWritePtr - world->m_VertexBufferData),
                                                 world->m_VertexBufferData, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
 
@@ -863,6 +1165,13 @@ namespace dmGameSystem
                     dmGraphics::SetIndexBufferData(world->m_IndexBuffer, index_size, world->m_IndexBufferData, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
                     DM_COUNTER("SpriteIndexBuffer", index_size);
                 }
+
+                if (world->m_InstanceBufferWritePtr != world->m_InstanceBufferData)
+                {
+                    uint32_t instance_size = world->m_InstanceBufferWritePtr - world->m_InstanceBufferData;
+                    dmGraphics::SetVertexBufferData(world->m_InstanceBuffer, instance_size, world->m_InstanceBufferData, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+                    DM_COUNTER("SpriteInstanceBuffer", instance_size);
+                }
                 break;
             default:
                 assert(params.m_Operation == dmRender::RENDER_LIST_OPERATION_BATCH);
@@ -979,10 +1288,8 @@ namespace dmGameSystem
         return component->m_PlaybackRate;
     }
 
-    dmGameObject::UpdateResult CompSpriteOnMessage(const dmGameObject::ComponentOnMessageParams& params)
+    static void HandleMessage(SpriteComponent* component, const dmGameObject::ComponentOnMessageParams& params)
     {
-        SpriteWorld* sprite_world = (SpriteWorld*)params.m_World;
-        SpriteComponent* component = &sprite_world->m_Components.Get(*params.m_UserData);
         if (params.m_Message->m_Id == dmGameObjectDDF::Enable::m_DDFDescriptor->m_NameHash)
         {
             component->m_Enabled = 1;
@@ -1040,7 +1347,25 @@ namespace dmGameSystem
                 component->m_Scale = ddf->m_Scale;
             }
         }
+    }
+
+    dmGameObject::UpdateResult CompSpriteOnMessage(const dmGameObject::ComponentOnMessageParams& params)
+    {
+        SpriteWorld* sprite_world = (SpriteWorld*)params.m_World;
+        SpriteComponent* component = &sprite_world->m_Components.Get(*params.m_UserData);
+        HandleMessage(component, params);
+        return dmGameObject::UPDATE_RESULT_OK;
+    }
 
+    dmGameObject::UpdateResult CompSpriteOnMessageBatch(const dmGameObject::ComponentsOnMessageBatchParams& params)
+    {
+        SpriteWorld* sprite_world = (SpriteWorld*)params.m_World;
+        const dmGameObject::ComponentOnMessageParams* messages = params.m_Messages;
+        for (uint32_t i = 0; i < params.m_MessageCount; ++i)
+        {
+            SpriteComponent* component = &sprite_world->m_Components.Get(*messages[i].m_UserData);
+            HandleMessage(component, messages[i]);
+        }
         return dmGameObject::UPDATE_RESULT_OK;
     }
 
@@ -33,6 +33,8 @@ namespace dmGameSystem
 
     dmGameObject::UpdateResult CompSpriteOnMessage(const dmGameObject::ComponentOnMessageParams& params);
 
+    dmGameObject::UpdateResult CompSpriteOnMessageBatch(const dmGameObject::ComponentsOnMessageBatchParams& params);
+
     void CompSpriteOnReload(const dmGameObject::ComponentOnReloadParams& params);
 
     dmGameObject::PropertyResult CompSpriteGetProperty(const dmGameObject::ComponentGetPropertyParams& params, dmGameObject::PropertyDesc& out_value);
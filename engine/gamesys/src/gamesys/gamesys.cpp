@@ -84,6 +84,7 @@ namespace dmGameSystem
     , m_RenderContext(0)
     , m_GuiContext(0)
     , m_ScriptContext(0)
+    , m_WorkerPool(0)
     , m_MaxGuiComponents(64)
     {
         m_Worlds.SetCapacity(128);
@@ -95,14 +96,17 @@ namespace dmGameSystem
 
         DM_STATIC_ASSERT( dmGameSystem::MAX_COMP_RENDER_CONSTANTS == dmRender::RenderObject::MAX_CONSTANT_COUNT, Constant_Count_Must_Be_Equal );
 
-#define REGISTER_RESOURCE_TYPE(extension, context, preload_func, create_func, post_create_func, destroy_func, recreate_func)\
-    e = dmResource::RegisterType(factory, extension, context, preload_func, create_func, post_create_func, destroy_func, recreate_func);\
+#define REGISTER_RESOURCE_TYPE_FLAGS(extension, context, preload_func, create_func, post_create_func, destroy_func, recreate_func, flags)\
+    e = dmResource::RegisterType(factory, extension, context, preload_func, create_func, post_create_func, destroy_func, recreate_func, flags);\
     if( e != dmResource::RESULT_OK )\
     {\
         dmLogFatal("Unable to register resource type: %s", extension);\
         return e;\
     }\
 
+#define REGISTER_RESOURCE_TYPE(extension, context, preload_func, create_func, post_create_func, destroy_func, recreate_func)\
+    REGISTER_RESOURCE_TYPE_FLAGS(extension, context, preload_func, create_func, post_create_func, destroy_func, recreate_func, 0)
+
         dmGraphics::HContext graphics_context = dmRender::GetGraphicsContext(render_context);
 
         REGISTER_RESOURCE_TYPE("collectionproxyc", 0, 0, ResCollectionProxyCreate, 0, ResCollectionProxyDestroy, ResCollectionProxyRecreate);
@@ -123,26 +127,27 @@ namespace dmGameSystem
         REGISTER_RESOURCE_TYPE("wavc", 0, 0, ResSoundDataCreate, 0, ResSoundDataDestroy, ResSoundDataRecreate);
         REGISTER_RESOURCE_TYPE("oggc", 0, 0, ResSoundDataCreate, 0, ResSoundDataDestroy, ResSoundDataRecreate);
         REGISTER_RESOURCE_TYPE("soundc", 0, ResSoundPreload, ResSoundCreate, 0, ResSoundDestroy, ResSoundRecreate);
-        REGISTER_RESOURCE_TYPE("camerac", 0, 0, ResCameraCreate, 0, ResCameraDestroy, ResCameraRecreate);
+        REGISTER_RESOURCE_TYPE_FLAGS("camerac", 0, 0, ResCameraCreate, 0, ResCameraDestroy, ResCameraRecreate, RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE);
         REGISTER_RESOURCE_TYPE("input_bindingc", input_context, 0, ResInputBindingCreate, 0, ResInputBindingDestroy, ResInputBindingRecreate);
-        REGISTER_RESOURCE_TYPE("gamepadsc", 0, 0, ResGamepadMapCreate, 0, ResGamepadMapDestroy, ResGamepadMapRecreate);
+        REGISTER_RESOURCE_TYPE_FLAGS("gamepadsc", 0, 0, ResGamepadMapCreate, 0, ResGamepadMapDestroy, ResGamepadMapRecreate, RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE);
         REGISTER_RESOURCE_TYPE("factoryc", 0, ResFactoryPreload, ResFactoryCreate, 0, ResFactoryDestroy, ResFactoryRecreate);
         REGISTER_RESOURCE_TYPE("collectionfactoryc", 0, ResCollectionFactoryPreload, ResCollectionFactoryCreate, 0, ResCollectionFactoryDestroy, ResCollectionFactoryRecreate);
         REGISTER_RESOURCE_TYPE("labelc", 0, ResLabelPreload, ResLabelCreate, 0, ResLabelDestroy, ResLabelRecreate);
-        REGISTER_RESOURCE_TYPE("lightc", 0, 0, ResLightCreate, 0, ResLightDestroy, ResLightRecreate);
+        REGISTER_RESOURCE_TYPE_FLAGS("lightc", 0, 0, ResLightCreate, 0, ResLightDestroy, ResLightRecreate, RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE);
         REGISTER_RESOURCE_TYPE("render_scriptc", render_context, 0, ResRenderScriptCreate, 0, ResRenderScriptDestroy, ResRenderScriptRecreate);
         REGISTER_RESOURCE_TYPE("renderc", render_context, 0, ResRenderPrototypeCreate, 0, ResRenderPrototypeDestroy, ResRenderPrototypeRecreate);
         REGISTER_RESOURCE_TYPE("spritec", 0, ResSpritePreload, ResSpriteCreate, 0, ResSpriteDestroy, ResSpriteRecreate);
         REGISTER_RESOURCE_TYPE("texturesetc", physics_context, ResTextureSetPreload, ResTextureSetCreate, 0, ResTextureSetDestroy, ResTextureSetRecreate);
         REGISTER_RESOURCE_TYPE(TILE_MAP_EXT, physics_context, ResTileGridPreload, ResTileGridCreate, 0, ResTileGridDestroy, ResTileGridRecreate);
-        REGISTER_RESOURCE_TYPE("animationsetc", 0, ResAnimationSetPreload, ResAnimationSetCreate, 0, ResAnimationSetDestroy, ResAnimationSetRecreate);
-        REGISTER_RESOURCE_TYPE("meshsetc", 0, ResMeshSetPreload, ResMeshSetCreate, 0, ResMeshSetDestroy, ResMeshSetRecreate);
-        REGISTER_RESOURCE_TYPE("skeletonc", 0, ResSkeletonPreload, ResSkeletonCreate, 0, ResSkeletonDestroy, ResSkeletonRecreate);
+        REGISTER_RESOURCE_TYPE_FLAGS("animationsetc", 0, ResAnimationSetPreload, ResAnimationSetCreate, 0, ResAnimationSetDestroy, ResAnimationSetRecreate, RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE);
+        REGISTER_RESOURCE_TYPE_FLAGS("meshsetc", 0, ResMeshSetPreload, ResMeshSetCreate, 0, ResMeshSetDestroy, ResMeshSetRecreate, RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE);
+        REGISTER_RESOURCE_TYPE_FLAGS("skeletonc", 0, ResSkeletonPreload, ResSkeletonCreate, 0, ResSkeletonDestroy, ResSkeletonRecreate, RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE);
         REGISTER_RESOURCE_TYPE("rigscenec", 0, ResRigScenePreload, ResRigSceneCreate, 0, ResRigSceneDestroy, ResRigSceneRecreate);
         REGISTER_RESOURCE_TYPE(SPINE_MODEL_EXT, 0, ResSpineModelPreload, ResSpineModelCreate, 0, ResSpineModelDestroy, ResSpineModelRecreate);
         REGISTER_RESOURCE_TYPE("display_profilesc", render_context, 0, ResDisplayProfilesCreate, 0, ResDisplayProfilesDestroy, ResDisplayProfilesRecreate);
 
 #undef REGISTER_RESOURCE_TYPE
+#undef REGISTER_RESOURCE_TYPE_FLAGS
 
         return e;
     }
@@ -242,6 +247,7 @@ namespace dmGameSystem
                 &CompCollisionObjectOnReload, CompCollisionObjectGetProperty, CompCollisionObjectSetProperty,
                 0, 0,
                 1);
+        dmGameObject::FindComponentType(regist, type, 0x0)->m_OnMessageBatchFunction = CompCollisionObjectOnMessageBatch;
 
         REGISTER_COMPONENT_TYPE("camerac", 500, render_context,
                 &CompCameraNewWorld, &CompCameraDeleteWorld,
@@ -266,6 +272,7 @@ namespace dmGameSystem
                 0, CompModelGetProperty, CompModelSetProperty,
                 0, 0,
                 0);
+        dmGameObject::FindComponentType(regist, type, 0x0)->m_OnMessageBatchFunction = CompModelOnMessageBatch;
 
         REGISTER_COMPONENT_TYPE("meshc", 725, mesh_context,
                 CompMeshNewWorld, CompMeshDeleteWorld,
@@ -322,6 +329,7 @@ namespace dmGameSystem
                 CompSpriteOnReload, CompSpriteGetProperty, CompSpriteSetProperty,
                 0, CompSpriteIterProperties,
                 1);
+        dmGameObject::FindComponentType(regist, type, 0x0)->m_OnMessageBatchFunction = CompSpriteOnMessageBatch;
 
         REGISTER_COMPONENT_TYPE(TILE_MAP_EXT, 1200, tilemap_context,
                 CompTileGridNewWorld, CompTileGridDeleteWorld,
@@ -86,6 +86,7 @@ namespace dmGameSystem
         dmRender::HRenderContext m_RenderContext;
         uint32_t m_MaxParticleFXCount;
         uint32_t m_MaxParticleCount;
+        dmWorkerPool::HWorkerPool m_WorkerPool; // Optional, used to update and render the emitters in parallel
         bool m_Debug;
     };
 
@@ -105,6 +106,7 @@ namespace dmGameSystem
         dmRender::HRenderContext    m_RenderContext;
         dmGui::HContext             m_GuiContext;
         dmScript::HContext          m_ScriptContext;
+        dmWorkerPool::HWorkerPool   m_WorkerPool;       // Optional, used to generate vertices in parallel
         uint32_t                    m_MaxGuiComponents;
         uint32_t                    m_MaxParticleFXCount;
         uint32_t                    m_MaxParticleCount;
@@ -118,6 +120,7 @@ namespace dmGameSystem
             memset(this, 0, sizeof(*this));
         }
         dmRender::HRenderContext    m_RenderContext;
+        dmWorkerPool::HWorkerPool   m_WorkerPool;       // Optional, used to generate vertices in parallel
         uint32_t                    m_MaxSpriteCount;
         uint32_t                    m_Subpixels : 1;
     };
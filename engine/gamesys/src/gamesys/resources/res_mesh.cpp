@@ -220,6 +220,14 @@ namespace dmGameSystem
         if (result != dmResource::RESULT_OK)
             return result;
 
+        if (dmRender::GetMaterialVertexSpace(resource->m_Material) == dmRenderDDF::MaterialDesc::VERTEX_SPACE_INSTANCE)
+        {
+            dmLogError("Failed to create Mesh component. Material vertex space option VERTEX_SPACE_INSTANCE is only supported by sprites.");
+            dmResource::Release(factory, resource->m_Material);
+            resource->m_Material = 0;
+            return dmResource::RESULT_NOT_SUPPORTED;
+        }
+
         result = dmResource::Get(factory, resource->m_MeshDDF->m_Vertices, (void**) &resource->m_BufferResource);
         if (result != dmResource::RESULT_OK) {
             dmResource::Release(factory, (void*) resource->m_MeshDDF->m_Material);
@@ -120,6 +120,12 @@ namespace dmGameSystem
         }
         memcpy(resource->m_Textures, textures, sizeof(dmGraphics::HTexture) * dmRender::RenderObject::MAX_TEXTURE_COUNT);
 
+        if(dmRender::GetMaterialVertexSpace(resource->m_Material) == dmRenderDDF::MaterialDesc::VERTEX_SPACE_INSTANCE)
+        {
+            dmLogError("Failed to create Model component. Material vertex space option VERTEX_SPACE_INSTANCE is only supported by sprites.");
+            return dmResource::RESULT_NOT_SUPPORTED;
+        }
+
         if(dmRender::GetMaterialVertexSpace(resource->m_Material) ==  dmRenderDDF::MaterialDesc::VERTEX_SPACE_LOCAL)
         {
             if(resource->m_RigScene->m_AnimationSetRes || resource->m_RigScene->m_SkeletonRes)
@@ -37,9 +37,10 @@ namespace dmGameSystem
         {
             return fr;
         }
-        if(dmRender::GetMaterialVertexSpace(resource->m_Material) != dmRenderDDF::MaterialDesc::VERTEX_SPACE_WORLD)
+        dmRenderDDF::MaterialDesc::VertexSpace vertex_space = dmRender::GetMaterialVertexSpace(resource->m_Material);
+        if(vertex_space != dmRenderDDF::MaterialDesc::VERTEX_SPACE_WORLD && vertex_space != dmRenderDDF::MaterialDesc::VERTEX_SPACE_INSTANCE)
         {
-            dmLogError("Failed to create Sprite component. This component only supports materials with the Vertex Space property set to 'vertex-space-world'");
+            dmLogError("Failed to create Sprite component. This component only supports materials with the Vertex Space property set to 'vertex-space-world' or 'vertex-space-instance'");
             return dmResource::RESULT_NOT_SUPPORTED;
         }
         resource->m_DefaultAnimation = dmHashString64(resource->m_DDF->m_DefaultAnimation);
@@ -228,8 +228,10 @@ namespace dmGameSystem
 
     dmResource::Result ResTexturePreload(const dmResource::ResourcePreloadParams& params)
     {
+        // Image data in a memory mapped archive outlives the texture upload, so it is referenced rather than copied
+        uint32_t options = params.m_IsBufferMapped ? dmDDF::OPTION_NO_COPY_BYTES : 0;
         dmGraphics::TextureImage* texture_image;
-        dmDDF::Result e = dmDDF::LoadMessage<dmGraphics::TextureImage>(params.m_Buffer, params.m_BufferSize, (&texture_image));
+        dmDDF::Result e = dmDDF::LoadMessage(params.m_Buffer, params.m_BufferSize, dmGraphics::TextureImage::m_DDFDescriptor, (void**) &texture_image, options, 0);
         if ( e != dmDDF::RESULT_OK )
         {
             return dmResource::RESULT_FORMAT_ERROR;
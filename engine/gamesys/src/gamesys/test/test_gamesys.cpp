@@ -1998,6 +1998,77 @@ BoxRenderParams box_render_params[] =
 };
 INSTANTIATE_TEST_CASE_P(BoxRender, BoxRenderTest, jc_test_values_in(box_render_params));
 
+/* Gui vertex jobs */
+
+static void RenderGuiVertices(dmRender::HRenderContext render_context, dmGameObject::HCollection collection, dmGameSystem::GuiWorld* world, dmArray<dmGameSystem::BoxVertex>& vertices)
+{
+    dmRender::RenderListBegin(render_context);
+    dmGui::SetSceneAdjustReference(world->m_Components[0]->m_Scene, dmGui::ADJUST_REFERENCE_DISABLED);
+    dmGameObject::Render(collection);
+    dmRender::RenderListEnd(render_context);
+    dmRender::DrawRenderList(render_context, 0x0, 0x0);
+
+    vertices.SetCapacity(world->m_ClientVertexBuffer.Size());
+    vertices.SetSize(world->m_ClientVertexBuffer.Size());
+    memcpy(vertices.Begin(), world->m_ClientVertexBuffer.Begin(), vertices.Size() * sizeof(dmGameSystem::BoxVertex));
+}
+
+// The vertices generated by the vertex jobs on a worker pool must be the same as when they run serially
+TEST_P(GuiVertexJobTest, WorkerPool)
+{
+    const char* go_path = GetParam();
+
+    // Serial
+    ASSERT_TRUE(dmGameObject::Init(m_Collection));
+    dmGameObject::HInstance go = Spawn(m_Factory, m_Collection, go_path, dmHashString64("/go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+    ASSERT_TRUE(dmGameObject::Update(m_Collection, &m_UpdateContext));
+
+    dmGameSystem::GuiWorld* world = (dmGameSystem::GuiWorld*)m_GuiContext.m_Worlds[0];
+    ASSERT_EQ((dmWorkerPool::HWorkerPool)0, world->m_WorkerPool);
+    dmArray<dmGameSystem::BoxVertex> serial_vertices;
+    RenderGuiVertices(m_RenderContext, m_Collection, world, serial_vertices);
+    // All 300 nodes were rendered, i.e. more than one vertex job
+    ASSERT_LE(300U * 4U, serial_vertices.Size());
+
+    // Worker pool, the gui world picks it up from the context when created
+    m_GuiContext.m_WorkerPool = dmWorkerPool::New(4, "gui_test");
+    ASSERT_NE((dmWorkerPool::HWorkerPool)0, m_GuiContext.m_WorkerPool);
+    dmGameObject::HCollection pooled_collection = dmGameObject::NewCollection("pooled_collection", m_Factory, m_Register, 1024);
+    ASSERT_NE((dmGameObject::HCollection)0, pooled_collection);
+
+    ASSERT_TRUE(dmGameObject::Init(pooled_collection));
+    go = Spawn(m_Factory, pooled_collection, go_path, dmHashString64("/go"), 0, 0, Point3(0, 0, 0), Quat(0, 0, 0, 1), Vector3(1, 1, 1));
+    ASSERT_NE((void*)0, go);
+    ASSERT_TRUE(dmGameObject::Update(pooled_collection, &m_UpdateContext));
+
+    world = (dmGameSystem::GuiWorld*)m_GuiContext.m_Worlds[m_GuiContext.m_Worlds.Size() - 1];
+    ASSERT_EQ(m_GuiContext.m_WorkerPool, world->m_WorkerPool);
+    dmArray<dmGameSystem::BoxVertex> pooled_vertices;
+    RenderGuiVertices(m_RenderContext, pooled_collection, world, pooled_vertices);
+
+    ASSERT_EQ(serial_vertices.Size(), pooled_vertices.Size());
+    for (uint32_t i = 0; i < serial_vertices.Size(); ++i)
+    {
+        AssertVertexEqual(serial_vertices[i], pooled_vertices[i]);
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            ASSERT_EQ(serial_vertices[i].m_Color[c], pooled_vertices[i].m_Color[c]);
+        }
+    }
+
+    ASSERT_TRUE(dmGameObject::Final(pooled_collection));
+    dmGameObject::DeleteCollection(pooled_collection);
+    dmGameObject::PostUpdate(m_Register);
+    dmWorkerPool::Delete(m_GuiContext.m_WorkerPool);
+    m_GuiContext.m_WorkerPool = 0;
+
+    ASSERT_TRUE(dmGameObject::Final(m_Collection));
+}
+
+const char* gui_vertex_job_gos[] = {"/gui/vertex_job_box_test.goc", "/gui/vertex_job_pie_test.goc"};
+INSTANTIATE_TEST_CASE_P(GuiVertexJob, GuiVertexJobTest, jc_test_values_in(gui_vertex_job_gos));
+
 /* Sprite cursor property */
 #define F1T3 1.0f/3.0f
 #define F2T3 2.0f/3.0f
@@ -184,6 +184,12 @@ public:
     virtual ~BoxRenderTest() {}
 };
 
+class GuiVertexJobTest : public GamesysTest<const char*>
+{
+public:
+    virtual ~GuiVertexJobTest() {}
+};
+
 class GamepadConnectedTest : public GamesysTest<const char*>
 {
 public:
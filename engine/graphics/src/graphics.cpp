@@ -469,6 +469,26 @@ namespace dmGraphics
     {
         g_functions.m_Draw(context, prim_type, first, count);
     }
+    bool IsInstancingSupported(HContext context)
+    {
+        return g_functions.m_IsInstancingSupported(context);
+    }
+    void EnableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration, HVertexBuffer instance_buffer, uint32_t offset, HProgram program)
+    {
+        g_functions.m_EnableInstanceDeclaration(context, instance_declaration, instance_buffer, offset, program);
+    }
+    void DisableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration)
+    {
+        g_functions.m_DisableInstanceDeclaration(context, instance_declaration);
+    }
+    void DrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer, uint32_t instance_count)
+    {
+        g_functions.m_DrawElementsInstanced(context, prim_type, first, count, type, index_buffer, instance_count);
+    }
+    void DrawInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count)
+    {
+        g_functions.m_DrawInstanced(context, prim_type, first, count, instance_count);
+    }
     HVertexProgram NewVertexProgram(HContext context, ShaderDesc::Shader* ddf)
     {
         return g_functions.m_NewVertexProgram(context, ddf);
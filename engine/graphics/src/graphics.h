@@ -618,6 +618,27 @@ namespace dmGraphics
     void DrawElements(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer);
     void Draw(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count);
 
+    /**
+     * Check if the context can draw instanced geometry, i.e if EnableInstanceDeclaration,
+     * DrawElementsInstanced and DrawInstanced are available.
+     * @param context Graphics context handle
+     * @return true if instanced drawing is supported
+     */
+    bool IsInstancingSupported(HContext context);
+    /**
+     * Enable a vertex declaration whose streams are read once per instance instead of once per vertex.
+     * Must be enabled after the per vertex declaration and disabled before it.
+     * @param context Graphics context handle
+     * @param instance_declaration Declaration of the per instance streams
+     * @param instance_buffer Buffer holding the per instance data
+     * @param offset Offset in bytes to the first instance in the buffer
+     * @param program Program the streams are bound to
+     */
+    void EnableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration, HVertexBuffer instance_buffer, uint32_t offset, HProgram program);
+    void DisableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration);
+    void DrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer, uint32_t instance_count);
+    void DrawInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count);
+
     HVertexProgram NewVertexProgram(HContext context, ShaderDesc::Shader* ddf);
     HFragmentProgram NewFragmentProgram(HContext context, ShaderDesc::Shader* ddf);
     HProgram NewProgram(HContext context, HVertexProgram vertex_program, HFragmentProgram fragment_program);
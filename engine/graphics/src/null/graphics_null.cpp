@@ -511,15 +511,21 @@ namespace dmGraphics
         s.m_Source = 0x0;
     }
 
+    static uint16_t GetVertexDeclarationStride(HVertexDeclaration vertex_declaration)
+    {
+        uint16_t stride = 0;
+        for (uint32_t i = 0; i < vertex_declaration->m_Count; ++i)
+            stride += vertex_declaration->m_Elements[i].m_Size * TYPE_SIZE[vertex_declaration->m_Elements[i].m_Type - dmGraphics::TYPE_BYTE];
+        return stride;
+    }
+
     static void NullEnableVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer)
     {
         assert(context);
         assert(vertex_declaration);
         assert(vertex_buffer);
         VertexBuffer* vb = (VertexBuffer*)vertex_buffer;
-        uint16_t stride = 0;
-        for (uint32_t i = 0; i < vertex_declaration->m_Count; ++i)
-            stride += vertex_declaration->m_Elements[i].m_Size * TYPE_SIZE[vertex_declaration->m_Elements[i].m_Type - dmGraphics::TYPE_BYTE];
+        uint16_t stride = GetVertexDeclarationStride(vertex_declaration);
         uint32_t offset = 0;
         for (uint16_t i = 0; i < vertex_declaration->m_Count; ++i)
         {
@@ -546,6 +552,40 @@ namespace dmGraphics
                 DisableVertexStream(context, i);
     }
 
+    static bool NullIsInstancingSupported(HContext context)
+    {
+        return true;
+    }
+
+    static void NullEnableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration, HVertexBuffer instance_buffer, uint32_t offset, HProgram program)
+    {
+        assert(context);
+        assert(instance_declaration);
+        assert(instance_buffer);
+        assert(context->m_InstanceDeclaration == 0x0);
+        context->m_InstanceDeclaration = instance_declaration;
+        context->m_InstanceBuffer = (VertexBuffer*)instance_buffer;
+        context->m_InstanceBufferOffset = offset;
+    }
+
+    static void NullDisableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration)
+    {
+        assert(context);
+        assert(context->m_InstanceDeclaration == instance_declaration);
+        context->m_InstanceDeclaration = 0x0;
+        context->m_InstanceBuffer = 0x0;
+        context->m_InstanceBufferOffset = 0;
+    }
+
+    // There is no vertex processing in the null device, only verify that every instance is backed by the bound instance buffer
+    static void VerifyInstances(HContext context, uint32_t instance_count)
+    {
+        assert(context->m_InstanceDeclaration);
+        uint32_t end = context->m_InstanceBufferOffset + instance_count * GetVertexDeclarationStride(context->m_InstanceDeclaration);
+        assert(end <= context->m_InstanceBuffer->m_Size);
+        (void)end;
+    }
+
     void NullHashVertexDeclaration(HashState32 *state, HVertexDeclaration vertex_declaration)
     {
         uint16_t stream_count = vertex_declaration->m_Count;
@@ -640,6 +680,18 @@ namespace dmGraphics
         g_DrawCount++;
     }
 
+    static void NullDrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer, uint32_t instance_count)
+    {
+        VerifyInstances(context, instance_count);
+        NullDrawElements(context, prim_type, first, count, type, index_buffer);
+    }
+
+    static void NullDrawInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count)
+    {
+        VerifyInstances(context, instance_count);
+        NullDraw(context, prim_type, first, count);
+    }
+
     // For tests
     uint64_t GetDrawCount()
     {
@@ -1256,6 +1308,11 @@ namespace dmGraphics
         fn_table.m_HashVertexDeclaration = NullHashVertexDeclaration;
         fn_table.m_DrawElements = NullDrawElements;
         fn_table.m_Draw = NullDraw;
+        fn_table.m_IsInstancingSupported = NullIsInstancingSupported;
+        fn_table.m_EnableInstanceDeclaration = NullEnableInstanceDeclaration;
+        fn_table.m_DisableInstanceDeclaration = NullDisableInstanceDeclaration;
+        fn_table.m_DrawElementsInstanced = NullDrawElementsInstanced;
+        fn_table.m_DrawInstanced = NullDrawInstanced;
         fn_table.m_NewVertexProgram = NullNewVertexProgram;
         fn_table.m_NewFragmentProgram = NullNewFragmentProgram;
         fn_table.m_NewProgram = NullNewProgram;
@@ -344,6 +344,12 @@ static void LogFrameBufferError(GLenum status)
     // The alternative is a matrix of conditional typedefs, linked statically/dynamically or core. OpenGL function prototypes does not change, so this is safe.
     typedef void (* DM_PFNGLINVALIDATEFRAMEBUFFERPROC) (GLenum target, GLsizei numAttachments, const GLenum *attachments);
     DM_PFNGLINVALIDATEFRAMEBUFFERPROC PFN_glInvalidateFramebuffer = NULL;
+    typedef void (* DM_PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+    DM_PFNGLVERTEXATTRIBDIVISORPROC PFN_glVertexAttribDivisor = NULL;
+    typedef void (* DM_PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei instancecount);
+    DM_PFNGLDRAWELEMENTSINSTANCEDPROC PFN_glDrawElementsInstanced = NULL;
+    typedef void (* DM_PFNGLDRAWARRAYSINSTANCEDPROC) (GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+    DM_PFNGLDRAWARRAYSINSTANCEDPROC PFN_glDrawArraysInstanced = NULL;
 
     Context* g_Context = 0x0;
 
@@ -900,6 +906,15 @@ static uintptr_t GetExtProcAddress(const char* name, const char* extension_name,
 
         DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glInvalidateFramebuffer, "glDiscardFramebuffer", "discard_framebuffer", "glInvalidateFramebuffer", DM_PFNGLINVALIDATEFRAMEBUFFERPROC, extensions);
 
+        // Instancing is core in OpenGL 3.3. On older contexts the divisor comes from (ARB|EXT)_instanced_arrays and
+        // the draw calls from either (ARB|EXT)_draw_instanced or EXT_instanced_arrays.
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glVertexAttribDivisor, "glVertexAttribDivisor", "instanced_arrays", "glVertexAttribDivisor", DM_PFNGLVERTEXATTRIBDIVISORPROC, extensions);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawElementsInstanced, "glDrawElementsInstanced", "draw_instanced", "glDrawElementsInstanced", DM_PFNGLDRAWELEMENTSINSTANCEDPROC, extensions);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawElementsInstanced, "glDrawElementsInstanced", "instanced_arrays", 0, DM_PFNGLDRAWELEMENTSINSTANCEDPROC, extensions);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawArraysInstanced, "glDrawArraysInstanced", "draw_instanced", "glDrawArraysInstanced", DM_PFNGLDRAWARRAYSINSTANCEDPROC, extensions);
+        DMGRAPHICS_GET_PROC_ADDRESS_EXT(PFN_glDrawArraysInstanced, "glDrawArraysInstanced", "instanced_arrays", 0, DM_PFNGLDRAWARRAYSINSTANCEDPROC, extensions);
+        context->m_InstancingSupport = PFN_glVertexAttribDivisor != NULL && PFN_glDrawElementsInstanced != NULL && PFN_glDrawArraysInstanced != NULL;
+
         if (IsExtensionSupported("GL_IMG_texture_compression_pvrtc", extensions) ||
             IsExtensionSupported("WEBGL_compressed_texture_pvrtc", extensions))
         {
@@ -1521,6 +1536,71 @@ static uintptr_t GetExtProcAddress(const char* name, const char* extension_name,
         CHECK_GL_ERROR;
     }
 
+    static bool OpenGLIsInstancingSupported(HContext context)
+    {
+        assert(context);
+        return context->m_InstancingSupport;
+    }
+
+    static void OpenGLEnableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration, HVertexBuffer instance_buffer, uint32_t offset, HProgram program)
+    {
+        assert(context);
+        assert(context->m_InstancingSupport);
+        assert(instance_buffer);
+        assert(instance_declaration);
+
+        if (!(context->m_ModificationVersion == instance_declaration->m_ModificationVersion && instance_declaration->m_BoundForProgram == program))
+        {
+            BindVertexDeclarationProgram(context, instance_declaration, program);
+        }
+
+        #define BUFFER_OFFSET(i) ((char*)0x0 + (i))
+
+        glBindBufferARB(GL_ARRAY_BUFFER, instance_buffer);
+        CHECK_GL_ERROR;
+
+        for (uint32_t i=0; i<instance_declaration->m_StreamCount; i++)
+        {
+            const VertexDeclaration::Stream& stream = instance_declaration->m_Streams[i];
+            if (stream.m_PhysicalIndex != -1)
+            {
+                glEnableVertexAttribArray(stream.m_PhysicalIndex);
+                CHECK_GL_ERROR;
+                glVertexAttribPointer(
+                        stream.m_PhysicalIndex,
+                        stream.m_Size,
+                        GetOpenGLType(stream.m_Type),
+                        stream.m_Normalize,
+                        instance_declaration->m_Stride,
+                BUFFER_OFFSET(offset + stream.m_Offset) );
+                CHECK_GL_ERROR;
+                PFN_glVertexAttribDivisor(stream.m_PhysicalIndex, 1);
+                CHECK_GL_ERROR;
+            }
+        }
+
+        #undef BUFFER_OFFSET
+    }
+
+    static void OpenGLDisableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration)
+    {
+        assert(context);
+        assert(instance_declaration);
+
+        // Reset the divisors, the attribute locations are shared with the regular vertex declarations
+        for (uint32_t i=0; i<instance_declaration->m_StreamCount; i++)
+        {
+            const VertexDeclaration::Stream& stream = instance_declaration->m_Streams[i];
+            if (stream.m_PhysicalIndex != -1)
+            {
+                PFN_glVertexAttribDivisor(stream.m_PhysicalIndex, 0);
+                CHECK_GL_ERROR;
+                glDisableVertexAttribArray(stream.m_PhysicalIndex);
+                CHECK_GL_ERROR;
+            }
+        }
+    }
+
     void OpenGLHashVertexDeclaration(HashState32 *state, HVertexDeclaration vertex_declaration)
     {
         uint16_t stream_count = vertex_declaration->m_StreamCount;
@@ -1563,6 +1643,31 @@ static uintptr_t GetExtProcAddress(const char* name, const char* extension_name,
         CHECK_GL_ERROR
     }
 
+    static void OpenGLDrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer, uint32_t instance_count)
+    {
+        assert(context);
+        assert(index_buffer);
+        assert(context->m_InstancingSupport);
+        DM_PROFILE(Graphics, "DrawElementsInstanced");
+        DM_COUNTER("DrawCalls", 1);
+
+        glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+        CHECK_GL_ERROR;
+
+        PFN_glDrawElementsInstanced(GetOpenGLPrimitiveType(prim_type), count, GetOpenGLType(type), (GLvoid*)(uintptr_t) first, instance_count);
+        CHECK_GL_ERROR
+    }
+
+    static void OpenGLDrawInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count)
+    {
+        assert(context);
+        assert(context->m_InstancingSupport);
+        DM_PROFILE(Graphics, "DrawInstanced");
+        DM_COUNTER("DrawCalls", 1);
+        PFN_glDrawArraysInstanced(GetOpenGLPrimitiveType(prim_type), first, count, instance_count);
+        CHECK_GL_ERROR
+    }
+
     static uint32_t CreateShader(GLenum type, const void* program, uint32_t program_size)
     {
         GLuint s = glCreateShader(type);
@@ -2901,6 +3006,11 @@ static uintptr_t GetExtProcAddress(const char* name, const char* extension_name,
         fn_table.m_HashVertexDeclaration = OpenGLHashVertexDeclaration;
         fn_table.m_DrawElements = OpenGLDrawElements;
         fn_table.m_Draw = OpenGLDraw;
+        fn_table.m_IsInstancingSupported = OpenGLIsInstancingSupported;
+        fn_table.m_EnableInstanceDeclaration = OpenGLEnableInstanceDeclaration;
+        fn_table.m_DisableInstanceDeclaration = OpenGLDisableInstanceDeclaration;
+        fn_table.m_DrawElementsInstanced = OpenGLDrawElementsInstanced;
+        fn_table.m_DrawInstanced = OpenGLDrawInstanced;
         fn_table.m_NewVertexProgram = OpenGLNewVertexProgram;
         fn_table.m_NewFragmentProgram = OpenGLNewFragmentProgram;
         fn_table.m_NewProgram = OpenGLNewProgram;
@@ -327,6 +327,54 @@ TEST_F(dmGraphicsTest, Drawing)
     dmGraphics::DeleteVertexDeclaration(vd);
 }
 
+TEST_F(dmGraphicsTest, InstancedDrawing)
+{
+    ASSERT_TRUE(dmGraphics::IsInstancingSupported(m_Context));
+
+    float v[] = { -0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f };
+    uint16_t i[] = { 0, 1, 2, 2, 3, 0 };
+    float instances[] = { 0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f };
+
+    dmGraphics::VertexElement ve[] =
+    {
+        {"position", 0, 2, dmGraphics::TYPE_FLOAT, false },
+    };
+    dmGraphics::VertexElement ie[] =
+    {
+        {"offset", 0, 2, dmGraphics::TYPE_FLOAT, false },
+    };
+    dmGraphics::HVertexDeclaration vd = dmGraphics::NewVertexDeclaration(m_Context, ve, 1);
+    dmGraphics::HVertexDeclaration id = dmGraphics::NewVertexDeclaration(m_Context, ie, 1);
+    dmGraphics::HVertexBuffer vb = dmGraphics::NewVertexBuffer(m_Context, sizeof(v), v, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+    dmGraphics::HVertexBuffer instance_buffer = dmGraphics::NewVertexBuffer(m_Context, sizeof(instances), instances, dmGraphics::BUFFER_USAGE_STREAM_DRAW);
+    dmGraphics::HIndexBuffer ib = dmGraphics::NewIndexBuffer(m_Context, sizeof(i), i, dmGraphics::BUFFER_USAGE_STATIC_DRAW);
+
+    // The draw count is reset by the first draw after a flip
+    dmGraphics::Flip(m_Context);
+
+    dmGraphics::EnableVertexDeclaration(m_Context, vd, vb);
+    dmGraphics::EnableInstanceDeclaration(m_Context, id, instance_buffer, 0, 0);
+    dmGraphics::DrawElementsInstanced(m_Context, dmGraphics::PRIMITIVE_TRIANGLES, 0, 6, dmGraphics::TYPE_UNSIGNED_SHORT, ib, 4);
+    dmGraphics::DisableInstanceDeclaration(m_Context, id);
+    dmGraphics::DisableVertexDeclaration(m_Context, vd);
+
+    // Skip the first instance
+    dmGraphics::EnableVertexDeclaration(m_Context, vd, vb);
+    dmGraphics::EnableInstanceDeclaration(m_Context, id, instance_buffer, 2 * sizeof(float), 0);
+    dmGraphics::DrawInstanced(m_Context, dmGraphics::PRIMITIVE_TRIANGLE_STRIP, 0, 4, 3);
+    dmGraphics::DisableInstanceDeclaration(m_Context, id);
+    dmGraphics::DisableVertexDeclaration(m_Context, vd);
+
+    // One draw call per instanced batch
+    ASSERT_EQ(2u, dmGraphics::GetDrawCount());
+
+    dmGraphics::DeleteIndexBuffer(ib);
+    dmGraphics::DeleteVertexBuffer(instance_buffer);
+    dmGraphics::DeleteVertexBuffer(vb);
+    dmGraphics::DeleteVertexDeclaration(id);
+    dmGraphics::DeleteVertexDeclaration(vd);
+}
+
 static inline dmGraphics::ShaderDesc::Shader MakeDDFShader(const char* data, uint32_t count)
 {
     dmGraphics::ShaderDesc::Shader ddf;
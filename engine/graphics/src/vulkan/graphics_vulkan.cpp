@@ -1309,13 +1309,17 @@ bail:
 
     static Pipeline* GetOrCreatePipeline(VkDevice vk_device, VkSampleCountFlagBits vk_sample_count,
         const PipelineState pipelineState, PipelineCache& pipelineCache,
-        Program* program, RenderTarget* rt, DeviceBuffer* vertexBuffer, HVertexDeclaration vertexDeclaration)
+        Program* program, RenderTarget* rt, DeviceBuffer* vertexBuffer, HVertexDeclaration vertexDeclaration, HVertexDeclaration instanceDeclaration)
     {
         HashState64 pipeline_hash_state;
         dmHashInit64(&pipeline_hash_state, false);
         dmHashUpdateBuffer64(&pipeline_hash_state, &program->m_Hash, sizeof(program->m_Hash));
         dmHashUpdateBuffer64(&pipeline_hash_state, &pipelineState, sizeof(pipelineState));
         dmHashUpdateBuffer64(&pipeline_hash_state, &vertexDeclaration->m_Hash, sizeof(vertexDeclaration->m_Hash));
+        if (instanceDeclaration)
+        {
+            dmHashUpdateBuffer64(&pipeline_hash_state, &instanceDeclaration->m_Hash, sizeof(instanceDeclaration->m_Hash));
+        }
         dmHashUpdateBuffer64(&pipeline_hash_state, &rt->m_Id, sizeof(rt->m_Id));
         dmHashUpdateBuffer64(&pipeline_hash_state, &vk_sample_count, sizeof(vk_sample_count));
         uint64_t pipeline_hash = dmHashFinal64(&pipeline_hash_state);
@@ -1332,7 +1336,7 @@ bail:
             vk_scissor.offset.x = 0;
             vk_scissor.offset.y = 0;
 
-            VkResult res = CreatePipeline(vk_device, vk_scissor, vk_sample_count, pipelineState, program, vertexBuffer, vertexDeclaration, rt->m_RenderPass, &new_pipeline);
+            VkResult res = CreatePipeline(vk_device, vk_scissor, vk_sample_count, pipelineState, program, vertexBuffer, vertexDeclaration, instanceDeclaration, rt->m_RenderPass, &new_pipeline);
             CHECK_VK_ERROR(res);
 
             if (pipelineCache.Full())
@@ -1617,11 +1621,8 @@ bail:
         context->m_CurrentVertexDeclaration = (VertexDeclaration*) vertex_declaration;
     }
 
-    static void VulkanEnableVertexDeclarationProgram(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, HProgram program)
+    static void BindVertexDeclarationProgram(HVertexDeclaration vertex_declaration, Program* program_ptr)
     {
-        Program* program_ptr = (Program*) program;
-        VulkanEnableVertexDeclaration(context, vertex_declaration, vertex_buffer);
-
         for (uint32_t i=0; i < vertex_declaration->m_StreamCount; i++)
         {
             VertexDeclaration::Stream& stream = vertex_declaration->m_Streams[i];
@@ -1641,11 +1642,36 @@ bail:
         }
     }
 
+    static void VulkanEnableVertexDeclarationProgram(HContext context, HVertexDeclaration vertex_declaration, HVertexBuffer vertex_buffer, HProgram program)
+    {
+        VulkanEnableVertexDeclaration(context, vertex_declaration, vertex_buffer);
+        BindVertexDeclarationProgram(vertex_declaration, (Program*) program);
+    }
+
     static void VulkanDisableVertexDeclaration(HContext context, HVertexDeclaration vertex_declaration)
     {
         context->m_CurrentVertexDeclaration = 0;
     }
 
+    static bool VulkanIsInstancingSupported(HContext context)
+    {
+        return true;
+    }
+
+    static void VulkanEnableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration, HVertexBuffer instance_buffer, uint32_t offset, HProgram program)
+    {
+        context->m_CurrentInstanceBuffer       = (DeviceBuffer*) instance_buffer;
+        context->m_CurrentInstanceDeclaration  = (VertexDeclaration*) instance_declaration;
+        context->m_CurrentInstanceBufferOffset = offset;
+        BindVertexDeclarationProgram(instance_declaration, (Program*) program);
+    }
+
+    static void VulkanDisableInstanceDeclaration(HContext context, HVertexDeclaration instance_declaration)
+    {
+        context->m_CurrentInstanceBuffer      = 0;
+        context->m_CurrentInstanceDeclaration = 0;
+    }
+
     static inline bool IsUniformTextureSampler(ShaderResourceBinding uniform)
     {
         return uniform.m_Type == ShaderDesc::SHADER_TYPE_SAMPLER2D ||
@@ -1921,7 +1947,7 @@ bail:
         Pipeline* pipeline = GetOrCreatePipeline(vk_device, vk_sample_count,
             context->m_PipelineState, context->m_PipelineCache,
             program_ptr, context->m_CurrentRenderTarget,
-            vertex_buffer, context->m_CurrentVertexDeclaration);
+            vertex_buffer, context->m_CurrentVertexDeclaration, context->m_CurrentInstanceDeclaration);
         vkCmdBindPipeline(vk_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, *pipeline);
 
 
@@ -1940,9 +1966,16 @@ bail:
         }
 
         // Bind the vertex buffers
-        VkBuffer vk_vertex_buffer             = vertex_buffer->m_Handle.m_Buffer;
-        VkDeviceSize vk_vertex_buffer_offsets = 0;
-        vkCmdBindVertexBuffers(vk_command_buffer, 0, 1, &vk_vertex_buffer, &vk_vertex_buffer_offsets);
+        VkBuffer vk_vertex_buffers[2]           = { vertex_buffer->m_Handle.m_Buffer, VK_NULL_HANDLE };
+        VkDeviceSize vk_vertex_buffer_offsets[2] = { 0, 0 };
+        uint32_t num_vertex_buffers              = 1;
+        if (context->m_CurrentInstanceDeclaration)
+        {
+            vk_vertex_buffers[1]        = context->m_CurrentInstanceBuffer->m_Handle.m_Buffer;
+            vk_vertex_buffer_offsets[1] = context->m_CurrentInstanceBufferOffset;
+            num_vertex_buffers          = 2;
+        }
+        vkCmdBindVertexBuffers(vk_command_buffer, 0, num_vertex_buffers, vk_vertex_buffers, vk_vertex_buffer_offsets);
     }
 
     void VulkanHashVertexDeclaration(HashState32 *state, HVertexDeclaration vertex_declaration)
@@ -1986,6 +2019,34 @@ bail:
         vkCmdDraw(vk_command_buffer, count, 1, first, 0);
     }
 
+    static void VulkanDrawElementsInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, Type type, HIndexBuffer index_buffer, uint32_t instance_count)
+    {
+        assert(context->m_FrameBegun);
+        assert(context->m_CurrentInstanceDeclaration);
+        DM_PROFILE(Graphics, "DrawElementsInstanced");
+        DM_COUNTER("DrawCalls", 1);
+        const uint8_t image_ix = context->m_SwapChain->m_ImageIndex;
+        VkCommandBuffer vk_command_buffer = context->m_MainCommandBuffers[image_ix];
+        context->m_PipelineState.m_PrimtiveType = prim_type;
+        DrawSetup(context, vk_command_buffer, &context->m_MainScratchBuffers[image_ix], (DeviceBuffer*) index_buffer, type);
+
+        uint32_t index_offset = first / (type == TYPE_UNSIGNED_SHORT ? 2 : 4);
+        vkCmdDrawIndexed(vk_command_buffer, count, instance_count, index_offset, 0, 0);
+    }
+
+    static void VulkanDrawInstanced(HContext context, PrimitiveType prim_type, uint32_t first, uint32_t count, uint32_t instance_count)
+    {
+        assert(context->m_FrameBegun);
+        assert(context->m_CurrentInstanceDeclaration);
+        DM_PROFILE(Graphics, "DrawInstanced");
+        DM_COUNTER("DrawCalls", 1);
+        const uint8_t image_ix = context->m_SwapChain->m_ImageIndex;
+        VkCommandBuffer vk_command_buffer = context->m_MainCommandBuffers[image_ix];
+        context->m_PipelineState.m_PrimtiveType = prim_type;
+        DrawSetup(context, vk_command_buffer, &context->m_MainScratchBuffers[image_ix], 0, TYPE_BYTE);
+        vkCmdDraw(vk_command_buffer, count, instance_count, first, 0);
+    }
+
     static void CreateShaderResourceBindings(ShaderModule* shader, ShaderDesc::Shader* ddf, uint32_t dynamicAlignment)
     {
         if (ddf->m_Uniforms.m_Count > 0)
@@ -3379,6 +3440,11 @@ bail:
         fn_table.m_HashVertexDeclaration = VulkanHashVertexDeclaration;
         fn_table.m_DrawElements = VulkanDrawElements;
         fn_table.m_Draw = VulkanDraw;
+        fn_table.m_IsInstancingSupported = VulkanIsInstancingSupported;
+        fn_table.m_EnableInstanceDeclaration = VulkanEnableInstanceDeclaration;
+        fn_table.m_DisableInstanceDeclaration = VulkanDisableInstanceDeclaration;
+        fn_table.m_DrawElementsInstanced = VulkanDrawElementsInstanced;
+        fn_table.m_DrawInstanced = VulkanDrawInstanced;
         fn_table.m_NewVertexProgram = VulkanNewVertexProgram;
         fn_table.m_NewFragmentProgram = VulkanNewFragmentProgram;
         fn_table.m_NewProgram = VulkanNewProgram;
@@ -65,6 +65,12 @@ namespace dmGui
     static inline void ResetInternalNode(HScene scene, InternalNode* n);
     static void RemoveFromNodeList(HScene scene, InternalNode* n);
 
+    // Makes the next RenderScene collect and sort the render entries again
+    static inline void InvalidateRenderEntries(HScene scene)
+    {
+        ++scene->m_StructureVersion;
+    }
+
     static const char* SCRIPT_FUNCTION_NAMES[] =
     {
         "init",
@@ -323,6 +329,7 @@ namespace dmGui
     void SetSceneAdjustReference(HScene scene, AdjustReference adjust_reference)
     {
         scene->m_AdjustReference = adjust_reference;
+        InvalidateRenderEntries(scene);
     }
 
     void SetDefaultNewSceneParams(NewSceneParams* params)
@@ -400,6 +407,8 @@ namespace dmGui
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NextVersionNumber = 0;
         scene->m_RenderOrder = 0;
+        scene->m_StructureVersion = 1;
+        scene->m_RenderStructureVersion = 0;
         scene->m_Width = context->m_DefaultProjectWidth;
         scene->m_Height = context->m_DefaultProjectHeight;
         scene->m_FetchTextureSetAnimCallback = params->m_FetchTextureSetAnimCallback;
@@ -810,6 +819,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             if (nodes[i].m_Node.m_LayerHash == layer_hash)
                 nodes[i].m_Node.m_LayerIndex = index;
         }
+        InvalidateRenderEntries(scene);
         return RESULT_OK;
     }
 
@@ -909,6 +919,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             set_node_callback(scene, GetNodeHandle(n), n->m_Node.m_NodeDescTable[index]);
             n->m_Node.m_DirtyLocal = 1;
         }
+        InvalidateRenderEntries(scene);
         return RESULT_OK;
     }
 
@@ -1390,30 +1401,67 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         CollectRenderEntries(scene, scene->m_RenderHead, 0, 0x0, clippers, render_entries);
     }
 
+    // Flags the enabled nodes whose render transform or opacity might have changed since the last RenderScene
+    static void UpdateDirtyRender(HScene scene, uint16_t start_index, bool parent_dirty)
+    {
+        uint16_t index = start_index;
+        while (index != INVALID_INDEX)
+        {
+            InternalNode* n = &scene->m_Nodes[index];
+            Node& node = n->m_Node;
+            if (node.m_Enabled)
+            {
+                // Auto sized flipbook nodes change size while animating
+                bool dirty = parent_dirty || node.m_DirtyLocal || node.m_DirtyRender ||
+                             (node.m_SizeMode != SIZE_MODE_MANUAL && node.m_TextureType == NODE_TEXTURE_TYPE_TEXTURE_SET);
+                node.m_DirtyRender = dirty;
+                UpdateDirtyRender(scene, n->m_ChildHead, dirty);
+            }
+            index = n->m_NextIndex;
+        }
+    }
+
+    static void CollectStencilScopes(HScene scene)
+    {
+        uint32_t entry_count = scene->m_RenderEntries.Size();
+        scene->m_StencilScopes.SetSize(entry_count);
+        for (uint32_t i = 0; i < entry_count; ++i)
+        {
+            const RenderEntry& entry = scene->m_RenderEntries[i];
+            uint16_t index = entry.m_Node & 0xffff;
+            InternalNode* n = &scene->m_Nodes[index];
+            StencilScope* scope = 0x0;
+            if (n->m_ClipperIndex != INVALID_INDEX) {
+                InternalClippingNode* clipper = &scene->m_StencilClippingNodes[n->m_ClipperIndex];
+                if (clipper->m_NodeIndex == index) {
+                    if (clipper->m_VisibleRenderKey == entry.m_RenderKey) {
+                        if (clipper->m_ParentIndex != INVALID_INDEX) {
+                            scope = &scene->m_StencilClippingNodes[clipper->m_ParentIndex].m_ChildScope;
+                        }
+                    } else {
+                        scope = &clipper->m_Scope;
+                    }
+                } else {
+                    scope = &clipper->m_ChildScope;
+                }
+            }
+            scene->m_StencilScopes[i] = scope;
+        }
+    }
+
     void RenderScene(HScene scene, const RenderSceneParams& params, void* context)
     {
+        DM_PROFILE(Gui, "RenderScene");
         Context* c = scene->m_Context;
 
         UpdateDynamicTextures(scene, params, context);
         DeferredDeleteDynamicTextures(scene, params, context);
 
-        c->m_RenderNodes.SetSize(0);
-        c->m_RenderTransforms.SetSize(0);
-        c->m_RenderOpacities.SetSize(0);
-        c->m_StencilClippingNodes.SetSize(0);
-        c->m_StencilScopes.SetSize(0);
-        c->m_StencilScopeIndices.SetSize(0);
         uint32_t capacity = scene->m_NodePool.Size() * 2;
-        if (capacity > c->m_RenderNodes.Capacity())
+        if (capacity > c->m_SceneTraversalCache.m_Data.Capacity())
         {
-            c->m_RenderNodes.SetCapacity(capacity);
-            c->m_RenderTransforms.SetCapacity(capacity);
-            c->m_RenderOpacities.SetCapacity(capacity);
             c->m_SceneTraversalCache.m_Data.SetCapacity(capacity);
             c->m_SceneTraversalCache.m_Data.SetSize(capacity);
-            c->m_StencilClippingNodes.SetCapacity(capacity);
-            c->m_StencilScopes.SetCapacity(capacity);
-            c->m_StencilScopeIndices.SetCapacity(capacity);
         }
 
         c->m_SceneTraversalCache.m_NodeIndex = 0;
@@ -1422,56 +1470,63 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             c->m_SceneTraversalCache.m_Version = 0;
         }
 
-        Matrix4 node_transform;
-        CollectNodes(scene, c->m_StencilClippingNodes, c->m_RenderNodes);
-        uint32_t node_count = c->m_RenderNodes.Size();
-        std::sort(c->m_RenderNodes.Begin(), c->m_RenderNodes.End(), RenderEntrySortPred(scene));
-        Matrix4 transform;
+        // The render entries (and their order and stencil scopes) only change when the node structure does.
+        // Particlefx emitters come and go without any structural change, so those scenes are always collected.
+        bool collect = scene->m_RenderStructureVersion != scene->m_StructureVersion || !scene->m_AliveParticlefxs.Empty();
+        if (collect)
+        {
+            DM_PROFILE(Gui, "CollectNodes");
+            scene->m_RenderEntries.SetSize(0);
+            scene->m_StencilClippingNodes.SetSize(0);
+            if (capacity > scene->m_RenderEntries.Capacity())
+            {
+                scene->m_RenderEntries.SetCapacity(capacity);
+                scene->m_StencilClippingNodes.SetCapacity(capacity);
+            }
 
-        if (c->m_RenderNodes.Capacity() > c->m_RenderTransforms.Capacity())
+            CollectNodes(scene, scene->m_StencilClippingNodes, scene->m_RenderEntries);
+            std::sort(scene->m_RenderEntries.Begin(), scene->m_RenderEntries.End(), RenderEntrySortPred(scene));
+
+            uint32_t entry_count = scene->m_RenderEntries.Size();
+            if (entry_count > scene->m_RenderTransforms.Capacity())
+            {
+                scene->m_RenderTransforms.SetCapacity(scene->m_RenderEntries.Capacity());
+                scene->m_RenderOpacities.SetCapacity(scene->m_RenderEntries.Capacity());
+                scene->m_StencilScopes.SetCapacity(scene->m_RenderEntries.Capacity());
+            }
+            scene->m_RenderTransforms.SetSize(entry_count);
+            scene->m_RenderOpacities.SetSize(entry_count);
+            CollectStencilScopes(scene);
+
+            scene->m_RenderStructureVersion = scene->m_StructureVersion;
+        }
+
+        // Without any structural change, only the transforms of nodes that changed (or have a changed ancestor) are recalculated
+        bool all_dirty = collect || (scene->m_ResChanged && scene->m_AdjustReference != ADJUST_REFERENCE_DISABLED);
+        if (!all_dirty)
         {
-            uint32_t new_capacity = c->m_RenderNodes.Capacity();
-            c->m_RenderTransforms.SetCapacity(new_capacity);
-            c->m_RenderOpacities.SetCapacity(new_capacity);
-            c->m_SceneTraversalCache.m_Data.SetCapacity(new_capacity);
-            c->m_SceneTraversalCache.m_Data.SetSize(new_capacity);
-            c->m_StencilClippingNodes.SetCapacity(new_capacity);
-            c->m_StencilScopes.SetCapacity(new_capacity);
-            c->m_StencilScopeIndices.SetCapacity(new_capacity);
+            UpdateDirtyRender(scene, scene->m_RenderHead, false);
         }
 
-        for (uint32_t i = 0; i < node_count; ++i)
+        uint32_t entry_count = scene->m_RenderEntries.Size();
+        const RenderEntry* entries = scene->m_RenderEntries.Begin();
+        for (uint32_t i = 0; i < entry_count; ++i)
         {
-            const RenderEntry& entry = c->m_RenderNodes[i];
-            uint16_t index = entry.m_Node & 0xffff;
-            InternalNode* n = &scene->m_Nodes[index];
-            float opacity = 1.0f;
-            CalculateNodeSize(n);
-            CalculateNodeTransformAndAlphaCached(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), transform, opacity);
-            c->m_RenderTransforms.Push(transform);
-            c->m_RenderOpacities.Push(opacity);
-            if (n->m_ClipperIndex != INVALID_INDEX) {
-                InternalClippingNode* clipper = &c->m_StencilClippingNodes[n->m_ClipperIndex];
-                if (clipper->m_NodeIndex == index) {
-                    if (clipper->m_VisibleRenderKey == entry.m_RenderKey) {
-                        StencilScope* scope = 0x0;
-                        if (clipper->m_ParentIndex != INVALID_INDEX) {
-                            scope = &c->m_StencilClippingNodes[clipper->m_ParentIndex].m_ChildScope;
-                        }
-                        c->m_StencilScopes.Push(scope);
-                    } else {
-                        c->m_StencilScopes.Push(&clipper->m_Scope);
-                    }
-                } else {
-                    c->m_StencilScopes.Push(&clipper->m_ChildScope);
-                }
-            } else {
-                c->m_StencilScopes.Push(0x0);
+            InternalNode* n = &scene->m_Nodes[entries[i].m_Node & 0xffff];
+            if (all_dirty || n->m_Node.m_DirtyRender)
+            {
+                CalculateNodeSize(n);
+                CalculateNodeTransformAndAlphaCached(scene, n, CalculateNodeTransformFlags(CALCULATE_NODE_INCLUDE_SIZE | CALCULATE_NODE_RESET_PIVOT), scene->m_RenderTransforms[i], scene->m_RenderOpacities[i]);
             }
         }
+        // Cleared in a separate pass since a node can have several entries
+        for (uint32_t i = 0; i < entry_count; ++i)
+        {
+            scene->m_Nodes[entries[i].m_Node & 0xffff].m_Node.m_DirtyRender = 0;
+        }
 
         scene->m_ResChanged = 0;
-        params.m_RenderNodes(scene, c->m_RenderNodes.Begin(), c->m_RenderTransforms.Begin(), c->m_RenderOpacities.Begin(), (const StencilScope**)c->m_StencilScopes.Begin(), c->m_RenderNodes.Size(), context);
+        params.m_RenderNodes(scene, scene->m_RenderEntries.Begin(), scene->m_RenderTransforms.Begin(), scene->m_RenderOpacities.Begin(), (const StencilScope**)scene->m_StencilScopes.Begin(), entry_count, context);
     }
 
     void RenderScene(HScene scene, RenderNodes render_nodes, void* context)
@@ -1481,17 +1536,42 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         RenderScene(scene, p, context);
     }
 
-    static bool IsNodeEnabledRecursive(HScene scene, uint16_t node_index)
+    static void CollectNodeEnabled(HScene scene, uint16_t start_index)
     {
-        InternalNode* node = &scene->m_Nodes[node_index];
-        if (node->m_Node.m_Enabled && node->m_ParentIndex != INVALID_INDEX)
+        uint8_t* node_enabled = scene->m_AnimationUpdate.m_NodeEnabled.Begin();
+        uint16_t index = start_index;
+        while (index != INVALID_INDEX)
         {
-            return IsNodeEnabledRecursive(scene, node->m_ParentIndex);
+            InternalNode* n = &scene->m_Nodes[index];
+            if (n->m_Node.m_Enabled)
+            {
+                node_enabled[index] = 1;
+                CollectNodeEnabled(scene, n->m_ChildHead);
+            }
+            index = n->m_NextIndex;
         }
-        else
+    }
+
+    // Caches if each node and all its ancestors are enabled, until the node structure changes
+    static void UpdateNodeEnabledCache(HScene scene)
+    {
+        AnimationUpdate& update = scene->m_AnimationUpdate;
+        if (update.m_NodeEnabledVersion == scene->m_StructureVersion)
+        {
+            return;
+        }
+        uint32_t node_count = scene->m_Nodes.Size();
+        if (node_count > update.m_NodeEnabled.Capacity())
+        {
+            update.m_NodeEnabled.SetCapacity(scene->m_Nodes.Capacity());
+        }
+        update.m_NodeEnabled.SetSize(node_count);
+        if (node_count > 0)
         {
-            return node->m_Node.m_Enabled;
+            memset(update.m_NodeEnabled.Begin(), 0, node_count);
         }
+        CollectNodeEnabled(scene, scene->m_RenderHead);
+        update.m_NodeEnabledVersion = scene->m_StructureVersion;
     }
 
     #define OLD_VERSION false
@@ -1567,9 +1647,31 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     void UpdateAnimations(HScene scene, float dt)
     {
         dmArray<Animation>* animations = &scene->m_Animations;
+        AnimationUpdate& update = scene->m_AnimationUpdate;
+
+        if (animations->Capacity() > update.m_Animations.Capacity())
+        {
+            uint32_t capacity = animations->Capacity();
+            update.m_Animations.SetCapacity(capacity);
+            update.m_Time.SetCapacity(capacity);
+            update.m_EasingSlots.SetCapacity(capacity);
+            update.m_EasingInput.SetCapacity(capacity);
+            update.m_EasingOutput.SetCapacity(capacity);
+            update.m_Completed.SetCapacity(capacity);
+        }
+        update.m_Animations.SetSize(0);
+        update.m_Time.SetSize(0);
+        update.m_Completed.SetSize(0);
+
+        if (!animations->Empty())
+        {
+            UpdateNodeEnabledCache(scene);
+        }
 
         uint32_t active_animations = 0;
+        uint32_t type_counts[dmEasing::TYPE_COUNT] = {0};
 
+        // Advance the animations, leaving the easing curves to be evaluated in batches below
         for (uint32_t i = 0; i < animations->Size(); ++i)
         {
             Animation* anim = &(*animations)[i];
@@ -1583,7 +1685,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             {
                 continue;
             }
-            if (!IsNodeEnabledRecursive(scene, anim->m_Node & 0xffff))
+            if (!update.m_NodeEnabled[anim->m_Node & 0xffff])
             {
                 continue;
             }
@@ -1623,11 +1725,9 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                     }
                 }
 
-                float x = dmEasing::GetValue(anim->m_Easing, t2);
-
-                *anim->m_Value = anim->m_From + (anim->m_To - anim->m_From) * x;
-                // Flag local transform as dirty for the node
-                scene->m_Nodes[anim->m_Node & 0xffff].m_Node.m_DirtyLocal = 1;
+                update.m_Animations.Push(i);
+                update.m_Time.Push(t2);
+                ++type_counts[anim->m_Easing.type];
 
                 // Animation complete, see above
                 if (t >= 1.0f)
@@ -1638,7 +1738,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                             anim->m_Backwards ^= 1;
                         }
                     } else {
-                        CompleteAnimation(scene, anim, true);
+                        update.m_Completed.Push(anim->m_Value);
                     }
                 }
             }
@@ -1648,6 +1748,68 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             }
         }
 
+        // Group the curve inputs by curve type
+        uint32_t update_count = update.m_Animations.Size();
+        uint32_t type_ends[dmEasing::TYPE_COUNT];
+        uint32_t offset = 0;
+        for (uint32_t type = 0; type < dmEasing::TYPE_COUNT; ++type)
+        {
+            type_ends[type] = offset;
+            offset += type_counts[type];
+        }
+        update.m_EasingSlots.SetSize(update_count);
+        update.m_EasingInput.SetSize(update_count);
+        update.m_EasingOutput.SetSize(update_count);
+        for (uint32_t i = 0; i < update_count; ++i)
+        {
+            const Animation* anim = &(*animations)[update.m_Animations[i]];
+            uint32_t slot = type_ends[anim->m_Easing.type]++;
+            update.m_EasingSlots[i] = slot;
+            update.m_EasingInput[slot] = update.m_Time[i];
+            // Custom curves each have their own samples
+            if (anim->m_Easing.type == dmEasing::TYPE_FLOAT_VECTOR)
+            {
+                update.m_EasingOutput[slot] = dmEasing::GetValue(anim->m_Easing, update.m_Time[i]);
+            }
+        }
+
+        uint32_t begin = 0;
+        for (uint32_t type = 0; type < dmEasing::TYPE_FLOAT_VECTOR; ++type)
+        {
+            uint32_t end = type_ends[type];
+            if (end > begin)
+            {
+                dmEasing::GetValues(dmEasing::Curve((dmEasing::Type) type), &update.m_EasingInput[begin], &update.m_EasingOutput[begin], end - begin);
+            }
+            begin = end;
+        }
+
+        for (uint32_t i = 0; i < update_count; ++i)
+        {
+            Animation* anim = &(*animations)[update.m_Animations[i]];
+            float x = update.m_EasingOutput[update.m_EasingSlots[i]];
+            *anim->m_Value = anim->m_From + (anim->m_To - anim->m_From) * x;
+            // Flag local transform as dirty for the node
+            scene->m_Nodes[anim->m_Node & 0xffff].m_Node.m_DirtyLocal = 1;
+        }
+
+        // The callbacks are invoked last since they might start, cancel or remove animations
+        uint32_t completed_count = update.m_Completed.Size();
+        for (uint32_t i = 0; i < completed_count; ++i)
+        {
+            uint32_t index = FindAnimation(*animations, update.m_Completed[i]);
+            if (index == 0xffffffff)
+            {
+                continue;
+            }
+            Animation* anim = &(*animations)[index];
+            // A previous callback might have started a new animation of the same value
+            if (!anim->m_FirstUpdate && !anim->m_Cancelled)
+            {
+                CompleteAnimation(scene, anim, true);
+            }
+        }
+
         uint32_t n = animations->Size();
         for (uint32_t i = 0; i < n; ++i)
         {
@@ -2126,6 +2288,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
                 dmParticle::DestroyInstance(scene->m_ParticlefxContext, c->m_Instance);
                 scene->m_AliveParticlefxs.EraseSwap(i);
+                InvalidateRenderEntries(scene);
                 --count;
             }
             else
@@ -2416,6 +2579,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             head = &parent_n->m_ChildHead;
             tail = &parent_n->m_ChildTail;
         }
+        InvalidateRenderEntries(scene);
         n->m_ParentIndex = parent_index;
         if (prev_n != 0x0)
         {
@@ -2452,6 +2616,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
 
     static void RemoveFromNodeList(HScene scene, InternalNode* n)
     {
+        InvalidateRenderEntries(scene);
         // Remove from list
         if (n->m_PrevIndex != INVALID_INDEX)
             scene->m_Nodes[n->m_PrevIndex].m_NextIndex = n->m_NextIndex;
@@ -2570,6 +2735,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         scene->m_RenderTail = INVALID_INDEX;
         scene->m_NodePool.Clear();
         scene->m_Animations.SetSize(0);
+        InvalidateRenderEntries(scene);
     }
 
     static Vector4 ApplyAdjustOnReferenceScale(const Vector4& reference_scale, uint32_t adjust_mode)
@@ -2671,12 +2837,15 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         }
 
         node.m_DirtyLocal = 0;
+        // The render transform is only recalculated for flagged nodes, see RenderScene
+        node.m_DirtyRender = 1;
     }
 
     void ResetNodes(HScene scene)
     {
         uint32_t n_nodes = scene->m_Nodes.Size();
         InternalNode* nodes = scene->m_Nodes.Begin();
+        bool reset = false;
         for (uint32_t i = 0; i < n_nodes; ++i) {
             InternalNode* node = &nodes[i];
             Node* n = &node->m_Node;
@@ -2684,8 +2853,13 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
                 memcpy(n->m_Properties, n->m_ResetPointProperties, sizeof(n->m_Properties));
                 n->m_DirtyLocal = 1;
                 n->m_State = n->m_ResetPointState;
+                reset = true;
             }
         }
+        if (reset) {
+            // The restored state includes the enabled and clipping states
+            InvalidateRenderEntries(scene);
+        }
         scene->m_Animations.SetSize(0);
     }
 
@@ -2855,6 +3029,8 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
         InternalNode* n = GetNode(scene, node);
         if (n->m_Node.m_TextureType == NODE_TEXTURE_TYPE_TEXTURE_SET)
             CancelNodeFlipbookAnim(scene, node);
+        // The size might change below
+        n->m_Node.m_DirtyLocal = 1;
         if (TextureInfo* texture_info = scene->m_Textures.Get(texture_id)) {
             n->m_Node.m_TextureHash = texture_id;
             n->m_Node.m_Texture = texture_info->m_TextureSource;
@@ -3252,6 +3428,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
             InternalNode* n = GetNode(scene, node);
             n->m_Node.m_LayerHash = layer_id;
             n->m_Node.m_LayerIndex = *layer_index;
+            InvalidateRenderEntries(scene);
             return RESULT_OK;
         }
         else
@@ -3275,6 +3452,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_InheritAlpha = inherit_alpha;
+        n->m_Node.m_DirtyLocal = 1;
     }
 
     float GetNodeFlipbookCursor(HScene scene, HNode node)
@@ -3555,6 +3733,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingMode = mode;
+        InvalidateRenderEntries(scene);
     }
 
     ClippingMode GetNodeClippingMode(HScene scene, HNode node)
@@ -3567,6 +3746,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingVisible = (uint32_t) visible;
+        InvalidateRenderEntries(scene);
     }
 
     bool GetNodeClippingVisible(HScene scene, HNode node)
@@ -3579,6 +3759,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_ClippingInverted = (uint32_t) inverted;
+        InvalidateRenderEntries(scene);
     }
 
     bool GetNodeClippingInverted(HScene scene, HNode node)
@@ -3626,6 +3807,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_XAnchor = (uint32_t) x_anchor;
+        n->m_Node.m_DirtyLocal = 1;
     }
 
     YAnchor GetNodeYAnchor(HScene scene, HNode node)
@@ -3638,6 +3820,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_YAnchor = (uint32_t) y_anchor;
+        n->m_Node.m_DirtyLocal = 1;
     }
 
 
@@ -3699,6 +3882,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Pivot = (uint32_t) pivot;
+        n->m_Node.m_DirtyLocal = 1;
     }
 
     bool GetNodeIsBone(HScene scene, HNode node)
@@ -3717,12 +3901,14 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_AdjustMode = (uint32_t) adjust_mode;
+        n->m_Node.m_DirtyLocal = 1;
     }
 
     void SetNodeSizeMode(HScene scene, HNode node, SizeMode size_mode)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_SizeMode = (uint32_t) size_mode;
+        n->m_Node.m_DirtyLocal = 1;
         if((n->m_Node.m_SizeMode != SIZE_MODE_MANUAL) && (n->m_Node.m_NodeType != NODE_TYPE_SPINE) && (n->m_Node.m_NodeType != NODE_TYPE_PARTICLEFX))
         {
             if (TextureInfo* texture_info = scene->m_Textures.Get(n->m_Node.m_TextureHash))
@@ -4166,6 +4352,7 @@ Result DeleteDynamicTexture(HScene scene, const dmhash_t texture_hash)
     {
         InternalNode* n = GetNode(scene, node);
         n->m_Node.m_Enabled = enabled;
+        InvalidateRenderEntries(scene);
         if(enabled)
         {
             SetDirtyLocalRecursive(scene, node);
@@ -88,12 +88,6 @@ namespace dmGui
         uint32_t                        m_DefaultProjectHeight;
         uint32_t                        m_Dpi;
         dmArray<HScene>                 m_Scenes;
-        dmArray<RenderEntry>            m_RenderNodes;
-        dmArray<Matrix4>                m_RenderTransforms;
-        dmArray<float>                	m_RenderOpacities;
-        dmArray<InternalClippingNode>   m_StencilClippingNodes;
-        dmArray<StencilScope*>          m_StencilScopes;
-        dmArray<uint16_t>               m_StencilScopeIndices;
         dmArray<HNode>                  m_ScratchBoneNodes;
         dmHID::HContext                 m_HidContext;
         void*                           m_DefaultFont;
@@ -132,7 +126,8 @@ namespace dmGui
                 uint32_t    m_ClippingInverted : 1;
                 uint32_t    m_IsBone : 1;
                 uint32_t    m_HasHeadlessPfx : 1;
-                uint32_t    m_Reserved : 3;
+                uint32_t    m_DirtyRender : 1; // The render transform and opacity need to be recalculated, see RenderScene
+                uint32_t    m_Reserved : 2;
             };
 
             uint32_t m_State;
@@ -210,6 +205,20 @@ namespace dmGui
         uint16_t m_Backwards : 1;
     };
 
+    // Per frame scratch data of UpdateAnimations. The running animations are laid out as arrays, with the easing
+    // curve input/output grouped by curve type so each group can be evaluated in one batch.
+    struct AnimationUpdate
+    {
+        dmArray<uint32_t>       m_Animations;   // Index into Scene::m_Animations
+        dmArray<float>          m_Time;         // Easing curve input
+        dmArray<uint32_t>       m_EasingSlots;  // Index into m_EasingInput/m_EasingOutput
+        dmArray<float>          m_EasingInput;
+        dmArray<float>          m_EasingOutput;
+        dmArray<float*>         m_Completed;    // Animation::m_Value of the animations that completed this frame
+        dmArray<uint8_t>        m_NodeEnabled;  // Enabled state of the node and all its ancestors, by node index
+        uint32_t                m_NodeEnabledVersion; // The Scene::m_StructureVersion m_NodeEnabled was cached for
+    };
+
     struct SpineAnimation
     {
         HNode    m_Node;
@@ -279,6 +288,7 @@ namespace dmGui
         dmIndexPool16           m_NodePool;
         dmArray<InternalNode>   m_Nodes;
         dmArray<Animation>      m_Animations;
+        AnimationUpdate         m_AnimationUpdate;
         dmArray<SpineAnimation> m_SpineAnimations;
         dmHashTable64<void*>    m_Fonts;
         dmHashTable64<TextureInfo>    m_Textures;
@@ -302,6 +312,14 @@ namespace dmGui
         uint16_t                m_RenderOrder; // For the render-key
         uint16_t                m_NextLayerIndex;
         uint16_t                m_ResChanged : 1;
+        // Render entries and stencil scopes collected by RenderScene, reused until the node structure changes
+        dmArray<RenderEntry>    m_RenderEntries;
+        dmArray<Matrix4>        m_RenderTransforms;
+        dmArray<float>          m_RenderOpacities;
+        dmArray<InternalClippingNode> m_StencilClippingNodes;
+        dmArray<StencilScope*>  m_StencilScopes;
+        uint32_t                m_StructureVersion; // Bumped when nodes are added, removed, moved, enabled/disabled or change layer or clipping
+        uint32_t                m_RenderStructureVersion; // The m_StructureVersion the render entries were collected for
         uint32_t                m_Width;
         uint32_t                m_Height;
         dmScript::ScriptWorld*  m_ScriptWorld;
@@ -2036,7 +2036,9 @@ namespace dmGui
         HNode hnode;
         InternalNode* n = LuaCheckNode(L, 1, &hnode);
         int clipping_mode = (int) luaL_checknumber(L, 2);
-        n->m_Node.m_ClippingMode = (ClippingMode) clipping_mode;
+        (void) n;
+        Scene* scene = GuiScriptInstance_Check(L);
+        SetNodeClippingMode(scene, hnode, (ClippingMode) clipping_mode);
         return 0;
     }
 
@@ -2067,7 +2069,9 @@ namespace dmGui
         HNode hnode;
         InternalNode* n = LuaCheckNode(L, 1, &hnode);
         int visible = lua_toboolean(L, 2);
-        n->m_Node.m_ClippingVisible = visible;
+        (void) n;
+        Scene* scene = GuiScriptInstance_Check(L);
+        SetNodeClippingVisible(scene, hnode, visible != 0);
         return 0;
     }
 
@@ -2098,7 +2102,9 @@ namespace dmGui
         HNode hnode;
         InternalNode* n = LuaCheckNode(L, 1, &hnode);
         int inverted = lua_toboolean(L, 2);
-        n->m_Node.m_ClippingInverted = inverted;
+        (void) n;
+        Scene* scene = GuiScriptInstance_Check(L);
+        SetNodeClippingInverted(scene, hnode, inverted != 0);
         return 0;
     }
 
@@ -2917,7 +2923,9 @@ namespace dmGui
         HNode hnode;
         InternalNode* n = LuaCheckNode(L, 1, &hnode);
         int adjust_mode = (int) luaL_checknumber(L, 2);
-        n->m_Node.m_AdjustMode = (AdjustMode) adjust_mode;
+        (void) n;
+        Scene* scene = GuiScriptInstance_Check(L);
+        SetNodeAdjustMode(scene, hnode, (AdjustMode) adjust_mode);
         return 0;
     }
 
@@ -4511,7 +4519,9 @@ namespace dmGui
         HNode hnode;
         InternalNode* n = LuaCheckNode(L, 1, &hnode);
         int inherit_alpha = lua_toboolean(L, 2);
-        n->m_Node.m_InheritAlpha = inherit_alpha;
+        (void) n;
+        Scene* scene = GuiScriptInstance_Check(L);
+        SetNodeInheritAlpha(scene, hnode, inherit_alpha != 0);
 
         assert(top == lua_gettop(L));
         return 0;
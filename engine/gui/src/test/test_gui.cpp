@@ -19,6 +19,7 @@
 #include <dlib/hash.h>
 #include <dlib/math.h>
 #include <dlib/message.h>
+#include <dlib/time.h>
 #include <dlib/log.h>
 #include <particle/particle.h>
 #include <script/script.h>
@@ -1743,6 +1744,92 @@ TEST_F(dmGuiTest, AnimateNodeOfDisabledParent)
     dmGui::DeleteNode(m_Scene, parent, true);
 }
 
+// Verify that animations with different easing curves, evaluated in batches per curve type, each get their own curve
+TEST_F(dmGuiTest, AnimateNodeEasingTypes)
+{
+    dmGui::HNode parent = dmGui::NewNode(m_Scene, Point3(0,0,0), Vector3(10,10,0), dmGui::NODE_TYPE_BOX);
+    dmhash_t property = dmHashString64("position.x");
+    dmArray<dmGui::HNode> nodes;
+    nodes.SetCapacity(dmEasing::TYPE_FLOAT_VECTOR);
+    for (uint32_t type = 0; type < dmEasing::TYPE_FLOAT_VECTOR; type += 2)
+    {
+        dmGui::HNode node = dmGui::NewNode(m_Scene, Point3(0,0,0), Vector3(10,10,0), dmGui::NODE_TYPE_BOX);
+        dmGui::SetNodeParent(m_Scene, node, parent, false);
+        dmGui::AnimateNodeHash(m_Scene, node, property, Vector4(1,0,0,0), dmEasing::Curve((dmEasing::Type) type), dmGui::PLAYBACK_ONCE_FORWARD, 1.0f, 0.0f, 0, 0, 0);
+        nodes.Push(node);
+    }
+
+    for (int i = 0; i < 15; ++i)
+        dmGui::UpdateScene(m_Scene, 1.0f / 60.0f);
+
+    // No progress while the parent is disabled
+    dmGui::SetNodeEnabled(m_Scene, parent, false);
+    for (int i = 0; i < 15; ++i)
+        dmGui::UpdateScene(m_Scene, 1.0f / 60.0f);
+    dmGui::SetNodeEnabled(m_Scene, parent, true);
+
+    for (int i = 0; i < 15; ++i)
+        dmGui::UpdateScene(m_Scene, 1.0f / 60.0f);
+
+    for (uint32_t i = 0; i < nodes.Size(); ++i)
+    {
+        float expected = dmEasing::GetValue((dmEasing::Type) (i * 2), 0.5f);
+        ASSERT_NEAR(expected, dmGui::GetNodePosition(m_Scene, nodes[i]).getX(), 0.0001f);
+    }
+
+    dmGui::DeleteNode(m_Scene, parent, true);
+}
+
+TEST_F(dmGuiTest, BenchAnimations)
+{
+    const uint32_t frame_count = 200;
+    // Full vector property animations, 4 animations each
+    const dmhash_t properties[] = { dmHashString64("position"), dmHashString64("rotation"), dmHashString64("scale"), dmHashString64("color"), dmHashString64("size") };
+    const uint32_t property_count = DM_ARRAY_SIZE(properties);
+    const uint32_t animation_counts[] = { 1000, 5000, 20000 };
+
+    for (uint32_t c = 0; c < DM_ARRAY_SIZE(animation_counts); ++c)
+    {
+        uint32_t animation_count = animation_counts[c];
+        uint32_t node_count = animation_count / (property_count * 4);
+
+        dmGui::NewSceneParams params;
+        params.m_MaxNodes = node_count;
+        params.m_MaxAnimations = animation_count;
+        params.m_UserData = this;
+        dmGui::HScene scene = dmGui::NewScene(m_Context, &params);
+
+        // Chains of 8 nodes, animated with a mix of easing curves
+        dmGui::HNode parent = dmGui::INVALID_HANDLE;
+        for (uint32_t i = 0; i < node_count; ++i)
+        {
+            dmGui::HNode node = dmGui::NewNode(scene, Point3(0,0,0), Vector3(10,10,0), dmGui::NODE_TYPE_BOX);
+            if (i % 8 != 0)
+            {
+                dmGui::SetNodeParent(scene, node, parent, false);
+            }
+            parent = node;
+            for (uint32_t p = 0; p < property_count; ++p)
+            {
+                dmEasing::Type type = (dmEasing::Type) ((i * property_count + p) % dmEasing::TYPE_FLOAT_VECTOR);
+                dmGui::AnimateNodeHash(scene, node, properties[p], Vector4(1,1,1,1), dmEasing::Curve(type), dmGui::PLAYBACK_LOOP_PINGPONG, 1.0f, 0.0f, 0, 0, 0);
+            }
+        }
+        ASSERT_EQ(animation_count, scene->m_Animations.Size());
+
+        uint64_t start = dmTime::GetTime();
+        for (uint32_t frame = 0; frame < frame_count; ++frame)
+        {
+            dmGui::UpdateScene(scene, 1.0f / 60.0f);
+        }
+        uint64_t end = dmTime::GetTime();
+        printf("Bench elapsed: %u animations on %u nodes, %u frames: %.2f ms (%.2f us/frame)\n", animation_count, node_count, frame_count,
+                (end - start) / 1000.0, (end - start) / (double)frame_count);
+
+        dmGui::DeleteScene(scene);
+    }
+}
+
 TEST_F(dmGuiTest, Reset)
 {
     dmGui::HNode n1 = dmGui::NewNode(m_Scene, Point3(10, 20, 30), Vector3(10,10,0), dmGui::NODE_TYPE_BOX);
@@ -4321,8 +4408,147 @@ TEST_F(dmGuiTest, HierarchicalTransforms)
     ASSERT_MAT4(transforms[0], transforms[2]);
 }
 
+// Verify that the cached render entries and transforms are kept up to date between renders:
+// - n1
+//   - n2
+// - n3
+TEST_F(dmGuiTest, RenderSceneCachedEntries)
+{
+    Vector3 size(1, 1, 0);
+
+    dmGui::HNode n1 = dmGui::NewNode(m_Scene, Point3(0.0f, 0.0f, 0.0f), size, dmGui::NODE_TYPE_BOX);
+    dmGui::HNode n2 = dmGui::NewNode(m_Scene, Point3(1.0f, 0.0f, 0.0f), size, dmGui::NODE_TYPE_BOX);
+    dmGui::HNode n3 = dmGui::NewNode(m_Scene, Point3(0.0f, 2.0f, 0.0f), size, dmGui::NODE_TYPE_BOX);
+    dmGui::SetNodeParent(m_Scene, n2, n1, false);
+
+    Vectormath::Aos::Matrix4 transforms[3];
+    dmGui::RenderScene(m_Scene, RenderNodesStoreTransform, transforms);
+    Vectormath::Aos::Matrix4 n2_transform = transforms[1];
+    Vectormath::Aos::Matrix4 n3_transform = transforms[2];
+
+    // Nothing changed
+    dmGui::RenderScene(m_Scene, RenderNodesStoreTransform, transforms);
+    ASSERT_MAT4(n2_transform, transforms[1]);
+    ASSERT_MAT4(n3_transform, transforms[2]);
+
+    // Moving the parent moves the child, but not the sibling
+    dmGui::SetNodePosition(m_Scene, n1, Point3(0.0f, 1.0f, 0.0f));
+    dmGui::RenderScene(m_Scene, RenderNodesStoreTransform, transforms);
+    n2_transform.setTranslation(n2_transform.getTranslation() + Vector3(0.0f, 1.0f, 0.0f));
+    ASSERT_MAT4(n2_transform, transforms[1]);
+    ASSERT_MAT4(n3_transform, transforms[2]);
+
+    // A transform calculated outside of the rendering is still picked up
+    dmGui::SetNodePosition(m_Scene, n1, Point3(0.0f, 2.0f, 0.0f));
+    dmGui::GetNodeWorldTransform(m_Scene, n2);
+    dmGui::RenderScene(m_Scene, RenderNodesStoreTransform, transforms);
+    n2_transform.setTranslation(n2_transform.getTranslation() + Vector3(0.0f, 1.0f, 0.0f));
+    ASSERT_MAT4(n2_transform, transforms[1]);
+
+    // Enabling and disabling rebuilds the entries
+    uint32_t count = 0;
+    dmGui::SetNodeEnabled(m_Scene, n1, false);
+    dmGui::RenderScene(m_Scene, RenderNodesCount, &count);
+    ASSERT_EQ(1u, count);
+    dmGui::SetNodeEnabled(m_Scene, n1, true);
+    dmGui::RenderScene(m_Scene, RenderNodesCount, &count);
+    ASSERT_EQ(3u, count);
+
+    // So does moving nodes around
+    std::map<dmGui::HNode, uint16_t> order;
+    dmGui::MoveNodeAbove(m_Scene, n1, n3);
+    dmGui::RenderScene(m_Scene, RenderNodesOrder, &order);
+    ASSERT_EQ(0u, order[n3]);
+    ASSERT_EQ(1u, order[n1]);
+    ASSERT_EQ(2u, order[n2]);
+
+    dmGui::DeleteNode(m_Scene, n3, true);
+    dmGui::RenderScene(m_Scene, RenderNodesCount, &count);
+    ASSERT_EQ(2u, count);
+
+    // Resetting nodes restores the enabled state
+    dmGui::SetNodeResetPoint(m_Scene, n1);
+    dmGui::SetNodeEnabled(m_Scene, n1, false);
+    dmGui::RenderScene(m_Scene, RenderNodesCount, &count);
+    ASSERT_EQ(0u, count);
+    dmGui::ResetNodes(m_Scene);
+    dmGui::RenderScene(m_Scene, RenderNodesCount, &count);
+    ASSERT_EQ(2u, count);
+}
+
 #undef ASSERT_MAT4
 
+static void RenderNodesNoop(dmGui::HScene scene, const dmGui::RenderEntry* nodes, const Vectormath::Aos::Matrix4* node_transforms, const float* node_opacities,
+        const dmGui::StencilScope** stencil_scopes, uint32_t node_count, void* context)
+{
+}
+
+TEST_F(dmGuiTest, BenchRenderScene)
+{
+    // 100 root nodes, each with a chain of 3 children with 2 leaves each
+    const uint32_t root_count = 100;
+    const uint32_t frame_count = 1000;
+
+    dmGui::NewSceneParams params;
+    params.m_MaxNodes = 1024;
+    params.m_MaxAnimations = MAX_ANIMATIONS;
+    params.m_UserData = this;
+    dmGui::HScene scene = dmGui::NewScene(m_Context, &params);
+
+    Vector3 size(10, 10, 0);
+    dmArray<dmGui::HNode> nodes;
+    nodes.SetCapacity(params.m_MaxNodes);
+    for (uint32_t i = 0; i < root_count; ++i)
+    {
+        dmGui::HNode parent = dmGui::NewNode(scene, Point3(i, 0.0f, 0.0f), size, dmGui::NODE_TYPE_BOX);
+        nodes.Push(parent);
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            dmGui::HNode child = dmGui::NewNode(scene, Point3(0.0f, 1.0f, 0.0f), size, dmGui::NODE_TYPE_BOX);
+            dmGui::SetNodeParent(scene, child, parent, false);
+            nodes.Push(child);
+            for (uint32_t k = 0; k < 2; ++k)
+            {
+                dmGui::HNode leaf = dmGui::NewNode(scene, Point3(1.0f, 0.0f, 0.0f), size, dmGui::NODE_TYPE_BOX);
+                dmGui::SetNodeParent(scene, leaf, child, false);
+                nodes.Push(leaf);
+            }
+            parent = child;
+        }
+    }
+    uint32_t node_count = nodes.Size();
+
+    const char* names[] = { "full rebuild", "static", "animated" };
+    for (uint32_t pass = 0; pass < 3; ++pass)
+    {
+        uint32_t seed = 0;
+        uint64_t start = dmTime::GetTime();
+        for (uint32_t frame = 0; frame < frame_count; ++frame)
+        {
+            if (pass == 0)
+            {
+                // What every frame used to cost
+                ++scene->m_StructureVersion;
+            }
+            else if (pass == 2)
+            {
+                // Move 10% of the nodes each frame
+                for (uint32_t i = 0; i < node_count / 10; ++i)
+                {
+                    dmGui::HNode node = nodes[dmMath::Rand(&seed) % node_count];
+                    dmGui::SetNodePosition(scene, node, Point3(dmMath::RandOpen01(&seed), dmMath::RandOpen01(&seed), 0.0f));
+                }
+            }
+            dmGui::RenderScene(scene, RenderNodesNoop, 0x0);
+        }
+        uint64_t end = dmTime::GetTime();
+        printf("Bench elapsed: %s, %u nodes, %u frames: %.2f ms (%.2f us/frame)\n", names[pass], node_count, frame_count,
+                (end - start) / 1000.0, (end - start) / (double)frame_count);
+    }
+
+    dmGui::DeleteScene(scene);
+}
+
 struct TransformColorData
 {
     Vectormath::Aos::Matrix4 m_Transform;
@@ -13,16 +13,17 @@
 #include <string.h>
 #include <stdint.h>
 #include <float.h>
-#include <algorithm>
 #include <dlib/hash.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/memory.h>
 #include <dlib/vmath.h>
 #include <dlib/profile.h>
 #include <dlib/time.h>
 
 #include "particle.h"
 #include "particle_private.h"
+#include "particle_simd.h"
 
 namespace dmParticle
 {
@@ -173,11 +174,80 @@ namespace dmParticle
         }
     }
 
+    /// Number of float streams in ParticleStreams, including the sort scratch
+    static const uint32_t PARTICLE_FLOAT_STREAM_COUNT = 8;
+
+    static void CopyParticleStream(float* dst, const float* src, uint32_t count)
+    {
+        memcpy(dst, src, count * sizeof(float));
+    }
+
+    /**
+     * Resize the particle streams of the emitter, keeping the state of the particles in m_Particles.
+     * Must be called after m_Particles has been resized.
+     */
+    static void SetParticleStreamsCapacity(Emitter* emitter, uint32_t capacity)
+    {
+        const uint32_t width = dmParticleSimd::WIDTH;
+        uint32_t padded_capacity = (capacity + width - 1) & ~(width - 1);
+        ParticleStreams old = emitter->m_Streams;
+        if (padded_capacity == old.m_Capacity)
+            return;
+
+        ParticleStreams& streams = emitter->m_Streams;
+        memset(&streams, 0, sizeof(ParticleStreams));
+        if (padded_capacity > 0)
+        {
+            uint32_t size = padded_capacity * (PARTICLE_FLOAT_STREAM_COUNT * sizeof(float) + 2 * sizeof(uint64_t));
+            void* memory = 0x0;
+            dmMemory::Result r = dmMemory::AlignedMalloc(&memory, 16, size);
+            assert(r == dmMemory::RESULT_OK);
+            (void)r;
+            memset(memory, 0, size);
+
+            float* stream = (float*)memory;
+            streams.m_PositionX = stream;
+            streams.m_PositionY = (stream += padded_capacity);
+            streams.m_PositionZ = (stream += padded_capacity);
+            streams.m_VelocityX = (stream += padded_capacity);
+            streams.m_VelocityY = (stream += padded_capacity);
+            streams.m_VelocityZ = (stream += padded_capacity);
+            streams.m_SpreadFactor = (stream += padded_capacity);
+            streams.m_Scratch = (stream += padded_capacity);
+            streams.m_SortPairs = (uint64_t*)(stream + padded_capacity);
+            streams.m_SortScratch = streams.m_SortPairs + padded_capacity;
+            streams.m_Memory = memory;
+            streams.m_Capacity = padded_capacity;
+
+            uint32_t count = dmMath::Min(emitter->m_Particles.Size(), padded_capacity);
+            if (old.m_Capacity > 0 && count > 0)
+            {
+                CopyParticleStream(streams.m_PositionX, old.m_PositionX, count);
+                CopyParticleStream(streams.m_PositionY, old.m_PositionY, count);
+                CopyParticleStream(streams.m_PositionZ, old.m_PositionZ, count);
+                CopyParticleStream(streams.m_VelocityX, old.m_VelocityX, count);
+                CopyParticleStream(streams.m_VelocityY, old.m_VelocityY, count);
+                CopyParticleStream(streams.m_VelocityZ, old.m_VelocityZ, count);
+                CopyParticleStream(streams.m_SpreadFactor, old.m_SpreadFactor, count);
+            }
+        }
+        if (old.m_Memory != 0x0)
+        {
+            dmMemory::AlignedFree(old.m_Memory);
+        }
+    }
+
+    static void SetParticleCapacity(Emitter* emitter, uint32_t capacity)
+    {
+        emitter->m_Particles.SetCapacity(capacity);
+        SetParticleStreamsCapacity(emitter, capacity);
+    }
+
     static void InitEmitter(Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, uint32_t original_seed)
     {
         emitter->m_Id = dmHashString64(emitter_ddf->m_Id);
         uint32_t particle_count = emitter_ddf->m_MaxParticleCount;
-        emitter->m_Particles.SetCapacity(particle_count);
+        SetParticleCapacity(emitter, particle_count);
         emitter->m_OriginalSeed = original_seed;
 
         uint32_t seed = original_seed;
@@ -253,7 +323,7 @@ namespace dmParticle
         for (uint32_t emitter_i = 0; emitter_i < emitter_count; ++emitter_i)
         {
             Emitter* emitter = &i->m_Emitters[emitter_i];
-            emitter->m_Particles.SetCapacity(0);
+            SetParticleCapacity(emitter, 0);
             emitter->m_RenderConstants.SetCapacity(0);
         }
         delete i;
@@ -359,7 +429,7 @@ namespace dmParticle
             {
                 for (uint32_t emitter_i = prototype_emitter_count; emitter_i < emitter_count; ++emitter_i)
                 {
-                    emitters[emitter_i].m_Particles.SetCapacity(0);
+                    SetParticleCapacity(&emitters[emitter_i], 0);
                 }
             }
             emitters.SetCapacity(prototype_emitter_count);
@@ -470,6 +540,7 @@ namespace dmParticle
         // Save particles array and id
         dmArray<Particle> tmp;
         tmp.Swap(emitter->m_Particles);
+        ParticleStreams streams = emitter->m_Streams;
         dmhash_t id = emitter->m_Id;
         uint32_t original_seed = emitter->m_OriginalSeed;
         float duration = emitter->m_Duration;
@@ -481,6 +552,7 @@ namespace dmParticle
 
         // Restore particles and id
         tmp.Swap(emitter->m_Particles);
+        emitter->m_Streams = streams;
         emitter->m_Id = id;
 
         // Remove living particles
@@ -578,26 +650,42 @@ namespace dmParticle
     static void EvaluateEmitterProperties(Emitter* emitter, Property* emitter_properties, float duration, float properties[EMITTER_KEY_COUNT]);
     static void EvaluateParticleProperties(Emitter* emitter, Property* particle_properties, dmParticleDDF::Emitter* emitter_ddf, float dt);
     static uint32_t UpdateRenderData(HParticleContext context, Instance* instance, Emitter* emitter, dmParticleDDF::Emitter* ddf, const Vector4& color, uint32_t vertex_index, void* vertex_buffer, uint32_t vertex_buffer_size, float dt, ParticleVertexFormat format);
-    static void GenerateKeys(Emitter* emitter, float max_particle_life_time);
-    static void SortParticles(Emitter* emitter);
     static void Simulate(Instance* instance, Emitter* emitter, EmitterPrototype* prototype, dmParticleDDF::Emitter* ddf, float dt);
 
-    static void UpdateEmitter(Prototype* prototype, Instance* instance, EmitterPrototype* emitter_prototype, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
+    /**
+     * Steps the particle life times and the emitter state, which spawns new particles.
+     * @return true if the particles of the emitter should be simulated
+     */
+    static bool StepEmitter(Instance* instance, EmitterPrototype* emitter_prototype, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
         // Don't update emitter if time is standing still
         if (IsSleeping(emitter) || dt <= 0.0f)
-            return;
+            return false;
 
         UpdateParticles(instance, emitter, emitter_ddf, dt);
 
         UpdateEmitterState(instance, emitter, emitter_prototype, emitter_ddf, dt);
+        return true;
+    }
 
+    /**
+     * Sorts and simulates the particles of the emitter.
+     * Only touches the emitter itself, which makes it safe to call concurrently for different emitters.
+     */
+    static void SimulateEmitter(Instance* instance, EmitterPrototype* emitter_prototype, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
+    {
         GenerateKeys(emitter, emitter_prototype->m_MaxParticleLifeTime);
         SortParticles(emitter);
 
         Simulate(instance, emitter, emitter_prototype, emitter_ddf, dt);
     }
 
+    static void UpdateEmitter(Prototype* prototype, Instance* instance, EmitterPrototype* emitter_prototype, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
+    {
+        if (StepEmitter(instance, emitter_prototype, emitter, emitter_ddf, dt))
+            SimulateEmitter(instance, emitter_prototype, emitter, emitter_ddf, dt);
+    }
+
     static void UpdateEmitterVelocity(Instance* instance, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
         // Update emitter velocity (1-frame estimate)
@@ -654,12 +742,129 @@ namespace dmParticle
         context->m_Stats.m_Particles = vertex_index / 6; // Debug data for editor playback
     }
 
+    struct GenerateVertexDataContext
+    {
+        Context*                m_Context;
+        float                   m_DT;
+        Vector4                 m_Color;
+        void*                   m_VertexBuffer;
+        uint32_t                m_VertexBufferSize;
+        ParticleVertexFormat    m_VertexFormat;
+    };
+
+    static void GenerateVertexDataRange(void* _ctx, uint32_t start, uint32_t end)
+    {
+        GenerateVertexDataContext* ctx = (GenerateVertexDataContext*)_ctx;
+        EmitterVertexJob* jobs = ctx->m_Context->m_VertexJobs.Begin();
+        for (uint32_t i = start; i < end; ++i)
+        {
+            EmitterVertexJob* job = &jobs[i];
+            dmParticleDDF::Emitter* emitter_ddf = &job->m_Instance->m_Prototype->m_DDF->m_Emitters[job->m_EmitterIndex];
+            UpdateRenderData(ctx->m_Context, job->m_Instance, job->m_Emitter, emitter_ddf, ctx->m_Color, job->m_VertexIndex, ctx->m_VertexBuffer, ctx->m_VertexBufferSize, ctx->m_DT, ctx->m_VertexFormat);
+        }
+    }
+
+    void GenerateVertexDataBatch(HParticleContext context, float dt, EmitterRenderData* const* emitters, uint32_t emitter_count, const Vector4& color, void* vertex_buffer, uint32_t vertex_buffer_size, uint32_t* out_vertex_buffer_size, ParticleVertexFormat vertex_format)
+    {
+        DM_PROFILE(Particle, "GenerateVertexDataBatch");
+
+        uint32_t vertex_size = sizeof(Vertex);
+
+        if (vertex_format == PARTICLE_GUI)
+        {
+            vertex_size = sizeof(ParticleGuiVertex);
+        }
+
+        uint32_t vertex_index = *out_vertex_buffer_size / vertex_size;
+        if (vertex_buffer == 0x0 || vertex_buffer_size == 0)
+            emitter_count = 0;
+
+        // Reserve the vertex range of each emitter up front, the same way UpdateRenderData would fill the
+        // buffer when called for one emitter at a time. The emitters can then be written to the buffer concurrently.
+        const uint32_t vertices_per_particle = 6;
+        uint32_t max_vertex_count = vertex_buffer_size / vertex_size;
+        dmArray<EmitterVertexJob>& jobs = context->m_VertexJobs;
+        jobs.SetSize(0);
+        if (jobs.Capacity() < emitter_count)
+        {
+            jobs.SetCapacity(emitter_count);
+        }
+        for (uint32_t i = 0; i < emitter_count; ++i)
+        {
+            const EmitterRenderData* render_data = emitters[i];
+            if (render_data->m_Instance == INVALID_INSTANCE)
+                continue;
+            Instance* inst = GetInstance(context, render_data->m_Instance);
+            if (!inst || IsSleeping(inst))
+                continue;
+
+            EmitterVertexJob job;
+            job.m_Instance = inst;
+            job.m_Emitter = &inst->m_Emitters[render_data->m_EmitterIndex];
+            job.m_EmitterIndex = render_data->m_EmitterIndex;
+            job.m_VertexIndex = vertex_index;
+            jobs.Push(job);
+
+            uint32_t particle_count = job.m_Emitter->m_Particles.Size();
+            if (vertex_index < max_vertex_count)
+            {
+                vertex_index += dmMath::Min(particle_count, (max_vertex_count - vertex_index) / vertices_per_particle) * vertices_per_particle;
+            }
+        }
+
+        GenerateVertexDataContext ctx;
+        ctx.m_Context = context;
+        ctx.m_DT = dt;
+        ctx.m_Color = color;
+        ctx.m_VertexBuffer = vertex_buffer;
+        ctx.m_VertexBufferSize = vertex_buffer_size;
+        ctx.m_VertexFormat = vertex_format;
+        dmWorkerPool::ParallelFor(context->m_WorkerPool, GenerateVertexDataRange, &ctx, jobs.Size(), 1);
+
+        *out_vertex_buffer_size = vertex_index * vertex_size;
+
+        context->m_Stats.m_Particles = vertex_index / vertices_per_particle; // Debug data for editor playback
+    }
+
+    void SetWorkerPool(HParticleContext context, dmWorkerPool::HWorkerPool pool)
+    {
+        context->m_WorkerPool = pool;
+    }
+
+    struct SimulateEmittersContext
+    {
+        Context*    m_Context;
+        float       m_DT;
+    };
+
+    static void SimulateEmittersRange(void* _ctx, uint32_t start, uint32_t end)
+    {
+        SimulateEmittersContext* ctx = (SimulateEmittersContext*)_ctx;
+        EmitterUpdate* updates = ctx->m_Context->m_EmitterUpdates.Begin();
+        for (uint32_t i = start; i < end; ++i)
+        {
+            EmitterUpdate* update = &updates[i];
+            if (!update->m_Simulate)
+                continue;
+            Instance* instance = update->m_Instance;
+            Prototype* prototype = instance->m_Prototype;
+            uint32_t emitter_i = update->m_EmitterIndex;
+            SimulateEmitter(instance, &prototype->m_Emitters[emitter_i], &instance->m_Emitters[emitter_i], &prototype->m_DDF->m_Emitters[emitter_i], ctx->m_DT);
+        }
+    }
+
     void Update(HParticleContext context, float dt, FetchAnimationCallback fetch_animation_callback)
     {
         DM_PROFILE(Particle, "Update");
 
+        // The update is split in three passes. The emitter state is stepped first, since spawning and the
+        // state changed callbacks must run in order on the calling thread. The particles of the emitters are
+        // then simulated, in parallel when there is a worker pool. The simulation only depends on the emitter
+        // itself, so the result is the same as updating the emitters one by one.
+        dmArray<EmitterUpdate>& updates = context->m_EmitterUpdates;
+        updates.SetSize(0);
+
         uint32_t size = context->m_Instances.Size();
-        uint32_t TotalAliveParticles = 0;
         for (uint32_t i = 0; i < size; i++)
         {
             Instance* instance = context->m_Instances[i];
@@ -684,6 +889,10 @@ namespace dmParticle
             instance->m_PlayTime += dt;
             Prototype* prototype = instance->m_Prototype;
             uint32_t emitter_count = instance->m_Emitters.Size();
+            if (updates.Remaining() < emitter_count)
+            {
+                updates.OffsetCapacity(dmMath::Max(emitter_count, updates.Capacity()));
+            }
             for (uint32_t emitter_i = 0; emitter_i < emitter_count; ++emitter_i)
             {
                 Emitter* emitter = &instance->m_Emitters[emitter_i];
@@ -691,16 +900,57 @@ namespace dmParticle
                 dmParticleDDF::Emitter* emitter_ddf = &prototype->m_DDF->m_Emitters[emitter_i];
 
                 UpdateEmitterVelocity(instance, emitter, emitter_ddf, dt);
-                UpdateEmitter(prototype, instance, emitter_prototype, emitter, emitter_ddf, dt);
-                TotalAliveParticles += (uint32_t)emitter->m_Particles.Size();
-                FetchAnimation(emitter, emitter_prototype, fetch_animation_callback);
-                UpdateEmitterRenderData(instance_handle, emitter_i, instance, emitter, emitter_ddf);
 
-                if (emitter->m_ReHash)
-                    ReHashEmitter(emitter);
+                EmitterUpdate update;
+                update.m_Instance = instance;
+                update.m_InstanceHandle = instance_handle;
+                update.m_EmitterIndex = emitter_i;
+                update.m_Simulate = StepEmitter(instance, emitter_prototype, emitter, emitter_ddf, dt);
+                updates.Push(update);
             }
         }
 
+        // A state changed callback might have destroyed an instance that was already stepped
+        uint32_t update_count = updates.Size();
+        for (uint32_t i = 0; i < update_count; ++i)
+        {
+            EmitterUpdate* update = &updates[i];
+            HInstance handle = update->m_InstanceHandle;
+            if (context->m_Instances[handle & 0xffff] != update->m_Instance || update->m_Instance->m_VersionNumber != (handle >> 16))
+            {
+                updates.EraseSwap(i);
+                --update_count;
+                --i;
+            }
+        }
+
+        {
+            DM_PROFILE(Particle, "SimulateEmitters");
+            SimulateEmittersContext ctx;
+            ctx.m_Context = context;
+            ctx.m_DT = dt;
+            dmWorkerPool::ParallelFor(context->m_WorkerPool, SimulateEmittersRange, &ctx, update_count, 1);
+        }
+
+        uint32_t TotalAliveParticles = 0;
+        for (uint32_t i = 0; i < update_count; ++i)
+        {
+            EmitterUpdate* update = &updates[i];
+            Instance* instance = update->m_Instance;
+            Prototype* prototype = instance->m_Prototype;
+            uint32_t emitter_i = update->m_EmitterIndex;
+            Emitter* emitter = &instance->m_Emitters[emitter_i];
+            EmitterPrototype* emitter_prototype = &prototype->m_Emitters[emitter_i];
+            dmParticleDDF::Emitter* emitter_ddf = &prototype->m_DDF->m_Emitters[emitter_i];
+
+            TotalAliveParticles += (uint32_t)emitter->m_Particles.Size();
+            FetchAnimation(emitter, emitter_prototype, fetch_animation_callback);
+            UpdateEmitterRenderData(update->m_InstanceHandle, emitter_i, instance, emitter, emitter_ddf);
+
+            if (emitter->m_ReHash)
+                ReHashEmitter(emitter);
+        }
+
         DM_COUNTER("Particles alive", TotalAliveParticles);
     }
 
@@ -727,6 +977,20 @@ namespace dmParticle
         }
     }
 
+    static void EraseSwapParticle(Emitter* emitter, uint32_t index)
+    {
+        uint32_t last = emitter->m_Particles.Size() - 1;
+        emitter->m_Particles.EraseSwap(index);
+        ParticleStreams& s = emitter->m_Streams;
+        s.m_PositionX[index] = s.m_PositionX[last];
+        s.m_PositionY[index] = s.m_PositionY[last];
+        s.m_PositionZ[index] = s.m_PositionZ[last];
+        s.m_VelocityX[index] = s.m_VelocityX[last];
+        s.m_VelocityY[index] = s.m_VelocityY[last];
+        s.m_VelocityZ[index] = s.m_VelocityZ[last];
+        s.m_SpreadFactor[index] = s.m_SpreadFactor[last];
+    }
+
     static void UpdateParticles(Instance* instance, Emitter* emitter, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
         DM_PROFILE(Particle, "UpdateParticles");
@@ -741,7 +1005,7 @@ namespace dmParticle
             if (p->GetTimeLeft() < 0.0f)
             {
                 // TODO Handle death-action
-                emitter->m_Particles.EraseSwap(j);
+                EraseSwapParticle(emitter, j);
                 --particle_count;
             } else {
                 ++j;
@@ -749,7 +1013,7 @@ namespace dmParticle
         }
     }
 
-    static void SpawnParticle(dmArray<Particle>& particles, uint32_t* seed, dmParticleDDF::Emitter* ddf, const dmTransform::TransformS1& emitter_transform, Vector3 emitter_velocity, float emitter_properties[EMITTER_KEY_COUNT], float dt);
+    static void SpawnParticle(Emitter* emitter, uint32_t* seed, dmParticleDDF::Emitter* ddf, const dmTransform::TransformS1& emitter_transform, Vector3 emitter_velocity, float emitter_properties[EMITTER_KEY_COUNT], float dt);
 
     static void UpdateEmitterState(Instance* instance, Emitter* emitter, EmitterPrototype* emitter_prototype, dmParticleDDF::Emitter* emitter_ddf, float dt)
     {
@@ -805,7 +1069,7 @@ namespace dmParticle
                     float r = dmMath::Rand11(&emitter->m_Seed);
                     emitter_properties[i] = original_emitter_properties[i] + r * emitter_prototype->m_Properties[i].m_Spread;
                 }
-                SpawnParticle(emitter->m_Particles, &emitter->m_Seed, emitter_ddf, emitter_transform, emitter_velocity, emitter_properties, dt);
+                SpawnParticle(emitter, &emitter->m_Seed, emitter_ddf, emitter_transform, emitter_velocity, emitter_properties, dt);
             }
 
             if (!IsEmitterLooping(emitter, emitter_ddf) && emitter->m_Timer >= emitter->m_Duration)
@@ -828,10 +1092,11 @@ namespace dmParticle
         return particle_count * vertices_per_particle;
     }
 
-    static void SpawnParticle(dmArray<Particle>& particles, uint32_t* seed, dmParticleDDF::Emitter* ddf, const dmTransform::TransformS1& emitter_transform, Vector3 emitter_velocity, float emitter_properties[EMITTER_KEY_COUNT], float dt)
+    static void SpawnParticle(Emitter* emitter, uint32_t* seed, dmParticleDDF::Emitter* ddf, const dmTransform::TransformS1& emitter_transform, Vector3 emitter_velocity, float emitter_properties[EMITTER_KEY_COUNT], float dt)
     {
         DM_PROFILE(Particle, "Spawn");
 
+        dmArray<Particle>& particles = emitter->m_Particles;
         uint32_t particle_count = particles.Size();
         particles.SetSize(particle_count + 1);
         Particle *particle = &particles[particle_count];
@@ -843,7 +1108,7 @@ namespace dmParticle
         particle->SetooMaxLifeTime(1.0f / particle->GetMaxLifeTime());
         // Include dt since already existing particles have already been advanced
         particle->SetTimeLeft(particle->GetMaxLifeTime() - dt);
-        particle->SetSpreadFactor(dmMath::Rand11(seed));
+        emitter->m_Streams.m_SpreadFactor[particle_count] = dmMath::Rand11(seed);
         particle->SetSourceSize(emitter_properties[EMITTER_KEY_PARTICLE_SIZE] * emitter_transform.GetScale());
         particle->SetSourceColor(Vector4(
                 emitter_properties[EMITTER_KEY_PARTICLE_RED],
@@ -985,14 +1250,14 @@ namespace dmParticle
         }
 
         transform = dmTransform::Mul(emitter_transform, transform);
-        particle->SetPosition(Point3(transform.GetTranslation()));
+        SetParticlePosition(emitter, particle_count, Point3(transform.GetTranslation()));
         if (ddf->m_ParticleOrientation == PARTICLE_ORIENTATION_MOVEMENT_DIRECTION) {
             particle->SetSourceRotation(dmVMath::QuatFromAngle(2, DEG_RAD * emitter_properties[EMITTER_KEY_PARTICLE_ROTATION]));
         } else {
             particle->SetSourceRotation(transform.GetRotation() * dmVMath::QuatFromAngle(2, DEG_RAD * emitter_properties[EMITTER_KEY_PARTICLE_ROTATION]));
         }
         particle->SetRotation(particle->GetSourceRotation());
-        particle->SetVelocity(dmTransform::Apply(emitter_transform, velocity) + emitter_velocity);
+        SetParticleVelocity(emitter, particle_count, dmTransform::Apply(emitter_transform, velocity) + emitter_velocity);
         particle->m_SourceStretchFactorX = emitter_properties[EMITTER_KEY_PARTICLE_STRETCH_FACTOR_X];
         particle->m_StretchFactorX = particle->m_SourceStretchFactorX;
         particle->m_SourceStretchFactorY = emitter_properties[EMITTER_KEY_PARTICLE_STRETCH_FACTOR_Y];
@@ -1129,7 +1394,7 @@ namespace dmParticle
             tile += start_tile;
             float* tex_coord = &tex_coords[tile << 3];
 
-            particle_transform.SetTranslation(Vector3(particle->GetPosition()));
+            particle_transform.SetTranslation(Vector3(GetParticlePosition(emitter, j)));
             particle_transform.SetRotation(particle->GetRotation());
             particle_transform.SetScale(size);
             particle_transform.SetRotation(emission_transform.GetRotation() * particle_transform.GetRotation());
@@ -1235,15 +1500,6 @@ namespace dmParticle
         return emitter->m_VertexCount;
     }
 
-    struct SortPred
-    {
-        inline bool operator () (const Particle& p1, const Particle& p2)
-        {
-            return p1.GetSortKey().m_Key < p2.GetSortKey().m_Key;
-        }
-
-    };
-
     void GenerateKeys(Emitter* emitter, float max_particle_life_time)
     {
         dmArray<Particle>& particles = emitter->m_Particles;
@@ -1267,11 +1523,142 @@ namespace dmParticle
         }
     }
 
+    static const uint64_t SORT_PAIR_INDEX_MASK = 0xffffffff;
+    static const uint64_t SORT_PAIR_VISITED = 1ULL << 63;
+    static const uint32_t SORT_RADIX_BITS = 8;
+    static const uint32_t SORT_RADIX_SIZE = 1 << SORT_RADIX_BITS;
+    static const uint32_t SORT_RADIX_PASS_COUNT = 32 / SORT_RADIX_BITS;
+
+    /**
+     * Sort the (key, index) pairs by key with an LSD radix sort, which is stable and linear in the number of pairs.
+     * The 32 bit keys are sorted as four 8 bit digits, which keeps the histograms small enough for the stack.
+     * The lower 16 bits of the keys hold the particle index (see GenerateKeys), so those passes are skipped when
+     * they are already in order, which is the case unless the emitter has more than 65536 particles.
+     * Passes where all keys share the same digit are skipped as well.
+     * @return pairs or scratch, whichever holds the sorted pairs
+     */
+    static uint64_t* RadixSortPairs(uint64_t* pairs, uint64_t* scratch, uint32_t count, bool low_keys_sorted)
+    {
+        const uint32_t digit_mask = SORT_RADIX_SIZE - 1;
+        uint32_t histograms[SORT_RADIX_PASS_COUNT][SORT_RADIX_SIZE];
+        memset(histograms, 0, sizeof(histograms));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t key = (uint32_t)(pairs[i] >> 32);
+            ++histograms[0][key & digit_mask];
+            ++histograms[1][(key >> 8) & digit_mask];
+            ++histograms[2][(key >> 16) & digit_mask];
+            ++histograms[3][key >> 24];
+        }
+
+        uint64_t* src = pairs;
+        uint64_t* dst = scratch;
+        uint32_t first_pass = low_keys_sorted ? 16 / SORT_RADIX_BITS : 0;
+        for (uint32_t pass = first_pass; pass < SORT_RADIX_PASS_COUNT; ++pass)
+        {
+            uint32_t* histogram = histograms[pass];
+            uint32_t shift = 32 + pass * SORT_RADIX_BITS;
+            if (histogram[(src[0] >> shift) & digit_mask] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < SORT_RADIX_SIZE; ++i)
+            {
+                uint32_t c = histogram[i];
+                histogram[i] = offset;
+                offset += c;
+            }
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint64_t pair = src[i];
+                dst[histogram[(pair >> shift) & digit_mask]++] = pair;
+            }
+            uint64_t* tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+        return src;
+    }
+
+    /// Reorder a stream into the scratch stream and swap the two
+    static void GatherParticleStream(float** stream, float** scratch, const uint64_t* pairs, uint32_t count)
+    {
+        const float* src = *stream;
+        float* dst = *scratch;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            dst[i] = src[pairs[i] & SORT_PAIR_INDEX_MASK];
+        }
+        *scratch = *stream;
+        *stream = dst;
+    }
+
+    /// Reorder the particles in place by following the cycles of the permutation, the pairs are consumed in the process
+    static void PermuteParticles(Particle* particles, uint64_t* pairs, uint32_t count)
+    {
+        // Drop the keys, the upper bits are used to mark visited particles
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            pairs[i] &= SORT_PAIR_INDEX_MASK;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (pairs[i] & SORT_PAIR_VISITED)
+                continue;
+            uint32_t j = i;
+            uint32_t src = (uint32_t)(pairs[j] & SORT_PAIR_INDEX_MASK);
+            if (src == i)
+                continue;
+            Particle tmp = particles[i];
+            while (src != i)
+            {
+                particles[j] = particles[src];
+                pairs[j] |= SORT_PAIR_VISITED;
+                j = src;
+                src = (uint32_t)(pairs[j] & SORT_PAIR_INDEX_MASK);
+            }
+            particles[j] = tmp;
+            pairs[j] |= SORT_PAIR_VISITED;
+        }
+    }
+
     void SortParticles(Emitter* emitter)
     {
         DM_PROFILE(Particle, "Sort");
 
-        std::sort(emitter->m_Particles.Begin(), emitter->m_Particles.End(), SortPred());
+        uint32_t count = emitter->m_Particles.Size();
+        if (count < 2)
+            return;
+
+        // Sort (key, index) pairs instead of the particles themselves, then apply the resulting permutation
+        // to the particles and each of the streams
+        Particle* particles = emitter->m_Particles.Begin();
+        ParticleStreams& streams = emitter->m_Streams;
+        uint64_t* pairs = streams.m_SortPairs;
+        bool sorted = true;
+        bool low_keys_sorted = true;
+        uint32_t prev_key = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint32_t key = particles[i].GetSortKey().m_Key;
+            sorted = sorted && prev_key <= key;
+            low_keys_sorted = low_keys_sorted && (prev_key & 0xffff) <= (key & 0xffff);
+            prev_key = key;
+            pairs[i] = ((uint64_t)key << 32) | i;
+        }
+        if (sorted)
+            return;
+
+        pairs = RadixSortPairs(pairs, streams.m_SortScratch, count, low_keys_sorted);
+
+        GatherParticleStream(&streams.m_PositionX, &streams.m_Scratch, pairs, count);
+        GatherParticleStream(&streams.m_PositionY, &streams.m_Scratch, pairs, count);
+        GatherParticleStream(&streams.m_PositionZ, &streams.m_Scratch, pairs, count);
+        GatherParticleStream(&streams.m_VelocityX, &streams.m_Scratch, pairs, count);
+        GatherParticleStream(&streams.m_VelocityY, &streams.m_Scratch, pairs, count);
+        GatherParticleStream(&streams.m_VelocityZ, &streams.m_Scratch, pairs, count);
+        GatherParticleStream(&streams.m_SpreadFactor, &streams.m_Scratch, pairs, count);
+        PermuteParticles(particles, pairs, count);
     }
 
 #define SAMPLE_PROP(segment, x, target)\
@@ -1327,9 +1714,10 @@ namespace dmParticle
                 uint32_t segment_index = dmMath::Min((uint32_t)(x * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
                 SAMPLE_PROP(particle_properties[PARTICLE_KEY_ROTATION].m_Segments[segment_index], x, properties[PARTICLE_KEY_ROTATION])
                 particle->SetRotation(particle->GetSourceRotation() * dmVMath::QuatFromAngle(2, DEG_RAD * properties[PARTICLE_KEY_ROTATION]));
-                if (lengthSqr(particle->m_Velocity) > EPSILON)
+                Vector3 velocity = GetParticleVelocity(emitter, i);
+                if (lengthSqr(velocity) > EPSILON)
                 {
-                    Vector3 vel_norm = normalize(particle->m_Velocity);
+                    Vector3 vel_norm = normalize(velocity);
                     float y_dot = dot(Vector3::yAxis(), vel_norm);
                     // Corner case, https://gamedev.stackexchange.com/questions/61672/align-a-rotation-to-a-direction
                     Quat q_vel = (dmMath::Abs(y_dot + 1.0f) > EPSILON) ? Quat::rotation(Vector3::yAxis(), vel_norm) : Quat(0.0, 0.0, 1.0, 0.0);
@@ -1361,40 +1749,74 @@ namespace dmParticle
 
     }
 
-    void ApplyAcceleration(dmArray<Particle>& particles, Property* modifier_properties, const Quat& rotation, float scale, float emitter_t, float dt)
+    void ApplyAcceleration(Emitter* emitter, Property* modifier_properties, const Quat& rotation, float scale, float emitter_t, float dt)
     {
-        uint32_t particle_count = particles.Size();
+        using namespace dmParticleSimd;
+
+        uint32_t particle_count = emitter->m_Particles.Size();
         Vector3 acc_step = rotate(rotation, ACCELERATION_LOCAL_DIR) * dt * scale;
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
         float magnitude;
         SAMPLE_PROP(magnitude_property.m_Segments[segment_index], emitter_t, magnitude)
         float mag_spread = magnitude_property.m_Spread;
-        for (uint32_t i = 0; i < particle_count; ++i)
+
+        ParticleStreams& s = emitter->m_Streams;
+        Float4 acc_x = Splat(acc_step.getX());
+        Float4 acc_y = Splat(acc_step.getY());
+        Float4 acc_z = Splat(acc_step.getZ());
+        Float4 mag = Splat(magnitude);
+        Float4 spread = Splat(mag_spread);
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
         {
-            Particle* particle = &particles[i];
-            particle->SetVelocity(particle->GetVelocity() + acc_step * (magnitude + mag_spread * particle->GetSpreadFactor()));
+            Float4 a = Add(mag, Mul(spread, Load(s.m_SpreadFactor + i)));
+            Store(s.m_VelocityX + i, Add(Load(s.m_VelocityX + i), Mul(acc_x, a)));
+            Store(s.m_VelocityY + i, Add(Load(s.m_VelocityY + i), Mul(acc_y, a)));
+            Store(s.m_VelocityZ + i, Add(Load(s.m_VelocityZ + i), Mul(acc_z, a)));
         }
     }
 
-    void ApplyDrag(dmArray<Particle>& particles, Property* modifier_properties, dmParticleDDF::Modifier* modifier_ddf, const Quat& rotation, float emitter_t, float dt)
+    void ApplyDrag(Emitter* emitter, Property* modifier_properties, dmParticleDDF::Modifier* modifier_ddf, const Quat& rotation, float emitter_t, float dt)
     {
-        uint32_t particle_count = particles.Size();
+        using namespace dmParticleSimd;
+
+        uint32_t particle_count = emitter->m_Particles.Size();
         Vector3 direction = rotate(rotation, DRAG_LOCAL_DIR);
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
         float magnitude;
         SAMPLE_PROP(magnitude_property.m_Segments[segment_index], emitter_t, magnitude)
         float mag_spread = magnitude_property.m_Spread;
-        for (uint32_t i = 0; i < particle_count; ++i)
-        {
-            Particle* particle = &particles[i];
-            Vector3 v = particle->GetVelocity();
-            if (modifier_ddf->m_UseDirection)
-                v = projection(Point3(particle->GetVelocity()), direction) * direction;
+
+        ParticleStreams& s = emitter->m_Streams;
+        bool use_direction = modifier_ddf->m_UseDirection != 0;
+        Float4 dir_x = Splat(direction.getX());
+        Float4 dir_y = Splat(direction.getY());
+        Float4 dir_z = Splat(direction.getZ());
+        Float4 mag = Splat(magnitude);
+        Float4 spread = Splat(mag_spread);
+        Float4 dt4 = Splat(dt);
+        Float4 one = Splat(1.0f);
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
+        {
+            Float4 vel_x = Load(s.m_VelocityX + i);
+            Float4 vel_y = Load(s.m_VelocityY + i);
+            Float4 vel_z = Load(s.m_VelocityZ + i);
+            Float4 v_x = vel_x;
+            Float4 v_y = vel_y;
+            Float4 v_z = vel_z;
+            if (use_direction)
+            {
+                Float4 p = Dot3(vel_x, vel_y, vel_z, dir_x, dir_y, dir_z);
+                v_x = Mul(p, dir_x);
+                v_y = Mul(p, dir_y);
+                v_z = Mul(p, dir_z);
+            }
             // Applied drag > 1 means the particle would travel in the reverse direction
-            float applied_drag = dmMath::Min((magnitude + mag_spread * particle->GetSpreadFactor()) * dt, 1.0f);
-            particle->SetVelocity(particle->GetVelocity() - v * applied_drag);
+            Float4 applied_drag = Min(Mul(Add(mag, Mul(spread, Load(s.m_SpreadFactor + i))), dt4), one);
+            Store(s.m_VelocityX + i, Sub(vel_x, Mul(v_x, applied_drag)));
+            Store(s.m_VelocityY + i, Sub(vel_y, Mul(v_y, applied_drag)));
+            Store(s.m_VelocityZ + i, Sub(vel_z, Mul(v_z, applied_drag)));
         }
     }
 
@@ -1413,9 +1835,26 @@ namespace dmParticle
         return result;
     }
 
-    void ApplyRadial(dmArray<Particle>& particles, Property* modifier_properties, const Point3& position, float scale, float emitter_t, float dt)
+    static void ApplyRadialScalar(Emitter* emitter, uint32_t begin, uint32_t end, const Point3& position, float magnitude, float mag_spread, float max_sq_distance, float applied_factor)
     {
-        uint32_t particle_count = particles.Size();
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            Particle* particle = &emitter->m_Particles[i];
+            Vector3 delta = GetParticlePosition(emitter, i) - position;
+            float delta_sq_len = lengthSqr(delta);
+            float applied_magnitude = magnitude + mag_spread * emitter->m_Streams.m_SpreadFactor[i];
+            // 0 acc delta lies outside max dist
+            float a = dmMath::Select(max_sq_distance - delta_sq_len, applied_magnitude, 0.0f);
+            Vector3 dir = normalize(NonZeroVector3(delta, delta_sq_len, GetParticleDir(particle)));
+            SetParticleVelocity(emitter, i, GetParticleVelocity(emitter, i) + dir * a * applied_factor);
+        }
+    }
+
+    void ApplyRadial(Emitter* emitter, Property* modifier_properties, const Point3& position, float scale, float emitter_t, float dt)
+    {
+        using namespace dmParticleSimd;
+
+        uint32_t particle_count = emitter->m_Particles.Size();
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         const Property& max_distance_property = modifier_properties[MODIFIER_KEY_MAX_DISTANCE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
@@ -1426,22 +1865,44 @@ namespace dmParticle
         float max_distance = max_distance_property.m_Segments[0].m_Y * scale;
         float max_sq_distance = max_distance * max_distance;
         float applied_factor = dt * scale;
-        for (uint32_t i = 0; i < particle_count; ++i)
-        {
-            Particle* particle = &particles[i];
-            Vector3 delta = particle->GetPosition() - position;
-            float delta_sq_len = lengthSqr(delta);
-            float applied_magnitude = magnitude + mag_spread * particle->GetSpreadFactor();
+
+        ParticleStreams& s = emitter->m_Streams;
+        Float4 pos_x = Splat(position.getX());
+        Float4 pos_y = Splat(position.getY());
+        Float4 pos_z = Splat(position.getZ());
+        Float4 mag = Splat(magnitude);
+        Float4 spread = Splat(mag_spread);
+        Float4 max_sq = Splat(max_sq_distance);
+        Float4 factor = Splat(applied_factor);
+        Float4 zero = Splat(0.0f);
+        Float4 one = Splat(1.0f);
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
+        {
+            Float4 delta_x = Sub(Load(s.m_PositionX + i), pos_x);
+            Float4 delta_y = Sub(Load(s.m_PositionY + i), pos_y);
+            Float4 delta_z = Sub(Load(s.m_PositionZ + i), pos_z);
+            Float4 delta_sq_len = Dot3(delta_x, delta_y, delta_z, delta_x, delta_y, delta_z);
+            // Particles at the modifier position are pushed along their own direction, which needs the rotation
+            if (AnyNonPositive(delta_sq_len))
+            {
+                ApplyRadialScalar(emitter, i, dmMath::Min(i + WIDTH, particle_count), position, magnitude, mag_spread, max_sq_distance, applied_factor);
+                continue;
+            }
+            Float4 applied_magnitude = Add(mag, Mul(spread, Load(s.m_SpreadFactor + i)));
             // 0 acc delta lies outside max dist
-            float a = dmMath::Select(max_sq_distance - delta_sq_len, applied_magnitude, 0.0f);
-            Vector3 dir = normalize(NonZeroVector3(delta, delta_sq_len, GetParticleDir(particle)));
-            particle->SetVelocity(particle->GetVelocity() + dir * a * applied_factor);
+            Float4 a = Select(Sub(max_sq, delta_sq_len), applied_magnitude, zero);
+            Float4 inv_len = Div(one, Sqrt(delta_sq_len));
+            Store(s.m_VelocityX + i, Add(Load(s.m_VelocityX + i), Mul(Mul(Mul(delta_x, inv_len), a), factor)));
+            Store(s.m_VelocityY + i, Add(Load(s.m_VelocityY + i), Mul(Mul(Mul(delta_y, inv_len), a), factor)));
+            Store(s.m_VelocityZ + i, Add(Load(s.m_VelocityZ + i), Mul(Mul(Mul(delta_z, inv_len), a), factor)));
         }
     }
 
-    void ApplyVortex(dmArray<Particle>& particles, Property* modifier_properties, const Point3& position, const Quat& rotation, float scale, float emitter_t, float dt)
+    void ApplyVortex(Emitter* emitter, Property* modifier_properties, const Point3& position, const Quat& rotation, float scale, float emitter_t, float dt)
     {
-        uint32_t particle_count = particles.Size();
+        using namespace dmParticleSimd;
+
+        uint32_t particle_count = emitter->m_Particles.Size();
         const Property& magnitude_property = modifier_properties[MODIFIER_KEY_MAGNITUDE];
         const Property& max_distance_property = modifier_properties[MODIFIER_KEY_MAX_DISTANCE];
         uint32_t segment_index = dmMath::Min((uint32_t)(emitter_t * PROPERTY_SAMPLE_COUNT), PROPERTY_SAMPLE_COUNT - 1);
@@ -1454,23 +1915,51 @@ namespace dmParticle
         Vector3 axis = rotate(rotation, VORTEX_LOCAL_AXIS);
         Vector3 start = rotate(rotation, VORTEX_LOCAL_START_DIR);
         float applied_factor = dt * scale;
-        for (uint32_t i = 0; i < particle_count; ++i)
+
+        ParticleStreams& s = emitter->m_Streams;
+        Float4 pos_x = Splat(position.getX());
+        Float4 pos_y = Splat(position.getY());
+        Float4 pos_z = Splat(position.getZ());
+        Float4 axis_x = Splat(axis.getX());
+        Float4 axis_y = Splat(axis.getY());
+        Float4 axis_z = Splat(axis.getZ());
+        Float4 start_x = Splat(start.getX());
+        Float4 start_y = Splat(start.getY());
+        Float4 start_z = Splat(start.getZ());
+        Float4 mag = Splat(magnitude);
+        Float4 spread = Splat(mag_spread);
+        Float4 max_sq = Splat(max_sq_distance);
+        Float4 factor = Splat(applied_factor);
+        Float4 zero = Splat(0.0f);
+        Float4 one = Splat(1.0f);
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
         {
-            Particle* particle = &particles[i];
             // delta from vortex position
-            Vector3 delta = particle->GetPosition() - position;
+            Float4 delta_x = Sub(Load(s.m_PositionX + i), pos_x);
+            Float4 delta_y = Sub(Load(s.m_PositionY + i), pos_y);
+            Float4 delta_z = Sub(Load(s.m_PositionZ + i), pos_z);
             // normal from vortex axis (non-unit)
-            Vector3 normal = delta - projection(Point3(delta), axis) * axis;
+            Float4 p = Dot3(delta_x, delta_y, delta_z, axis_x, axis_y, axis_z);
+            Float4 normal_x = Sub(delta_x, Mul(p, axis_x));
+            Float4 normal_y = Sub(delta_y, Mul(p, axis_y));
+            Float4 normal_z = Sub(delta_z, Mul(p, axis_z));
             // tangent is the direction of the vortex acceleration
-            Vector3 tangent = cross(axis, normal);
+            Float4 tangent_x = Sub(Mul(axis_y, normal_z), Mul(axis_z, normal_y));
+            Float4 tangent_y = Sub(Mul(axis_z, normal_x), Mul(axis_x, normal_z));
+            Float4 tangent_z = Sub(Mul(axis_x, normal_y), Mul(axis_y, normal_x));
             // In case the particle is directed along the axis, give it a guaranteed orthogonal start
-            tangent = NonZeroVector3(tangent, lengthSqr(tangent), start);
+            Float4 neg_tangent_sq_len = Sub(zero, Dot3(tangent_x, tangent_y, tangent_z, tangent_x, tangent_y, tangent_z));
+            tangent_x = Select(neg_tangent_sq_len, start_x, tangent_x);
+            tangent_y = Select(neg_tangent_sq_len, start_y, tangent_y);
+            tangent_z = Select(neg_tangent_sq_len, start_z, tangent_z);
             // tangent is now guaranteed to be non-zero
-            tangent = normalize(tangent);
+            Float4 inv_len = Div(one, Sqrt(Dot3(tangent_x, tangent_y, tangent_z, tangent_x, tangent_y, tangent_z)));
             // use normal for max distance test
-            float normal_sq_len = lengthSqr(normal);
-            float acceleration = dmMath::Select(max_sq_distance - normal_sq_len, magnitude + mag_spread * particle->GetSpreadFactor(), 0.0f);
-            particle->SetVelocity(particle->GetVelocity() + tangent * acceleration * applied_factor);
+            Float4 normal_sq_len = Dot3(normal_x, normal_y, normal_z, normal_x, normal_y, normal_z);
+            Float4 acceleration = Select(Sub(max_sq, normal_sq_len), Add(mag, Mul(spread, Load(s.m_SpreadFactor + i))), zero);
+            Store(s.m_VelocityX + i, Add(Load(s.m_VelocityX + i), Mul(Mul(Mul(tangent_x, inv_len), acceleration), factor)));
+            Store(s.m_VelocityY + i, Add(Load(s.m_VelocityY + i), Mul(Mul(Mul(tangent_y, inv_len), acceleration), factor)));
+            Store(s.m_VelocityZ + i, Add(Load(s.m_VelocityZ + i), Mul(Mul(Mul(tangent_z, inv_len), acceleration), factor)));
         }
     }
 
@@ -1495,6 +1984,21 @@ namespace dmParticle
         return emitter_ddf->m_Rotation * modifier_ddf->m_Rotation;
     }
 
+    static void IntegrateParticles(Emitter* emitter, float dt)
+    {
+        using namespace dmParticleSimd;
+
+        uint32_t particle_count = emitter->m_Particles.Size();
+        ParticleStreams& s = emitter->m_Streams;
+        Float4 dt4 = Splat(dt);
+        for (uint32_t i = 0; i < particle_count; i += WIDTH)
+        {
+            Store(s.m_PositionX + i, Add(Load(s.m_PositionX + i), Mul(Load(s.m_VelocityX + i), dt4)));
+            Store(s.m_PositionY + i, Add(Load(s.m_PositionY + i), Mul(Load(s.m_VelocityY + i), dt4)));
+            Store(s.m_PositionZ + i, Add(Load(s.m_PositionZ + i), Mul(Load(s.m_VelocityZ + i), dt4)));
+        }
+    }
+
     void Simulate(Instance* instance, Emitter* emitter, EmitterPrototype* prototype, dmParticleDDF::Emitter* ddf, float dt)
     {
         DM_PROFILE(Particle, "Simulate");
@@ -1516,43 +2020,43 @@ namespace dmParticle
             case dmParticleDDF::MODIFIER_TYPE_ACCELERATION:
                 {
                     Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
-                    ApplyAcceleration(particles, modifier->m_Properties, rotation, scale, emitter_t, dt);
+                    ApplyAcceleration(emitter, modifier->m_Properties, rotation, scale, emitter_t, dt);
                 }
                 break;
             case dmParticleDDF::MODIFIER_TYPE_DRAG:
                 {
                     Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
-                    ApplyDrag(particles, modifier->m_Properties, modifier_ddf, rotation, emitter_t, dt);
+                    ApplyDrag(emitter, modifier->m_Properties, modifier_ddf, rotation, emitter_t, dt);
                 }
                 break;
             case dmParticleDDF::MODIFIER_TYPE_RADIAL:
                 {
                     Point3 position = CalculateModifierPosition(instance, ddf, modifier_ddf);
-                    ApplyRadial(particles, modifier->m_Properties, position, scale, emitter_t, dt);
+                    ApplyRadial(emitter, modifier->m_Properties, position, scale, emitter_t, dt);
                 }
                 break;
             case dmParticleDDF::MODIFIER_TYPE_VORTEX:
                 {
                     Point3 position = CalculateModifierPosition(instance, ddf, modifier_ddf);
                     Quat rotation = CalculateModifierRotation(instance, ddf, modifier_ddf);
-                    ApplyVortex(particles, modifier->m_Properties, position, rotation, scale, emitter_t, dt);
+                    ApplyVortex(emitter, modifier->m_Properties, position, rotation, scale, emitter_t, dt);
                 }
                 break;
             }
         }
+        // NOTE This velocity integration has a larger error than normal since we don't use the velocity at the
+        // beginning of the frame, but it's ok since particle movement does not need to be very exact
+        IntegrateParticles(emitter, dt);
+
         uint32_t particle_count = particles.Size();
         for (uint32_t i = 0; i < particle_count; ++i)
         {
             Particle* p = &particles[i];
-            // NOTE This velocity integration has a larger error than normal since we don't use the velocity at the
-            // beginning of the frame, but it's ok since particle movement does not need to be very exact
-            p->SetPosition(p->GetPosition() + p->m_Velocity * dt);
-
             p->m_Scale[0] += p->m_Scale[0] * p->m_StretchFactorX;
             if (!ddf->m_StretchWithVelocity)
                 p->m_Scale[1] += p->m_Scale[1] * p->m_StretchFactorY;
             else
-                p->m_Scale[1] += p->m_Scale[1] * p->m_StretchFactorY * length(p->m_Velocity) * STRETCH_SCALING;
+                p->m_Scale[1] += p->m_Scale[1] * p->m_StretchFactorY * length(GetParticleVelocity(emitter, i)) * STRETCH_SCALING;
         }
     }
 
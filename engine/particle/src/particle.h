@@ -16,6 +16,7 @@
 #include <dmsdk/vectormath/cpp/vectormath_aos.h>
 #include <dlib/configfile.h>
 #include <dlib/hash.h>
+#include <dlib/worker_pool.h>
 #include <ddf/ddf.h>
 #include "particle/particle_ddf.h"
 
@@ -235,6 +236,29 @@ namespace dmParticle
     // For tests
     Vector3 GetPosition(HParticleContext context, HInstance instance);
 
+    /**
+     * Set the worker pool used to simulate the emitters and generate vertex data in parallel.
+     * The result is identical to the serial update, since the emitters are simulated independently of each other.
+     * @param context Particle context
+     * @param pool Worker pool, or 0x0 to update the emitters on the calling thread
+     */
+    void SetWorkerPool(HParticleContext context, dmWorkerPool::HWorkerPool pool);
+
+    /**
+     * Generates vertex data for a batch of emitters, in parallel if the context has a worker pool.
+     * The vertices are written in the same order, and with the same limits, as when calling GenerateVertexData
+     * for each emitter in turn.
+     * @param context Particle context
+     * @param dt Time step.
+     * @param emitters Render data of the emitters to generate vertex data for
+     * @param emitter_count Number of emitters
+     * @param vertex_buffer Vertex buffer into which to store the particle vertex data. If this is 0x0, no data will be generated.
+     * @param vertex_buffer_size Size in bytes of the supplied vertex buffer.
+     * @param out_vertex_buffer_size Size in bytes of the total data written to vertex buffer, the first emitter is written at this offset.
+     * @param vertex_format Which vertex format to use
+     */
+    void GenerateVertexDataBatch(HParticleContext context, float dt, EmitterRenderData* const* emitters, uint32_t emitter_count, const Vector4& color, void* vertex_buffer, uint32_t vertex_buffer_size, uint32_t* out_vertex_buffer_size, ParticleVertexFormat vertex_format);
+
 #define DM_PARTICLE_PROTO(ret, name,  ...) \
     \
     ret name(__VA_ARGS__);\
@@ -17,6 +17,7 @@
 #include <dlib/configfile.h>
 #include <dlib/index_pool.h>
 #include <dlib/transform.h>
+#include <dlib/worker_pool.h>
 
 #include "particle/particle_ddf.h"
 
@@ -43,6 +44,7 @@ namespace dmParticle
 
     /**
      * Representation of a particle.
+     * The position, velocity and spread factor are stored separately in the ParticleStreams of the emitter.
      *
      * TODO Separate source state from current (chaining modifiers)
      */
@@ -52,14 +54,11 @@ namespace dmParticle
         inline type Get##property() const { return m_##property; }\
         inline void Set##property(type v) { m_##property = v; }\
 
-        GET_SET(Position, Point3)
         GET_SET(SourceRotation, Quat)
         GET_SET(Rotation, Quat)
-        GET_SET(Velocity, Vector3)
         GET_SET(TimeLeft, float)
         GET_SET(MaxLifeTime, float)
         GET_SET(ooMaxLifeTime, float)
-        GET_SET(SpreadFactor, float)
         GET_SET(SourceSize, float)
         GET_SET(Scale, Vector3)
         GET_SET(SourceColor, Vector4)
@@ -67,21 +66,15 @@ namespace dmParticle
         GET_SET(SortKey, SortKey)
 #undef GET_SET
 
-        /// Position, which is defined in emitter space or world space depending on how the emitter which spawned the particles is tweaked.
-        Point3 m_Position;
         /// Rotation, which is defined in emitter space or world space depending on how the emitter which spawned the particles is tweaked.
         Quat m_SourceRotation;
         Quat m_Rotation;
-        /// Velocity of the particle
-        Vector3 m_Velocity;
         /// Time left before the particle dies.
         float       m_TimeLeft;
         /// The duration of this particle.
         float       m_MaxLifeTime;
         /// Inverted duration.
         float       m_ooMaxLifeTime;
-        /// Factor used for spread
-        float       m_SpreadFactor;
         /// Particle source size
         float       m_SourceSize;
         /// Particle source stretch factor
@@ -101,6 +94,38 @@ namespace dmParticle
         float       m_SourceAngularVelocity;
     };
 
+    /**
+     * Simulation state of the particles of an emitter, stored as structure-of-arrays so that the modifiers can
+     * process several particles at a time. Element i of each stream belongs to Emitter::m_Particles[i].
+     *
+     * All streams live in a single 16 byte aligned allocation and the capacity is padded to a multiple of
+     * dmParticleSimd::WIDTH, so the kernels may read and write the padding of the last group.
+     * The order of the float streams within the allocation is not fixed, since sorting swaps streams with m_Scratch.
+     */
+    struct ParticleStreams
+    {
+        /// Position, which is defined in emitter space or world space depending on how the emitter which spawned the particles is tweaked.
+        float*      m_PositionX;
+        float*      m_PositionY;
+        float*      m_PositionZ;
+        /// Velocity of the particle
+        float*      m_VelocityX;
+        float*      m_VelocityY;
+        float*      m_VelocityZ;
+        /// Factor used for spread
+        float*      m_SpreadFactor;
+        /// Scratch stream used when sorting
+        float*      m_Scratch;
+        /// Sort keys paired with the original particle index
+        uint64_t*   m_SortPairs;
+        /// Scratch pairs used by the radix sort
+        uint64_t*   m_SortScratch;
+        /// Single allocation holding all the streams, which are swapped around when sorting
+        void*       m_Memory;
+        /// Allocated (padded) capacity of each stream
+        uint32_t    m_Capacity;
+    };
+
     /**
      * Representation of an emitter.
      */
@@ -114,6 +139,8 @@ namespace dmParticle
         AnimationData           m_AnimationData;
         /// Particle buffer.
         dmArray<Particle>       m_Particles;
+        /// Simulation state of the particles, parallel to m_Particles.
+        ParticleStreams         m_Streams;
         dmArray<RenderConstant> m_RenderConstants;
         Vector3                 m_Velocity;
         Point3                  m_LastPosition;
@@ -181,13 +208,38 @@ namespace dmParticle
         uint16_t                m_ScaleAlongZ : 1;
     };
 
+    /**
+     * An emitter that was stepped during Update, and which particles are simulated on the worker pool.
+     */
+    struct EmitterUpdate
+    {
+        Instance*   m_Instance;
+        /// Handle used to verify that the instance is still alive after the state changed callbacks
+        HInstance   m_InstanceHandle;
+        uint32_t    m_EmitterIndex : 31;
+        /// If the particles should be simulated (false for sleeping emitters)
+        uint32_t    m_Simulate : 1;
+    };
+
+    /**
+     * An emitter to write vertex data for in GenerateVertexDataBatch, at a precomputed vertex index.
+     */
+    struct EmitterVertexJob
+    {
+        Instance*   m_Instance;
+        Emitter*    m_Emitter;
+        uint32_t    m_EmitterIndex;
+        uint32_t    m_VertexIndex;
+    };
+
     /**
      * Representation of a context to hold a set of emitters.
      */
     struct Context
     {
         Context(uint32_t max_instance_count, uint32_t max_particle_count)
-        : m_MaxParticleCount(max_particle_count)
+        : m_WorkerPool(0)
+        , m_MaxParticleCount(max_particle_count)
         , m_NextVersionNumber(1)
         , m_InstanceSeeding(0)
         {
@@ -210,6 +262,12 @@ namespace dmParticle
         dmArray<Instance*>  m_Instances;
         /// Index pool used to index the instance buffer.
         dmIndexPool16       m_InstanceIndexPool;
+        /// Emitters stepped in the current Update
+        dmArray<EmitterUpdate> m_EmitterUpdates;
+        /// Emitters to generate vertex data for in the current GenerateVertexDataBatch
+        dmArray<EmitterVertexJob> m_VertexJobs;
+        /// Optional, used to simulate the emitters and generate vertex data in parallel
+        dmWorkerPool::HWorkerPool m_WorkerPool;
         /// Maximum number of particles allowed
         uint32_t            m_MaxParticleCount;
         /// Version number used to create new handles.
@@ -286,6 +344,36 @@ namespace dmParticle
     };
 
     void UpdateRenderData(HParticleContext context, HInstance instance, uint32_t emitter_index);
+    void GenerateKeys(Emitter* emitter, float max_particle_life_time);
+    void SortParticles(Emitter* emitter);
+
+    inline Point3 GetParticlePosition(const Emitter* emitter, uint32_t index)
+    {
+        const ParticleStreams& s = emitter->m_Streams;
+        return Point3(s.m_PositionX[index], s.m_PositionY[index], s.m_PositionZ[index]);
+    }
+
+    inline void SetParticlePosition(Emitter* emitter, uint32_t index, const Point3& position)
+    {
+        ParticleStreams& s = emitter->m_Streams;
+        s.m_PositionX[index] = position.getX();
+        s.m_PositionY[index] = position.getY();
+        s.m_PositionZ[index] = position.getZ();
+    }
+
+    inline Vector3 GetParticleVelocity(const Emitter* emitter, uint32_t index)
+    {
+        const ParticleStreams& s = emitter->m_Streams;
+        return Vector3(s.m_VelocityX[index], s.m_VelocityY[index], s.m_VelocityZ[index]);
+    }
+
+    inline void SetParticleVelocity(Emitter* emitter, uint32_t index, const Vector3& velocity)
+    {
+        ParticleStreams& s = emitter->m_Streams;
+        s.m_VelocityX[index] = velocity.getX();
+        s.m_VelocityY[index] = velocity.getY();
+        s.m_VelocityZ[index] = velocity.getZ();
+    }
 }
 
 #endif // DM_PARTICLE_PRIVATE_H
@@ -0,0 +1,133 @@
+// Copyright 2020 The Defold Foundation
+// Licensed under the Defold License version 1.0 (the "License"); you may not use
+// this file except in compliance with the License.
+//
+// You may obtain a copy of the License, together with FAQs at
+// https://www.defold.com/license
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef DM_PARTICLE_SIMD_H
+#define DM_PARTICLE_SIMD_H
+
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * Minimal 4-wide float operations used by the particle simulation kernels.
+ *
+ * SSE2 is used on x86 and NEON on arm64. Other targets (e.g. armv7, web) get a plain
+ * scalar implementation with the same interface.
+ * The operations are evaluated in the same order as the scalar vector math, which keeps
+ * the results identical across the backends.
+ * All loads and stores require 16 byte aligned addresses.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DM_PARTICLE_SIMD_SSE2
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define DM_PARTICLE_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace dmParticleSimd
+{
+    /// Number of lanes in a Float4
+    static const uint32_t WIDTH = 4;
+
+#if defined(DM_PARTICLE_SIMD_SSE2)
+
+    typedef __m128 Float4;
+
+    static inline Float4 Load(const float* p)                   { return _mm_load_ps(p); }
+    static inline void   Store(float* p, Float4 v)              { _mm_store_ps(p, v); }
+    static inline Float4 Splat(float v)                         { return _mm_set1_ps(v); }
+    static inline Float4 Add(Float4 a, Float4 b)                { return _mm_add_ps(a, b); }
+    static inline Float4 Sub(Float4 a, Float4 b)                { return _mm_sub_ps(a, b); }
+    static inline Float4 Mul(Float4 a, Float4 b)                { return _mm_mul_ps(a, b); }
+    static inline Float4 Div(Float4 a, Float4 b)                { return _mm_div_ps(a, b); }
+    static inline Float4 Sqrt(Float4 a)                         { return _mm_sqrt_ps(a); }
+    // Same argument order as dmMath::Min, which returns b unless a < b
+    static inline Float4 Min(Float4 a, Float4 b)                { return _mm_min_ps(a, b); }
+
+    /// Per lane dmMath::Select, i.e. x >= 0 ? a : b
+    static inline Float4 Select(Float4 x, Float4 a, Float4 b)
+    {
+        __m128 mask = _mm_cmpge_ps(x, _mm_setzero_ps());
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    /// True if any lane is <= 0
+    static inline bool AnyNonPositive(Float4 x)
+    {
+        return _mm_movemask_ps(_mm_cmple_ps(x, _mm_setzero_ps())) != 0;
+    }
+
+#elif defined(DM_PARTICLE_SIMD_NEON)
+
+    typedef float32x4_t Float4;
+
+    static inline Float4 Load(const float* p)                   { return vld1q_f32(p); }
+    static inline void   Store(float* p, Float4 v)              { vst1q_f32(p, v); }
+    static inline Float4 Splat(float v)                         { return vdupq_n_f32(v); }
+    static inline Float4 Add(Float4 a, Float4 b)                { return vaddq_f32(a, b); }
+    static inline Float4 Sub(Float4 a, Float4 b)                { return vsubq_f32(a, b); }
+    static inline Float4 Mul(Float4 a, Float4 b)                { return vmulq_f32(a, b); }
+    static inline Float4 Div(Float4 a, Float4 b)                { return vdivq_f32(a, b); }
+    static inline Float4 Sqrt(Float4 a)                         { return vsqrtq_f32(a); }
+    static inline Float4 Min(Float4 a, Float4 b)                { return vminq_f32(a, b); }
+
+    static inline Float4 Select(Float4 x, Float4 a, Float4 b)
+    {
+        return vbslq_f32(vcgeq_f32(x, vdupq_n_f32(0.0f)), a, b);
+    }
+
+    static inline bool AnyNonPositive(Float4 x)
+    {
+        return vmaxvq_u32(vcleq_f32(x, vdupq_n_f32(0.0f))) != 0;
+    }
+
+#else
+
+    struct Float4
+    {
+        float m_V[4];
+    };
+
+#define DM_PARTICLE_SIMD_OP(expr)\
+    Float4 r;\
+    for (uint32_t i = 0; i < 4; ++i) { r.m_V[i] = expr; }\
+    return r;
+
+    static inline Float4 Load(const float* p)                   { DM_PARTICLE_SIMD_OP(p[i]) }
+    static inline void   Store(float* p, Float4 v)              { for (uint32_t i = 0; i < 4; ++i) p[i] = v.m_V[i]; }
+    static inline Float4 Splat(float v)                         { DM_PARTICLE_SIMD_OP(v) }
+    static inline Float4 Add(Float4 a, Float4 b)                { DM_PARTICLE_SIMD_OP(a.m_V[i] + b.m_V[i]) }
+    static inline Float4 Sub(Float4 a, Float4 b)                { DM_PARTICLE_SIMD_OP(a.m_V[i] - b.m_V[i]) }
+    static inline Float4 Mul(Float4 a, Float4 b)                { DM_PARTICLE_SIMD_OP(a.m_V[i] * b.m_V[i]) }
+    static inline Float4 Div(Float4 a, Float4 b)                { DM_PARTICLE_SIMD_OP(a.m_V[i] / b.m_V[i]) }
+    static inline Float4 Sqrt(Float4 a)                         { DM_PARTICLE_SIMD_OP(sqrtf(a.m_V[i])) }
+    static inline Float4 Min(Float4 a, Float4 b)                { DM_PARTICLE_SIMD_OP(a.m_V[i] < b.m_V[i] ? a.m_V[i] : b.m_V[i]) }
+    static inline Float4 Select(Float4 x, Float4 a, Float4 b)   { DM_PARTICLE_SIMD_OP(x.m_V[i] >= 0.0f ? a.m_V[i] : b.m_V[i]) }
+
+#undef DM_PARTICLE_SIMD_OP
+
+    static inline bool AnyNonPositive(Float4 x)
+    {
+        return x.m_V[0] <= 0.0f || x.m_V[1] <= 0.0f || x.m_V[2] <= 0.0f || x.m_V[3] <= 0.0f;
+    }
+
+#endif
+
+    /// Dot product of the vectors (ax, ay, az) and (bx, by, bz) per lane
+    static inline Float4 Dot3(Float4 ax, Float4 ay, Float4 az, Float4 bx, Float4 by, Float4 bz)
+    {
+        return Add(Add(Mul(ax, bx), Mul(ay, by)), Mul(az, bz));
+    }
+}
+
+#endif // DM_PARTICLE_SIMD_H
@@ -15,10 +15,12 @@
 #include <stdio.h>
 #include <algorithm>
 #include <map>
+#include <vector>
 
 #include <dlib/dstrings.h>
 #include <dlib/log.h>
 #include <dlib/math.h>
+#include <dlib/time.h>
 #include <dlib/vmath.h>
 
 #include <ddf/ddf.h>
@@ -703,8 +705,7 @@ TEST_F(ParticleTest, EmissionSpace)
     dmParticle::Update(m_Context, dt, 0x0);
 
     dmParticle::Emitter* e = GetEmitter(m_Context, instance, 0);
-    dmParticle::Particle* p = &e->m_Particles[0];
-    ASSERT_EQ(10.0f, p->GetPosition().getX());
+    ASSERT_EQ(10.0f, dmParticle::GetParticlePosition(e, 0).getX());
 
     dmParticle::DestroyInstance(m_Context, instance);
     dmParticle::Particle_DeletePrototype(m_Prototype);
@@ -720,8 +721,7 @@ TEST_F(ParticleTest, EmissionSpace)
     dmParticle::Update(m_Context, dt, 0x0);
 
     e = GetEmitter(m_Context, instance, 0);
-    p = &e->m_Particles[0];
-    ASSERT_EQ(0.0f, p->GetPosition().getX());
+    ASSERT_EQ(0.0f, dmParticle::GetParticlePosition(e, 0).getX());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1475,15 +1475,16 @@ TEST_F(ParticleTest, StableSort)
     ASSERT_EQ(particle_count, i->m_Emitters[0].m_Particles.Size());
 
     float x[particle_count];
-    dmParticle::Particle* p = &i->m_Emitters[0].m_Particles[0];
+    dmParticle::Emitter* e = &i->m_Emitters[0];
+    dmParticle::Particle* p = &e->m_Particles[0];
     // Store x-positions
     for (uint32_t pi = 0; pi < particle_count; ++pi)
     {
         float f = (float)pi + 1;
         x[pi] = f;
-        Point3 pos = p[pi].GetPosition();
+        Point3 pos = dmParticle::GetParticlePosition(e, pi);
         pos.setX(f);
-        p[pi].SetPosition(pos);
+        dmParticle::SetParticlePosition(e, pi, pos);
     }
     // Disturb order by altering a few particles
     const uint32_t disturb_count = particle_count / 2;
@@ -1491,9 +1492,9 @@ TEST_F(ParticleTest, StableSort)
     {
         p[d].SetTimeLeft(p[d].GetTimeLeft() - dt);
         x[d] += particle_count;
-        Point3 pos = p[d].GetPosition();
+        Point3 pos = dmParticle::GetParticlePosition(e, d);
         pos.setX(x[d]);
-        p[d].SetPosition(pos);
+        dmParticle::SetParticlePosition(e, d, pos);
     }
     // Sort
     dmParticle::Update(m_Context, dt, 0x0);
@@ -1502,12 +1503,71 @@ TEST_F(ParticleTest, StableSort)
     // Verify order of undisturbed
     for (uint32_t pi = 0; pi < particle_count; ++pi)
     {
-        ASSERT_EQ(x[pi], p[pi].GetPosition().getX());
+        ASSERT_EQ(x[pi], dmParticle::GetParticlePosition(e, pi).getX());
     }
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
 
+static void ScrambleLifeTimes(dmParticle::Emitter* e, float max_life_time, uint32_t* seed)
+{
+    uint32_t particle_count = ParticleCount(e);
+    for (uint32_t i = 0; i < particle_count; ++i)
+    {
+        e->m_Particles[i].SetTimeLeft(dmMath::Rand01(seed) * max_life_time);
+    }
+}
+
+// The radix sort must order the particles exactly like a comparison sort of the keys
+TEST_F(ParticleTest, SortOrder)
+{
+    const float dt = 1.0f / 60.0f;
+    // Above 65536 particles the index part of the keys wraps around
+    const uint32_t particle_counts[] = {2, 1000, 70000};
+
+    ASSERT_TRUE(LoadPrototype("bench_simulate.particlefxc", &m_Prototype));
+    float max_life_time = m_Prototype->m_Emitters[0].m_MaxParticleLifeTime;
+    uint32_t seed = 0;
+    for (uint32_t c = 0; c < DM_ARRAY_SIZE(particle_counts); ++c)
+    {
+        uint32_t particle_count = particle_counts[c];
+        m_Prototype->m_DDF->m_Emitters[0].m_MaxParticleCount = particle_count;
+        dmParticle::HInstance instance = dmParticle::CreateInstance(m_Context, m_Prototype, 0x0);
+        dmParticle::Emitter* e = GetEmitter(m_Context, instance, 0);
+        dmParticle::StartInstance(m_Context, instance);
+        dmParticle::Update(m_Context, dt, 0x0);
+        ASSERT_EQ(particle_count, ParticleCount(e));
+
+        for (uint32_t iteration = 0; iteration < 3; ++iteration)
+        {
+            ScrambleLifeTimes(e, max_life_time, &seed);
+            // Tag the particles with their index before the sort
+            for (uint32_t i = 0; i < particle_count; ++i)
+            {
+                dmParticle::SetParticlePosition(e, i, Point3((float)i, 0.0f, 0.0f));
+            }
+            dmParticle::GenerateKeys(e, max_life_time);
+
+            std::vector<uint64_t> expected(particle_count);
+            for (uint32_t i = 0; i < particle_count; ++i)
+            {
+                expected[i] = ((uint64_t)e->m_Particles[i].GetSortKey().m_Key << 32) | i;
+            }
+            std::sort(expected.begin(), expected.end());
+
+            dmParticle::SortParticles(e);
+
+            for (uint32_t i = 0; i < particle_count; ++i)
+            {
+                ASSERT_EQ((uint32_t)(expected[i] >> 32), e->m_Particles[i].GetSortKey().m_Key);
+                ASSERT_EQ((float)(uint32_t)expected[i], dmParticle::GetParticlePosition(e, i).getX());
+            }
+        }
+
+        dmParticle::DestroyInstance(m_Context, instance);
+    }
+}
+
 TEST_F(ParticleTest, ReloadPrototype)
 {
     ASSERT_TRUE(LoadPrototype("reload1.particlefxc", &m_Prototype));
@@ -1536,6 +1596,8 @@ TEST_F(ParticleTest, ReloadInstance)
 
     dmParticle::Particle original_particle;
     memcpy(&original_particle, &e->m_Particles[0], sizeof(dmParticle::Particle));
+    Point3 original_position = dmParticle::GetParticlePosition(e, 0);
+    Vector3 original_velocity = dmParticle::GetParticleVelocity(e, 0);
 
     uint32_t seed = e->m_Seed;
     float timer = e->m_Timer;
@@ -1548,6 +1610,8 @@ TEST_F(ParticleTest, ReloadInstance)
     ASSERT_EQ(1u, e->m_Particles.Size());
     dmParticle::Particle* particle = &e->m_Particles[0];
     ASSERT_EQ(0, memcmp(&original_particle, particle, sizeof(dmParticle::Particle)));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticlePosition(e, 0) - original_position));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(e, 0) - original_velocity));
 
     dmParticle::Emitter* e1 = GetEmitter(m_Context, instance, 1);
     ASSERT_EQ(1u, e1->m_Particles.Size());
@@ -1559,6 +1623,8 @@ TEST_F(ParticleTest, ReloadInstance)
     ASSERT_EQ(1u, e->m_Particles.Size());
     particle = &e->m_Particles[0];
     ASSERT_EQ(0, memcmp(&original_particle, particle, sizeof(dmParticle::Particle)));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticlePosition(e, 0) - original_position));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(e, 0) - original_velocity));
 
     // Test reload with max_particle_count changed
     ASSERT_TRUE(ReloadPrototype("reload3.particlefxc", m_Prototype));
@@ -1568,6 +1634,8 @@ TEST_F(ParticleTest, ReloadInstance)
     ASSERT_EQ(2u, e->m_Particles.Size());
     particle = &e->m_Particles[0];
     ASSERT_EQ(0, memcmp(&original_particle, particle, sizeof(dmParticle::Particle)));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticlePosition(e, 0) - original_position));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(e, 0) - original_velocity));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1596,6 +1664,8 @@ TEST_F(ParticleTest, ReloadInstanceLoop)
 
     dmParticle::Particle original_particle;
     memcpy(&original_particle, &e->m_Particles[0], sizeof(dmParticle::Particle));
+    Point3 original_position = dmParticle::GetParticlePosition(e, 0);
+    Vector3 original_velocity = dmParticle::GetParticleVelocity(e, 0);
 
     ASSERT_TRUE(ReloadPrototype("reload_loop.particlefxc", m_Prototype));
     dmParticle::ReloadInstance(m_Context, instance, true);
@@ -1606,6 +1676,8 @@ TEST_F(ParticleTest, ReloadInstanceLoop)
     ASSERT_EQ(1u, e->m_Particles.Size());
     dmParticle::Particle* particle = &e->m_Particles[0];
     ASSERT_EQ(0, memcmp(&original_particle, particle, sizeof(dmParticle::Particle)));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticlePosition(e, 0) - original_position));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(e, 0) - original_velocity));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1662,19 +1734,17 @@ TEST_F(ParticleTest, AccelerationWorld)
 
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_EQ(1.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getX());
+    ASSERT_EQ(1.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getY());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getZ());
 
     dmParticle::SetRotation(m_Context, instance, Quat::rotationZ(M_PI * 0.5f));
     dmParticle::ResetInstance(m_Context, instance);
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_EQ(1.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getX());
+    ASSERT_EQ(1.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getY());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1698,8 +1768,7 @@ TEST_F(ParticleTest, AccelerationScaledEmitter)
 
         dmParticle::StartInstance(m_Context, instance);
         dmParticle::Update(m_Context, dt, 0x0);
-        dmParticle::Particle* particle = &inst->m_Emitters[0].m_Particles[0];
-        delta[i] = Vector3(particle->GetPosition());
+        delta[i] = Vector3(dmParticle::GetParticlePosition(&inst->m_Emitters[0], 0));
 
         dmParticle::DestroyInstance(m_Context, instance);
     }
@@ -1729,8 +1798,7 @@ TEST_F(ParticleTest, AccelerationScaledWorld)
 
         dmParticle::StartInstance(m_Context, instance);
         dmParticle::Update(m_Context, dt, 0x0);
-        dmParticle::Particle* particle = &inst->m_Emitters[0].m_Particles[0];
-        delta[i] = Vector3(particle->GetPosition());
+        delta[i] = Vector3(dmParticle::GetParticlePosition(&inst->m_Emitters[0], 0));
 
         dmParticle::DestroyInstance(m_Context, instance);
     }
@@ -1752,19 +1820,17 @@ TEST_F(ParticleTest, AccelerationEmitter)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_NEAR(1.0f, particle->GetVelocity().getY(), EPSILON);
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getX());
+    ASSERT_NEAR(1.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getY(), EPSILON);
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getZ());
 
     dmParticle::SetRotation(m_Context, instance, Quat::rotationZ(M_PI));
     dmParticle::ResetInstance(m_Context, instance);
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_NEAR(1.0f, particle->GetVelocity().getY(), EPSILON);
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getX());
+    ASSERT_NEAR(1.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getY(), EPSILON);
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1780,22 +1846,19 @@ TEST_F(ParticleTest, AccelerationAnimated)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &emitter->m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_LT(0.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(emitter, 0).getX());
+    ASSERT_LT(0.0f, dmParticle::GetParticleVelocity(emitter, 0).getY());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(emitter, 0).getZ());
 
     dmParticle::Update(m_Context, dt, 0x0);
     // New particle at 0 because of sorting
-    particle = &emitter->m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(emitter, 0)));
 
     dmParticle::Update(m_Context, dt, 0x0);
     // New particle at 0 because of sorting
-    particle = &emitter->m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_GT(0.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(emitter, 0).getX());
+    ASSERT_GT(0.0f, dmParticle::GetParticleVelocity(emitter, 0).getY());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(emitter, 0).getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1812,8 +1875,7 @@ TEST_F(ParticleTest, DragNoDir)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0)));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1830,8 +1892,7 @@ TEST_F(ParticleTest, DragDir)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    Vector3 velocity = particle->GetVelocity();
+    Vector3 velocity = dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0);
     ASSERT_NEAR(0.0f, velocity.getX(), EPSILON);
     ASSERT_LT(0.0f, velocity.getY());
     ASSERT_EQ(0.0f, velocity.getZ());
@@ -1851,8 +1912,7 @@ TEST_F(ParticleTest, DragBigMagnitude)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0u, lengthSqr(particle->GetVelocity()));
+    ASSERT_EQ(0u, lengthSqr(dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0)));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1869,9 +1929,8 @@ TEST_F(ParticleTest, Radial)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(1.0f, lengthSqr(particle->GetVelocity()));
-    ASSERT_EQ(-1.0f, particle->GetVelocity().getX());
+    ASSERT_EQ(1.0f, lengthSqr(dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0)));
+    ASSERT_EQ(-1.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getX());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1888,16 +1947,14 @@ TEST_F(ParticleTest, RadialMaxDistance)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0)));
 
     // Test with instance scale
     dmParticle::ResetInstance(m_Context, instance);
     dmParticle::SetScale(m_Context, instance, 2.0f);
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0)));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1915,8 +1972,7 @@ TEST_F(ParticleTest, RadialEdgeCase)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(1.0f, lengthSqr(particle->GetVelocity()));
+    ASSERT_EQ(1.0f, lengthSqr(dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0)));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1933,10 +1989,9 @@ TEST_F(ParticleTest, Vortex)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, particle->GetVelocity().getX());
-    ASSERT_EQ(-1.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getX());
+    ASSERT_EQ(-1.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getY());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1953,16 +2008,14 @@ TEST_F(ParticleTest, VortexMaxDistance)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0)));
 
     // Test with instance scale
     dmParticle::ResetInstance(m_Context, instance);
     dmParticle::SetScale(m_Context, instance, 2.0f);
     dmParticle::StartInstance(m_Context, instance);
     dmParticle::Update(m_Context, dt, 0x0);
-    particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(0.0f, lengthSqr(particle->GetVelocity()));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0)));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -1979,10 +2032,9 @@ TEST_F(ParticleTest, VortexEdgeCase)
     dmParticle::StartInstance(m_Context, instance);
 
     dmParticle::Update(m_Context, dt, 0x0);
-    dmParticle::Particle* particle = &i->m_Emitters[0].m_Particles[0];
-    ASSERT_EQ(-1.0f, particle->GetVelocity().getX());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getY());
-    ASSERT_EQ(0.0f, particle->GetVelocity().getZ());
+    ASSERT_EQ(-1.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getX());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getY());
+    ASSERT_EQ(0.0f, dmParticle::GetParticleVelocity(&i->m_Emitters[0], 0).getZ());
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -2058,8 +2110,8 @@ TEST_F(ParticleTest, InheritVelocity)
     dmParticle::SetPosition(m_Context, instance, Point3(10, 0, 0));
     dmParticle::Update(m_Context, dt, 0x0);
 
-    ASSERT_EQ(0.0f, lengthSqr(e1->m_Particles[0].GetVelocity()));
-    ASSERT_NE(0.0f, lengthSqr(e2->m_Particles[0].GetVelocity()));
+    ASSERT_EQ(0.0f, lengthSqr(dmParticle::GetParticleVelocity(e1, 0)));
+    ASSERT_NE(0.0f, lengthSqr(dmParticle::GetParticleVelocity(e2, 0)));
 
     dmParticle::DestroyInstance(m_Context, instance);
 }
@@ -2092,6 +2144,166 @@ TEST_F(ParticleTest, Stats)
     dmParticle::DestroyInstance(m_Context, instance);
 }
 
+// Simulating and generating vertex data on a worker pool must give the same result as the serial update
+TEST_F(ParticleTest, WorkerPool)
+{
+    const float dt = 1.0f / 60.0f;
+    const uint32_t instance_count = 8;
+    const uint32_t max_particle_count = 2048;
+
+    ASSERT_TRUE(LoadPrototype("bench_simulate.particlefxc", &m_Prototype));
+    m_Prototype->m_DDF->m_Emitters[0].m_MaxParticleCount = 500;
+
+    dmWorkerPool::HWorkerPool pool = dmWorkerPool::New(3, "particle_test");
+    dmParticle::HParticleContext contexts[2];
+    dmParticle::HInstance instances[2][instance_count];
+    uint32_t vertex_buffer_size = dmParticle::GetVertexBufferSize(max_particle_count, dmParticle::PARTICLE_GO);
+    uint8_t* vertex_buffers[2];
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        contexts[c] = dmParticle::CreateContext(instance_count, max_particle_count);
+        vertex_buffers[c] = new uint8_t[vertex_buffer_size];
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            instances[c][i] = dmParticle::CreateInstance(contexts[c], m_Prototype, 0x0);
+            dmParticle::SetPosition(contexts[c], instances[c][i], Point3((float)i, 0.0f, 0.0f));
+            dmParticle::StartInstance(contexts[c], instances[c][i]);
+        }
+    }
+    dmParticle::SetWorkerPool(contexts[1], pool);
+    // The seeds are based on the time of creation
+    for (uint32_t i = 0; i < instance_count; ++i)
+    {
+        dmParticle::Emitter* e0 = GetEmitter(contexts[0], instances[0][i], 0);
+        dmParticle::Emitter* e1 = GetEmitter(contexts[1], instances[1][i], 0);
+        e1->m_OriginalSeed = e0->m_OriginalSeed;
+        e1->m_Seed = e0->m_Seed;
+        e1->m_Duration = e0->m_Duration;
+        e1->m_StartDelay = e0->m_StartDelay;
+        e1->m_SpawnRateSpread = e0->m_SpawnRateSpread;
+    }
+
+    for (uint32_t f = 0; f < 30; ++f)
+    {
+        dmParticle::Update(contexts[0], dt, 0x0);
+        dmParticle::Update(contexts[1], dt, 0x0);
+
+        uint32_t vertex_sizes[2] = {0, 0};
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            dmParticle::GenerateVertexData(contexts[0], dt, instances[0][i], 0, Vector4(1.0f), vertex_buffers[0], vertex_buffer_size, &vertex_sizes[0], dmParticle::PARTICLE_GO);
+        }
+        dmParticle::EmitterRenderData* render_data[instance_count];
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            dmParticle::GetEmitterRenderData(contexts[1], instances[1][i], 0, &render_data[i]);
+        }
+        dmParticle::GenerateVertexDataBatch(contexts[1], dt, render_data, instance_count, Vector4(1.0f), vertex_buffers[1], vertex_buffer_size, &vertex_sizes[1], dmParticle::PARTICLE_GO);
+
+        // More particles are alive than the context allows, which are partitioned between the emitters in order
+        ASSERT_EQ(vertex_buffer_size, vertex_sizes[1]);
+        ASSERT_EQ(vertex_sizes[0], vertex_sizes[1]);
+        ASSERT_EQ(0, memcmp(vertex_buffers[0], vertex_buffers[1], vertex_sizes[0]));
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            dmParticle::Emitter* e0 = GetEmitter(contexts[0], instances[0][i], 0);
+            dmParticle::Emitter* e1 = GetEmitter(contexts[1], instances[1][i], 0);
+            uint32_t particle_count = ParticleCount(e0);
+            ASSERT_EQ(particle_count, ParticleCount(e1));
+            ASSERT_EQ(e0->m_VertexIndex, e1->m_VertexIndex);
+            ASSERT_EQ(e0->m_VertexCount, e1->m_VertexCount);
+            for (uint32_t p = 0; p < particle_count; ++p)
+            {
+                ASSERT_EQ(0, memcmp(&e0->m_Particles[p], &e1->m_Particles[p], sizeof(dmParticle::Particle)));
+                ASSERT_EQ(0, memcmp(&e0->m_Streams.m_PositionX[p], &e1->m_Streams.m_PositionX[p], sizeof(float)));
+                ASSERT_EQ(0, memcmp(&e0->m_Streams.m_VelocityY[p], &e1->m_Streams.m_VelocityY[p], sizeof(float)));
+            }
+        }
+    }
+    for (uint32_t c = 0; c < 2; ++c)
+    {
+        for (uint32_t i = 0; i < instance_count; ++i)
+        {
+            dmParticle::DestroyInstance(contexts[c], instances[c][i]);
+        }
+        dmParticle::DestroyContext(contexts[c]);
+        delete [] vertex_buffers[c];
+    }
+    dmWorkerPool::Delete(pool);
+}
+
+/**
+ * Microbenchmark of the particle simulation, with every modifier type applied to a single full emitter.
+ * Prints the average update time per frame for each particle count.
+ */
+TEST_F(ParticleTest, BenchSimulate)
+{
+    const float dt = 1.0f / 60.0f;
+    const uint32_t frame_count = 60;
+    const uint32_t particle_counts[] = {10000, 50000, 200000};
+
+    ASSERT_TRUE(LoadPrototype("bench_simulate.particlefxc", &m_Prototype));
+    for (uint32_t c = 0; c < DM_ARRAY_SIZE(particle_counts); ++c)
+    {
+        uint32_t particle_count = particle_counts[c];
+        m_Prototype->m_DDF->m_Emitters[0].m_MaxParticleCount = particle_count;
+        dmParticle::HInstance instance = dmParticle::CreateInstance(m_Context, m_Prototype, 0x0);
+        dmParticle::Emitter* e = GetEmitter(m_Context, instance, 0);
+        dmParticle::StartInstance(m_Context, instance);
+
+        // The spawn rate fills the emitter in one frame
+        dmParticle::Update(m_Context, dt, 0x0);
+        ASSERT_EQ(particle_count, ParticleCount(e));
+
+        uint64_t start = dmTime::GetTime();
+        for (uint32_t f = 0; f < frame_count; ++f)
+        {
+            dmParticle::Update(m_Context, dt, 0x0);
+        }
+        uint64_t end = dmTime::GetTime();
+        ASSERT_EQ(particle_count, ParticleCount(e));
+
+        printf("Bench elapsed: %u particles, %.3f ms/frame\n", particle_count, (end - start) / (1000.0 * frame_count));
+
+        dmParticle::DestroyInstance(m_Context, instance);
+    }
+}
+
+TEST_F(ParticleTest, BenchSort)
+{
+    const float dt = 1.0f / 60.0f;
+    const uint32_t iteration_count = 100;
+    const uint32_t particle_counts[] = {1000, 10000, 50000};
+
+    ASSERT_TRUE(LoadPrototype("bench_simulate.particlefxc", &m_Prototype));
+    float max_life_time = m_Prototype->m_Emitters[0].m_MaxParticleLifeTime;
+    uint32_t seed = 0;
+    for (uint32_t c = 0; c < DM_ARRAY_SIZE(particle_counts); ++c)
+    {
+        uint32_t particle_count = particle_counts[c];
+        m_Prototype->m_DDF->m_Emitters[0].m_MaxParticleCount = particle_count;
+        dmParticle::HInstance instance = dmParticle::CreateInstance(m_Context, m_Prototype, 0x0);
+        dmParticle::Emitter* e = GetEmitter(m_Context, instance, 0);
+        dmParticle::StartInstance(m_Context, instance);
+        dmParticle::Update(m_Context, dt, 0x0);
+        ASSERT_EQ(particle_count, ParticleCount(e));
+
+        uint64_t elapsed = 0;
+        for (uint32_t i = 0; i < iteration_count; ++i)
+        {
+            ScrambleLifeTimes(e, max_life_time, &seed);
+            uint64_t start = dmTime::GetTime();
+            dmParticle::GenerateKeys(e, max_life_time);
+            dmParticle::SortParticles(e);
+            elapsed += dmTime::GetTime() - start;
+        }
+
+        printf("Bench elapsed: %u particles, %.3f ms/sort\n", particle_count, elapsed / (1000.0 * iteration_count));
+
+        dmParticle::DestroyInstance(m_Context, instance);
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -19,6 +19,7 @@
 #include <dlib/hash.h>
 #include <dlib/message.h>
 #include <dlib/transform.h>
+#include <dlib/worker_pool.h>
 
 template <typename T> class dmArray;
 
@@ -126,6 +127,35 @@ namespace dmPhysics
      */
     typedef void (*SetWorldTransformCallback)(void* user_data, const Vectormath::Aos::Point3& position, const Vectormath::Aos::Quat& rotation);
 
+    /**
+     * World transform of an external object, used when exchanging transforms with the physics simulation in batches.
+     */
+    struct WorldTransformEntry
+    {
+        /// User data pointing to the external object
+        void*                   m_UserData;
+        /// World transform of the external object
+        dmTransform::Transform  m_WorldTransform;
+    };
+
+    /**
+     * Batched version of GetWorldTransformCallback, called once per step with all the objects which transforms
+     * are propagated into the physics simulation.
+     *
+     * @param entries Entries with the user data set, the world transforms are output parameters
+     * @param count Number of entries
+     */
+    typedef void (*GetWorldTransformsCallback)(WorldTransformEntry* entries, uint32_t count);
+    /**
+     * Batched version of SetWorldTransformCallback, called once per step with all the objects which were moved
+     * by the physics simulation.
+     *
+     * @param entries Entries with the user data and the position and rotation the external objects will obtain.
+     *                The scale of the transforms is not used.
+     * @param count Number of entries
+     */
+    typedef void (*SetWorldTransformsCallback)(const WorldTransformEntry* entries, uint32_t count);
+
     /**
      * Callback used to signal collisions.
      *
@@ -216,6 +246,15 @@ namespace dmPhysics
      */
     typedef void (*RayCastCallback)(const RayCastResponse& response, const RayCastRequest& request, void* user_data);
 
+    /**
+     * Callback used to report the responses of all ray casts performed during a step.
+     * @param responses Array of responses, one per request
+     * @param requests Array of the requests, in the order they were made
+     * @param count Number of requests
+     * @param user_data The user data as supplied to the StepWorldContext::m_RayCastUserData
+     */
+    typedef void (*RayCastBatchCallback)(const RayCastResponse* responses, const RayCastRequest* requests, uint32_t count, void* user_data);
+
     /**
      * Parameters to use when creating a context.
      */
@@ -239,6 +278,16 @@ namespace dmPhysics
         uint32_t m_RayCastLimit3D;
         /// Maximum number of overlapping triggers
         uint32_t m_TriggerOverlapCapacity;
+        /// Optional worker pool used to perform the requested ray casts in parallel
+        dmWorkerPool::HWorkerPool m_WorkerPool;
+        /// Time step in seconds when stepping the worlds at a fixed rate. If 0 (default), the worlds are stepped once per update with the update time step
+        float m_FixedTimeStep;
+        /// Maximum number of fixed time steps per update, the remaining time is dropped
+        uint32_t m_MaxFixedTimeSteps;
+        /// Number of velocity iterations of the constraint solver per step
+        uint32_t m_VelocityIterations;
+        /// Number of position iterations of the constraint solver per step, only used by the 2D physics
+        uint32_t m_PositionIterations;
         /// If true, the collision objects will retrieve the position of its game object
         uint8_t m_AllowDynamicTransforms:1;
         uint8_t :7;
@@ -301,6 +350,10 @@ namespace dmPhysics
         GetWorldTransformCallback m_GetWorldTransformCallback;
         /// param set_world_transform Callback for copying the transform from the collision object to the corresponding user data
         SetWorldTransformCallback m_SetWorldTransformCallback;
+        /// param get_world_transforms Optional, used instead of m_GetWorldTransformCallback when stepping the world
+        GetWorldTransformsCallback m_GetWorldTransformsCallback;
+        /// param set_world_transforms Optional, used instead of m_SetWorldTransformCallback when stepping the world
+        SetWorldTransformsCallback m_SetWorldTransformsCallback;
     };
 
     /**
@@ -354,6 +407,8 @@ namespace dmPhysics
         void*                   m_ContactPointUserData;
         /// Ray cast callback
         RayCastCallback         m_RayCastCallback;
+        /// Optional, used instead of m_RayCastCallback to report all ray casts of the step in one call
+        RayCastBatchCallback    m_RayCastBatchCallback;
         /// Ray cast callback user data
         void*                   m_RayCastUserData;
         /// Trigger entered callback
@@ -1094,6 +1149,28 @@ namespace dmPhysics
      */
     void RequestRayCast2D(HWorld2D world, const RayCastRequest& request);
 
+    /**
+     * Request several ray casts that will be performed the next time the 3D world is updated.
+     * The ray casts are performed in parallel if the context has a worker pool.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests
+     * @param count Number of requests
+     * @note Unlike RequestRayCast3D, the request queue grows as needed and is not bounded by the ray cast limit
+     */
+    void RequestRayCasts3D(HWorld3D world, const RayCastRequest* requests, uint32_t count);
+
+    /**
+     * Request several ray casts that will be performed the next time the 2D world is updated.
+     * The ray casts are performed in parallel if the context has a worker pool.
+     *
+     * @param world Physics world in which to perform the ray casts
+     * @param requests Array of requests
+     * @param count Number of requests
+     * @note Unlike RequestRayCast2D, the request queue grows as needed and is not bounded by the ray cast limit
+     */
+    void RequestRayCasts2D(HWorld2D world, const RayCastRequest* requests, uint32_t count);
+
     /**
      * Request a synchronous ray cast
      *
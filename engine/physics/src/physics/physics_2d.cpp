@@ -38,6 +38,11 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_WorkerPool(0)
+    , m_FixedTimeStep(0.0f)
+    , m_MaxFixedTimeSteps(0)
+    , m_VelocityIterations(0)
+    , m_PositionIterations(0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -48,10 +53,14 @@ namespace dmPhysics
     , m_Context(context)
     , m_World(context->m_Gravity)
     , m_RayCastRequests()
+    , m_RayCastResponses()
     , m_DebugDraw(&context->m_DebugCallbacks)
     , m_ContactListener(this)
     , m_GetWorldTransformCallback(params.m_GetWorldTransformCallback)
     , m_SetWorldTransformCallback(params.m_SetWorldTransformCallback)
+    , m_GetWorldTransformsCallback(params.m_GetWorldTransformsCallback)
+    , m_SetWorldTransformsCallback(params.m_SetWorldTransformsCallback)
+    , m_FixedTimeAccumulator(0.0f)
     , m_AllowDynamicTransforms(context->m_AllowDynamicTransforms)
     {
     	m_RayCastRequests.SetCapacity(context->m_RayCastLimit);
@@ -128,6 +137,36 @@ namespace dmPhysics
             return -1.f;
     }
 
+    struct RayCastJob2D
+    {
+        HWorld2D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+    };
+
+    // Only reads from the world, which makes it safe to run the ranges in parallel
+    static void RayCastRange2D(void* _job, uint32_t start, uint32_t end)
+    {
+        RayCastJob2D* job = (RayCastJob2D*)_job;
+        HWorld2D world = job->m_World;
+        float scale = world->m_Context->m_Scale;
+        ProcessRayCastResultCallback2D callback;
+        callback.m_Context = world->m_Context;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            const RayCastRequest& request = job->m_Requests[i];
+            b2Vec2 from;
+            ToB2(request.m_From, from, scale);
+            b2Vec2 to;
+            ToB2(request.m_To, to, scale);
+            callback.m_IgnoredUserData = request.m_IgnoredUserData;
+            callback.m_CollisionMask = request.m_Mask;
+            callback.m_Response = RayCastResponse();
+            world->m_World.RayCast(&callback, from, to);
+            job->m_Responses[i] = callback.m_Response;
+        }
+    }
+
     ContactListener::ContactListener(HWorld2D world)
     : m_World(world)
     {
@@ -214,6 +253,11 @@ namespace dmPhysics
         context->m_ContactImpulseLimit = params.m_ContactImpulseLimit * params.m_Scale;
         context->m_TriggerEnterLimit = params.m_TriggerEnterLimit * params.m_Scale;
         context->m_RayCastLimit = params.m_RayCastLimit2D;
+        context->m_WorkerPool = params.m_WorkerPool;
+        context->m_FixedTimeStep = params.m_FixedTimeStep;
+        context->m_MaxFixedTimeSteps = params.m_MaxFixedTimeSteps;
+        context->m_VelocityIterations = params.m_VelocityIterations;
+        context->m_PositionIterations = params.m_PositionIterations;
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
@@ -337,17 +381,14 @@ namespace dmPhysics
         FlipBody(collision_object, 1, -1);
     }
 
-    static inline float GetUniformScale2D(dmTransform::Transform& transform)
+    static inline float GetUniformScale2D(const dmTransform::Transform& transform)
     {
         const float* v = transform.GetScalePtr();
         return dmMath::Min(v[0], v[1]);
     }
 
-    static void UpdateScale(HWorld2D world, b2Body* body)
+    static void UpdateScale(HWorld2D world, b2Body* body, const dmTransform::Transform& world_transform)
     {
-        dmTransform::Transform world_transform;
-        (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
-
         float object_scale = GetUniformScale2D(world_transform);
 
         b2Fixture* fix = body->GetFixtureList();
@@ -385,6 +426,50 @@ namespace dmPhysics
         }
     }
 
+    static WorldTransformEntry* PushTransformEntry(HWorld2D world, b2Body* body)
+    {
+        dmArray<b2Body*>& bodies = world->m_TransformBodies;
+        dmArray<WorldTransformEntry>& entries = world->m_TransformEntries;
+        if (bodies.Full())
+        {
+            uint32_t capacity = bodies.Capacity() + dmMath::Max(bodies.Capacity(), 64u);
+            bodies.SetCapacity(capacity);
+            entries.SetCapacity(capacity);
+        }
+        bodies.Push(body);
+        entries.SetSize(entries.Size() + 1);
+        WorldTransformEntry* entry = &entries.Back();
+        entry->m_UserData = body->GetUserData();
+        return entry;
+    }
+
+    // Steps the world with the fixed time step as many times as the accumulated time allows, up to the max count,
+    // and returns the time that is left. Time beyond the max count is dropped.
+    static float StepFixed2D(HWorld2D world, float dt)
+    {
+        HContext2D context = world->m_Context;
+        float fixed_dt = context->m_FixedTimeStep;
+        float accumulator = world->m_FixedTimeAccumulator + dt;
+        // Tolerate rounding errors when dt is a multiple of the fixed step, e.g. 60 Hz frames with 30 Hz physics
+        uint32_t step_count = (uint32_t)((accumulator + fixed_dt * 0.001f) / fixed_dt);
+        accumulator = dmMath::Max(0.0f, accumulator - step_count * fixed_dt);
+        step_count = dmMath::Min(step_count, context->m_MaxFixedTimeSteps);
+        for (uint32_t i = 0; i < step_count; ++i)
+        {
+            world->m_World.Step(fixed_dt, context->m_VelocityIterations, context->m_PositionIterations);
+        }
+        world->m_FixedTimeAccumulator = accumulator;
+        return accumulator;
+    }
+
+    // Extrapolates the body transform by its velocities, the same way Bullet interpolates the motion states when stepping at a fixed rate
+    static void ExtrapolateTransform(const b2Body* body, float time, b2Vec2* position, float* angle)
+    {
+        *angle = body->GetAngle() + body->GetAngularVelocity() * time;
+        b2Vec2 center = body->GetWorldCenter() + time * body->GetLinearVelocity();
+        *position = center - b2Mul(b2Rot(*angle), body->GetLocalCenter());
+    }
+
     void StepWorld2D(HWorld2D world, const StepWorldContext& step_context)
     {
         float dt = step_context.m_DT;
@@ -394,67 +479,130 @@ namespace dmPhysics
         // Values are picked by inspection, current rot value is roughly equivalent to 1 degree
         const float POS_EPSILON = 0.00005f * scale;
         const float ROT_EPSILON = 0.00007f;
+        dmArray<b2Body*>& transform_bodies = world->m_TransformBodies;
+        dmArray<WorldTransformEntry>& transform_entries = world->m_TransformEntries;
         // Update transforms of kinematic bodies
-        if (world->m_GetWorldTransformCallback)
+        if (world->m_GetWorldTransformCallback || world->m_GetWorldTransformsCallback)
         {
             DM_PROFILE(Physics, "UpdateKinematic");
+            // Gather the bodies first, so that the transforms can be fetched in one batch
+            transform_bodies.SetSize(0);
+            transform_entries.SetSize(0);
             for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
             {
                 bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && body->GetType() != b2_staticBody;
+                if (retrieve_gameworld_transform || body->GetType() == b2_kinematicBody)
+                {
+                    PushTransformEntry(world, body);
+                }
+            }
+            uint32_t count = transform_bodies.Size();
+            GetWorldTransforms(world->m_GetWorldTransformsCallback, world->m_GetWorldTransformCallback, transform_entries.Begin(), count);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                b2Body* body = transform_bodies[i];
+                const dmTransform::Transform& world_transform = transform_entries[i].m_WorldTransform;
+                bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && body->GetType() != b2_staticBody;
 
                 // translate & rotation
-                if (retrieve_gameworld_transform || body->GetType() == b2_kinematicBody)
+                Vectormath::Aos::Point3 old_position = GetWorldPosition2D(context, body);
+                Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
+                // Ignore z-component
+                position.setZ(0.0f);
+                Vectormath::Aos::Quat rotation = world_transform.GetRotation();
+                float old_angle = body->GetAngle();
+                // Compare against what was last reported to the game object, which is extrapolated when stepping
+                // at a fixed rate. Otherwise the extrapolation would be fed back into the simulation every frame.
+                ReportedTransform2D* reported = world->m_ReportedTransforms.Empty() ? 0x0 : world->m_ReportedTransforms.Get((uintptr_t)body);
+                if (reported)
                 {
-                    Vectormath::Aos::Point3 old_position = GetWorldPosition2D(context, body);
-                    dmTransform::Transform world_transform;
-                    (*world->m_GetWorldTransformCallback)(body->GetUserData(), world_transform);
-                    Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
-                    // Ignore z-component
-                    position.setZ(0.0f);
-                    Vectormath::Aos::Quat rotation = world_transform.GetRotation();
-                    float dp = distSqr(old_position, position);
-                    float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
-                    float old_angle = body->GetAngle();
-                    float da = old_angle - angle;
-
-                    if (dp > POS_EPSILON || fabsf(da) > ROT_EPSILON)
-                    {
-                        b2Vec2 b2_position;
-                        ToB2(position, b2_position, scale);
-                        body->SetTransform(b2_position, angle);
-                        body->SetSleepingAllowed(false);
-                    }
-                    else
+                    old_position = reported->m_Position;
+                    old_angle = reported->m_Angle;
+                }
+                float dp = distSqr(old_position, position);
+                float angle = atan2(2.0f * (rotation.getW() * rotation.getZ() + rotation.getX() * rotation.getY()), 1.0f - 2.0f * (rotation.getY() * rotation.getY() + rotation.getZ() * rotation.getZ()));
+                float da = old_angle - angle;
+
+                if (dp > POS_EPSILON || fabsf(da) > ROT_EPSILON)
+                {
+                    b2Vec2 b2_position;
+                    ToB2(position, b2_position, scale);
+                    body->SetTransform(b2_position, angle);
+                    body->SetSleepingAllowed(false);
+                    if (reported)
                     {
-                        body->SetSleepingAllowed(true);
+                        reported->m_Position = position;
+                        reported->m_Angle = angle;
                     }
                 }
+                else
+                {
+                    body->SetSleepingAllowed(true);
+                }
 
                 // Scaling
                 if(retrieve_gameworld_transform)
                 {
-                    UpdateScale(world, body);
+                    UpdateScale(world, body, world_transform);
                 }
             }
         }
         {
             DM_PROFILE(Physics, "StepSimulation");
             world->m_ContactListener.SetStepWorldContext(&step_context);
-            world->m_World.Step(dt, 10, 10);
+            // Time since the last fixed step, which the reported transforms are extrapolated by
+            float remaining_time = 0.0f;
+            if (context->m_FixedTimeStep > 0.0f)
+            {
+                remaining_time = StepFixed2D(world, dt);
+            }
+            else
+            {
+                world->m_World.Step(dt, context->m_VelocityIterations, context->m_PositionIterations);
+            }
             float inv_scale = world->m_Context->m_InvScale;
             // Update transforms of dynamic bodies
-            if (world->m_SetWorldTransformCallback)
+            if (world->m_SetWorldTransformCallback || world->m_SetWorldTransformsCallback)
             {
+                dmHashTable<uintptr_t, ReportedTransform2D>& reported_transforms = world->m_ReportedTransforms;
+                bool keep_reported = world->m_AllowDynamicTransforms && context->m_FixedTimeStep > 0.0f;
+                if (!reported_transforms.Empty())
+                {
+                    reported_transforms.Clear();
+                }
+                transform_bodies.SetSize(0);
+                transform_entries.SetSize(0);
                 for (b2Body* body = world->m_World.GetBodyList(); body; body = body->GetNext())
                 {
                     if (body->GetType() == b2_dynamicBody && body->IsActive())
                     {
+                        b2Vec2 b2_position = body->GetPosition();
+                        float angle = body->GetAngle();
+                        if (remaining_time > 0.0f && body->IsAwake())
+                        {
+                            ExtrapolateTransform(body, remaining_time, &b2_position, &angle);
+                        }
                         Vectormath::Aos::Point3 position;
-                        FromB2(body->GetPosition(), position, inv_scale);
-                        Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat::rotationZ(body->GetAngle());
-                        (*world->m_SetWorldTransformCallback)(body->GetUserData(), position, rotation);
+                        FromB2(b2_position, position, inv_scale);
+                        Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat::rotationZ(angle);
+                        WorldTransformEntry* entry = PushTransformEntry(world, body);
+                        entry->m_WorldTransform = dmTransform::Transform(Vectormath::Aos::Vector3(position), rotation, 1.0f);
+                        if (keep_reported)
+                        {
+                            if (reported_transforms.Full())
+                            {
+                                uint32_t capacity = reported_transforms.Capacity() + 64;
+                                reported_transforms.SetCapacity(capacity / 2 + 1, capacity);
+                            }
+                            ReportedTransform2D reported;
+                            reported.m_Position = position;
+                            reported.m_Angle = angle;
+                            reported_transforms.Put((uintptr_t)body, reported);
+                        }
                     }
                 }
+                SetWorldTransforms(world->m_SetWorldTransformsCallback, world->m_SetWorldTransformCallback, transform_entries.Begin(), transform_entries.Size());
             }
         }
         // Perform requested ray casts
@@ -462,21 +610,18 @@ namespace dmPhysics
         if (size > 0)
         {
             DM_PROFILE(Physics, "RayCasts");
-            ProcessRayCastResultCallback2D callback;
-            callback.m_Context = world->m_Context;
-            for (uint32_t i = 0; i < size; ++i)
-            {
-                RayCastRequest& request = world->m_RayCastRequests[i];
-                b2Vec2 from;
-                ToB2(request.m_From, from, scale);
-                b2Vec2 to;
-                ToB2(request.m_To, to, scale);
-                callback.m_IgnoredUserData = request.m_IgnoredUserData;
-                callback.m_CollisionMask = request.m_Mask;
-                callback.m_Response.m_Hit = 0;
-                world->m_World.RayCast(&callback, from, to);
-                (*step_context.m_RayCastCallback)(callback.m_Response, request, step_context.m_RayCastUserData);
-            }
+            dmArray<RayCastResponse>& responses = world->m_RayCastResponses;
+            if (responses.Capacity() < size)
+                responses.SetCapacity(world->m_RayCastRequests.Capacity());
+            responses.SetSize(size);
+
+            RayCastJob2D job;
+            job.m_World = world;
+            job.m_Requests = world->m_RayCastRequests.Begin();
+            job.m_Responses = responses.Begin();
+            dmWorkerPool::ParallelFor(world->m_Context->m_WorkerPool, RayCastRange2D, &job, size, RAY_CAST_CHUNK_SIZE);
+
+            ReportRayCasts(step_context, responses.Begin(), world->m_RayCastRequests.Begin(), size);
             world->m_RayCastRequests.SetSize(0);
         }
         // Report sensor collisions
@@ -1122,26 +1267,47 @@ namespace dmPhysics
         return body->GetMass();
     }
 
+    static bool IsValidRayCast2D(const RayCastRequest& request)
+    {
+        // Verify that the ray is not 0-length
+        // We need to remove the z-value before calculating length (DEF-1286)
+        const Vectormath::Aos::Point3 from2d = Vectormath::Aos::Point3(request.m_From.getX(), request.m_From.getY(), 0.0);
+        const Vectormath::Aos::Point3 to2d = Vectormath::Aos::Point3(request.m_To.getX(), request.m_To.getY(), 0.0);
+        if (Vectormath::Aos::lengthSqr(to2d - from2d) <= 0.0f)
+        {
+            dmLogWarning("Ray had 0 length when ray casting, ignoring request.");
+            return false;
+        }
+        return true;
+    }
+
     void RequestRayCast2D(HWorld2D world, const RayCastRequest& request)
     {
-        if (!world->m_RayCastRequests.Full())
+        // The queue may have grown beyond the limit from batched requests
+        if (world->m_RayCastRequests.Size() < (uint32_t) world->m_Context->m_RayCastLimit)
         {
-            // Verify that the ray is not 0-length
-            // We need to remove the z-value before calculating length (DEF-1286)
-            const Vectormath::Aos::Point3 from2d = Vectormath::Aos::Point3(request.m_From.getX(), request.m_From.getY(), 0.0);
-            const Vectormath::Aos::Point3 to2d = Vectormath::Aos::Point3(request.m_To.getX(), request.m_To.getY(), 0.0);
-            if (Vectormath::Aos::lengthSqr(to2d - from2d) <= 0.0f)
-            {
-                dmLogWarning("Ray had 0 length when ray casting, ignoring request.");
-            }
-            else
+            if (IsValidRayCast2D(request))
             {
                 world->m_RayCastRequests.Push(request);
             }
         }
         else
         {
-            dmLogWarning("Ray cast query buffer is full (%d), ignoring request.", world->m_RayCastRequests.Capacity());
+            dmLogWarning("Ray cast query buffer is full (%d), ignoring request.", world->m_Context->m_RayCastLimit);
+        }
+    }
+
+    void RequestRayCasts2D(HWorld2D world, const RayCastRequest* requests, uint32_t count)
+    {
+        dmArray<RayCastRequest>& queue = world->m_RayCastRequests;
+        if (queue.Remaining() < count)
+            queue.OffsetCapacity(count - queue.Remaining());
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (IsValidRayCast2D(requests[i]))
+            {
+                queue.Push(requests[i]);
+            }
         }
     }
 
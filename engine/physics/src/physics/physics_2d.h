@@ -37,6 +37,13 @@ namespace dmPhysics
         const StepWorldContext* m_TempStepWorldContext;
     };
 
+    /// Transform last passed to the game object of a body, extrapolated when stepping at a fixed rate
+    struct ReportedTransform2D
+    {
+        Vectormath::Aos::Point3     m_Position;
+        float                       m_Angle;
+    };
+
     struct World2D
     {
         World2D(HContext2D context, const NewWorldParams& params);
@@ -45,10 +52,22 @@ namespace dmPhysics
         HContext2D                  m_Context;
         b2World                     m_World;
         dmArray<RayCastRequest>     m_RayCastRequests;
+        /// Responses of the requested ray casts, parallel to m_RayCastRequests while stepping
+        dmArray<RayCastResponse>    m_RayCastResponses;
         DebugDraw2D                 m_DebugDraw;
         ContactListener             m_ContactListener;
         GetWorldTransformCallback   m_GetWorldTransformCallback;
         SetWorldTransformCallback   m_SetWorldTransformCallback;
+        GetWorldTransformsCallback  m_GetWorldTransformsCallback;
+        SetWorldTransformsCallback  m_SetWorldTransformsCallback;
+        /// Bodies which transforms are exchanged with the external objects when stepping, parallel to m_TransformEntries
+        dmArray<b2Body*>            m_TransformBodies;
+        dmArray<WorldTransformEntry> m_TransformEntries;
+        /// Reported transforms of the dynamic bodies by body, kept when stepping at a fixed rate with dynamic transforms
+        /// allowed, so that the game object transforms are only read back when they have been changed by the user
+        dmHashTable<uintptr_t, ReportedTransform2D> m_ReportedTransforms;
+        /// Time not yet stepped when stepping at a fixed rate
+        float                       m_FixedTimeAccumulator;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -67,6 +86,11 @@ namespace dmPhysics
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        dmWorkerPool::HWorkerPool   m_WorkerPool;
+        float                       m_FixedTimeStep;
+        uint32_t                    m_MaxFixedTimeSteps;
+        uint32_t                    m_VelocityIterations;
+        uint32_t                    m_PositionIterations;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
@@ -222,6 +222,10 @@ namespace dmPhysics
     {
     }
 
+    void RequestRayCasts2D(HWorld2D world, const RayCastRequest* requests, uint32_t count)
+    {
+    }
+
     void RayCast2D(HWorld2D world, const RayCastRequest& request, dmArray<RayCastResponse>& results)
     {
     }
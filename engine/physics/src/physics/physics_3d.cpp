@@ -48,6 +48,23 @@ namespace dmPhysics
     static Vectormath::Aos::Point3 GetWorldPosition(HContext3D context, btCollisionObject* collision_object);
     static Vectormath::Aos::Quat GetWorldRotation(HContext3D context, btCollisionObject* collision_object);
 
+    static WorldTransformEntry* PushTransformEntry(HWorld3D world, btCollisionObject* collision_object, void* user_data)
+    {
+        dmArray<btCollisionObject*>& objects = world->m_TransformObjects;
+        dmArray<WorldTransformEntry>& entries = world->m_TransformEntries;
+        if (objects.Full())
+        {
+            uint32_t capacity = objects.Capacity() + dmMath::Max(objects.Capacity(), 64u);
+            objects.SetCapacity(capacity);
+            entries.SetCapacity(capacity);
+        }
+        objects.Push(collision_object);
+        entries.SetSize(entries.Size() + 1);
+        WorldTransformEntry* entry = &entries.Back();
+        entry->m_UserData = user_data;
+        return entry;
+    }
+
     static btCollisionObject* GetCollisionObject(HCollisionObject3D co)
     {
         return ((CollisionObject3D*)co)->m_CollisionObject;
@@ -56,11 +73,13 @@ namespace dmPhysics
     class MotionState : public btMotionState
     {
     public:
-        MotionState(HContext3D context, void* user_data, GetWorldTransformCallback get_world_transform, SetWorldTransformCallback set_world_transform)
-        : m_Context(context)
+        MotionState(HWorld3D world, void* user_data)
+        : m_World(world)
+        , m_Context(world->m_Context)
         , m_UserData(user_data)
-        , m_GetWorldTransform(get_world_transform)
-        , m_SetWorldTransform(set_world_transform)
+        , m_GetWorldTransform(world->m_GetWorldTransform)
+        , m_SetWorldTransform(world->m_SetWorldTransform)
+        , m_HasReportedTransform(0)
         {
         }
 
@@ -90,23 +109,46 @@ namespace dmPhysics
 
         virtual void setWorldTransform(const btTransform &worldTrans)
         {
-            if (m_SetWorldTransform != 0x0)
+            // Interpolated when stepping at a fixed rate, so it can differ from the transform of the body
+            m_ReportedPosition = Point3(ToTranslation(worldTrans));
+            m_ReportedRotation = ToRotation(worldTrans);
+            m_HasReportedTransform = 1;
+            if (m_World->m_SetWorldTransforms != 0x0)
             {
-                btVector3 bt_pos = worldTrans.getOrigin();
-                btQuaternion bt_rot = worldTrans.getRotation();
-
-                Vector3 translation;
-                FromBt(bt_pos, translation, m_Context->m_InvScale);
-                Quat rot = Quat(bt_rot.getX(), bt_rot.getY(), bt_rot.getZ(), bt_rot.getW());
-                m_SetWorldTransform(m_UserData, Point3(translation), rot);
+                // Queued and propagated in one batch after the simulation step
+                WorldTransformEntry* entry = PushTransformEntry(m_World, 0x0, m_UserData);
+                entry->m_WorldTransform = dmTransform::Transform(ToTranslation(worldTrans), ToRotation(worldTrans), 1.0f);
+            }
+            else if (m_SetWorldTransform != 0x0)
+            {
+                m_SetWorldTransform(m_UserData, Point3(ToTranslation(worldTrans)), ToRotation(worldTrans));
             }
         }
 
     protected:
+        Vector3 ToTranslation(const btTransform& world_trans) const
+        {
+            Vector3 translation;
+            FromBt(world_trans.getOrigin(), translation, m_Context->m_InvScale);
+            return translation;
+        }
+
+        Quat ToRotation(const btTransform& world_trans) const
+        {
+            btQuaternion bt_rot = world_trans.getRotation();
+            return Quat(bt_rot.getX(), bt_rot.getY(), bt_rot.getZ(), bt_rot.getW());
+        }
+
+    public:
+        HWorld3D m_World;
         HContext3D m_Context;
         void* m_UserData;
         GetWorldTransformCallback m_GetWorldTransform;
         SetWorldTransformCallback m_SetWorldTransform;
+        /// Last transform passed to the game object
+        Point3 m_ReportedPosition;
+        Quat m_ReportedRotation;
+        uint8_t m_HasReportedTransform:1;
     };
 
     Context3D::Context3D()
@@ -120,6 +162,11 @@ namespace dmPhysics
     , m_TriggerEnterLimit(0.0f)
     , m_RayCastLimit(0)
     , m_TriggerOverlapCapacity(0)
+    , m_WorkerPool(0)
+    , m_FixedTimeStep(0.0f)
+    , m_MaxFixedTimeSteps(0)
+    , m_VelocityIterations(0)
+    , m_PositionIterations(0)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -148,9 +195,12 @@ namespace dmPhysics
         m_DynamicsWorld = new btDiscreteDynamicsWorld(m_Dispatcher, m_OverlappingPairCache, m_Solver, m_CollisionConfiguration);
         m_DynamicsWorld->setGravity(btVector3(context->m_Gravity.getX(), context->m_Gravity.getY(), context->m_Gravity.getZ()));
         m_DynamicsWorld->setDebugDrawer(&m_DebugDraw);
+        m_DynamicsWorld->getSolverInfo().m_numIterations = context->m_VelocityIterations;
 
         m_GetWorldTransform = params.m_GetWorldTransformCallback;
         m_SetWorldTransform = params.m_SetWorldTransformCallback;
+        m_GetWorldTransforms = params.m_GetWorldTransformsCallback;
+        m_SetWorldTransforms = params.m_SetWorldTransformsCallback;
 
         m_RayCastRequests.SetCapacity(context->m_RayCastLimit);
         OverlapCacheInit(&m_TriggerOverlaps);
@@ -267,6 +317,43 @@ namespace dmPhysics
         void* m_IgnoredUserData;
     };
 
+    struct RayCastJob3D
+    {
+        HWorld3D                m_World;
+        const RayCastRequest*   m_Requests;
+        RayCastResponse*        m_Responses;
+    };
+
+    // Only reads from the world, which makes it safe to run the ranges in parallel
+    static void RayCastRange3D(void* _job, uint32_t start, uint32_t end)
+    {
+        RayCastJob3D* job = (RayCastJob3D*)_job;
+        HWorld3D world = job->m_World;
+        float scale = world->m_Context->m_Scale;
+        float inv_scale = world->m_Context->m_InvScale;
+        for (uint32_t i = start; i < end; ++i)
+        {
+            const RayCastRequest& request = job->m_Requests[i];
+            btVector3 from;
+            ToBt(request.m_From, from, scale);
+            btVector3 to;
+            ToBt(request.m_To, to, scale);
+            RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
+            world->m_DynamicsWorld->rayTest(from, to, result_callback);
+            RayCastResponse& response = job->m_Responses[i];
+            response = RayCastResponse();
+            response.m_Hit = result_callback.hasHit() ? 1 : 0;
+            response.m_Fraction = result_callback.m_closestHitFraction;
+            FromBt(result_callback.m_hitPointWorld, response.m_Position, inv_scale);
+            FromBt(result_callback.m_hitNormalWorld, response.m_Normal, 1.0f); // don't scale normal
+            if (result_callback.m_collisionObject != 0x0)
+            {
+                response.m_CollisionObjectUserData = result_callback.m_collisionObject->getUserPointer();
+                response.m_CollisionObjectGroup = result_callback.m_collisionObject->getBroadphaseHandle()->m_collisionFilterGroup;
+            }
+        }
+    }
+
     HContext3D NewContext3D(const NewContextParams& params)
     {
         if (params.m_Scale < MIN_SCALE || params.m_Scale > MAX_SCALE)
@@ -282,6 +369,11 @@ namespace dmPhysics
         context->m_ContactImpulseLimit = params.m_ContactImpulseLimit * params.m_Scale;
         context->m_TriggerEnterLimit = params.m_TriggerEnterLimit * params.m_Scale;
         context->m_RayCastLimit = params.m_RayCastLimit3D;
+        context->m_WorkerPool = params.m_WorkerPool;
+        context->m_FixedTimeStep = params.m_FixedTimeStep;
+        context->m_MaxFixedTimeSteps = params.m_MaxFixedTimeSteps;
+        context->m_VelocityIterations = params.m_VelocityIterations;
+        context->m_PositionIterations = params.m_PositionIterations;
         context->m_TriggerOverlapCapacity = params.m_TriggerOverlapCapacity;
         context->m_AllowDynamicTransforms = params.m_AllowDynamicTransforms;
         dmMessage::Result result = dmMessage::NewSocket(PHYSICS_SOCKET_NAME, &context->m_Socket);
@@ -364,44 +456,73 @@ namespace dmPhysics
         // Values are picked by inspection, current rot value is roughly equivalent to 1 degree
         const float POS_EPSILON = 0.00005f * scale;
         const float ROT_EPSILON = 0.00007f;
+        dmArray<btCollisionObject*>& transform_objects = world->m_TransformObjects;
+        dmArray<WorldTransformEntry>& transform_entries = world->m_TransformEntries;
         // Update all trigger transforms before physics world step
-        if (world->m_GetWorldTransform != 0x0)
+        if (world->m_GetWorldTransform != 0x0 || world->m_GetWorldTransforms != 0x0)
         {
             DM_PROFILE(Physics, "UpdateTriggers");
+            // Gather the collision objects first, so that the transforms can be fetched in one batch
+            transform_objects.SetSize(0);
+            transform_entries.SetSize(0);
             int collision_object_count = world->m_DynamicsWorld->getNumCollisionObjects();
             btCollisionObjectArray& collision_objects = world->m_DynamicsWorld->getCollisionObjectArray();
             for (int i = 0; i < collision_object_count; ++i)
             {
                 btCollisionObject* collision_object = collision_objects[i];
+                bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && !collision_object->isStaticObject();
+                if (collision_object->getInternalType() == btCollisionObject::CO_GHOST_OBJECT || collision_object->isKinematicObject() || retrieve_gameworld_transform)
+                {
+                    PushTransformEntry(world, collision_object, collision_object->getUserPointer());
+                }
+            }
+            uint32_t count = transform_objects.Size();
+            GetWorldTransforms(world->m_GetWorldTransforms, world->m_GetWorldTransform, transform_entries.Begin(), count);
 
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                btCollisionObject* collision_object = transform_objects[i];
+                const dmTransform::Transform& world_transform = transform_entries[i].m_WorldTransform;
                 bool retrieve_gameworld_transform = world->m_AllowDynamicTransforms && !collision_object->isStaticObject();
 
-                if (collision_object->getInternalType() == btCollisionObject::CO_GHOST_OBJECT || collision_object->isKinematicObject() || retrieve_gameworld_transform)
+                // translate & rotation
+                Point3 old_position = GetWorldPosition(context, collision_object);
+                Quat old_rotation = GetWorldRotation(context, collision_object);
+                Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
+                Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat(world_transform.GetRotation());
+                // Compare against what was last reported to the game object, which is interpolated when stepping
+                // at a fixed rate. Otherwise the interpolation would be fed back into the simulation every frame.
+                btRigidBody* rigid_body = btRigidBody::upcast(collision_object);
+                MotionState* motion_state = rigid_body ? (MotionState*)rigid_body->getMotionState() : 0x0;
+                float dp;
+                float dr;
+                if (motion_state && motion_state->m_HasReportedTransform)
                 {
-                    Point3 old_position = GetWorldPosition(context, collision_object);
-                    Quat old_rotation = GetWorldRotation(context, collision_object);
-                    dmTransform::Transform world_transform;
-                    (*world->m_GetWorldTransform)(collision_object->getUserPointer(), world_transform);
-                    Vectormath::Aos::Point3 position = Vectormath::Aos::Point3(world_transform.GetTranslation());
-                    Vectormath::Aos::Quat rotation = Vectormath::Aos::Quat(world_transform.GetRotation());
-                    float dp = distSqr(old_position, position);
-                    float dr = norm(rotation - old_rotation);
-                    if (dp > POS_EPSILON || dr > ROT_EPSILON)
+                    dp = distSqr(motion_state->m_ReportedPosition, position);
+                    dr = norm(rotation - motion_state->m_ReportedRotation);
+                }
+                else
+                {
+                    dp = distSqr(old_position, position);
+                    dr = norm(rotation - old_rotation);
+                }
+                if (dp > POS_EPSILON || dr > ROT_EPSILON)
+                {
+                    btVector3 bt_pos;
+                    ToBt(position, bt_pos, scale);
+                    btTransform world_t(btQuaternion(rotation.getX(), rotation.getY(), rotation.getZ(), rotation.getW()), bt_pos);
+                    collision_object->setWorldTransform(world_t);
+                    collision_object->activate(true);
+                    if (motion_state)
                     {
-                        btVector3 bt_pos;
-                        ToBt(position, bt_pos, scale);
-                        btTransform world_t(btQuaternion(rotation.getX(), rotation.getY(), rotation.getZ(), rotation.getW()), bt_pos);
-                        collision_object->setWorldTransform(world_t);
-                        collision_object->activate(true);
+                        motion_state->m_ReportedPosition = position;
+                        motion_state->m_ReportedRotation = rotation;
                     }
                 }
 
                 // Scaling
                 if (retrieve_gameworld_transform)
                 {
-                    dmTransform::Transform world_transform;
-                    world->m_GetWorldTransform(collision_object->getUserPointer(), world_transform);
-
                     // The compound shape scale always defaults to 1
                     btCollisionShape* shape = collision_object->getCollisionShape();
 
@@ -420,9 +541,20 @@ namespace dmPhysics
 
         {
             DM_PROFILE(Physics, "StepSimulation");
-            // Step simulation
-            // TODO: Max substeps = 1 for now...
-            world->m_DynamicsWorld->stepSimulation(dt, 1);
+            transform_objects.SetSize(0);
+            transform_entries.SetSize(0);
+            if (context->m_FixedTimeStep > 0.0f)
+            {
+                // Bullet accumulates the time and interpolates the transforms passed to the motion states
+                world->m_DynamicsWorld->stepSimulation(dt, context->m_MaxFixedTimeSteps, context->m_FixedTimeStep);
+            }
+            else
+            {
+                // TODO: Max substeps = 1 for now...
+                world->m_DynamicsWorld->stepSimulation(dt, 1);
+            }
+            // The motion states queue the transforms of the moved bodies when batching
+            SetWorldTransforms(world->m_SetWorldTransforms, world->m_SetWorldTransform, transform_entries.Begin(), transform_entries.Size());
         }
 
         // Handle ray cast requests
@@ -430,33 +562,24 @@ namespace dmPhysics
         if (size > 0)
         {
             DM_PROFILE(Physics, "RayCasts");
-            for (uint32_t i = 0; i < size; ++i)
+            if (step_context.m_RayCastCallback == 0x0 && step_context.m_RayCastBatchCallback == 0x0)
             {
-                const RayCastRequest& request = world->m_RayCastRequests[i];
-                if (step_context.m_RayCastCallback == 0x0)
-                {
-                    dmLogWarning("Ray cast requested without any response callback, skipped.");
-                    continue;
-                }
-                float scale = world->m_Context->m_Scale;
-                btVector3 from;
-                ToBt(request.m_From, from, scale);
-                btVector3 to;
-                ToBt(request.m_To, to, scale);
-                RayCastResultClosestCallback3D result_callback(from, to, request.m_Mask, request.m_IgnoredUserData);
-                world->m_DynamicsWorld->rayTest(from, to, result_callback);
-                RayCastResponse response;
-                response.m_Hit = result_callback.hasHit() ? 1 : 0;
-                response.m_Fraction = result_callback.m_closestHitFraction;
-                float inv_scale = world->m_Context->m_InvScale;
-                FromBt(result_callback.m_hitPointWorld, response.m_Position, inv_scale);
-                FromBt(result_callback.m_hitNormalWorld, response.m_Normal, 1.0f); // don't scale normal
-                if (result_callback.m_collisionObject != 0x0)
-                {
-                    response.m_CollisionObjectUserData = result_callback.m_collisionObject->getUserPointer();
-                    response.m_CollisionObjectGroup = result_callback.m_collisionObject->getBroadphaseHandle()->m_collisionFilterGroup;
-                }
-                step_context.m_RayCastCallback(response, request, step_context.m_RayCastUserData);
+                dmLogWarning("Ray casts requested without any response callback, skipped.");
+            }
+            else
+            {
+                dmArray<RayCastResponse>& responses = world->m_RayCastResponses;
+                if (responses.Capacity() < size)
+                    responses.SetCapacity(world->m_RayCastRequests.Capacity());
+                responses.SetSize(size);
+
+                RayCastJob3D job;
+                job.m_World = world;
+                job.m_Requests = world->m_RayCastRequests.Begin();
+                job.m_Responses = responses.Begin();
+                dmWorkerPool::ParallelFor(world->m_Context->m_WorkerPool, RayCastRange3D, &job, size, RAY_CAST_CHUNK_SIZE);
+
+                ReportRayCasts(step_context, responses.Begin(), world->m_RayCastRequests.Begin(), size);
             }
             world->m_RayCastRequests.SetSize(0);
         }
@@ -731,7 +854,7 @@ namespace dmPhysics
         btCollisionObject* collision_object = 0x0;
         if (data.m_Type != COLLISION_OBJECT_TYPE_TRIGGER)
         {
-            MotionState* motion_state = new MotionState(world->m_Context, data.m_UserData, world->m_GetWorldTransform, world->m_SetWorldTransform);
+            MotionState* motion_state = new MotionState(world, data.m_UserData);
             btRigidBody::btRigidBodyConstructionInfo rb_info(data.m_Mass, motion_state, compound_shape, local_inertia);
             rb_info.m_friction = data.m_Friction;
             rb_info.m_restitution = data.m_Restitution;
@@ -1071,23 +1194,44 @@ namespace dmPhysics
         }
     }
 
+    static bool IsValidRayCast3D(const RayCastRequest& request)
+    {
+        // Verify that the ray is not 0-length
+        if (Vectormath::Aos::lengthSqr(request.m_To - request.m_From) <= 0.0f)
+        {
+            dmLogWarning("Ray had 0 length when ray casting, ignoring request.");
+            return false;
+        }
+        return true;
+    }
+
     void RequestRayCast3D(HWorld3D world, const RayCastRequest& request)
     {
-        if (!world->m_RayCastRequests.Full())
+        // The queue may have grown beyond the limit from batched requests
+        if (world->m_RayCastRequests.Size() < (uint32_t) world->m_Context->m_RayCastLimit)
         {
-            // Verify that the ray is not 0-length
-            if (Vectormath::Aos::lengthSqr(request.m_To - request.m_From) <= 0.0f)
-            {
-                dmLogWarning("Ray had 0 length when ray casting, ignoring request.");
-            }
-            else
+            if (IsValidRayCast3D(request))
             {
                 world->m_RayCastRequests.Push(request);
             }
         }
         else
         {
-            dmLogWarning("Ray cast query buffer is full (%d), ignoring request.", world->m_RayCastRequests.Capacity());
+            dmLogWarning("Ray cast query buffer is full (%d), ignoring request.", world->m_Context->m_RayCastLimit);
+        }
+    }
+
+    void RequestRayCasts3D(HWorld3D world, const RayCastRequest* requests, uint32_t count)
+    {
+        dmArray<RayCastRequest>& queue = world->m_RayCastRequests;
+        if (queue.Remaining() < count)
+            queue.OffsetCapacity(count - queue.Remaining());
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (IsValidRayCast3D(requests[i]))
+            {
+                queue.Push(requests[i]);
+            }
         }
     }
 
@@ -28,6 +28,8 @@ namespace dmPhysics
 
         OverlapCache                            m_TriggerOverlaps;
         dmArray<RayCastRequest>                 m_RayCastRequests;
+        /// Responses of the requested ray casts, parallel to m_RayCastRequests while stepping
+        dmArray<RayCastResponse>                m_RayCastResponses;
         DebugDraw3D                             m_DebugDraw;
         HContext3D                              m_Context;
         btDefaultCollisionConfiguration*        m_CollisionConfiguration;
@@ -37,6 +39,11 @@ namespace dmPhysics
         btDiscreteDynamicsWorld*                m_DynamicsWorld;
         GetWorldTransformCallback               m_GetWorldTransform;
         SetWorldTransformCallback               m_SetWorldTransform;
+        GetWorldTransformsCallback              m_GetWorldTransforms;
+        SetWorldTransformsCallback              m_SetWorldTransforms;
+        /// Collision objects which transforms are exchanged with the external objects when stepping, parallel to m_TransformEntries
+        dmArray<btCollisionObject*>             m_TransformObjects;
+        dmArray<WorldTransformEntry>            m_TransformEntries;
         uint8_t                                 m_AllowDynamicTransforms:1;
         uint8_t                                 :7;
     };
@@ -55,6 +62,11 @@ namespace dmPhysics
         float                       m_TriggerEnterLimit;
         int                         m_RayCastLimit;
         int                         m_TriggerOverlapCapacity;
+        dmWorkerPool::HWorkerPool   m_WorkerPool;
+        float                       m_FixedTimeStep;
+        uint32_t                    m_MaxFixedTimeSteps;
+        uint32_t                    m_VelocityIterations;
+        uint32_t                    m_PositionIterations;
         uint8_t                     m_AllowDynamicTransforms:1;
         uint8_t                     :7;
     };
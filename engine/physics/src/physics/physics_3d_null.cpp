@@ -190,6 +190,10 @@ namespace dmPhysics
     {
     }
 
+    void RequestRayCasts3D(HWorld3D world, const RayCastRequest* requests, uint32_t count)
+    {
+    }
+
     void RayCast3D(HWorld3D world, const RayCastRequest& request, dmArray<RayCastResponse>& results)
     {
     }
@@ -15,6 +15,8 @@
 
 #include <string.h>
 
+#include <dlib/profile.h>
+
 namespace dmPhysics
 {
     using namespace Vectormath::Aos;
@@ -30,6 +32,11 @@ namespace dmPhysics
     , m_RayCastLimit2D(0)
     , m_RayCastLimit3D(0)
     , m_TriggerOverlapCapacity(0)
+    , m_WorkerPool(0)
+    , m_FixedTimeStep(0.0f)
+    , m_MaxFixedTimeSteps(2)
+    , m_VelocityIterations(10)
+    , m_PositionIterations(10)
     , m_AllowDynamicTransforms(0)
     {
 
@@ -42,8 +49,57 @@ namespace dmPhysics
     , m_WorldMax(WORLD_EXTENT, WORLD_EXTENT, WORLD_EXTENT)
     , m_GetWorldTransformCallback(0x0)
     , m_SetWorldTransformCallback(0x0)
+    , m_GetWorldTransformsCallback(0x0)
+    , m_SetWorldTransformsCallback(0x0)
+    {
+
+    }
+
+    void GetWorldTransforms(GetWorldTransformsCallback get_world_transforms, GetWorldTransformCallback get_world_transform, WorldTransformEntry* entries, uint32_t count)
     {
+        if (count == 0)
+            return;
+        if (get_world_transforms != 0x0)
+        {
+            get_world_transforms(entries, count);
+            return;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            get_world_transform(entries[i].m_UserData, entries[i].m_WorldTransform);
+        }
+    }
 
+    void SetWorldTransforms(SetWorldTransformsCallback set_world_transforms, SetWorldTransformCallback set_world_transform, const WorldTransformEntry* entries, uint32_t count)
+    {
+        if (count == 0)
+            return;
+        if (set_world_transforms != 0x0)
+        {
+            set_world_transforms(entries, count);
+            return;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const dmTransform::Transform& world_transform = entries[i].m_WorldTransform;
+            set_world_transform(entries[i].m_UserData, Point3(world_transform.GetTranslation()), world_transform.GetRotation());
+        }
+    }
+
+    void ReportRayCasts(const StepWorldContext& step_context, const RayCastResponse* responses, const RayCastRequest* requests, uint32_t count)
+    {
+        DM_PROFILE(Physics, "RayCastCallbacks");
+        if (step_context.m_RayCastBatchCallback != 0x0)
+        {
+            step_context.m_RayCastBatchCallback(responses, requests, count, step_context.m_RayCastUserData);
+            return;
+        }
+        if (step_context.m_RayCastCallback == 0x0)
+            return;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            step_context.m_RayCastCallback(responses[i], requests[i], step_context.m_RayCastUserData);
+        }
     }
 
     CollisionObjectData::CollisionObjectData()
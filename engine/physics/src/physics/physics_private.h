@@ -123,6 +123,29 @@ namespace dmPhysics
      * if it is the last known occurrence of overlap.
      */
     void OverlapCachePrune(OverlapCache* cache, const OverlapCachePruneData& data);
+
+    /**
+     * Fetch the world transforms of the entries, with a single call to the batched callback if it is set
+     * and otherwise one call per entry.
+     */
+    void GetWorldTransforms(GetWorldTransformsCallback get_world_transforms, GetWorldTransformCallback get_world_transform, WorldTransformEntry* entries, uint32_t count);
+
+    /**
+     * Propagate the world transforms of the entries, with a single call to the batched callback if it is set
+     * and otherwise one call per entry.
+     */
+    void SetWorldTransforms(SetWorldTransformsCallback set_world_transforms, SetWorldTransformCallback set_world_transform, const WorldTransformEntry* entries, uint32_t count);
+
+    /**
+     * Minimum number of ray casts performed per worker pool job.
+     */
+    const uint32_t RAY_CAST_CHUNK_SIZE = 16;
+
+    /**
+     * Report the responses of the ray casts performed during a step, with a single call to the batched callback
+     * if it is set and otherwise one call per request.
+     */
+    void ReportRayCasts(const StepWorldContext& step_context, const RayCastResponse* responses, const RayCastRequest* requests, uint32_t count);
 }
 
 #endif // PHYSICS_PRIVATE_H
@@ -15,6 +15,7 @@
 
 #include "test_physics.h"
 #include <dlib/math.h>
+#include <dlib/time.h>
 
 
 using namespace Vectormath::Aos;
@@ -124,6 +125,7 @@ Test3D::Test3D()
 , m_SetAngularDampingFunc(dmPhysics::SetAngularDamping3D)
 , m_GetMassFunc(dmPhysics::GetMass3D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast3D)
+, m_RequestRayCastsFunc(dmPhysics::RequestRayCasts3D)
 , m_RayCastFunc(dmPhysics::RayCast3D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks3D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape3D)
@@ -181,6 +183,7 @@ Test2D::Test2D()
 , m_SetAngularDampingFunc(dmPhysics::SetAngularDamping2D)
 , m_GetMassFunc(dmPhysics::GetMass2D)
 , m_RequestRayCastFunc(dmPhysics::RequestRayCast2D)
+, m_RequestRayCastsFunc(dmPhysics::RequestRayCasts2D)
 , m_RayCastFunc(dmPhysics::RayCast2D)
 , m_SetDebugCallbacksFunc(dmPhysics::SetDebugCallbacks2D)
 , m_ReplaceShapeFunc(dmPhysics::ReplaceShape2D)
@@ -427,6 +430,205 @@ TYPED_TEST(PhysicsTest, WorldTransformCallbacks)
     (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
 }
 
+struct BatchedTransformCounts
+{
+    uint32_t m_GetCalls;
+    uint32_t m_GetEntries;
+    uint32_t m_SetCalls;
+    uint32_t m_SetEntries;
+};
+
+static BatchedTransformCounts g_BatchedTransformCounts;
+
+static void GetWorldTransforms(dmPhysics::WorldTransformEntry* entries, uint32_t count)
+{
+    ++g_BatchedTransformCounts.m_GetCalls;
+    g_BatchedTransformCounts.m_GetEntries += count;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        GetWorldTransform(entries[i].m_UserData, entries[i].m_WorldTransform);
+    }
+}
+
+static void SetWorldTransforms(const dmPhysics::WorldTransformEntry* entries, uint32_t count)
+{
+    ++g_BatchedTransformCounts.m_SetCalls;
+    g_BatchedTransformCounts.m_SetEntries += count;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const dmTransform::Transform& transform = entries[i].m_WorldTransform;
+        SetWorldTransform(entries[i].m_UserData, Vectormath::Aos::Point3(transform.GetTranslation()), transform.GetRotation());
+    }
+}
+
+TYPED_TEST(PhysicsTest, BatchedWorldTransformCallbacks)
+{
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    world_params.m_GetWorldTransformsCallback = GetWorldTransforms;
+    world_params.m_SetWorldTransformsCallback = SetWorldTransforms;
+    typename TypeParam::WorldType world = (*TestFixture::m_Test.m_NewWorldFunc)(TestFixture::m_Context, world_params);
+
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(TestFixture::m_Context, Vector3(1.0f, 1.0f, 1.0f));
+    dmPhysics::CollisionObjectData data;
+
+    VisualObject dynamic_vo;
+    dynamic_vo.m_Position = Vectormath::Aos::Point3(0.0f, 10.0f, 0.0f);
+    data.m_UserData = &dynamic_vo;
+    typename TypeParam::CollisionObjectType dynamic_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(world, data, &shape, 1u);
+
+    VisualObject kinematic_vo;
+    kinematic_vo.m_Position = Vectormath::Aos::Point3(10.0f, 0.0f, 0.0f);
+    data.m_UserData = &kinematic_vo;
+    data.m_Mass = 0.0f;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_KINEMATIC;
+    typename TypeParam::CollisionObjectType kinematic_co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(world, data, &shape, 1u);
+
+    memset(&g_BatchedTransformCounts, 0, sizeof(g_BatchedTransformCounts));
+    kinematic_vo.m_Position.setY(1.0f);
+
+    (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext);
+
+    // One call each way per step, with the kinematic object in and the dynamic object out
+    ASSERT_EQ(1u, g_BatchedTransformCounts.m_GetCalls);
+    ASSERT_EQ(1u, g_BatchedTransformCounts.m_GetEntries);
+    ASSERT_EQ(1u, g_BatchedTransformCounts.m_SetCalls);
+    ASSERT_EQ(1u, g_BatchedTransformCounts.m_SetEntries);
+
+    ASSERT_GT(10.0f, dynamic_vo.m_Position.getY());
+    ASSERT_GT(10.0f, (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, dynamic_co).getY());
+    ASSERT_EQ(1.0f, (*TestFixture::m_Test.m_GetWorldPositionFunc)(TestFixture::m_Context, kinematic_co).getY());
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(world, dynamic_co);
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(world, kinematic_co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+    (*TestFixture::m_Test.m_DeleteWorldFunc)(TestFixture::m_Context, world);
+}
+
+// Only one context may exist at a time, so the context of the fixture is replaced
+template<typename T>
+static void ReplaceContext(T& test, typename T::ContextType* context, typename T::WorldType* world, const dmPhysics::NewContextParams& context_params)
+{
+    (*test.m_DeleteWorldFunc)(*context, *world);
+    (*test.m_DeleteContextFunc)(*context);
+
+    *context = (*test.m_NewContextFunc)(context_params);
+    dmPhysics::NewWorldParams world_params;
+    world_params.m_GetWorldTransformCallback = GetWorldTransform;
+    world_params.m_SetWorldTransformCallback = SetWorldTransform;
+    *world = (*test.m_NewWorldFunc)(*context, world_params);
+}
+
+TYPED_TEST(PhysicsTest, FixedTimeStep)
+{
+    const float fixed_dt = 1.0f / 30.0f;
+    const float dt = 1.0f / 60.0f;
+    const float gravity = -10.0f;
+
+    dmPhysics::NewContextParams context_params;
+    context_params.m_Scale = PHYSICS_SCALE;
+    context_params.m_Gravity = Vector3(0.0f, gravity, 0.0f);
+    context_params.m_FixedTimeStep = fixed_dt;
+    context_params.m_MaxFixedTimeSteps = 2;
+    ReplaceContext(TestFixture::m_Test, &this->m_Context, &this->m_World, context_params);
+    typename TypeParam::ContextType context = TestFixture::m_Context;
+    typename TypeParam::WorldType world = TestFixture::m_World;
+
+    VisualObject vo;
+    vo.m_Position = Point3(0.0f, 10.0f, 0.0f);
+    dmPhysics::CollisionObjectData data;
+    data.m_UserData = &vo;
+    typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(context, Vector3(0.5f, 0.5f, 0.5f));
+    typename TypeParam::CollisionObjectType co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(world, data, &shape, 1u);
+
+    TestFixture::m_StepWorldContext.m_DT = dt;
+
+    // Step until the first fixed step is taken, since Bullet does not start at the beginning of a step
+    for (uint32_t i = 0; i < 2 && (*TestFixture::m_Test.m_GetLinearVelocityFunc)(context, co).getY() == 0.0f; ++i)
+    {
+        (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext);
+    }
+    ASSERT_NEAR(gravity * fixed_dt, (*TestFixture::m_Test.m_GetLinearVelocityFunc)(context, co).getY(), 0.0001f);
+    float stepped_y = (*TestFixture::m_Test.m_GetWorldPositionFunc)(context, co).getY();
+    ASSERT_GT(10.0f, stepped_y);
+    ASSERT_NEAR(stepped_y, vo.m_Position.getY(), 0.0001f);
+
+    // Half a fixed step, the body is not stepped but the game object is moved ahead of it by the remaining time
+    (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(gravity * fixed_dt, (*TestFixture::m_Test.m_GetLinearVelocityFunc)(context, co).getY(), 0.0001f);
+    ASSERT_NEAR(stepped_y, (*TestFixture::m_Test.m_GetWorldPositionFunc)(context, co).getY(), 0.0001f);
+    ASSERT_NEAR(stepped_y + gravity * fixed_dt * dt, vo.m_Position.getY(), 0.0001f);
+
+    // The second half completes the step
+    (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(2 * gravity * fixed_dt, (*TestFixture::m_Test.m_GetLinearVelocityFunc)(context, co).getY(), 0.0001f);
+    ASSERT_GT(stepped_y, (*TestFixture::m_Test.m_GetWorldPositionFunc)(context, co).getY());
+    ASSERT_NEAR((*TestFixture::m_Test.m_GetWorldPositionFunc)(context, co).getY(), vo.m_Position.getY(), 0.0001f);
+
+    // A long frame is capped to the max number of steps, and the whole steps beyond it are dropped
+    TestFixture::m_StepWorldContext.m_DT = 5 * fixed_dt + dt;
+    (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(4 * gravity * fixed_dt, (*TestFixture::m_Test.m_GetLinearVelocityFunc)(context, co).getY(), 0.0001f);
+    TestFixture::m_StepWorldContext.m_DT = fixed_dt;
+    (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext);
+    ASSERT_NEAR(5 * gravity * fixed_dt, (*TestFixture::m_Test.m_GetLinearVelocityFunc)(context, co).getY(), 0.0001f);
+
+    (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(world, co);
+    (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+// With dynamic transforms allowed, the game object transforms are read back into the bodies before each step.
+// The extrapolated/interpolated transforms must not be fed back into the simulation.
+TYPED_TEST(PhysicsTest, FixedTimeStepDynamicTransforms)
+{
+    const float fixed_dt = 1.0f / 30.0f;
+    const float dt = 1.0f / 60.0f;
+    const uint32_t frame_count = 31;
+
+    float positions[2];
+    for (uint32_t allow = 0; allow < 2; ++allow)
+    {
+        dmPhysics::NewContextParams context_params;
+        context_params.m_Scale = PHYSICS_SCALE;
+        context_params.m_Gravity = Vector3(0.0f, -10.0f, 0.0f);
+        context_params.m_FixedTimeStep = fixed_dt;
+        context_params.m_MaxFixedTimeSteps = 2;
+        context_params.m_AllowDynamicTransforms = allow;
+        ReplaceContext(TestFixture::m_Test, &this->m_Context, &this->m_World, context_params);
+        typename TypeParam::ContextType context = TestFixture::m_Context;
+        typename TypeParam::WorldType world = TestFixture::m_World;
+
+        VisualObject vo;
+        vo.m_Position = Point3(0.0f, 10.0f, 0.0f);
+        dmPhysics::CollisionObjectData data;
+        data.m_UserData = &vo;
+        typename TypeParam::CollisionShapeType shape = (*TestFixture::m_Test.m_NewBoxShapeFunc)(context, Vector3(0.5f, 0.5f, 0.5f));
+        typename TypeParam::CollisionObjectType co = (*TestFixture::m_Test.m_NewCollisionObjectFunc)(world, data, &shape, 1u);
+
+        TestFixture::m_StepWorldContext.m_DT = dt;
+        for (uint32_t i = 0; i < frame_count; ++i)
+        {
+            (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext);
+        }
+        positions[allow] = (*TestFixture::m_Test.m_GetWorldPositionFunc)(context, co).getY();
+
+        if (allow)
+        {
+            // Changes made to the game object are still applied to the body
+            vo.m_Position.setX(5.0f);
+            (*TestFixture::m_Test.m_StepWorldFunc)(world, TestFixture::m_StepWorldContext);
+            ASSERT_NEAR(5.0f, (*TestFixture::m_Test.m_GetWorldPositionFunc)(context, co).getX(), 0.001f);
+        }
+
+        (*TestFixture::m_Test.m_DeleteCollisionObjectFunc)(world, co);
+        (*TestFixture::m_Test.m_DeleteCollisionShapeFunc)(shape);
+    }
+
+    ASSERT_GT(10.0f, positions[0]);
+    ASSERT_NEAR(positions[0], positions[1], 0.001f);
+}
+
 TYPED_TEST(PhysicsTest, GroundBoxCollision)
 {
     float ground_height_half_ext = 1.0f;
@@ -1232,6 +1434,210 @@ enum Groups
     GROUP_B = 1 << 1
 };
 
+struct RayCastBatchResult
+{
+    RayCastBatchResult() : m_CallCount(0) {}
+
+    dmArray<dmPhysics::RayCastResponse> m_Responses;
+    dmArray<dmPhysics::RayCastRequest>  m_Requests;
+    uint32_t                            m_CallCount;
+};
+
+static void RayCastBatchCallback(const dmPhysics::RayCastResponse* responses, const dmPhysics::RayCastRequest* requests, uint32_t count, void* user_data)
+{
+    RayCastBatchResult* result = (RayCastBatchResult*)user_data;
+    ++result->m_CallCount;
+    result->m_Responses.SetCapacity(count);
+    result->m_Responses.SetSize(count);
+    memcpy(result->m_Responses.Begin(), responses, count * sizeof(dmPhysics::RayCastResponse));
+    result->m_Requests.SetCapacity(count);
+    result->m_Requests.SetSize(count);
+    memcpy(result->m_Requests.Begin(), requests, count * sizeof(dmPhysics::RayCastRequest));
+}
+
+static const uint32_t RAY_CAST_GRID_SIZE = 10;
+
+// A grid of static boxes in the xy-plane, with some lanes left open
+template<typename T>
+static void CreateRayCastGrid(T& test, typename T::ContextType context, typename T::WorldType world, typename T::CollisionShapeType* shape,
+                              VisualObject* visual_objects, dmArray<typename T::CollisionObjectType>& objects)
+{
+    *shape = (*test.m_NewBoxShapeFunc)(context, Vector3(0.5f, 0.5f, 0.5f));
+    dmPhysics::CollisionObjectData data;
+    data.m_Mass = 0.0f;
+    data.m_Type = dmPhysics::COLLISION_OBJECT_TYPE_STATIC;
+    objects.SetCapacity(RAY_CAST_GRID_SIZE * RAY_CAST_GRID_SIZE);
+    for (uint32_t y = 0; y < RAY_CAST_GRID_SIZE; ++y)
+    {
+        for (uint32_t x = 0; x < RAY_CAST_GRID_SIZE; ++x)
+        {
+            if ((x * 7 + y * 3) % 5 == 0)
+                continue;
+            VisualObject* vo = &visual_objects[objects.Size()];
+            vo->m_Position = Point3(x * 3.0f, y * 3.0f, 0.0f);
+            data.m_UserData = vo;
+            objects.Push((*test.m_NewCollisionObjectFunc)(world, data, shape, 1u));
+        }
+    }
+}
+
+template<typename T>
+static void DeleteRayCastGrid(T& test, typename T::WorldType world, typename T::CollisionShapeType shape, dmArray<typename T::CollisionObjectType>& objects)
+{
+    for (uint32_t i = 0; i < objects.Size(); ++i)
+    {
+        (*test.m_DeleteCollisionObjectFunc)(world, objects[i]);
+    }
+    (*test.m_DeleteCollisionShapeFunc)(shape);
+}
+
+static void MakeRayCastRequests(dmPhysics::RayCastRequest* requests, uint32_t count)
+{
+    const float extent = RAY_CAST_GRID_SIZE * 3.0f;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        float t = i / (float)count;
+        float s = ((i * 7919) % count) / (float)count;
+        dmPhysics::RayCastRequest& request = requests[i];
+        request = dmPhysics::RayCastRequest();
+        request.m_From = Point3(-2.0f, t * extent, 0.0f);
+        request.m_To = Point3(extent, s * extent, 0.0f);
+        request.m_UserId = i;
+    }
+}
+
+TYPED_TEST(PhysicsTest, BatchedRayCasting)
+{
+    const uint32_t ray_count = 500;
+
+    dmPhysics::NewContextParams context_params;
+    context_params.m_Scale = PHYSICS_SCALE;
+    context_params.m_WorkerPool = dmWorkerPool::New(3, "physics_test");
+    ReplaceContext(TestFixture::m_Test, &this->m_Context, &this->m_World, context_params);
+    typename TypeParam::ContextType context = TestFixture::m_Context;
+    typename TypeParam::WorldType world = TestFixture::m_World;
+
+    VisualObject visual_objects[RAY_CAST_GRID_SIZE * RAY_CAST_GRID_SIZE];
+    typename TypeParam::CollisionShapeType shape;
+    dmArray<typename TypeParam::CollisionObjectType> objects;
+    CreateRayCastGrid(TestFixture::m_Test, context, world, &shape, visual_objects, objects);
+
+    dmArray<dmPhysics::RayCastRequest> requests;
+    requests.SetCapacity(ray_count + 1);
+    requests.SetSize(ray_count);
+    MakeRayCastRequests(requests.Begin(), ray_count);
+    // 0-length rays are ignored
+    requests.Push(requests[0]);
+    requests.Back().m_To = requests.Back().m_From;
+
+    // The batched requests are not bound by the ray cast limit
+    (*TestFixture::m_Test.m_RequestRayCastsFunc)(world, requests.Begin(), requests.Size());
+
+    RayCastBatchResult result;
+    dmPhysics::StepWorldContext step_context;
+    step_context.m_DT = 1.0f / 60.0f;
+    step_context.m_RayCastBatchCallback = RayCastBatchCallback;
+    step_context.m_RayCastUserData = &result;
+    (*TestFixture::m_Test.m_StepWorldFunc)(world, step_context);
+
+    ASSERT_EQ(1u, result.m_CallCount);
+    ASSERT_EQ(ray_count, result.m_Responses.Size());
+
+    // The parallel ray casts give the same results as the synchronous ones
+    uint32_t hit_count = 0;
+    dmArray<dmPhysics::RayCastResponse> hits;
+    for (uint32_t i = 0; i < ray_count; ++i)
+    {
+        ASSERT_EQ(i, result.m_Requests[i].m_UserId);
+        const dmPhysics::RayCastResponse& response = result.m_Responses[i];
+
+        hits.SetSize(0);
+        (*TestFixture::m_Test.m_RayCastFunc)(world, requests[i], hits);
+        ASSERT_EQ(hits.Size(), (uint32_t)response.m_Hit);
+        if (response.m_Hit)
+        {
+            ++hit_count;
+            ASSERT_EQ(hits[0].m_CollisionObjectUserData, response.m_CollisionObjectUserData);
+            ASSERT_NEAR(hits[0].m_Fraction, response.m_Fraction, 0.00001f);
+            ASSERT_NEAR(hits[0].m_Position.getX(), response.m_Position.getX(), 0.0001f);
+            ASSERT_NEAR(hits[0].m_Position.getY(), response.m_Position.getY(), 0.0001f);
+        }
+    }
+    ASSERT_LT(0u, hit_count);
+    ASSERT_GT(ray_count, hit_count);
+
+    // Without a batch callback, the responses are reported one by one
+    RayCastResult single_results[2];
+    memset(single_results, 0, sizeof(single_results));
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        requests[i].m_UserData = single_results;
+    }
+    (*TestFixture::m_Test.m_RequestRayCastsFunc)(world, requests.Begin(), 2);
+    step_context.m_RayCastBatchCallback = 0x0;
+    step_context.m_RayCastCallback = RayCastCallback;
+    (*TestFixture::m_Test.m_StepWorldFunc)(world, step_context);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        ASSERT_EQ((void*)single_results, single_results[i].m_UserData);
+        ASSERT_EQ(result.m_Responses[i].m_Hit, single_results[i].m_Response.m_Hit);
+    }
+
+    DeleteRayCastGrid(TestFixture::m_Test, world, shape, objects);
+    dmWorkerPool::Delete(context_params.m_WorkerPool);
+}
+
+TYPED_TEST(PhysicsTest, BenchRayCasts)
+{
+    const uint32_t ray_count = 4000;
+    const uint32_t iteration_count = 20;
+    const uint32_t worker_counts[] = {0, 1, 3};
+
+    dmArray<dmPhysics::RayCastRequest> requests;
+    requests.SetCapacity(ray_count);
+    requests.SetSize(ray_count);
+    MakeRayCastRequests(requests.Begin(), ray_count);
+
+    for (uint32_t w = 0; w < DM_ARRAY_SIZE(worker_counts); ++w)
+    {
+        dmPhysics::NewContextParams context_params;
+        context_params.m_Scale = PHYSICS_SCALE;
+        context_params.m_WorkerPool = worker_counts[w] > 0 ? dmWorkerPool::New(worker_counts[w], "physics_bench") : 0;
+        ReplaceContext(TestFixture::m_Test, &this->m_Context, &this->m_World, context_params);
+        typename TypeParam::ContextType context = TestFixture::m_Context;
+        typename TypeParam::WorldType world = TestFixture::m_World;
+
+        VisualObject visual_objects[RAY_CAST_GRID_SIZE * RAY_CAST_GRID_SIZE];
+        typename TypeParam::CollisionShapeType shape;
+        dmArray<typename TypeParam::CollisionObjectType> objects;
+        CreateRayCastGrid(TestFixture::m_Test, context, world, &shape, visual_objects, objects);
+
+        RayCastBatchResult result;
+        dmPhysics::StepWorldContext step_context;
+        step_context.m_DT = 1.0f / 60.0f;
+        step_context.m_RayCastBatchCallback = RayCastBatchCallback;
+        step_context.m_RayCastUserData = &result;
+
+        uint64_t elapsed = 0;
+        for (uint32_t i = 0; i < iteration_count; ++i)
+        {
+            (*TestFixture::m_Test.m_RequestRayCastsFunc)(world, requests.Begin(), ray_count);
+            uint64_t start = dmTime::GetTime();
+            (*TestFixture::m_Test.m_StepWorldFunc)(world, step_context);
+            elapsed += dmTime::GetTime() - start;
+        }
+        ASSERT_EQ(iteration_count, result.m_CallCount);
+        ASSERT_EQ(ray_count, result.m_Responses.Size());
+
+        printf("Bench elapsed: %u rays, %u workers, %.3f ms/step\n", ray_count, worker_counts[w], elapsed / (1000.0 * iteration_count));
+
+        DeleteRayCastGrid(TestFixture::m_Test, world, shape, objects);
+        // The context is not used by the fixture after the test
+        if (context_params.m_WorkerPool)
+            dmWorkerPool::Delete(context_params.m_WorkerPool);
+    }
+}
+
 TYPED_TEST(PhysicsTest, FilteredRayCasting)
 {
     float box_half_ext = 0.5f;
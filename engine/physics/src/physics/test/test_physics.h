@@ -119,6 +119,7 @@ struct Funcs
     typedef void (*SetAngularDampingFunc)(typename T::CollisionObjectType collision_object, float angular_damping);
     typedef float (*GetMassFunc)(typename T::CollisionObjectType collision_object);
     typedef void (*RequestRayCastFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest& request);
+    typedef void (*RequestRayCastsFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest* requests, uint32_t count);
     typedef void (*RayCastFunc)(typename T::WorldType world, const dmPhysics::RayCastRequest& request, dmArray<dmPhysics::RayCastResponse>& results);
     typedef void (*SetDebugCallbacks)(typename T::ContextType context, const dmPhysics::DebugCallbacks& callbacks);
     typedef void (*ReplaceShapeFunc)(typename T::ContextType context, typename T::CollisionShapeType old_shape, typename T::CollisionShapeType new_shape);
@@ -173,6 +174,7 @@ struct Test3D
     Funcs<Test3D>::SetAngularDampingFunc            m_SetAngularDampingFunc;
     Funcs<Test3D>::GetMassFunc                      m_GetMassFunc;
     Funcs<Test3D>::RequestRayCastFunc               m_RequestRayCastFunc;
+    Funcs<Test3D>::RequestRayCastsFunc              m_RequestRayCastsFunc;
     Funcs<Test3D>::RayCastFunc                      m_RayCastFunc;
     Funcs<Test3D>::SetDebugCallbacks                m_SetDebugCallbacksFunc;
     Funcs<Test3D>::ReplaceShapeFunc                 m_ReplaceShapeFunc;
@@ -230,6 +232,7 @@ struct Test2D
     Funcs<Test2D>::SetAngularDampingFunc            m_SetAngularDampingFunc;
     Funcs<Test2D>::GetMassFunc                      m_GetMassFunc;
     Funcs<Test2D>::RequestRayCastFunc               m_RequestRayCastFunc;
+    Funcs<Test2D>::RequestRayCastsFunc              m_RequestRayCastsFunc;
     Funcs<Test2D>::RayCastFunc                      m_RayCastFunc;
     Funcs<Test2D>::SetDebugCallbacks                m_SetDebugCallbacksFunc;
     Funcs<Test2D>::ReplaceShapeFunc                 m_ReplaceShapeFunc;
@@ -136,6 +136,9 @@ namespace dmRender
         context->m_StencilBufferCleared = 0;
 
         context->m_RenderListDispatch.SetCapacity(255);
+        context->m_RenderListSortCacheHits = 0;
+        context->m_RenderListSortCacheMisses = 0;
+        context->m_RenderListDepthViewProj = context->m_ViewProj;
 
         dmMessage::Result r = dmMessage::NewSocket(RENDER_SOCKET_NAME, &context->m_Socket);
         assert(r == dmMessage::RESULT_OK);
@@ -229,17 +232,6 @@ namespace dmRender
         render_context->m_RenderListRanges.SetSize(0);
     }
 
-    struct RenderListSorter
-    {
-        bool operator()(uint32_t a, uint32_t b) const
-        {
-            const RenderListSortValue& u = values[a];
-            const RenderListSortValue& v = values[b];
-            return u.m_SortKey < v.m_SortKey;
-        }
-        RenderListSortValue* values;
-    };
-
     void RenderListEnd(HRenderContext render_context)
     {
         // Unflushed leftovers are assumed to be the debug rendering
@@ -364,6 +356,74 @@ namespace dmRender
         }
     }
 
+    void RadixSort64(uint64_t* keys, uint32_t* values, uint64_t* tmp_keys, uint32_t* tmp_values, uint32_t count)
+    {
+        const uint32_t RADIX_PASSES = 8;
+
+        if (count == 0)
+            return;
+
+        // Gather the histograms for all passes in one sweep
+        uint32_t histograms[RADIX_PASSES][256];
+        memset(histograms, 0, sizeof(histograms));
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint64_t key = keys[i];
+            for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass)
+            {
+                histograms[pass][(key >> (pass * 8)) & 0xff]++;
+            }
+        }
+
+        uint64_t* src_keys = keys;
+        uint32_t* src_values = values;
+        uint64_t* dst_keys = tmp_keys;
+        uint32_t* dst_values = tmp_values;
+
+        for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass)
+        {
+            uint32_t* histogram = histograms[pass];
+            const uint32_t shift = pass * 8;
+
+            // All keys share the same byte, so the pass wouldn't change the order
+            if (histogram[(src_keys[0] >> shift) & 0xff] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = histogram[i];
+                histogram[i] = offset;
+                offset += c;
+            }
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint64_t key = src_keys[i];
+                uint32_t dst = histogram[(key >> shift) & 0xff]++;
+                dst_keys[dst] = key;
+                dst_values[dst] = src_values[i];
+            }
+
+            uint64_t* swap_keys = src_keys; src_keys = dst_keys; dst_keys = swap_keys;
+            uint32_t* swap_values = src_values; src_values = dst_values; dst_values = swap_values;
+        }
+
+        if (src_keys != keys)
+        {
+            memcpy(keys, src_keys, sizeof(uint64_t) * count);
+            memcpy(values, src_values, sizeof(uint32_t) * count);
+        }
+    }
+
+    static void PrepareSortScratch(HRenderContext context, uint32_t capacity)
+    {
+        // SetCapacity does early out if they are the same, so the buffers are reused between frames
+        context->m_RenderListSortKeys.SetCapacity(capacity);
+        context->m_RenderListSortKeysTmp.SetCapacity(capacity);
+        context->m_RenderListSortBufferTmp.SetCapacity(capacity);
+    }
+
     // For unit testing only
     bool FindTagListRange(RenderListRange* ranges, uint32_t num_ranges, uint32_t tag_list_key, RenderListRange& range)
     {
@@ -378,6 +438,37 @@ namespace dmRender
         return false;
     }
 
+    // Compute the view projected depth of the world entries in the range, unless they're already computed
+    static void UpdateRangeDepths(HRenderContext context, RenderListRange& range)
+    {
+        if (range.m_DepthValid)
+            return;
+
+        const Matrix4& transform = context->m_ViewProj;
+        const RenderListEntry* entries = context->m_RenderList.Begin();
+        const uint32_t* indices = context->m_RenderListSortIndices.Begin();
+        float* depths = context->m_RenderListDepths.Begin();
+
+        float minZW = FLT_MAX;
+        float maxZW = -FLT_MAX;
+        for (uint32_t i = range.m_Start; i < range.m_Start+range.m_Count; ++i)
+        {
+            uint32_t idx = indices[i];
+            const RenderListEntry* entry = &entries[idx];
+            if (entry->m_MajorOrder != RENDER_ORDER_WORLD)
+                continue; // Could perhaps break here, if we also sorted on the major order (cost more when I tested it /MAWE)
+
+            const Vector4 res = transform * entry->m_WorldPosition;
+            const float zw = res.getZ() / res.getW();
+            depths[idx] = zw;
+            if (zw < minZW) minZW = zw;
+            if (zw > maxZW) maxZW = zw;
+        }
+        range.m_MinZW = minZW;
+        range.m_MaxZW = maxZW;
+        range.m_DepthValid = 1;
+    }
+
     // Compute new sort values for everything that matches tag_mask
     static void MakeSortBuffer(HRenderContext context, uint32_t tag_count, dmhash_t* tags)
     {
@@ -389,11 +480,12 @@ namespace dmRender
         context->m_RenderListSortBuffer.SetSize(0);
         context->m_RenderListSortValues.SetCapacity(required_capacity);
         context->m_RenderListSortValues.SetSize(context->m_RenderListSortIndices.Size());
+        PrepareSortScratch(context, required_capacity);
+        context->m_RenderListSortKeys.SetSize(0);
 
         RenderListSortValue* sort_values = context->m_RenderListSortValues.Begin();
         RenderListEntry* entries = context->m_RenderList.Begin();
-
-        const Matrix4& transform = context->m_ViewProj;
+        const float* depths = context->m_RenderListDepths.Begin();
 
         float minZW = FLT_MAX;
         float maxZW = -FLT_MAX;
@@ -414,20 +506,9 @@ namespace dmRender
                 continue;
             }
 
-            // Write z values...
-            for (uint32_t i = range.m_Start; i < range.m_Start+range.m_Count; ++i)
-            {
-                uint32_t idx = context->m_RenderListSortIndices[i];
-                RenderListEntry* entry = &entries[idx];
-                if (entry->m_MajorOrder != RENDER_ORDER_WORLD)
-                    continue; // Could perhaps break here, if we also sorted on the major order (cost more when I tested it /MAWE)
-
-                const Vector4 res = transform * entry->m_WorldPosition;
-                const float zw = res.getZ() / res.getW();
-                sort_values[idx].m_ZW = zw;
-                if (zw < minZW) minZW = zw;
-                if (zw > maxZW) maxZW = zw;
-            }
+            UpdateRangeDepths(context, range);
+            if (range.m_MinZW < minZW) minZW = range.m_MinZW;
+            if (range.m_MaxZW > maxZW) maxZW = range.m_MaxZW;
         }
 
         // ... and compute range
@@ -449,7 +530,7 @@ namespace dmRender
                 sort_values[idx].m_MajorOrder = entry->m_MajorOrder;
                 if (entry->m_MajorOrder == RENDER_ORDER_WORLD)
                 {
-                    const float z = sort_values[idx].m_ZW;
+                    const float z = depths[idx];
                     sort_values[idx].m_Order = (uint32_t) (0xfffff8 - 0xfffff0 * rc * (z - minZW));
                 }
                 else
@@ -461,10 +542,78 @@ namespace dmRender
                 sort_values[idx].m_BatchKey = entry->m_BatchKey & 0x00ffffff;
                 sort_values[idx].m_Dispatch = entry->m_Dispatch;
                 context->m_RenderListSortBuffer.Push(idx);
+                context->m_RenderListSortKeys.Push(sort_values[idx].m_SortKey);
             }
         }
     }
 
+    static inline bool IsSameMatrix(const Matrix4& a, const Matrix4& b)
+    {
+        return memcmp(&a, &b, sizeof(Matrix4)) == 0;
+    }
+
+    // Drop the cached depths if the view projection has changed since they were computed
+    static void ValidateRenderListDepths(HRenderContext context)
+    {
+        if (IsSameMatrix(context->m_RenderListDepthViewProj, context->m_ViewProj))
+            return;
+
+        context->m_RenderListDepthViewProj = context->m_ViewProj;
+        RenderListRange* ranges = context->m_RenderListRanges.Begin();
+        uint32_t num_ranges = context->m_RenderListRanges.Size();
+        for (uint32_t i = 0; i < num_ranges; ++i)
+        {
+            ranges[i].m_DepthValid = 0;
+        }
+    }
+
+    // Copies a previously sorted render list into the sort buffer
+    static bool GetCachedSortBuffer(HRenderContext context, uint64_t tags_hash)
+    {
+        for (uint32_t i = 0; i < context->m_RenderListSortCache.Size(); ++i)
+        {
+            const RenderListSortCacheEntry& cache_entry = context->m_RenderListSortCache[i];
+            if (cache_entry.m_TagsHash != tags_hash || !IsSameMatrix(cache_entry.m_ViewProj, context->m_ViewProj))
+                continue;
+
+            context->m_RenderListSortBuffer.SetCapacity(context->m_RenderListSortIndices.Capacity());
+            context->m_RenderListSortBuffer.SetSize(cache_entry.m_Count);
+            if (cache_entry.m_Count > 0)
+            {
+                memcpy(context->m_RenderListSortBuffer.Begin(), context->m_RenderListSortCacheIndices.Begin() + cache_entry.m_Start, sizeof(uint32_t) * cache_entry.m_Count);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    static void PutCachedSortBuffer(HRenderContext context, uint64_t tags_hash)
+    {
+        dmArray<uint32_t>& cache_indices = context->m_RenderListSortCacheIndices;
+        const uint32_t count = context->m_RenderListSortBuffer.Size();
+        if (cache_indices.Remaining() < count)
+        {
+            cache_indices.OffsetCapacity(count - cache_indices.Remaining());
+        }
+        if (context->m_RenderListSortCache.Full())
+        {
+            context->m_RenderListSortCache.OffsetCapacity(8);
+        }
+
+        RenderListSortCacheEntry cache_entry;
+        cache_entry.m_ViewProj = context->m_ViewProj;
+        cache_entry.m_TagsHash = tags_hash;
+        cache_entry.m_Start = cache_indices.Size();
+        cache_entry.m_Count = count;
+        context->m_RenderListSortCache.Push(cache_entry);
+
+        cache_indices.SetSize(cache_entry.m_Start + count);
+        if (count > 0)
+        {
+            memcpy(cache_indices.Begin() + cache_entry.m_Start, context->m_RenderListSortBuffer.Begin(), sizeof(uint32_t) * count);
+        }
+    }
+
     static void CollectRenderEntryRange(void* _ctx, uint32_t tag_list_key, size_t start, size_t count)
     {
         HRenderContext context = (HRenderContext)_ctx;
@@ -476,6 +625,10 @@ namespace dmRender
         range.m_TagListKey = tag_list_key;
         range.m_Start = start;
         range.m_Count = count;
+        range.m_Skip = 0;
+        range.m_DepthValid = 0;
+        range.m_MinZW = FLT_MAX;
+        range.m_MaxZW = -FLT_MAX;
         context->m_RenderListRanges.Push(range);
     }
 
@@ -509,9 +662,19 @@ namespace dmRender
 
         // First sort on the tag masks
         {
-            RenderListEntrySorter sort;
-            sort.m_Base = context->m_RenderList.Begin();
-            std::stable_sort(context->m_RenderListSortIndices.Begin(), context->m_RenderListSortIndices.End(), sort);
+            const uint32_t count = context->m_RenderListSortIndices.Size();
+            PrepareSortScratch(context, context->m_RenderListSortIndices.Capacity());
+            context->m_RenderListSortKeys.SetSize(count);
+
+            const RenderListEntry* entries = context->m_RenderList.Begin();
+            const uint32_t* indices = context->m_RenderListSortIndices.Begin();
+            uint64_t* keys = context->m_RenderListSortKeys.Begin();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                keys[i] = entries[indices[i]].m_TagListKey;
+            }
+
+            RadixSort64(keys, context->m_RenderListSortIndices.Begin(), context->m_RenderListSortKeysTmp.Begin(), context->m_RenderListSortBufferTmp.Begin(), count);
         }
         // Now find the ranges of tag masks
         {
@@ -535,20 +698,43 @@ namespace dmRender
         if (context->m_RenderListRanges.Empty())
         {
             SortRenderList(context);
+            context->m_RenderListSortCache.SetSize(0);
+            context->m_RenderListSortCacheIndices.SetSize(0);
+            context->m_RenderListDepths.SetCapacity(context->m_RenderListSortIndices.Capacity());
+            context->m_RenderListDepths.SetSize(context->m_RenderListSortIndices.Size());
         }
 
-        MakeSortBuffer(context, predicate?predicate->m_TagCount:0, predicate?predicate->m_Tags:0);
+        ValidateRenderListDepths(context);
 
-        if (context->m_RenderListSortBuffer.Empty())
-            return RESULT_OK;
+        // The predicate tags are kept sorted, so the hash is the same for the same set of tags
+        const uint32_t tag_count = predicate ? predicate->m_TagCount : 0;
+        const uint64_t tags_hash = tag_count > 0 ? dmHashBuffer64(predicate->m_Tags, sizeof(dmhash_t) * tag_count) : 0;
 
+        if (GetCachedSortBuffer(context, tags_hash))
+        {
+            context->m_RenderListSortCacheHits++;
+            DM_COUNTER("Render.SortCacheHits", 1);
+        }
+        else
         {
-            DM_PROFILE(Render, "DrawRenderList_SORT");
-            RenderListSorter sort;
-            sort.values = context->m_RenderListSortValues.Begin();
-            std::stable_sort(context->m_RenderListSortBuffer.Begin(), context->m_RenderListSortBuffer.End(), sort);
+            context->m_RenderListSortCacheMisses++;
+            DM_COUNTER("Render.SortCacheMisses", 1);
+
+            MakeSortBuffer(context, tag_count, predicate?predicate->m_Tags:0);
+
+            {
+                DM_PROFILE(Render, "DrawRenderList_SORT");
+                RadixSort64(context->m_RenderListSortKeys.Begin(), context->m_RenderListSortBuffer.Begin(),
+                            context->m_RenderListSortKeysTmp.Begin(), context->m_RenderListSortBufferTmp.Begin(),
+                            context->m_RenderListSortBuffer.Size());
+            }
+
+            PutCachedSortBuffer(context, tags_hash);
         }
 
+        if (context->m_RenderListSortBuffer.Empty())
+            return RESULT_OK;
+
         // Construct render objects
         context->m_RenderObjects.SetSize(0);
 
@@ -679,7 +865,18 @@ namespace dmRender
 
             dmGraphics::EnableVertexDeclaration(context, ro->m_VertexDeclaration, ro->m_VertexBuffer, GetMaterialProgram(material));
 
-            if (ro->m_IndexBuffer)
+            if (ro->m_InstanceCount > 0)
+            {
+                dmGraphics::EnableInstanceDeclaration(context, ro->m_InstanceDeclaration, ro->m_InstanceBuffer, ro->m_InstanceOffset, GetMaterialProgram(material));
+
+                if (ro->m_IndexBuffer)
+                    dmGraphics::DrawElementsInstanced(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_IndexType, ro->m_IndexBuffer, ro->m_InstanceCount);
+                else
+                    dmGraphics::DrawInstanced(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_InstanceCount);
+
+                dmGraphics::DisableInstanceDeclaration(context, ro->m_InstanceDeclaration);
+            }
+            else if (ro->m_IndexBuffer)
                 dmGraphics::DrawElements(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount, ro->m_IndexType, ro->m_IndexBuffer);
             else
                 dmGraphics::Draw(context, ro->m_PrimitiveType, ro->m_VertexStart, ro->m_VertexCount);
@@ -137,6 +137,8 @@ namespace dmRender
         dmGraphics::HVertexBuffer       m_VertexBuffer;
         dmGraphics::HVertexDeclaration  m_VertexDeclaration;
         dmGraphics::HIndexBuffer        m_IndexBuffer;
+        dmGraphics::HVertexBuffer       m_InstanceBuffer;       // Optional per instance streams, see m_InstanceCount
+        dmGraphics::HVertexDeclaration  m_InstanceDeclaration;
         HMaterial                       m_Material;
         dmGraphics::HTexture            m_Textures[MAX_TEXTURE_COUNT];
         dmGraphics::PrimitiveType       m_PrimitiveType;
@@ -146,6 +148,8 @@ namespace dmRender
         StencilTestParams               m_StencilTestParams;
         uint32_t                        m_VertexStart;
         uint32_t                        m_VertexCount;
+        uint32_t                        m_InstanceOffset;       // Offset in bytes into m_InstanceBuffer
+        uint32_t                        m_InstanceCount;        // Draw m_InstanceCount instances when non-zero
         uint8_t                         m_VertexConstantMask;
         uint8_t                         m_FragmentConstantMask;
         uint8_t                         m_SetBlendFactors : 1;
@@ -197,8 +197,20 @@ namespace dmRender
     {
         uint32_t m_TagListKey;
         uint32_t m_Start;       // Index into the renderlist
-        uint32_t m_Count:31;
+        uint32_t m_Count:30;
         uint32_t m_Skip:1;      // During the current draw call
+        uint32_t m_DepthValid:1;// If the depths of the world entries are computed for the current view projection
+        float    m_MinZW;
+        float    m_MaxZW;
+    };
+
+    // A sorted render list, reused by later draw calls with the same view projection and predicate during the frame
+    struct RenderListSortCacheEntry
+    {
+        Matrix4  m_ViewProj;
+        uint64_t m_TagsHash;
+        uint32_t m_Start;       // Index into m_RenderListSortCacheIndices
+        uint32_t m_Count;
     };
 
     struct MaterialTagList
@@ -222,7 +234,16 @@ namespace dmRender
         dmArray<RenderListSortValue>m_RenderListSortValues;
         dmArray<uint32_t>           m_RenderListSortBuffer;
         dmArray<uint32_t>           m_RenderListSortIndices;
+        dmArray<uint64_t>           m_RenderListSortKeys;       // Sort keys, parallel to the array being sorted
+        dmArray<uint64_t>           m_RenderListSortKeysTmp;    // Radix sort scratch buffers, reused between frames
+        dmArray<uint32_t>           m_RenderListSortBufferTmp;
         dmArray<RenderListRange>    m_RenderListRanges;         // Maps tagmask to a range in the (sorted) render list
+        dmArray<float>              m_RenderListDepths;         // View projected depth per render list entry, see RenderListRange::m_DepthValid
+        dmArray<RenderListSortCacheEntry> m_RenderListSortCache;  // Cleared when the ranges are rebuilt
+        dmArray<uint32_t>           m_RenderListSortCacheIndices;
+        uint32_t                    m_RenderListSortCacheHits;
+        uint32_t                    m_RenderListSortCacheMisses;
+        Matrix4                     m_RenderListDepthViewProj;  // The view projection used for the cached depths
 
         dmHashTable32<MaterialTagList>  m_MaterialTagLists;
 
@@ -280,6 +301,11 @@ namespace dmRender
         }
     };
 
+    // Stable LSD radix sort of the values on their 64 bit keys, 8 bits per pass.
+    // Passes where all keys share the same byte are skipped.
+    // The tmp buffers must hold at least count elements. The result is always stored in keys/values.
+    void RadixSort64(uint64_t* keys, uint32_t* values, uint64_t* tmp_keys, uint32_t* tmp_values, uint32_t count);
+
     typedef void (*RangeCallback)(void* ctx, uint32_t val, size_t start, size_t count);
 
     // Invokes the callback for each range. Two ranges are not guaranteed to preceed/succeed one another.
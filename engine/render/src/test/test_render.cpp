@@ -17,6 +17,7 @@
 
 #include <dlib/hash.h>
 #include <dlib/math.h>
+#include <dlib/time.h>
 
 #include <script/script.h>
 #include <algorithm> // std::stable_sort
@@ -318,6 +319,113 @@ TEST_F(dmRenderTest, TestRenderListDraw)
     ASSERT_EQ(ctx.m_Z, orders[1]);
 }
 
+struct TestSortCacheDispatchCtx
+{
+    uint32_t m_EntriesRendered;
+    float    m_Z[16];
+};
+
+static void TestSortCacheDispatch(dmRender::RenderListDispatchParams const & params)
+{
+    TestSortCacheDispatchCtx *ctx = (TestSortCacheDispatchCtx*) params.m_UserData;
+    if (params.m_Operation != dmRender::RENDER_LIST_OPERATION_BATCH)
+        return;
+    for (uint32_t* i = params.m_Begin; i != params.m_End; ++i)
+    {
+        ASSERT_LT(ctx->m_EntriesRendered, DM_ARRAY_SIZE(ctx->m_Z));
+        ctx->m_Z[ctx->m_EntriesRendered++] = params.m_Buf[*i].m_WorldPosition.getZ();
+    }
+}
+
+TEST_F(dmRenderTest, TestRenderListSortCache)
+{
+    TestSortCacheDispatchCtx ctx;
+    memset(&ctx, 0x00, sizeof(TestSortCacheDispatchCtx));
+
+    Vectormath::Aos::Matrix4 view = Vectormath::Aos::Matrix4::identity();
+    Vectormath::Aos::Matrix4 proj = Vectormath::Aos::Matrix4::orthographic(0.0f, WIDTH, HEIGHT, 0.0f, 0.1f, 1.0f);
+    dmRender::SetViewMatrix(m_Context, view);
+    dmRender::SetProjectionMatrix(m_Context, proj);
+
+    dmRender::RenderListBegin(m_Context);
+
+    uint8_t dispatch = dmRender::RenderListMakeDispatch(m_Context, TestSortCacheDispatch, &ctx);
+
+    const uint32_t n = DM_ARRAY_SIZE(ctx.m_Z);
+    dmRender::RenderListEntry* out = dmRender::RenderListAlloc(m_Context, n);
+    for (uint32_t i=0;i!=n;i++)
+    {
+        dmRender::RenderListEntry & entry = out[i];
+        entry.m_WorldPosition = Point3(0,0,(i * 7) % n);
+        entry.m_MajorOrder = dmRender::RENDER_ORDER_WORLD;
+        entry.m_MinorOrder = 0;
+        entry.m_TagListKey = 0;
+        entry.m_Order = 0;
+        entry.m_BatchKey = i & 1;
+        entry.m_Dispatch = dispatch;
+        entry.m_UserData = 0;
+    }
+
+    dmRender::RenderListSubmit(m_Context, out, out + n);
+    dmRender::RenderListEnd(m_Context);
+
+    const uint32_t hits = m_Context->m_RenderListSortCacheHits;
+    const uint32_t misses = m_Context->m_RenderListSortCacheMisses;
+
+    dmRender::DrawRenderList(m_Context, 0, 0);
+    ASSERT_EQ(hits, m_Context->m_RenderListSortCacheHits);
+    ASSERT_EQ(misses + 1, m_Context->m_RenderListSortCacheMisses);
+    ASSERT_EQ(n, ctx.m_EntriesRendered);
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        ASSERT_LT(ctx.m_Z[i-1], ctx.m_Z[i]);
+    }
+
+    // Same view projection and predicate, the sorted list is reused
+    TestSortCacheDispatchCtx first = ctx;
+    memset(&ctx, 0x00, sizeof(TestSortCacheDispatchCtx));
+    dmRender::DrawRenderList(m_Context, 0, 0);
+    ASSERT_EQ(hits + 1, m_Context->m_RenderListSortCacheHits);
+    ASSERT_EQ(misses + 1, m_Context->m_RenderListSortCacheMisses);
+    ASSERT_EQ(0, memcmp(&first, &ctx, sizeof(TestSortCacheDispatchCtx)));
+
+    // A new view projection needs a new sort
+    memset(&ctx, 0x00, sizeof(TestSortCacheDispatchCtx));
+    dmRender::SetViewMatrix(m_Context, Vectormath::Aos::Matrix4::translation(Vector3(0, 0, -0.5f)));
+    dmRender::DrawRenderList(m_Context, 0, 0);
+    ASSERT_EQ(hits + 1, m_Context->m_RenderListSortCacheHits);
+    ASSERT_EQ(misses + 2, m_Context->m_RenderListSortCacheMisses);
+    ASSERT_EQ(0, memcmp(&first, &ctx, sizeof(TestSortCacheDispatchCtx)));
+
+    // A new frame invalidates the cache
+    dmRender::RenderListBegin(m_Context);
+    memset(&ctx, 0x00, sizeof(TestSortCacheDispatchCtx));
+    dispatch = dmRender::RenderListMakeDispatch(m_Context, TestSortCacheDispatch, &ctx);
+    out = dmRender::RenderListAlloc(m_Context, n);
+    for (uint32_t i=0;i!=n;i++)
+    {
+        dmRender::RenderListEntry & entry = out[i];
+        entry.m_WorldPosition = Point3(0,0,n - i);
+        entry.m_MajorOrder = dmRender::RENDER_ORDER_WORLD;
+        entry.m_MinorOrder = 0;
+        entry.m_TagListKey = 0;
+        entry.m_Order = 0;
+        entry.m_BatchKey = 0;
+        entry.m_Dispatch = dispatch;
+        entry.m_UserData = 0;
+    }
+    dmRender::RenderListSubmit(m_Context, out, out + n);
+    dmRender::RenderListEnd(m_Context);
+    dmRender::DrawRenderList(m_Context, 0, 0);
+    ASSERT_EQ(hits + 1, m_Context->m_RenderListSortCacheHits);
+    ASSERT_EQ(misses + 3, m_Context->m_RenderListSortCacheMisses);
+    ASSERT_EQ(n, ctx.m_EntriesRendered);
+    for (uint32_t i = 1; i < n; ++i)
+    {
+        ASSERT_LT(ctx.m_Z[i-1], ctx.m_Z[i]);
+    }
+}
+
 struct TestRenderListOrderDispatchCtx
 {
     int m_BeginCalls;
@@ -762,6 +870,122 @@ TEST_F(dmRenderTest, FindRanges)
     ASSERT_EQ(6, range.m_Count);
 }
 
+struct RenderListKeySorter
+{
+    bool operator()(uint32_t a, uint32_t b) const
+    {
+        return m_Keys[a] < m_Keys[b];
+    }
+    const uint64_t* m_Keys;
+};
+
+// Creates sort keys with lots of duplicates in the upper bits, as produced by MakeSortBuffer
+static void MakeRenderListSortKeys(uint64_t* keys, uint32_t count, uint32_t seed)
+{
+    srand(seed);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        dmRender::RenderListSortValue value;
+        value.m_BatchKey = rand() & 0xf;
+        value.m_Dispatch = rand() & 0x3;
+        value.m_Order = ((rand() << 8) ^ rand()) & 0xffffff;
+        value.m_MajorOrder = rand() % 3;
+        value.m_MinorOrder = 0;
+        keys[i] = value.m_SortKey;
+    }
+}
+
+TEST(dmRenderListSort, RadixSort)
+{
+    const uint32_t counts[] = {0, 1, 2, 17, 1000, 4096};
+    for (uint32_t c = 0; c < DM_ARRAY_SIZE(counts); ++c)
+    {
+        const uint32_t count = counts[c];
+        uint64_t* source_keys = new uint64_t[count+1];
+        uint64_t* keys = new uint64_t[count+1];
+        uint64_t* tmp_keys = new uint64_t[count+1];
+        uint32_t* values = new uint32_t[count+1];
+        uint32_t* tmp_values = new uint32_t[count+1];
+        uint32_t* expected = new uint32_t[count+1];
+
+        MakeRenderListSortKeys(source_keys, count, c);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            keys[i] = source_keys[i];
+            values[i] = i;
+            expected[i] = i;
+        }
+
+        RenderListKeySorter sort;
+        sort.m_Keys = source_keys;
+        std::stable_sort(expected, expected + count, sort);
+
+        dmRender::RadixSort64(keys, values, tmp_keys, tmp_values, count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(expected[i], values[i]);
+            ASSERT_EQ(source_keys[expected[i]], keys[i]);
+        }
+
+        delete[] source_keys;
+        delete[] keys;
+        delete[] tmp_keys;
+        delete[] values;
+        delete[] tmp_values;
+        delete[] expected;
+    }
+}
+
+TEST(dmRenderListSort, Bench)
+{
+    const uint32_t counts[] = {1000, 10000, 100000};
+    const uint32_t iterations = 10;
+    for (uint32_t c = 0; c < DM_ARRAY_SIZE(counts); ++c)
+    {
+        const uint32_t count = counts[c];
+        uint64_t* source_keys = new uint64_t[count];
+        uint64_t* keys = new uint64_t[count];
+        uint64_t* tmp_keys = new uint64_t[count];
+        uint32_t* values = new uint32_t[count];
+        uint32_t* tmp_values = new uint32_t[count];
+
+        MakeRenderListSortKeys(source_keys, count, count);
+
+        RenderListKeySorter sort;
+        sort.m_Keys = source_keys;
+
+        uint64_t stable_sort_time = 0;
+        uint64_t radix_sort_time = 0;
+        for (uint32_t iter = 0; iter < iterations; ++iter)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+                values[i] = i;
+            uint64_t start = dmTime::GetTime();
+            std::stable_sort(values, values + count, sort);
+            stable_sort_time += dmTime::GetTime() - start;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                keys[i] = source_keys[i];
+                values[i] = i;
+            }
+            start = dmTime::GetTime();
+            dmRender::RadixSort64(keys, values, tmp_keys, tmp_values, count);
+            radix_sort_time += dmTime::GetTime() - start;
+        }
+
+        printf("Sorting %u entries: std::stable_sort %.3f ms, radix sort %.3f ms\n", count,
+                stable_sort_time / (1000.0f * iterations), radix_sort_time / (1000.0f * iterations));
+
+        delete[] source_keys;
+        delete[] keys;
+        delete[] tmp_keys;
+        delete[] values;
+        delete[] tmp_values;
+    }
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
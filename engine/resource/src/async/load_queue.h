@@ -35,6 +35,10 @@ namespace dmLoadQueue
         dmResource::FResourcePreload m_Function;
         dmResource::PreloadHintInfo m_HintInfo;
         void* m_Context;
+        // Set for resource types that may be created on a load thread. The queue is free to
+        // create the resource if the preload function did not hint any other resources.
+        dmResource::FResourceCreate m_CreateFunction;
+        dmhash_t m_CanonicalPathHash;
     };
 
     struct LoadResult
@@ -42,6 +46,12 @@ namespace dmLoadQueue
         dmResource::Result m_LoadResult;
         dmResource::Result m_PreloadResult;
         void* m_PreloadData;
+        // RESULT_PENDING unless the resource was created by the queue, in which case
+        // m_Resource holds the created resource (m_ResourceType is left unset)
+        dmResource::Result m_CreateResult;
+        dmResource::SResourceDescriptor m_Resource;
+        // The buffer returned by EndLoad points into a memory mapped archive, see ResourceCreateParams::m_IsBufferMapped
+        bool m_IsBufferMapped;
     };
 
     HQueue CreateQueue(dmResource::HFactory factory);
@@ -70,17 +70,20 @@ namespace dmLoadQueue
             return RESULT_INVALID_PARAM;
         }
 
-        load_result->m_LoadResult    = dmResource::LoadResource(queue->m_Factory, request->m_CanonicalPath, request->m_Name, buf, size);
+        load_result->m_LoadResult    = dmResource::LoadResource(queue->m_Factory, request->m_CanonicalPath, request->m_Name, buf, size, &load_result->m_IsBufferMapped);
         load_result->m_PreloadResult = dmResource::RESULT_PENDING;
         load_result->m_PreloadData   = 0;
+        load_result->m_CreateResult  = dmResource::RESULT_PENDING;
 
         if (load_result->m_LoadResult == dmResource::RESULT_OK && request->m_PreloadInfo.m_Function)
         {
             dmResource::ResourcePreloadParams params;
             params.m_Factory             = queue->m_Factory;
             params.m_Context             = request->m_PreloadInfo.m_Context;
+            params.m_Filename            = request->m_Name;
             params.m_Buffer              = *buf;
             params.m_BufferSize          = *size;
+            params.m_IsBufferMapped      = load_result->m_IsBufferMapped;
             params.m_HintInfo            = &request->m_PreloadInfo.m_HintInfo;
             params.m_PreloadData         = &load_result->m_PreloadData;
             load_result->m_PreloadResult = request->m_PreloadInfo.m_Function(params);
@@ -20,11 +20,19 @@
 #include <dlib/thread.h>
 #include <dlib/mutex.h>
 #include <dlib/time.h>
+#include <dlib/profile.h>
 #include <dlib/condition_variable.h>
 
 namespace dmLoadQueue
 {
-    // Implementation of dmLoadQueue with a thread that loads items in the order they are supplied,
+    // Implementation of dmLoadQueue with a number of threads that load items in parallel. The items are picked
+    // in the order they are supplied, and their results are delivered in that order too.
+    //
+    // Each item is loaded in two stages:
+    // * The I/O stage reads the data while holding the factory load lock, so only one thread at a time does I/O
+    // * The decode stage decrypts and decompresses archive entries and runs the preload function without any locks held
+    // This way one thread can read the next item while the others decode the items they have read.
+    // Resource types that are safe to create off the main thread are also created in the decode stage.
 
     // Default to small buffers since a lot of what is loaded are just small objects anyway.
     // That way we can have more in flight, but throttle when max pending data grows too large anyway
@@ -34,14 +42,21 @@ namespace dmLoadQueue
     // This sets the bandwidth of the loader.
     const uint64_t MAX_PENDING_DATA = 4 * 1024 * 1024;
     const uint32_t QUEUE_SLOTS      = 16;
+    const uint32_t MAX_THREADS      = 8;
 
     struct Request
     {
         const char* m_Name;
         const char* m_CanonicalPath;
         dmResource::LoadBufferType m_Buffer;
+        dmResource::RawResource m_Raw;
+        // The loaded data, either in m_Buffer or in a memory mapped archive
+        const void* m_Data;
+        uint32_t m_DataSize;
         PreloadInfo m_PreloadInfo;
         LoadResult m_Result;
+        uint32_t m_Index;
+        bool m_Done;
     };
 
     struct Queue
@@ -49,16 +64,17 @@ namespace dmLoadQueue
         dmResource::HFactory m_Factory;
         dmMutex::HMutex m_Mutex;
         dmConditionVariable::HConditionVariable m_WakeupCond;
-        dmThread::Thread m_Thread;
+        dmThread::Thread m_Threads[MAX_THREADS];
+        uint32_t m_ThreadCount;
         Request m_Request[QUEUE_SLOTS];
-        uint32_t m_Front, m_Back, m_Loaded;
+        uint32_t m_Front, m_Back, m_Loaded, m_Loading;
         uint64_t m_BytesWaiting;
         bool m_Shutdown;
 
         // Circular queue with indexing as follow (exclusive end)
         //
-        //          m_Back           m_Loaded   m_Front
-        // [N/A]   [loaded] [loaded] [to-load]  [N/A]
+        //          m_Back           m_Loaded                       m_Loading  m_Front
+        // [N/A]   [loaded] [loaded] [loading or loaded out of order] [to-load]  [N/A]
         //
     };
 
@@ -73,12 +89,93 @@ namespace dmLoadQueue
             return 0x0;
         }
 
-        if (queue->m_Loaded == queue->m_Front)
+        if (queue->m_Loading == queue->m_Front)
         {
             return 0x0;
         }
 
-        return &queue->m_Request[queue->m_Loaded % QUEUE_SLOTS];
+        return &queue->m_Request[(queue->m_Loading++) % QUEUE_SLOTS];
+    }
+
+    static void CreateResource(Queue* queue, Request* current, LoadResult* result)
+    {
+        DM_PROFILE(Resource, "CreateResource");
+
+        dmResource::SResourceDescriptor* resource = &result->m_Resource;
+        memset(resource, 0, sizeof(*resource));
+        resource->m_NameHash           = current->m_PreloadInfo.m_CanonicalPathHash;
+        resource->m_ReferenceCount     = 1;
+        resource->m_ResourceSizeOnDisc = current->m_DataSize;
+
+        dmResource::ResourceCreateParams params;
+        params.m_Factory        = queue->m_Factory;
+        params.m_Context        = current->m_PreloadInfo.m_Context;
+        params.m_PreloadData    = result->m_PreloadData;
+        params.m_Resource       = resource;
+        params.m_Filename       = current->m_Name;
+        params.m_Buffer         = current->m_Data;
+        params.m_BufferSize     = current->m_DataSize;
+        params.m_IsBufferMapped = result->m_IsBufferMapped;
+        result->m_CreateResult  = current->m_PreloadInfo.m_CreateFunction(params);
+    }
+
+    // Runs both load stages for a request without the queue mutex held
+    static void LoadRequest(Queue* queue, Request* current, LoadResult* result)
+    {
+        uint32_t size;
+
+        assert(current->m_Buffer.Size() == 0);
+        if (current->m_Buffer.Capacity() != DEFAULT_CAPACITY)
+        {
+            current->m_Buffer.SetCapacity(DEFAULT_CAPACITY);
+        }
+        result->m_LoadResult    = DoReadResource(queue->m_Factory, current->m_CanonicalPath, current->m_Name, &size, &current->m_Buffer, &current->m_Raw);
+        result->m_PreloadResult = dmResource::RESULT_PENDING;
+        result->m_PreloadData   = 0;
+        result->m_CreateResult  = dmResource::RESULT_PENDING;
+        result->m_IsBufferMapped = false;
+
+        if (result->m_LoadResult == dmResource::RESULT_OK && current->m_Raw.m_NeedsDecode)
+        {
+            result->m_LoadResult = DecodeResource(&current->m_Raw, &current->m_Buffer);
+        }
+
+        current->m_Data     = current->m_Buffer.Begin();
+        current->m_DataSize = current->m_Buffer.Size();
+        if (result->m_LoadResult == dmResource::RESULT_OK && current->m_Raw.m_MappedData)
+        {
+            current->m_Data          = current->m_Raw.m_MappedData;
+            current->m_DataSize      = size;
+            result->m_IsBufferMapped = true;
+        }
+
+        if (result->m_LoadResult == dmResource::RESULT_OK)
+        {
+            assert(current->m_DataSize == size);
+            if (current->m_PreloadInfo.m_Function)
+            {
+                dmResource::ResourcePreloadParams params;
+                params.m_Factory        = queue->m_Factory;
+                params.m_Context        = current->m_PreloadInfo.m_Context;
+                params.m_Filename       = current->m_Name;
+                params.m_Buffer         = current->m_Data;
+                params.m_BufferSize     = current->m_DataSize;
+                params.m_IsBufferMapped = result->m_IsBufferMapped;
+                params.m_HintInfo       = &current->m_PreloadInfo.m_HintInfo;
+                params.m_PreloadData    = &result->m_PreloadData;
+                result->m_PreloadResult = current->m_PreloadInfo.m_Function(params);
+            }
+            else
+            {
+                result->m_PreloadResult = dmResource::RESULT_OK;
+            }
+
+            // A resource that hinted others depends on them, and those must be created first
+            if (result->m_PreloadResult == dmResource::RESULT_OK && current->m_PreloadInfo.m_CreateFunction && current->m_PreloadInfo.m_HintInfo.m_HintCount == 0)
+            {
+                CreateResource(queue, current, result);
+            }
+        }
     }
 
     static void LoadThread(void* arg)
@@ -92,11 +189,17 @@ namespace dmLoadQueue
                 dmMutex::ScopedLock lk(queue->m_Mutex);
                 if (current != 0)
                 {
-                    // Just finished one (from previous iteratino)
+                    // Just finished one (from previous iteration)
                     queue->m_BytesWaiting += current->m_Buffer.Capacity();
-                    queue->m_Loaded++;
                     current->m_Result = result;
+                    current->m_Done   = true;
                     current           = 0;
+
+                    // Requests may finish out of order, only hand out the ones that have no unfinished requests before them
+                    while (queue->m_Loaded != queue->m_Loading && queue->m_Request[queue->m_Loaded % QUEUE_SLOTS].m_Done)
+                    {
+                        queue->m_Loaded++;
+                    }
                 }
                 if (queue->m_Shutdown)
                 {
@@ -110,13 +213,17 @@ namespace dmLoadQueue
                     for (uint32_t i = 0; i < QUEUE_SLOTS; ++i)
                     {
                         Request* r = &queue->m_Request[i];
-                        if (r->m_Buffer.Size() == 0)
+                        if (r->m_Name == 0x0)
                         {
+                            // Just free the memory here, no need to allocate while holding the mutex
                             if (r->m_Buffer.Capacity() > DEFAULT_CAPACITY)
                             {
-                                // Just free the memory here, no need to allocate while holding the mutex
                                 r->m_Buffer.SetCapacity(0);
                             }
+                            if (r->m_Raw.m_Data.Capacity() > DEFAULT_CAPACITY)
+                            {
+                                r->m_Raw.m_Data.SetCapacity(0);
+                            }
                         }
                     }
                     dmConditionVariable::Wait(queue->m_WakeupCond, queue->m_Mutex);
@@ -127,52 +234,31 @@ namespace dmLoadQueue
             if (current)
             {
                 // We use the temporary result object here to fill in the data so it can be written with the mutex held.
-                uint32_t size;
-
-                assert(current->m_Buffer.Size() == 0);
-                if (current->m_Buffer.Capacity() != DEFAULT_CAPACITY)
-                {
-                    current->m_Buffer.SetCapacity(DEFAULT_CAPACITY);
-                }
-                result.m_LoadResult    = DoLoadResource(queue->m_Factory, current->m_CanonicalPath, current->m_Name, &size, &current->m_Buffer);
-                result.m_PreloadResult = dmResource::RESULT_PENDING;
-                result.m_PreloadData   = 0;
-
-                if (result.m_LoadResult == dmResource::RESULT_OK)
-                {
-                    assert(current->m_Buffer.Size() == size);
-                    if (current->m_PreloadInfo.m_Function)
-                    {
-                        dmResource::ResourcePreloadParams params;
-                        params.m_Factory       = queue->m_Factory;
-                        params.m_Context       = current->m_PreloadInfo.m_Context;
-                        params.m_Buffer        = current->m_Buffer.Begin();
-                        params.m_BufferSize    = current->m_Buffer.Size();
-                        params.m_HintInfo      = &current->m_PreloadInfo.m_HintInfo;
-                        params.m_PreloadData   = &result.m_PreloadData;
-                        result.m_PreloadResult = current->m_PreloadInfo.m_Function(params);
-                    }
-                    else
-                    {
-                        result.m_PreloadResult = dmResource::RESULT_OK;
-                    }
-                }
+                LoadRequest(queue, current, &result);
             }
         }
     }
 
     HQueue CreateQueue(dmResource::HFactory factory)
     {
+        uint32_t thread_count = dmResource::GetLoadThreadCount(factory);
+        thread_count = thread_count < 1 ? 1 : (thread_count > MAX_THREADS ? MAX_THREADS : thread_count);
+
         Queue* q          = new Queue();
         q->m_Factory      = factory;
         q->m_Front        = 0;
         q->m_Back         = 0;
         q->m_Loaded       = 0;
+        q->m_Loading      = 0;
         q->m_Shutdown     = false;
         q->m_BytesWaiting = 0;
         q->m_Mutex        = dmMutex::New();
         q->m_WakeupCond   = dmConditionVariable::New();
-        q->m_Thread       = dmThread::New(&LoadThread, 65536, q, "AsyncLoad");
+        q->m_ThreadCount  = thread_count;
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            q->m_Threads[i] = dmThread::New(&LoadThread, 65536, q, "AsyncLoad");
+        }
 
         return q;
     }
@@ -182,10 +268,13 @@ namespace dmLoadQueue
         {
             dmMutex::ScopedLock lk(queue->m_Mutex);
             queue->m_Shutdown = true;
-            // Wake up the worker so it can exit and allow us to join
-            dmConditionVariable::Signal(queue->m_WakeupCond);
+            // Wake up the workers so they can exit and allow us to join
+            dmConditionVariable::Broadcast(queue->m_WakeupCond);
+        }
+        for (uint32_t i = 0; i < queue->m_ThreadCount; ++i)
+        {
+            dmThread::Join(queue->m_Threads[i]);
         }
-        dmThread::Join(queue->m_Thread);
         dmConditionVariable::Delete(queue->m_WakeupCond);
         dmMutex::Delete(queue->m_Mutex);
         delete queue;
@@ -204,15 +293,14 @@ namespace dmLoadQueue
         if ((queue->m_Front - queue->m_Back) == QUEUE_SLOTS)
             return 0;
 
-        if (queue->m_Loaded == queue->m_Front)
-        {
-            // The worker is sleeping waiting for request, wake it up
-            dmConditionVariable::Signal(queue->m_WakeupCond);
-        }
+        // Wake up a worker that is sleeping waiting for requests
+        dmConditionVariable::Signal(queue->m_WakeupCond);
 
-        Request* req         = &queue->m_Request[(queue->m_Front++) % QUEUE_SLOTS];
+        Request* req         = &queue->m_Request[queue->m_Front % QUEUE_SLOTS];
         req->m_Name          = name;
         req->m_CanonicalPath = canonical_path;
+        req->m_Index         = queue->m_Front++;
+        req->m_Done          = false;
 
         req->m_PreloadInfo         = *info;
         req->m_Result.m_LoadResult = dmResource::RESULT_PENDING;
@@ -223,11 +311,12 @@ namespace dmLoadQueue
     Result EndLoad(HQueue queue, HRequest request, void** buf, uint32_t* size, LoadResult* load_result)
     {
         dmMutex::ScopedLock lk(queue->m_Mutex);
-        if (request->m_Result.m_LoadResult == dmResource::RESULT_PENDING)
+        // Results are delivered in request order
+        if ((queue->m_Front - request->m_Index) <= (queue->m_Front - queue->m_Loaded))
             return RESULT_PENDING;
 
-        *buf         = request->m_Buffer.Begin();
-        *size        = request->m_Buffer.Size();
+        *buf         = (void*) request->m_Data;
+        *size        = request->m_DataSize;
         *load_result = request->m_Result;
 
         return RESULT_OK;
@@ -245,11 +334,11 @@ namespace dmLoadQueue
         uint32_t buffer_capacity = request->m_Buffer.Capacity();
         queue->m_BytesWaiting -= buffer_capacity;
         // If we either have blocked further processing by exceeding MAX_PENDING_DATA or
-        // the buffer has a non-default capacity, we want to wake up the worker
+        // the buffer has a non-default capacity, we want to wake up the workers
         if (buffer_capacity != DEFAULT_CAPACITY || (old_bytes_waiting >= MAX_PENDING_DATA && queue->m_BytesWaiting < MAX_PENDING_DATA))
         {
-            // Wake up thread, we can now fit a new request
-            dmConditionVariable::Signal(queue->m_WakeupCond);
+            // Wake up threads, we can now fit a new request
+            dmConditionVariable::Broadcast(queue->m_WakeupCond);
         }
 
         // Clean up picked up requests
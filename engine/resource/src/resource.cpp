@@ -131,6 +131,9 @@ struct SResourceFactory
     Manifest*                                    m_Manifest;
     void*                                        m_ArchiveMountInfo;
 
+    // Number of threads used by the asynchronous load queue
+    uint32_t                                     m_LoadThreadCount;
+
     uint8_t                                      m_UseLiveUpdate : 1;
 };
 
@@ -199,6 +202,8 @@ void SetDefaultNewFactoryParams(struct NewFactoryParams* params)
     params->m_ArchiveIndex.m_Size = 0;
     params->m_ArchiveData.m_Data = 0;
     params->m_ArchiveData.m_Size = 0;
+
+    params->m_LoadThreadCount = 2;
 }
 
 static void HttpHeader(dmHttpClient::HResponse response, void* user_data, int status_code, const char* key, const char* value)
@@ -456,6 +461,7 @@ HFactory NewFactory(NewFactoryParams* params, const char* uri)
     memset(factory, 0, sizeof(*factory));
     factory->m_Socket = socket;
     factory->m_UseLiveUpdate = params->m_Flags & RESOURCE_FACTORY_FLAGS_LIVE_UPDATE ? 1 : 0;
+    factory->m_LoadThreadCount = params->m_LoadThreadCount;
 
     dmURI::Result uri_result = dmURI::Parse(uri, &factory->m_UriParts);
     if (uri_result != dmURI::RESULT_OK)
@@ -750,6 +756,19 @@ Result RegisterType(HFactory factory,
                            FResourcePostCreate post_create_function,
                            FResourceDestroy destroy_function,
                            FResourceRecreate recreate_function)
+{
+    return RegisterType(factory, extension, context, preload_function, create_function, post_create_function, destroy_function, recreate_function, 0);
+}
+
+Result RegisterType(HFactory factory,
+                           const char* extension,
+                           void* context,
+                           FResourcePreload preload_function,
+                           FResourceCreate create_function,
+                           FResourcePostCreate post_create_function,
+                           FResourceDestroy destroy_function,
+                           FResourceRecreate recreate_function,
+                           uint32_t flags)
 {
     if (factory->m_ResourceTypesCount == MAX_RESOURCE_TYPES)
         return RESULT_OUT_OF_RESOURCES;
@@ -773,6 +792,7 @@ Result RegisterType(HFactory factory,
     resource_type.m_PostCreateFunction = post_create_function;
     resource_type.m_DestroyFunction = destroy_function;
     resource_type.m_RecreateFunction = recreate_function;
+    resource_type.m_Flags = flags;
 
     factory->m_ResourceTypes[factory->m_ResourceTypesCount++] = resource_type;
 
@@ -843,25 +863,63 @@ Result VerifyResourcesBundled(dmResourceArchive::HArchiveIndexContainer base_arc
     return VerifyResourcesBundled(entries, entry_count, hash_len, base_archive);
 }
 
-static Result LoadFromManifest(const Manifest* manifest, const char* path, uint32_t* resource_size, LoadBufferType* buffer)
+// If raw is set, decryption and decompression of the entry is left to DecodeResource when possible
+// If mapped_data is set, it receives a pointer into the memory mapped archive instead of the data being read when possible
+static Result LoadFromManifest(const Manifest* manifest, const char* path, uint32_t* resource_size, LoadBufferType* buffer, RawResource* raw, const void** mapped_data)
 {
-    dmhash_t path_hash = dmHashString64(path);
-
-    int index = FindEntryIndex(manifest, path_hash);
-    if (index < 0) {
-        return RESULT_RESOURCE_NOT_FOUND; // Path not in manifest
-    }
-
     dmLiveUpdateDDF::HashAlgorithm algorithm = manifest->m_DDFData->m_Header.m_ResourceHashAlgorithm;
     dmLiveUpdateDDF::ResourceEntry* entries = manifest->m_DDFData->m_Resources.m_Data;
     dmResourceArchive::EntryData ed;
     dmResourceArchive::HArchiveIndexContainer archive;
-    uint8_t* hash = entries[index].m_Hash.m_Data.m_Data;
+    uint8_t* hash = 0;
     uint32_t hash_len = dmResource::HashLength(algorithm);
-    dmResourceArchive::Result res = dmResourceArchive::FindEntry(manifest->m_ArchiveIndex, hash, hash_len, &archive, &ed);
+    dmResourceArchive::Result res;
+    {
+        // Path to archive entry lookup
+        DM_PROFILE(Resource, "FindEntry");
+        int index = FindEntryIndex(manifest, dmHashString64(path));
+        if (index < 0) {
+            return RESULT_RESOURCE_NOT_FOUND; // Path not in manifest
+        }
+
+        hash = entries[index].m_Hash.m_Data.m_Data;
+        res = dmResourceArchive::FindEntry(manifest->m_ArchiveIndex, hash, hash_len, &archive, &ed);
+    }
     if (res == dmResourceArchive::RESULT_OK)
     {
         uint32_t file_size = ed.m_ResourceSize;
+        if (mapped_data)
+        {
+            *mapped_data = dmResourceArchive::GetMappedEntryData(archive, &ed);
+            if (*mapped_data)
+            {
+                buffer->SetSize(0);
+                *resource_size = file_size;
+                return RESULT_OK;
+            }
+        }
+
+        if (raw && dmResourceArchive::IsEntryEncoded(&ed) && dmResourceArchive::HasDefaultReader(archive))
+        {
+            uint32_t raw_size = dmResourceArchive::GetRawEntrySize(&ed);
+            if (raw->m_Data.Capacity() < raw_size)
+            {
+                raw->m_Data.SetCapacity(raw_size);
+            }
+            raw->m_Data.SetSize(0);
+            if (dmResourceArchive::ReadRawEntryFromArchive(archive, &ed, raw->m_Data.Begin()) != dmResourceArchive::RESULT_OK)
+            {
+                return RESULT_IO_ERROR;
+            }
+            raw->m_Data.SetSize(raw_size);
+            raw->m_Entry = ed;
+            raw->m_NeedsDecode = true;
+
+            buffer->SetSize(0);
+            *resource_size = file_size;
+            return RESULT_OK;
+        }
+
         if (buffer->Capacity() < file_size)
         {
             buffer->SetCapacity(file_size);
@@ -889,12 +947,12 @@ static Result LoadFromManifest(const Manifest* manifest, const char* path, uint3
 }
 
 // Assumes m_LoadMutex is already held
-static Result DoLoadResourceLocked(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer)
+static Result DoLoadResourceLocked(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, RawResource* raw, const void** mapped_data)
 {
     DM_PROFILE(Resource, "LoadResource");
     if (factory->m_BuiltinsManifest)
     {
-        if (LoadFromManifest(factory->m_BuiltinsManifest, original_name, resource_size, buffer) == RESULT_OK)
+        if (LoadFromManifest(factory->m_BuiltinsManifest, original_name, resource_size, buffer, raw, mapped_data) == RESULT_OK)
         {
             return RESULT_OK;
         }
@@ -948,7 +1006,7 @@ static Result DoLoadResourceLocked(HFactory factory, const char* path, const cha
     }
     else if (factory->m_Manifest)
     {
-        Result r = LoadFromManifest(factory->m_Manifest, original_name, resource_size, buffer);
+        Result r = LoadFromManifest(factory->m_Manifest, original_name, resource_size, buffer, raw, mapped_data);
         return r;
     }
     else
@@ -997,24 +1055,70 @@ Result DoLoadResource(HFactory factory, const char* path, const char* original_n
 {
     // Called from async queue so we wrap around a lock
     dmMutex::ScopedLock lk(factory->m_LoadMutex);
-    return DoLoadResourceLocked(factory, path, original_name, resource_size, buffer);
+    return DoLoadResourceLocked(factory, path, original_name, resource_size, buffer, 0, 0);
+}
+
+// Takes the lock.
+Result DoReadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, RawResource* raw)
+{
+    raw->m_NeedsDecode = false;
+    raw->m_MappedData = 0;
+    dmMutex::ScopedLock lk(factory->m_LoadMutex);
+    return DoLoadResourceLocked(factory, path, original_name, resource_size, buffer, raw, &raw->m_MappedData);
+}
+
+Result DecodeResource(RawResource* raw, LoadBufferType* buffer)
+{
+    DM_PROFILE(Resource, "DecodeResource");
+    assert(raw->m_NeedsDecode);
+    raw->m_NeedsDecode = false;
+
+    uint32_t size = raw->m_Entry.m_ResourceSize;
+    if (buffer->Capacity() < size)
+    {
+        buffer->SetCapacity(size);
+    }
+    buffer->SetSize(0);
+
+    dmResourceArchive::Result r = dmResourceArchive::DecodeRawEntry(&raw->m_Entry, raw->m_Data.Begin(), buffer->Begin());
+    raw->m_Data.SetSize(0);
+    if (r != dmResourceArchive::RESULT_OK)
+    {
+        return RESULT_IO_ERROR;
+    }
+    buffer->SetSize(size);
+    return RESULT_OK;
+}
+
+uint32_t GetLoadThreadCount(HFactory factory)
+{
+    return factory->m_LoadThreadCount;
 }
 
 // Assumes m_LoadMutex is already held
-Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size)
+Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size, bool* is_mapped)
 {
     if (factory->m_Buffer.Capacity() != DEFAULT_BUFFER_SIZE) {
         factory->m_Buffer.SetCapacity(DEFAULT_BUFFER_SIZE);
     }
     factory->m_Buffer.SetSize(0);
-    Result r = DoLoadResourceLocked(factory, path, original_name, resource_size, &factory->m_Buffer);
+    const void* mapped_data = 0;
+    Result r = DoLoadResourceLocked(factory, path, original_name, resource_size, &factory->m_Buffer, 0, is_mapped ? &mapped_data : 0);
+    if (is_mapped)
+        *is_mapped = mapped_data != 0;
     if (r == RESULT_OK)
-        *buffer = factory->m_Buffer.Begin();
+        *buffer = mapped_data ? (void*) mapped_data : factory->m_Buffer.Begin();
     else
         *buffer = 0;
     return r;
 }
 
+// Assumes m_LoadMutex is already held
+Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size)
+{
+    return LoadResource(factory, path, original_name, buffer, resource_size, 0);
+}
+
 
 static const char* GetExtFromPath(const char* name, char* buffer, uint32_t buffersize)
 {
@@ -1076,7 +1180,8 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
 
         void *buffer;
         uint32_t file_size;
-        Result result = LoadResource(factory, canonical_path, name, &buffer, &file_size);
+        bool is_mapped;
+        Result result = LoadResource(factory, canonical_path, name, &buffer, &file_size, &is_mapped);
         if (result != RESULT_OK) {
             if (result == RESULT_RESOURCE_NOT_FOUND) {
                 dmLogWarning("Resource not found: %s", name);
@@ -1084,7 +1189,7 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
             return result;
         }
 
-        assert(buffer == factory->m_Buffer.Begin());
+        assert(is_mapped || buffer == factory->m_Buffer.Begin());
 
         // TODO: We should *NOT* allocate SResource dynamically...
         SResourceDescriptor tmp_resource;
@@ -1103,6 +1208,7 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
             params.m_Context = resource_type->m_Context;
             params.m_Buffer = buffer;
             params.m_BufferSize = file_size;
+            params.m_IsBufferMapped = is_mapped;
             params.m_PreloadData = &preload_data;
             params.m_Filename = name;
             params.m_HintInfo = 0; // No hinting now
@@ -1119,6 +1225,7 @@ static Result DoGet(HFactory factory, const char* name, void** resource)
             params.m_Context = resource_type->m_Context;
             params.m_Buffer = buffer;
             params.m_BufferSize = file_size;
+            params.m_IsBufferMapped = is_mapped;
             params.m_PreloadData = preload_data;
             params.m_Resource = &tmp_resource;
             params.m_Filename = name;
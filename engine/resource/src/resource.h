@@ -57,6 +57,14 @@ namespace dmResource
      */
     #define RESOURCE_FACTORY_FLAGS_LIVE_UPDATE    (1 << 3)
 
+    /**
+     * The create function of the resource type may be called from a loading thread.
+     * It must then not call into the factory (e.g. Get or Release) or use anything
+     * that is only safe to use from the main thread, such as the graphics context.
+     * Resources that hint other resources while preloading are always created on the main thread.
+     */
+    #define RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE (1 << 0)
+
     /**
      * Result
      */
@@ -162,6 +170,8 @@ namespace dmResource
         const void* m_Buffer;
         /// Size of data buffer
         uint32_t m_BufferSize;
+        /// True if m_Buffer is borrowed from a memory mapped archive, see ResourceCreateParams::m_IsBufferMapped
+        bool m_IsBufferMapped;
         /// Hinter info. Use this when calling PreloadHint
         HPreloadHintInfo m_HintInfo;
         /// Writable user data that will be passed on to ResourceCreate function
@@ -169,8 +179,9 @@ namespace dmResource
     };
 
     /**
-     * Resource preloading function. This may be called from a separate loading thread
-     * but will not keep any mutexes held while executing the call. During this call
+     * Resource preloading function. This may be called from one of several loading threads,
+     * concurrently with the preloading of other resources, but will not keep any mutexes held
+     * while executing the call. During this call
      * PreloadHint can be called with the supplied hint_info handle.
      * If RESULT_OK is returned, the resource Create function is guaranteed to be called
      * with the preload_data value supplied.
@@ -194,6 +205,10 @@ namespace dmResource
         const void* m_Buffer;
         /// Size of the data buffer
         uint32_t m_BufferSize;
+        /// True if m_Buffer is borrowed from a memory mapped archive. The data then stays valid until
+        /// the factory is deleted and may be referenced by the resource instead of being copied.
+        /// Otherwise the buffer is only valid during the call.
+        bool m_IsBufferMapped;
         /// Preloaded data from Preload phase
         void* m_PreloadData;
         /// Resource descriptor to fill in
@@ -358,7 +373,10 @@ namespace dmResource
         EmbeddedResource m_ArchiveData;
         EmbeddedResource m_ArchiveManifest;
 
-        uint32_t m_Reserved[5];
+        /// Number of threads used by the asynchronous load queue. Default is 2
+        uint32_t m_LoadThreadCount;
+
+        uint32_t m_Reserved[4];
 
         NewFactoryParams()
         {
@@ -407,6 +425,29 @@ namespace dmResource
                                FResourceDestroy destroy_function,
                                FResourceRecreate recreate_function);
 
+    /**
+     * Register a resource type with flags
+     * @param factory Factory handle
+     * @param extension File extension for resource
+     * @param context User context
+     * @param preload_function Preload function. Optional, 0 if no preloading is used
+     * @param create_function Create function pointer
+     * @param post_create_function Post create function pointer
+     * @param destroy_function Destroy function pointer
+     * @param recreate_function Recreate function pointer. Optional, 0 if recreate is not supported.
+     * @param flags Resource type flags, e.g. RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE
+     * @return RESULT_OK on success
+     */
+    Result RegisterType(HFactory factory,
+                               const char* extension,
+                               void* context,
+                               FResourcePreload preload_function,
+                               FResourceCreate create_function,
+                               FResourcePostCreate post_create_function,
+                               FResourceDestroy destroy_function,
+                               FResourceRecreate recreate_function,
+                               uint32_t flags);
+
     /**
      * Get a resource from factory
      * @param factory Factory handle
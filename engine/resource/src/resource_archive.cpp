@@ -301,6 +301,7 @@ namespace dmResourceArchive
         }
 
         aic->m_ArchiveFileIndex->m_FileResourceData = f_data; // game.arcd file handle
+        BuildEntryLookup(aic);
         *archive = aic;
 
         fclose(f_index);
@@ -344,46 +345,134 @@ namespace dmResourceArchive
         return RESULT_OK;
     }
 
-    Result FindEntryInArchive(HArchiveIndexContainer archive, const uint8_t* hash, uint32_t hash_len, EntryData* entry)
+    static void GetHashesAndEntries(HArchiveIndexContainer archive, uint8_t** hashes, EntryData** entries)
+    {
+        // If archive is loaded from file use the member arrays for hashes and entries, otherwise read with mem offsets.
+        if (!archive->m_IsMemMapped)
+        {
+            *hashes = archive->m_ArchiveFileIndex->m_Hashes;
+            *entries = archive->m_ArchiveFileIndex->m_Entries;
+        }
+        else
+        {
+            uint32_t entry_offset = dmEndian::ToNetwork(archive->m_ArchiveIndex->m_EntryDataOffset);
+            uint32_t hash_offset = dmEndian::ToNetwork(archive->m_ArchiveIndex->m_HashOffset);
+            *hashes = (uint8_t*)((uintptr_t)archive->m_ArchiveIndex + hash_offset);
+            *entries = (EntryData*)((uintptr_t)archive->m_ArchiveIndex + entry_offset);
+        }
+    }
+
+    // The hashes are digests, so the first bytes are already evenly distributed and used as is.
+    // The first word picks the slot, the second is kept in the slot to skip most of the full compares.
+    static const uint32_t ENTRY_LOOKUP_KEY_SIZE = 2 * sizeof(uint32_t);
+    static const uint32_t ENTRY_LOOKUP_EMPTY = 0xFFFFFFFF;
+
+    struct EntryLookupSlot
+    {
+        uint32_t m_Key;
+        uint32_t m_Index;
+    };
+
+    // Open addressing (linear probing) table from hash digest to entry index
+    struct EntryLookup
+    {
+        const ArchiveIndex* m_ArchiveIndex; // The index the table was built for
+        uint32_t            m_EntryCount;
+        uint32_t            m_Mask;
+        EntryLookupSlot*    m_Slots;
+    };
+
+    void DeleteEntryLookup(HArchiveIndexContainer archive)
+    {
+        if (archive->m_EntryLookup)
+        {
+            free(archive->m_EntryLookup->m_Slots);
+            delete archive->m_EntryLookup;
+            archive->m_EntryLookup = 0;
+        }
+    }
+
+    void BuildEntryLookup(HArchiveIndexContainer archive)
     {
+        DeleteEntryLookup(archive);
+
         uint32_t entry_count = dmEndian::ToNetwork(archive->m_ArchiveIndex->m_EntryDataCount);
-        uint32_t entry_offset = dmEndian::ToNetwork(archive->m_ArchiveIndex->m_EntryDataOffset);
-        uint32_t hash_offset = dmEndian::ToNetwork(archive->m_ArchiveIndex->m_HashOffset);
+        uint32_t hash_length = dmEndian::ToNetwork(archive->m_ArchiveIndex->m_HashLength);
+        if (entry_count == 0 || hash_length < ENTRY_LOOKUP_KEY_SIZE)
+        {
+            return;
+        }
+
         uint8_t* hashes = 0;
         EntryData* entries = 0;
+        GetHashesAndEntries(archive, &hashes, &entries);
 
-        // If archive is loaded from file use the member arrays for hashes and entries, otherwise read with mem offsets.
-        if (!archive->m_IsMemMapped)
+        // Keep the load factor at or below 0.5
+        uint32_t capacity = 16;
+        while (capacity < entry_count * 2)
         {
-            hashes = archive->m_ArchiveFileIndex->m_Hashes;
-            entries = archive->m_ArchiveFileIndex->m_Entries;
+            capacity <<= 1;
         }
-        else
+
+        EntryLookup* lookup = new EntryLookup;
+        lookup->m_ArchiveIndex = archive->m_ArchiveIndex;
+        lookup->m_EntryCount = entry_count;
+        lookup->m_Mask = capacity - 1;
+        lookup->m_Slots = (EntryLookupSlot*)malloc(capacity * sizeof(EntryLookupSlot));
+        memset(lookup->m_Slots, 0xFF, capacity * sizeof(EntryLookupSlot));
+
+        for (uint32_t i = 0; i < entry_count; ++i)
         {
-            hashes = (uint8_t*)((uintptr_t)archive->m_ArchiveIndex + hash_offset);
-            entries = (EntryData*)((uintptr_t)archive->m_ArchiveIndex + entry_offset);
+            uint32_t key[2];
+            memcpy(key, hashes + dmResourceArchive::MAX_HASH * i, sizeof(key));
+
+            uint32_t slot = key[0] & lookup->m_Mask;
+            while (lookup->m_Slots[slot].m_Index != ENTRY_LOOKUP_EMPTY)
+            {
+                slot = (slot + 1) & lookup->m_Mask;
+            }
+            lookup->m_Slots[slot].m_Key = key[1];
+            lookup->m_Slots[slot].m_Index = i;
+        }
+
+        archive->m_EntryLookup = lookup;
+    }
+
+    static int LookupEntryIndex(const EntryLookup* lookup, const uint8_t* hashes, const uint8_t* hash, uint32_t hash_len)
+    {
+        uint32_t key[2];
+        memcpy(key, hash, sizeof(key));
+
+        uint32_t slot = key[0] & lookup->m_Mask;
+        while (true)
+        {
+            const EntryLookupSlot* s = &lookup->m_Slots[slot];
+            if (s->m_Index == ENTRY_LOOKUP_EMPTY)
+            {
+                return -1;
+            }
+            if (s->m_Key == key[1] && memcmp(hash, hashes + dmResourceArchive::MAX_HASH * s->m_Index, hash_len) == 0)
+            {
+                return (int)s->m_Index;
+            }
+            slot = (slot + 1) & lookup->m_Mask;
         }
+    }
 
+    static int BinarySearchEntryIndex(const uint8_t* hashes, uint32_t entry_count, const uint8_t* hash, uint32_t hash_len)
+    {
         // Search for hash with binary search (entries are sorted on hash)
         int first = 0;
         int last = (int)entry_count-1;
         while (first <= last)
         {
             int mid = first + (last - first) / 2;
-            uint8_t* h = (hashes + dmResourceArchive::MAX_HASH * mid);
+            const uint8_t* h = (hashes + dmResourceArchive::MAX_HASH * mid);
 
             int cmp = memcmp(hash, h, hash_len);
             if (cmp == 0)
             {
-                if (entry != 0)
-                {
-                    EntryData* e = &entries[mid];
-                    entry->m_ResourceDataOffset = dmEndian::ToNetwork(e->m_ResourceDataOffset);
-                    entry->m_ResourceSize = dmEndian::ToNetwork(e->m_ResourceSize);
-                    entry->m_ResourceCompressedSize = dmEndian::ToNetwork(e->m_ResourceCompressedSize);
-                    entry->m_Flags = dmEndian::ToNetwork(e->m_Flags);
-                }
-                return RESULT_OK;
+                return mid;
             }
             else if (cmp > 0)
             {
@@ -394,8 +483,42 @@ namespace dmResourceArchive
                 last = mid-1;
             }
         }
+        return -1;
+    }
 
-        return RESULT_NOT_FOUND;
+    Result FindEntryInArchive(HArchiveIndexContainer archive, const uint8_t* hash, uint32_t hash_len, EntryData* entry)
+    {
+        uint32_t entry_count = dmEndian::ToNetwork(archive->m_ArchiveIndex->m_EntryDataCount);
+        uint8_t* hashes = 0;
+        EntryData* entries = 0;
+        GetHashesAndEntries(archive, &hashes, &entries);
+
+        // The table is skipped if the index has been modified in place since it was built (e.g. ShiftAndInsert)
+        const EntryLookup* lookup = archive->m_EntryLookup;
+        int index;
+        if (lookup && lookup->m_ArchiveIndex == archive->m_ArchiveIndex && lookup->m_EntryCount == entry_count && hash_len >= ENTRY_LOOKUP_KEY_SIZE)
+        {
+            index = LookupEntryIndex(lookup, hashes, hash, hash_len);
+        }
+        else
+        {
+            index = BinarySearchEntryIndex(hashes, entry_count, hash, hash_len);
+        }
+
+        if (index < 0)
+        {
+            return RESULT_NOT_FOUND;
+        }
+
+        if (entry != 0)
+        {
+            EntryData* e = &entries[index];
+            entry->m_ResourceDataOffset = dmEndian::ToNetwork(e->m_ResourceDataOffset);
+            entry->m_ResourceSize = dmEndian::ToNetwork(e->m_ResourceSize);
+            entry->m_ResourceCompressedSize = dmEndian::ToNetwork(e->m_ResourceCompressedSize);
+            entry->m_Flags = dmEndian::ToNetwork(e->m_Flags);
+        }
+        return RESULT_OK;
     }
 
     Result DecryptBuffer(void* buffer, uint32_t buffer_len)
@@ -528,6 +651,74 @@ namespace dmResourceArchive
         return RESULT_OK;
     }
 
+    bool HasDefaultReader(HArchiveIndexContainer archive)
+    {
+        return archive->m_Loader.m_Read == ReadEntryFromArchive;
+    }
+
+    bool IsEntryEncoded(const EntryData* entry)
+    {
+        return (entry->m_Flags & ENTRY_FLAG_ENCRYPTED) || entry->m_ResourceCompressedSize != 0xFFFFFFFF;
+    }
+
+    uint32_t GetRawEntrySize(const EntryData* entry)
+    {
+        return entry->m_ResourceCompressedSize != 0xFFFFFFFF ? entry->m_ResourceCompressedSize : entry->m_ResourceSize;
+    }
+
+    Result ReadRawEntryFromArchive(HArchiveIndexContainer archive, const EntryData* entry, void* raw_buffer)
+    {
+        uint32_t raw_size = GetRawEntrySize(entry);
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+        if (afi->m_IsMemMapped)
+        {
+            memcpy(raw_buffer, afi->m_ResourceData + entry->m_ResourceDataOffset, raw_size);
+            return RESULT_OK;
+        }
+
+        FILE* resource_file = afi->m_FileResourceData;
+        fseek(resource_file, entry->m_ResourceDataOffset, SEEK_SET);
+        if (fread(raw_buffer, 1, raw_size, resource_file) != raw_size)
+        {
+            return RESULT_IO_ERROR;
+        }
+        return RESULT_OK;
+    }
+
+    Result DecodeRawEntry(const EntryData* entry, void* raw_buffer, void* buffer)
+    {
+        uint32_t raw_size = GetRawEntrySize(entry);
+        if (entry->m_Flags & ENTRY_FLAG_ENCRYPTED)
+        {
+            Result r = DecryptBuffer(raw_buffer, raw_size);
+            if (r != RESULT_OK)
+            {
+                return r;
+            }
+        }
+
+        if (entry->m_ResourceCompressedSize != 0xFFFFFFFF)
+        {
+            return DecompressBuffer(raw_buffer, raw_size, buffer, entry->m_ResourceSize);
+        }
+
+        if (buffer != raw_buffer)
+        {
+            memcpy(buffer, raw_buffer, entry->m_ResourceSize);
+        }
+        return RESULT_OK;
+    }
+
+    const void* GetMappedEntryData(HArchiveIndexContainer archive, const EntryData* entry)
+    {
+        const ArchiveFileIndex* afi = archive->m_ArchiveFileIndex;
+        if (!HasDefaultReader(archive) || !afi->m_IsMemMapped || IsEntryEncoded(entry) || (entry->m_Flags & ENTRY_FLAG_LIVEUPDATE_DATA))
+        {
+            return 0;
+        }
+        return afi->m_ResourceData + entry->m_ResourceDataOffset;
+    }
+
     void RegisterDefaultArchiveLoader()
     {
         dmResourceArchive::ArchiveLoader loader;
@@ -567,6 +758,8 @@ namespace dmResourceArchive
         (*archive)->m_ArchiveIndex = a;
         (*archive)->m_ArchiveIndexSize = index_buffer_size;
 
+        BuildEntryLookup(*archive);
+
         return RESULT_OK;
     }
 
@@ -588,6 +781,7 @@ namespace dmResourceArchive
 
     void Delete(HArchiveIndexContainer &archive)
     {
+        DeleteEntryLookup(archive);
         DeleteArchiveFileIndex(archive->m_ArchiveFileIndex);
 
         if (!archive->m_IsMemMapped)
@@ -980,6 +1174,8 @@ namespace dmResourceArchive
         // Since we store data sequentially when doing the deep-copy we want to access it in that fashion
         archive_container->m_IsMemMapped = mem_mapped;
 
+        BuildEntryLookup(archive_container);
+
     }
 
     uint32_t GetEntryCount(HArchiveIndexContainer archive)
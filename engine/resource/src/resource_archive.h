@@ -121,6 +121,8 @@ namespace dmResourceArchive
         bool        m_IsMemMapped;      // Is the data memory mapped?
     };
 
+    struct EntryLookup;
+
     struct ArchiveIndexContainer
     {
         ArchiveIndexContainer()
@@ -135,6 +137,7 @@ namespace dmResourceArchive
 
         ArchiveLoader       m_Loader;
         void*               m_UserData;         // private to the loader
+        EntryLookup*        m_EntryLookup;      // hash table used by FindEntryInArchive, built when the archive is mounted
 
         uint32_t m_ArchiveIndexSize;            // kept for unmapping
         uint8_t  m_IsMemMapped:1; // if the m_ArchiveIndex is memory mapped
@@ -213,6 +216,28 @@ namespace dmResourceArchive
     // Reads an entry from a single archive
     Result ReadEntryFromArchive(HArchiveIndexContainer archive, const uint8_t* hash, uint32_t hash_len, const EntryData* entry, void* buffer);
 
+    // Reading an entry can also be split in two steps. ReadRawEntryFromArchive does the I/O and must be
+    // serialized with other reads from the same archive, while DecodeRawEntry may run on any thread.
+    // Only valid for archives where ReadEntryFromArchive is the reader (see HasDefaultReader)
+    bool HasDefaultReader(HArchiveIndexContainer archive);
+
+    // True if the entry is encrypted and/or compressed in the archive
+    bool IsEntryEncoded(const EntryData* entry);
+
+    // The size of the entry data as it is stored in the archive
+    uint32_t GetRawEntrySize(const EntryData* entry);
+
+    // Reads the stored entry data into raw_buffer, which must hold GetRawEntrySize() bytes
+    Result ReadRawEntryFromArchive(HArchiveIndexContainer archive, const EntryData* entry, void* raw_buffer);
+
+    // Decrypts raw_buffer in place and decompresses it into buffer, which must hold entry->m_ResourceSize bytes
+    Result DecodeRawEntry(const EntryData* entry, void* raw_buffer, void* buffer);
+
+    // Returns a pointer to the entry data in the memory mapped archive, or 0 if the entry must be read into a buffer.
+    // Only entries that are neither compressed nor encrypted qualify. Live update data is excluded since that
+    // archive is remapped when resources are added to it. The data stays valid until the archive is unloaded.
+    const void* GetMappedEntryData(HArchiveIndexContainer archive, const EntryData* entry);
+
     // Calls each loader in sequence
 
     /*# Loads the archives, calling each registered loader in sequence
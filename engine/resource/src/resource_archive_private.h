@@ -64,5 +64,14 @@ namespace dmResourceArchive
 
     void Delete(ArchiveIndex* archive);
 
+    /**
+     * (Re)builds the hash table FindEntryInArchive uses instead of the binary search.
+     * Called when the archive is mounted or gets a new index. Exposed for unit tests.
+     */
+    void BuildEntryLookup(HArchiveIndexContainer archive);
+
+    // Removes the hash table, FindEntryInArchive falls back to the binary search. Exposed for unit tests.
+    void DeleteEntryLookup(HArchiveIndexContainer archive);
+
 }
 #endif // RESOURCE_ARCHIVE_PRIVATE_H
\ No newline at end of file
@@ -100,6 +100,8 @@ namespace dmResource
         // Set for items that are pending and waiting for children to complete
         void* m_Buffer;
         uint32_t m_BufferSize;
+        // m_Buffer points into a memory mapped archive and is not owned by the preloader
+        bool m_IsBufferMapped;
 
         // Set once preload function has run
         void* m_PreloadData;
@@ -506,12 +508,14 @@ namespace dmResource
         return NewPreloader(factory, names);
     }
 
+    static void InsertCreatedResource(HPreloader preloader, PreloadRequest* req, SResourceDescriptor* created_resource);
+
     // CreateResource operation ends either with
     //   1) Having created the resource and free:d all buffers => RESULT_OK + m_Resource
     //   2) Having failed, (or created and destroyed), leaving => RESULT_SOME_ERROR + everything free:d
     //
     // If buffer is null it means to use the items internal buffer
-    static void CreateResource(HPreloader preloader, PreloadRequest* req, void* buffer, uint32_t buffer_size)
+    static void CreateResource(HPreloader preloader, PreloadRequest* req, void* buffer, uint32_t buffer_size, bool is_buffer_mapped)
     {
         assert(req->m_LoadResult == RESULT_PENDING);
         assert(req->m_PendingChildCount == 0);
@@ -541,9 +545,13 @@ namespace dmResource
             tmp_resource.m_ResourceSizeOnDisc = req->m_BufferSize;
             params.m_Buffer                   = req->m_Buffer;
             params.m_BufferSize               = req->m_BufferSize;
+            params.m_IsBufferMapped           = req->m_IsBufferMapped;
             req->m_LoadResult                 = resource_type->m_CreateFunction(params);
 
-            dmBlockAllocator::Free(preloader->m_BlockAllocator, req->m_Buffer, req->m_BufferSize);
+            if (!req->m_IsBufferMapped)
+            {
+                dmBlockAllocator::Free(preloader->m_BlockAllocator, req->m_Buffer, req->m_BufferSize);
+            }
 
             req->m_Buffer = 0;
         }
@@ -552,9 +560,20 @@ namespace dmResource
             tmp_resource.m_ResourceSizeOnDisc = buffer_size;
             params.m_Buffer                   = buffer;
             params.m_BufferSize               = buffer_size;
+            params.m_IsBufferMapped           = is_buffer_mapped;
             req->m_LoadResult                 = resource_type->m_CreateFunction(params);
         }
 
+        InsertCreatedResource(preloader, req, &tmp_resource);
+    }
+
+    // Second half of CreateResource, once the create function has been called and req->m_LoadResult holds its result.
+    // Also used for resources created by the load queue.
+    static void InsertCreatedResource(HPreloader preloader, PreloadRequest* req, SResourceDescriptor* created_resource)
+    {
+        SResourceType* resource_type = req->m_PathDescriptor.m_ResourceType;
+        SResourceDescriptor& tmp_resource = *created_resource;
+
         if (req->m_LoadResult == RESULT_OK)
         {
             if (resource_type->m_PostCreateFunction)
@@ -680,7 +699,7 @@ namespace dmResource
         {
             return false;
         }
-        CreateResource(preloader, parent_req, 0, 0);
+        CreateResource(preloader, parent_req, 0, 0, false);
         UnmarkPathInProgress(preloader, &parent_req->m_PathDescriptor);
         PreloaderTryPruneParent(preloader, parent_req);
         return true;
@@ -722,10 +741,30 @@ namespace dmResource
         {
             if (req->m_LoadResult == RESULT_PENDING)
             {
-                // Create the resource using the loading buffer directly.
-                CreateResource(preloader, req, buffer, buffer_size);
+                if (load_result.m_CreateResult != RESULT_PENDING)
+                {
+                    // Already created by the load queue, only the insertion remains
+                    SResourceDescriptor tmp_resource = load_result.m_Resource;
+                    tmp_resource.m_ResourceType      = (void*)req->m_PathDescriptor.m_ResourceType;
+                    req->m_LoadResult                = load_result.m_CreateResult;
+                    InsertCreatedResource(preloader, req, &tmp_resource);
+                }
+                else
+                {
+                    // Create the resource using the loading buffer directly.
+                    CreateResource(preloader, req, buffer, buffer_size, load_result.m_IsBufferMapped);
+                }
                 created_resource = true;
             }
+            else if (load_result.m_CreateResult == RESULT_OK)
+            {
+                // Created by the load queue but no longer wanted
+                ResourceDestroyParams params;
+                params.m_Factory  = preloader->m_Factory;
+                params.m_Context  = req->m_PathDescriptor.m_ResourceType->m_Context;
+                params.m_Resource = &load_result.m_Resource;
+                req->m_PathDescriptor.m_ResourceType->m_DestroyFunction(params);
+            }
             UnmarkPathInProgress(preloader, &req->m_PathDescriptor);
             dmLoadQueue::FreeLoad(preloader->m_LoadQueue, req->m_LoadRequest);
             req->m_LoadRequest = 0;
@@ -734,9 +773,17 @@ namespace dmResource
         }
         else
         {
-            // Keep the loaded bytes until we have loaded all children
-            req->m_Buffer = dmBlockAllocator::Allocate(preloader->m_BlockAllocator, buffer_size);
-            memcpy(req->m_Buffer, buffer, buffer_size);
+            // Keep the loaded bytes until we have loaded all children. Mapped data stays valid and need not be copied.
+            req->m_IsBufferMapped = load_result.m_IsBufferMapped;
+            if (req->m_IsBufferMapped)
+            {
+                req->m_Buffer = buffer;
+            }
+            else
+            {
+                req->m_Buffer = dmBlockAllocator::Allocate(preloader->m_BlockAllocator, buffer_size);
+                memcpy(req->m_Buffer, buffer, buffer_size);
+            }
             req->m_BufferSize = buffer_size;
             dmLoadQueue::FreeLoad(preloader->m_LoadQueue, req->m_LoadRequest);
             req->m_LoadRequest = 0;
@@ -854,11 +901,21 @@ namespace dmResource
             return false;
         }
 
+        SResourceType* resource_type = req->m_PathDescriptor.m_ResourceType;
+
         dmLoadQueue::PreloadInfo info;
         info.m_HintInfo.m_Preloader = preloader;
         info.m_HintInfo.m_Parent    = index;
-        info.m_Function             = req->m_PathDescriptor.m_ResourceType->m_PreloadFunction;
-        info.m_Context              = req->m_PathDescriptor.m_ResourceType->m_Context;
+        info.m_HintInfo.m_HintCount = 0;
+        info.m_Function             = resource_type->m_PreloadFunction;
+        info.m_Context              = resource_type->m_Context;
+        info.m_CanonicalPathHash    = req->m_PathDescriptor.m_CanonicalPathHash;
+        // Resources that already have children (e.g. the root of a preloader with several names) wait for them to be created
+        info.m_CreateFunction       = 0;
+        if ((resource_type->m_Flags & RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE) && req->m_FirstChild == -1)
+        {
+            info.m_CreateFunction = resource_type->m_CreateFunction;
+        }
 
         // If we can't add the request to the load queue it is because the queue is full
         // We will try again once we completed loading of an item via dmLoadQueue::EndLoad
@@ -1052,6 +1109,8 @@ namespace dmResource
         if (!info || !name)
             return false;
 
+        info->m_HintCount++;
+
         HPreloader preloader = info->m_Preloader;
 
         PathDescriptor path_descriptor;
@@ -40,6 +40,7 @@ namespace dmResource
         FResourcePostCreate m_PostCreateFunction;
         FResourceDestroy    m_DestroyFunction;
         FResourceRecreate   m_RecreateFunction;
+        uint32_t            m_Flags;
     };
 
     typedef dmArray<char> LoadBufferType;
@@ -50,9 +51,30 @@ namespace dmResource
 
     // load with default internal buffer and its management, returns buffer ptr in 'buffer'
     Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size);
+    // as above, but 'buffer' may point straight into a memory mapped archive instead, in which case is_mapped is set
+    Result LoadResource(HFactory factory, const char* path, const char* original_name, void** buffer, uint32_t* resource_size, bool* is_mapped);
     // load with own buffer
     Result DoLoadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer);
 
+    // Archive entry data that is still encrypted and/or compressed
+    struct RawResource
+    {
+        LoadBufferType               m_Data;
+        dmResourceArchive::EntryData m_Entry;
+        // Points into the memory mapped archive when the entry can be used as is
+        const void*                  m_MappedData;
+        bool                         m_NeedsDecode;
+    };
+
+    // I/O part of DoLoadResource. If the resource is read from an archive entry that needs decoding, the stored data is
+    // put in raw and raw->m_NeedsDecode is set. If the entry can be used straight from the memory mapped archive, nothing
+    // is read and raw->m_MappedData is set. Otherwise it behaves exactly like DoLoadResource. Takes the load lock.
+    Result DoReadResource(HFactory factory, const char* path, const char* original_name, uint32_t* resource_size, LoadBufferType* buffer, RawResource* raw);
+    // Decrypts and decompresses the data read by DoReadResource into buffer. Thread safe, does not take the load lock.
+    Result DecodeResource(RawResource* raw, LoadBufferType* buffer);
+
+    uint32_t GetLoadThreadCount(HFactory factory);
+
     Result InsertResource(HFactory factory, const char* path, uint64_t canonical_path_hash, SResourceDescriptor* descriptor);
     uint32_t GetCanonicalPath(const char* relative_dir, char* buf);
     uint32_t GetCanonicalPathFromBase(const char* base_dir, const char* relative_dir, char* buf);
@@ -89,6 +111,8 @@ namespace dmResource
     {
         HPreloader m_Preloader;
         int32_t m_Parent;
+        // Number of PreloadHint calls made during the preload
+        uint32_t m_HintCount;
     };
 }
 
@@ -12,6 +12,7 @@
 
 #include <dlib/log.h>
 
+#include <dlib/atomic.h>
 #include <dlib/dstrings.h>
 #include <dlib/hash.h>
 #include <dlib/log.h>
@@ -974,6 +975,201 @@ TEST(dmResource, Builtins)
     dmResource::DeleteFactory(factory);
 }
 
+struct MappedCreateInfo
+{
+    const void* m_Buffer;
+    bool        m_IsBufferMapped;
+};
+
+static MappedCreateInfo g_MappedCreateInfo;
+
+dmResource::Result AdMappedResourceCreate(const dmResource::ResourceCreateParams& params)
+{
+    g_MappedCreateInfo.m_Buffer = params.m_Buffer;
+    g_MappedCreateInfo.m_IsBufferMapped = params.m_IsBufferMapped;
+    return AdResourceCreate(params);
+}
+
+TEST(dmResource, BuiltinsMapped)
+{
+    dmResource::NewFactoryParams params;
+    params.m_MaxResources = 16;
+
+    params.m_ArchiveIndex.m_Data    = (const void*) RESOURCES_ARCI;
+    params.m_ArchiveIndex.m_Size    = RESOURCES_ARCI_SIZE;
+
+    params.m_ArchiveData.m_Data     = (const void*) RESOURCES_ARCD;
+    params.m_ArchiveData.m_Size     = RESOURCES_ARCD_SIZE;
+
+    params.m_ArchiveManifest.m_Data = (const void*) RESOURCES_DMANIFEST;
+    params.m_ArchiveManifest.m_Size = RESOURCES_DMANIFEST_SIZE;
+
+    dmResource::HFactory factory = dmResource::NewFactory(&params, ".");
+    ASSERT_NE((void*) 0, factory);
+
+    dmResource::RegisterType(factory, "adc", 0, 0, AdMappedResourceCreate, 0, AdResourceDestroy, 0);
+
+    const uint8_t* data_begin = RESOURCES_ARCD;
+    const uint8_t* data_end = RESOURCES_ARCD + RESOURCES_ARCD_SIZE;
+
+    // The builtins archive is uncompressed and wrapped in memory, so the entries are passed without a copy
+    memset(&g_MappedCreateInfo, 0, sizeof(g_MappedCreateInfo));
+    void* resource;
+    dmResource::Result result = dmResource::Get(factory, "/archive_data/file1.adc", &resource);
+    ASSERT_EQ(dmResource::RESULT_OK, result);
+    ASSERT_STREQ("file1_datafile1_datafile1_data", (const char*) resource);
+    ASSERT_TRUE(g_MappedCreateInfo.m_IsBufferMapped);
+    ASSERT_GE((const uint8_t*) g_MappedCreateInfo.m_Buffer, data_begin);
+    ASSERT_LT((const uint8_t*) g_MappedCreateInfo.m_Buffer, data_end);
+    dmResource::Release(factory, resource);
+
+    // Same thing through the preloader
+    memset(&g_MappedCreateInfo, 0, sizeof(g_MappedCreateInfo));
+    dmResource::HPreloader pr = dmResource::NewPreloader(factory, "/archive_data/file2.adc");
+    for (uint32_t i = 0; i < 33; ++i)
+    {
+        result = dmResource::UpdatePreloader(pr, 0, 0, 30*1000);
+        if (result != dmResource::RESULT_PENDING)
+            break;
+        dmTime::Sleep(30000);
+    }
+    ASSERT_EQ(dmResource::RESULT_OK, result);
+    ASSERT_TRUE(g_MappedCreateInfo.m_IsBufferMapped);
+    ASSERT_GE((const uint8_t*) g_MappedCreateInfo.m_Buffer, data_begin);
+    ASSERT_LT((const uint8_t*) g_MappedCreateInfo.m_Buffer, data_end);
+
+    result = dmResource::Get(factory, "/archive_data/file2.adc", &resource);
+    ASSERT_EQ(dmResource::RESULT_OK, result);
+    ASSERT_STREQ("file2_datafile2_datafile2_data", (const char*) resource);
+    dmResource::Release(factory, resource);
+
+    dmResource::DeletePreloader(pr);
+    dmResource::DeleteFactory(factory);
+}
+
+// Must match the files generated for resources_large in the wscript
+static const uint32_t LARGE_ARCHIVE_FILE_COUNT = 512;
+
+static uint32_t LargeArchiveFileSize(uint32_t index)
+{
+    return 1024 + (index * 7919) % (64 * 1024);
+}
+
+TEST(dmResource, BenchLoadLargeArchive)
+{
+    char names[LARGE_ARCHIVE_FILE_COUNT][64];
+    dmArray<const char*> resource_names;
+    resource_names.SetCapacity(LARGE_ARCHIVE_FILE_COUNT);
+    for (uint32_t i = 0; i < LARGE_ARCHIVE_FILE_COUNT; ++i)
+    {
+        dmSnPrintf(names[i], sizeof(names[i]), "/archive_data/large_%04u.adc", i);
+        resource_names.Push(names[i]);
+    }
+
+    const uint32_t thread_counts[] = {1, 2, 4};
+    for (uint32_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); ++t)
+    {
+        dmResource::NewFactoryParams params;
+        params.m_MaxResources = LARGE_ARCHIVE_FILE_COUNT + 16;
+        params.m_LoadThreadCount = thread_counts[t];
+
+        dmResourceArchive::ClearArchiveLoaders();
+        dmResourceArchive::RegisterDefaultArchiveLoader();
+        dmResource::HFactory factory = dmResource::NewFactory(&params, "dmanif:build/default/src/test/resources_large.dmanifest");
+        ASSERT_NE((void*) 0, factory);
+        dmResource::RegisterType(factory, "adc", 0, 0, AdResourceCreate, 0, AdResourceDestroy, 0);
+
+        uint64_t start = dmTime::GetTime();
+        dmResource::HPreloader pr = dmResource::NewPreloader(factory, resource_names);
+        dmResource::Result r;
+        do
+        {
+            r = dmResource::UpdatePreloader(pr, 0, 0, 10*1000);
+        } while (r == dmResource::RESULT_PENDING);
+        uint64_t end = dmTime::GetTime();
+        ASSERT_EQ(dmResource::RESULT_OK, r);
+
+        for (uint32_t i = 0; i < LARGE_ARCHIVE_FILE_COUNT; ++i)
+        {
+            const char* resource = 0;
+            ASSERT_EQ(dmResource::RESULT_OK, dmResource::Get(factory, names[i], (void**) &resource));
+            ASSERT_EQ(LargeArchiveFileSize(i), (uint32_t) strlen(resource));
+            char header[16];
+            dmSnPrintf(header, sizeof(header), "large_%04u\n", i);
+            ASSERT_EQ(0, strncmp(header, resource, strlen(header)));
+            dmResource::Release(factory, (void*) resource);
+        }
+
+        dmResource::DeletePreloader(pr);
+        dmResource::DeleteFactory(factory);
+
+        printf("Bench elapsed: %u load threads, %u resources: %.2f ms\n", thread_counts[t], LARGE_ARCHIVE_FILE_COUNT, (end - start) / 1000.0);
+    }
+}
+
+static dmThread::TlsKey g_MainThreadKey;
+static int32_atomic_t   g_LoadThreadCreateCount = 0;
+
+dmResource::Result ThreadSafeAdResourceCreate(const dmResource::ResourceCreateParams& params)
+{
+    if (dmThread::GetTlsValue(g_MainThreadKey) == 0)
+    {
+        dmAtomicIncrement32(&g_LoadThreadCreateCount);
+    }
+    return AdResourceCreate(params);
+}
+
+TEST(dmResource, ThreadSafeCreate)
+{
+    char names[LARGE_ARCHIVE_FILE_COUNT][64];
+    dmArray<const char*> resource_names;
+    resource_names.SetCapacity(LARGE_ARCHIVE_FILE_COUNT);
+    for (uint32_t i = 0; i < LARGE_ARCHIVE_FILE_COUNT; ++i)
+    {
+        dmSnPrintf(names[i], sizeof(names[i]), "/archive_data/large_%04u.adc", i);
+        resource_names.Push(names[i]);
+    }
+
+    g_MainThreadKey = dmThread::AllocTls();
+    dmThread::SetTlsValue(g_MainThreadKey, (void*) 1);
+    g_LoadThreadCreateCount = 0;
+
+    dmResource::NewFactoryParams params;
+    params.m_MaxResources = LARGE_ARCHIVE_FILE_COUNT + 16;
+
+    dmResourceArchive::ClearArchiveLoaders();
+    dmResourceArchive::RegisterDefaultArchiveLoader();
+    dmResource::HFactory factory = dmResource::NewFactory(&params, "dmanif:build/default/src/test/resources_large.dmanifest");
+    ASSERT_NE((void*) 0, factory);
+    dmResource::Result e = dmResource::RegisterType(factory, "adc", 0, 0, ThreadSafeAdResourceCreate, 0, AdResourceDestroy, 0, RESOURCE_TYPE_FLAGS_THREAD_SAFE_CREATE);
+    ASSERT_EQ(dmResource::RESULT_OK, e);
+
+    dmResource::HPreloader pr = dmResource::NewPreloader(factory, resource_names);
+    dmResource::Result r;
+    do
+    {
+        r = dmResource::UpdatePreloader(pr, 0, 0, 10*1000);
+    } while (r == dmResource::RESULT_PENDING);
+    ASSERT_EQ(dmResource::RESULT_OK, r);
+
+#if !defined(__EMSCRIPTEN__)
+    // None of the files hint other resources, so all of them are created on the loading threads
+    ASSERT_EQ((int32_t) LARGE_ARCHIVE_FILE_COUNT, g_LoadThreadCreateCount);
+#endif
+
+    for (uint32_t i = 0; i < LARGE_ARCHIVE_FILE_COUNT; ++i)
+    {
+        dmResource::SResourceDescriptor descriptor;
+        ASSERT_EQ(dmResource::RESULT_OK, dmResource::GetDescriptor(factory, names[i], &descriptor));
+        ASSERT_EQ(1u, descriptor.m_ReferenceCount);
+        ASSERT_EQ(LargeArchiveFileSize(i), (uint32_t) strlen((const char*) descriptor.m_Resource));
+    }
+
+    dmResource::DeletePreloader(pr);
+    dmResource::DeleteFactory(factory);
+    dmThread::FreeTls(g_MainThreadKey);
+}
+
 struct ReloadData {
     ReloadData(): m_Old(0), m_New(0) {}
     int m_Old;
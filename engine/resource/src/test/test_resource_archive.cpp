@@ -15,6 +15,7 @@
 #include "../resource_archive_private.h"
 #include <dlib/dstrings.h>
 #include <dlib/endian.h>
+#include <dlib/time.h>
 
 // TODO: replace with dmEndian
 #if defined(_WIN32)
@@ -841,6 +842,187 @@ TEST(dmResourceArchive, LoadFromDisk_Compressed)
     dmResourceArchive::Delete(archive);
 }
 
+TEST(dmResourceArchive, LoadFromDisk_CompressedRawRead)
+{
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    const char* archive_path = MOUNTFS "build/default/src/test/resources_compressed.arci";
+    const char* resource_path = MOUNTFS "build/default/src/test/resources_compressed.arcd";
+    dmResourceArchive::Result result = dmResourceArchive::LoadArchiveFromFile(archive_path, resource_path, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+    dmResourceArchive::SetDefaultReader(archive);
+
+    dmResourceArchive::HArchiveIndexContainer entryarchive;
+    dmResourceArchive::EntryData entry;
+    for (uint32_t i = 0; i < sizeof(path_name)/sizeof(path_name[0]); ++i)
+    {
+        if (IsLiveUpdateResource(path_hash[i])) continue;
+
+        result = dmResourceArchive::FindEntry(archive, compressed_content_hash[i], sizeof(compressed_content_hash[i]), &entryarchive, &entry);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        ASSERT_TRUE(dmResourceArchive::HasDefaultReader(entryarchive));
+
+        // Read the stored data, then decode it as a separate step
+        char raw_buffer[1024] = { 0 };
+        char buffer[1024] = { 0 };
+        ASSERT_GE(sizeof(raw_buffer), dmResourceArchive::GetRawEntrySize(&entry));
+        result = dmResourceArchive::ReadRawEntryFromArchive(entryarchive, &entry, raw_buffer);
+        ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+
+        if (dmResourceArchive::IsEntryEncoded(&entry))
+        {
+            result = dmResourceArchive::DecodeRawEntry(&entry, raw_buffer, buffer);
+            ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+        }
+        else
+        {
+            memcpy(buffer, raw_buffer, entry.m_ResourceSize);
+        }
+
+        ASSERT_EQ(strlen(content[i]), strlen(buffer));
+        ASSERT_STREQ(content[i], buffer);
+    }
+
+    dmResourceArchive::Delete(archive);
+}
+
+static int CompareSyntheticHash(const void* a, const void* b)
+{
+    return memcmp(a, b, 20);
+}
+
+// Creates an archive index with entry_count random (sorted) sha1 sized hashes, where entry i has resource offset i
+static uint8_t* NewSyntheticArchiveIndex(uint32_t entry_count, uint32_t seed, uint32_t* out_size)
+{
+    const uint32_t hash_len = 20;
+    uint32_t hashes_size = entry_count * dmResourceArchive::MAX_HASH;
+    uint32_t size = sizeof(dmResourceArchive::ArchiveIndex) + hashes_size + entry_count * sizeof(dmResourceArchive::EntryData);
+    uint8_t* buffer = new uint8_t[size];
+    memset(buffer, 0, size);
+
+    dmResourceArchive::ArchiveIndex header;
+    header.m_Version = dmEndian::ToHost(dmResourceArchive::VERSION);
+    header.m_EntryDataCount = dmEndian::ToHost(entry_count);
+    header.m_HashOffset = dmEndian::ToHost((uint32_t)sizeof(dmResourceArchive::ArchiveIndex));
+    header.m_EntryDataOffset = dmEndian::ToHost((uint32_t)(sizeof(dmResourceArchive::ArchiveIndex) + hashes_size));
+    header.m_HashLength = dmEndian::ToHost(hash_len);
+    memcpy(buffer, &header, sizeof(header));
+
+    uint8_t* hashes = buffer + sizeof(dmResourceArchive::ArchiveIndex);
+    uint32_t state = seed;
+    for (uint32_t i = 0; i < entry_count; ++i)
+    {
+        uint8_t* h = hashes + i * dmResourceArchive::MAX_HASH;
+        for (uint32_t j = 0; j < hash_len; ++j)
+        {
+            state = state * 1664525 + 1013904223;
+            h[j] = (uint8_t)(state >> 24);
+        }
+    }
+    qsort(hashes, entry_count, dmResourceArchive::MAX_HASH, CompareSyntheticHash);
+
+    dmResourceArchive::EntryData* entries = (dmResourceArchive::EntryData*)(hashes + hashes_size);
+    for (uint32_t i = 0; i < entry_count; ++i)
+    {
+        entries[i].m_ResourceDataOffset = dmEndian::ToHost(i);
+        entries[i].m_ResourceCompressedSize = dmEndian::ToHost(0xFFFFFFFF);
+    }
+
+    *out_size = size;
+    return buffer;
+}
+
+static const uint8_t* GetSyntheticHash(const uint8_t* index_buffer, uint32_t i)
+{
+    return index_buffer + sizeof(dmResourceArchive::ArchiveIndex) + i * dmResourceArchive::MAX_HASH;
+}
+
+TEST(dmResourceArchive, EntryLookup)
+{
+    const uint32_t entry_count = 5000;
+    uint32_t size;
+    uint8_t* index_buffer = NewSyntheticArchiveIndex(entry_count, 1, &size);
+
+    dmResourceArchive::HArchiveIndexContainer archive = 0;
+    dmResourceArchive::Result result = dmResourceArchive::WrapArchiveBuffer(index_buffer, size, true, RESOURCES_ARCD, RESOURCES_ARCD_SIZE, true, &archive);
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+    dmResourceArchive::SetDefaultReader(archive);
+    ASSERT_NE((dmResourceArchive::EntryLookup*)0, archive->m_EntryLookup);
+
+    uint8_t invalid_hash[20];
+    memset(invalid_hash, 0xAB, sizeof(invalid_hash));
+
+    // Once with the lookup table, once with the binary search
+    for (uint32_t pass = 0; pass < 2; ++pass)
+    {
+        for (uint32_t i = 0; i < entry_count; ++i)
+        {
+            dmResourceArchive::EntryData entry;
+            result = dmResourceArchive::FindEntryInArchive(archive, GetSyntheticHash(index_buffer, i), 20, &entry);
+            ASSERT_EQ(dmResourceArchive::RESULT_OK, result);
+            ASSERT_EQ(i, entry.m_ResourceDataOffset);
+        }
+
+        dmResourceArchive::EntryData entry;
+        result = dmResourceArchive::FindEntryInArchive(archive, invalid_hash, sizeof(invalid_hash), &entry);
+        ASSERT_EQ(dmResourceArchive::RESULT_NOT_FOUND, result);
+
+        dmResourceArchive::DeleteEntryLookup(archive);
+    }
+
+    dmResourceArchive::Delete(archive);
+    delete[] index_buffer;
+}
+
+TEST(dmResourceArchive, BenchEntryLookup)
+{
+    // Emulates a liveupdate archive chained in front of the bundled archive, with all lookups ending up in the latter
+    const uint32_t entry_count = 50000;
+    const uint32_t lookup_count = 1000000;
+    uint32_t base_size, liveupdate_size;
+    uint8_t* base_buffer = NewSyntheticArchiveIndex(entry_count, 1, &base_size);
+    uint8_t* liveupdate_buffer = NewSyntheticArchiveIndex(entry_count, 2, &liveupdate_size);
+
+    dmResourceArchive::HArchiveIndexContainer base = 0;
+    dmResourceArchive::HArchiveIndexContainer liveupdate = 0;
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, dmResourceArchive::WrapArchiveBuffer(base_buffer, base_size, true, RESOURCES_ARCD, RESOURCES_ARCD_SIZE, true, &base));
+    ASSERT_EQ(dmResourceArchive::RESULT_OK, dmResourceArchive::WrapArchiveBuffer(liveupdate_buffer, liveupdate_size, true, RESOURCES_ARCD, RESOURCES_ARCD_SIZE, true, &liveupdate));
+    dmResourceArchive::SetDefaultReader(base);
+    dmResourceArchive::SetDefaultReader(liveupdate);
+    liveupdate->m_Next = base;
+
+    const char* names[] = { "hash table", "binary search" };
+    for (uint32_t pass = 0; pass < 2; ++pass)
+    {
+        uint32_t found = 0;
+        uint64_t start = dmTime::GetTime();
+        for (uint32_t i = 0; i < lookup_count; ++i)
+        {
+            // Visit the entries in a scattered order
+            uint32_t index = (uint32_t)(((uint64_t)i * 7919) % entry_count);
+            dmResourceArchive::EntryData entry;
+            dmResourceArchive::HArchiveIndexContainer entry_archive;
+            if (dmResourceArchive::FindEntry(liveupdate, GetSyntheticHash(base_buffer, index), 20, &entry_archive, &entry) == dmResourceArchive::RESULT_OK && entry.m_ResourceDataOffset == index)
+            {
+                ++found;
+            }
+        }
+        uint64_t end = dmTime::GetTime();
+        ASSERT_EQ(lookup_count, found);
+
+        printf("Bench elapsed: %s, 2 archives with %u entries, %u lookups: %.2f ms (%.1f ns/lookup)\n", names[pass], entry_count, lookup_count,
+                (end - start) / 1000.0, (end - start) * 1000.0 / lookup_count);
+
+        dmResourceArchive::DeleteEntryLookup(base);
+        dmResourceArchive::DeleteEntryLookup(liveupdate);
+    }
+
+    dmResourceArchive::Delete(liveupdate);
+    dmResourceArchive::Delete(base);
+    delete[] liveupdate_buffer;
+    delete[] base_buffer;
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
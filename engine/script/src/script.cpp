@@ -17,6 +17,7 @@
 #include <dlib/math.h>
 #include <dlib/pprint.h>
 #include <dlib/profile.h>
+#include <dlib/time.h>
 
 #include "script_private.h"
 #include "script_hash.h"
@@ -82,6 +83,14 @@ namespace dmScript
         context->m_LuaState = lua_open();
         context->m_ContextTableRef = LUA_NOREF;
         context->m_EnableExtensions = enable_extensions;
+        context->m_GCStepTime = 0;
+        context->m_GCStepSize = 0;
+        if (config_file)
+        {
+            context->m_GCStepTime = (uint32_t) dmMath::Max(0, dmConfigFile::GetInt(config_file, "script.gc_step_time", 0));
+            context->m_GCStepSize = (uint32_t) dmMath::Max(0, dmConfigFile::GetInt(config_file, "script.gc_step_size", 0));
+        }
+        context->m_GCMemoryLimit = 0xffffffff;
         return context;
     }
 
@@ -216,6 +225,12 @@ namespace dmScript
                 (*l)->Initialize(context);
             }
         }
+
+        if (context->m_GCStepTime != 0 || context->m_GCStepSize != 0)
+        {
+            // All collection is done in StepGarbageCollector from now on
+            lua_gc(L, LUA_GCSTOP, 0);
+        }
     }
 
     void RegisterScriptExtension(HContext context, HScriptExtension script_extension)
@@ -238,6 +253,43 @@ namespace dmScript
         }
     }
 
+    void StepGarbageCollector(HContext context)
+    {
+        if (context->m_GCStepTime == 0 && context->m_GCStepSize == 0)
+            return;
+
+        DM_PROFILE(Script, "StepGarbageCollector");
+
+        lua_State* L = context->m_LuaState;
+        uint64_t start = dmTime::GetTime();
+        uint32_t kb_before = (uint32_t) lua_gc(L, LUA_GCCOUNT, 0);
+
+        // If the scripts allocate faster than the budget allows us to collect, the memory would grow
+        // without bounds. Past the limit we keep stepping until the cycle is done, like the automatic
+        // collector would have.
+        bool over_limit = kb_before > context->m_GCMemoryLimit;
+        while (true)
+        {
+            if (lua_gc(L, LUA_GCSTEP, context->m_GCStepSize))
+            {
+                // A cycle was completed, same limit as the default pause of the automatic collector (200%)
+                context->m_GCMemoryLimit = 2 * (uint32_t) lua_gc(L, LUA_GCCOUNT, 0);
+                break;
+            }
+            if (over_limit)
+                continue;
+            if (context->m_GCStepTime == 0 || dmTime::GetTime() - start >= context->m_GCStepTime)
+                break;
+        }
+
+        // Stepping restarts the automatic collector
+        lua_gc(L, LUA_GCSTOP, 0);
+
+        uint32_t kb_after = (uint32_t) lua_gc(L, LUA_GCCOUNT, 0);
+        DM_COUNTER("Lua.GC time (us)", (uint32_t) (dmTime::GetTime() - start));
+        DM_COUNTER("Lua.GC collected (Kb)", kb_before > kb_after ? kb_before - kb_after : 0);
+    }
+
     void Finalize(HContext context)
     {
         lua_State* L = context->m_LuaState;
@@ -193,6 +193,14 @@ namespace dmScript
      */
     void Update(HContext context);
 
+    /**
+     * Runs the garbage collector within the budget set by script.gc_step_time and script.gc_step_size
+     * in the config file. Does nothing if neither is set, the collector then runs automatically while
+     * the scripts allocate memory.
+     * @param context script context
+     */
+    void StepGarbageCollector(HContext context);
+
     /**
      * Finalize script libraries
      * @param context script context
@@ -74,6 +74,11 @@ namespace dmScript
         dmArray<HScriptExtension>   m_ScriptExtensions;
         lua_State*                  m_LuaState;
         int                         m_ContextTableRef;
+        // Garbage collection done in StepGarbageCollector, instead of automatically when scripts allocate.
+        // Enabled when either budget is non zero (script.gc_step_time and script.gc_step_size).
+        uint32_t                    m_GCStepTime;       // Microseconds per frame
+        uint32_t                    m_GCStepSize;       // Kilobytes of work per step
+        uint32_t                    m_GCMemoryLimit;    // Kilobytes, the budget is ignored until the current cycle is done when above
         bool                        m_EnableExtensions;
     };
 
@@ -2265,6 +2265,125 @@ namespace dmScript
         return 1;
     }
 
+    enum IntoOperation
+    {
+        INTO_OPERATION_ADD,
+        INTO_OPERATION_SUB,
+    };
+
+    static int VectorInto(lua_State* L, IntoOperation operation, const char* function_name)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vectormath::Aos::Vector3* out = CheckVector3(L, 1);
+            Vectormath::Aos::Vector3* v1 = CheckVector3(L, 2);
+            Vectormath::Aos::Vector3* v2 = CheckVector3(L, 3);
+            *out = operation == INTO_OPERATION_ADD ? *v1 + *v2 : *v1 - *v2;
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vectormath::Aos::Vector4* out = CheckVector4(L, 1);
+            Vectormath::Aos::Vector4* v1 = CheckVector4(L, 2);
+            Vectormath::Aos::Vector4* v2 = CheckVector4(L, 3);
+            *out = operation == INTO_OPERATION_ADD ? *v1 + *v2 : *v1 - *v2;
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s) as arguments.", SCRIPT_LIB_NAME, function_name, SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
+    /*# adds two vectors and stores the result in an existing vector
+     *
+     * Same as <code>v1 + v2</code>, but the result is written to <code>out</code> instead of
+     * a new vector. This avoids creating garbage in code that runs every frame.
+     * <code>out</code> may be one of the operands.
+     *
+     * @name vmath.add_into
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v1 [type:vector3|vector4] first vector
+     * @param v2 [type:vector3|vector4] second vector
+     * @return out [type:vector3|vector4] the out vector
+     * @examples
+     *
+     * ```lua
+     * function update(self, dt)
+     *     vmath.add_into(self.position, self.position, self.offset)
+     * end
+     * ```
+     */
+    static int AddInto(lua_State* L)
+    {
+        return VectorInto(L, INTO_OPERATION_ADD, "add_into");
+    }
+
+    /*# subtracts two vectors and stores the result in an existing vector
+     *
+     * Same as <code>v1 - v2</code>, but the result is written to <code>out</code> instead of
+     * a new vector. <code>out</code> may be one of the operands.
+     *
+     * @name vmath.sub_into
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v1 [type:vector3|vector4] first vector
+     * @param v2 [type:vector3|vector4] second vector
+     * @return out [type:vector3|vector4] the out vector
+     * @examples
+     *
+     * ```lua
+     * vmath.sub_into(self.direction, target_position, self.position)
+     * ```
+     */
+    static int SubInto(lua_State* L)
+    {
+        return VectorInto(L, INTO_OPERATION_SUB, "sub_into");
+    }
+
+    /*# multiplies a vector by a scalar and stores the result in an existing vector
+     *
+     * Same as <code>v * s</code>, but the result is written to <code>out</code> instead of
+     * a new vector. <code>out</code> may be the same vector as <code>v</code>.
+     *
+     * @name vmath.mul_into
+     * @param out [type:vector3|vector4] vector to store the result in
+     * @param v [type:vector3|vector4] vector to multiply
+     * @param s [type:number] scalar
+     * @return out [type:vector3|vector4] the out vector
+     * @examples
+     *
+     * ```lua
+     * function update(self, dt)
+     *     vmath.mul_into(self.step, self.velocity, dt)
+     *     vmath.add_into(self.position, self.position, self.step)
+     *     go.set_position(self.position)
+     * end
+     * ```
+     */
+    static int MulInto(lua_State* L)
+    {
+        const ScriptUserType type = GetType(L, 1);
+        if (type == SCRIPT_TYPE_VECTOR3)
+        {
+            Vectormath::Aos::Vector3* out = CheckVector3(L, 1);
+            Vectormath::Aos::Vector3* v = CheckVector3(L, 2);
+            *out = *v * (float) luaL_checknumber(L, 3);
+        }
+        else if (type == SCRIPT_TYPE_VECTOR4)
+        {
+            Vectormath::Aos::Vector4* out = CheckVector4(L, 1);
+            Vectormath::Aos::Vector4* v = CheckVector4(L, 2);
+            *out = *v * (float) luaL_checknumber(L, 3);
+        }
+        else
+        {
+            return luaL_error(L, "%s.%s accepts (%s|%s) as arguments.", SCRIPT_LIB_NAME, "mul_into", SCRIPT_TYPE_NAME_VECTOR3, SCRIPT_TYPE_NAME_VECTOR4);
+        }
+        lua_pushvalue(L, 1);
+        return 1;
+    }
+
     static const luaL_reg methods[] =
     {
         {SCRIPT_TYPE_NAME_VECTOR, Vector_new},
@@ -2301,6 +2420,9 @@ namespace dmScript
         {"inv", Inverse},
         {"ortho_inv", OrthoInverse},
         {"mul_per_elem", MulPerElem},
+        {"add_into", AddInto},
+        {"sub_into", SubInto},
+        {"mul_into", MulInto},
         {0, 0}
     };
 
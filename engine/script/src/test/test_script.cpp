@@ -938,6 +938,36 @@ TEST_F(ScriptTest, ScriptExtension)
     dmScript::DeleteContext(context);
 }
 
+TEST_F(ScriptTest, StepGarbageCollector)
+{
+    const char* config = "[script]\ngc_step_size = 64\n";
+    dmConfigFile::HConfig config_file;
+    ASSERT_EQ(dmConfigFile::RESULT_OK, dmConfigFile::LoadFromBuffer(config, strlen(config), 0, 0, &config_file));
+
+    dmScript::HContext context = dmScript::NewContext(config_file, 0, true);
+    dmScript::Initialize(context);
+    lua_State* L = dmScript::GetLuaState(context);
+
+    // The collector doesn't run while the script allocates
+    uint32_t kb_start = dmScript::GetLuaGCCount(L);
+    ASSERT_TRUE(RunString(L, "for i = 1, 100000 do local t = {} end"));
+    ASSERT_GT(dmScript::GetLuaGCCount(L), kb_start + 1000);
+
+    // Each call only does a limited amount of work, but all of the garbage is eventually collected
+    uint32_t step_count = 0;
+    while (dmScript::GetLuaGCCount(L) > kb_start + 100 && step_count < 100000)
+    {
+        dmScript::StepGarbageCollector(context);
+        ++step_count;
+    }
+    ASSERT_GT(step_count, 1u);
+    ASSERT_LE(dmScript::GetLuaGCCount(L), kb_start + 100);
+
+    dmScript::Finalize(context);
+    dmScript::DeleteContext(context);
+    dmConfigFile::Delete(config_file);
+}
+
 TEST_F(ScriptTest, InstanceId)
 {
     uintptr_t instanceid0 = dmScript::GetInstanceId(L);
@@ -21,6 +21,7 @@
 
 #include <dlib/log.h>
 #include <dlib/dstrings.h>
+#include <dlib/time.h>
 
 extern "C"
 {
@@ -157,6 +158,10 @@ TEST_F(ScriptVmathTest, TestVector3Fail)
     ASSERT_FALSE(RunString(L, "local s = vmath.mul_per_elem(vmath.vector3(1,2,3))"));
     ASSERT_FALSE(RunString(L, "local s = vmath.mul_per_elem(vmath.vector3(1,2,3), 1)"));
     ASSERT_FALSE(RunString(L, "local s = vmath.mul_per_elem(1, 1)"));
+    // Into
+    ASSERT_FALSE(RunString(L, "vmath.add_into(vmath.vector3(), vmath.vector3(), vmath.vector4())"));
+    ASSERT_FALSE(RunString(L, "vmath.sub_into(1, vmath.vector3(), vmath.vector3())"));
+    ASSERT_FALSE(RunString(L, "vmath.mul_into(vmath.vector3(), vmath.vector3(), vmath.vector3())"));
 }
 
 TEST_F(ScriptVmathTest, TestVector4)
@@ -205,7 +210,9 @@ TEST_F(ScriptVmathTest, TestVector4Fail)
     ASSERT_FALSE(RunString(L, "local s = vmath.mul_per_elem(vmath.vector4(1,2,3,4))"));
     ASSERT_FALSE(RunString(L, "local s = vmath.mul_per_elem(vmath.vector4(1,2,3,4), 1)"));
     ASSERT_FALSE(RunString(L, "local s = vmath.mul_per_elem(1, 1)"));
-
+    // Into
+    ASSERT_FALSE(RunString(L, "vmath.add_into(vmath.vector4(), vmath.vector4(), vmath.vector3())"));
+    ASSERT_FALSE(RunString(L, "vmath.mul_into(vmath.vector4(), vmath.vector4())"));
 }
 
 TEST_F(ScriptVmathTest, TestQuat)
@@ -411,6 +418,46 @@ TEST_F(ScriptVmathTest, TestToValueFn)
     ASSERT_EQ(top, lua_gettop(L));
 }
 
+// Typical movement code, once with the vmath operators that create a new vector for every result and
+// once with the functions that write into existing vectors
+TEST_F(ScriptVmathTest, BenchMovement)
+{
+    const char* names[] = {"operators", "into"};
+    const char* scripts[] = {
+        "local pos = vmath.vector3()\n"
+        "local vel = vmath.vector3(1, 2, 0)\n"
+        "for i = 1, 10000 do\n"
+        "    pos = pos + vel * 0.016\n"
+        "end\n",
+
+        "local pos = vmath.vector3()\n"
+        "local vel = vmath.vector3(1, 2, 0)\n"
+        "local step = vmath.vector3()\n"
+        "for i = 1, 10000 do\n"
+        "    vmath.mul_into(step, vel, 0.016)\n"
+        "    vmath.add_into(pos, pos, step)\n"
+        "end\n",
+    };
+
+    int allocated[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        lua_gc(L, LUA_GCSTOP, 0);
+        int before = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+
+        uint64_t start = dmTime::GetTime();
+        ASSERT_TRUE(RunString(L, scripts[i]));
+        uint64_t end = dmTime::GetTime();
+
+        allocated[i] = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0) - before;
+        lua_gc(L, LUA_GCRESTART, 0);
+        printf("Bench elapsed: %s, 10000 calls: %.2f ms, %d bytes allocated\n", names[i], (end - start) / 1000.0, allocated[i]);
+    }
+
+    ASSERT_LT(allocated[1] * 10, allocated[0]);
+}
+
 int main(int argc, char **argv)
 {
     jc_test_init(&argc, argv);
@@ -120,4 +120,13 @@ assert(math.abs(v.x - 0.5 * sq2) < 0.000001 and math.abs(v.y + 0.5 * sq2) < 0.00
 v = vmath.mul_per_elem(vmath.vector3(1,2,3), vmath.vector3(5,6,7))
 assert(v.x == 5, "v.x is not 5")
 assert(v.y ==12, "v.y is not 12")
-assert(v.z ==21, "v.z is not 21")
\ No newline at end of file
+assert(v.z ==21, "v.z is not 21")
+-- add_into, sub_into, mul_into
+local out = vmath.vector3()
+v = vmath.add_into(out, vmath.vector3(1, 2, 3), vmath.vector3(4, 5, 6))
+assert(rawequal(v, out), "add_into does not return out")
+assert(out.x == 5 and out.y == 7 and out.z == 9, "add_into")
+vmath.sub_into(out, out, vmath.vector3(1, 2, 3))
+assert(out.x == 4 and out.y == 5 and out.z == 6, "sub_into")
+vmath.mul_into(out, out, 2)
+assert(out.x == 8 and out.y == 10 and out.z == 12, "mul_into")
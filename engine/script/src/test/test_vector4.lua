@@ -131,3 +131,13 @@ assert(v.x == 5, "v.x is not 5")
 assert(v.y ==12, "v.y is not 12")
 assert(v.z ==21, "v.z is not 21")
 assert(v.w ==32, "v.w is not 32")
+
+-- add_into, sub_into, mul_into
+local out = vmath.vector4()
+v = vmath.add_into(out, vmath.vector4(1, 2, 3, 4), vmath.vector4(5, 6, 7, 8))
+assert(rawequal(v, out), "add_into does not return out")
+assert(out.x == 6 and out.y == 8 and out.z == 10 and out.w == 12, "add_into")
+vmath.sub_into(out, out, vmath.vector4(1, 2, 3, 4))
+assert(out.x == 5 and out.y == 6 and out.z == 7 and out.w == 8, "sub_into")
+vmath.mul_into(out, out, 2)
+assert(out.x == 10 and out.y == 12 and out.z == 14 and out.w == 16, "mul_into")
@@ -151,6 +151,8 @@ namespace dmSound
         // Index in m_SoundData
         uint16_t      m_Index;
         SoundDataType m_Type;
+        // False if m_Data is referenced, see NewSoundDataNoCopy
+        bool          m_OwnsData;
     };
 
     struct SoundInstance
@@ -453,16 +455,25 @@ namespace dmSound
     }
 
 
-    static Result SetSoundDataNoLock(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size)
+    static Result SetSoundDataNoLock(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size, bool copy)
     {
-        free(sound_data->m_Data);
-        sound_data->m_Data = malloc(sound_buffer_size);
+        if (sound_data->m_OwnsData)
+            free(sound_data->m_Data);
         sound_data->m_Size = sound_buffer_size;
-        memcpy(sound_data->m_Data, sound_buffer, sound_buffer_size);
+        sound_data->m_OwnsData = copy;
+        if (copy)
+        {
+            sound_data->m_Data = malloc(sound_buffer_size);
+            memcpy(sound_data->m_Data, sound_buffer, sound_buffer_size);
+        }
+        else
+        {
+            sound_data->m_Data = (void*) sound_buffer;
+        }
         return RESULT_OK;
     }
 
-    Result NewSoundData(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    static Result NewSoundData(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name, bool copy)
     {
         SoundSystem* sound = g_SoundSystem;
 
@@ -482,8 +493,9 @@ namespace dmSound
         sd->m_Index = index;
         sd->m_Data = 0;
         sd->m_Size = 0;
+        sd->m_OwnsData = false;
 
-        Result result = SetSoundDataNoLock(sd, sound_buffer, sound_buffer_size);
+        Result result = SetSoundDataNoLock(sd, sound_buffer, sound_buffer_size, copy);
         if (result == RESULT_OK)
             *sound_data = sd;
         else
@@ -492,23 +504,36 @@ namespace dmSound
         return result;
     }
 
+    Result NewSoundData(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    {
+        return NewSoundData(sound_buffer, sound_buffer_size, type, sound_data, name, true);
+    }
+
+    Result NewSoundDataNoCopy(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    {
+        return NewSoundData(sound_buffer, sound_buffer_size, type, sound_data, name, false);
+    }
+
     Result SetSoundData(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size)
     {
         DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
-        return SetSoundDataNoLock(sound_data, sound_buffer, sound_buffer_size);
+        return SetSoundDataNoLock(sound_data, sound_buffer, sound_buffer_size, true);
     }
 
     uint32_t GetSoundResourceSize(HSoundData sound_data)
     {
-        return sound_data->m_Size + sizeof(SoundData);
+        // Referenced data is not allocated by the sound system
+        return (sound_data->m_OwnsData ? sound_data->m_Size : 0) + sizeof(SoundData);
     }
 
     Result DeleteSoundData(HSoundData sound_data)
     {
         DM_MUTEX_OPTIONAL_SCOPED_LOCK(g_SoundSystem->m_Mutex);
 
-        if (sound_data->m_Data != 0x0)
+        if (sound_data->m_OwnsData)
             free((void*) sound_data->m_Data);
+        sound_data->m_Data = 0;
+        sound_data->m_OwnsData = false;
 
         SoundSystem* sound = g_SoundSystem;
         sound->m_SoundDataPool.Push(sound_data->m_Index);
@@ -25,6 +25,7 @@ namespace dmSound
     {
         char* m_Buffer;
         uint32_t m_BufferSize;
+        bool m_OwnsBuffer;
     };
 
     struct SoundInstance
@@ -56,6 +57,7 @@ namespace dmSound
     {
         HSoundData sd = new SoundData();
         sd->m_Buffer = 0x0;
+        sd->m_OwnsBuffer = false;
         Result result = SetSoundData(sd, sound_buffer, sound_buffer_size);
         if (result == RESULT_OK)
             *sound_data = sd;
@@ -64,24 +66,35 @@ namespace dmSound
         return result;
     }
 
+    Result NewSoundDataNoCopy(const void* sound_buffer, uint32_t sound_buffer_size, SoundDataType type, HSoundData* sound_data, dmhash_t name)
+    {
+        HSoundData sd = new SoundData();
+        sd->m_Buffer = (char*) sound_buffer;
+        sd->m_BufferSize = sound_buffer_size;
+        sd->m_OwnsBuffer = false;
+        *sound_data = sd;
+        return RESULT_OK;
+    }
+
     Result SetSoundData(HSoundData sound_data, const void* sound_buffer, uint32_t sound_buffer_size)
     {
-        if (sound_data->m_Buffer != 0x0)
+        if (sound_data->m_OwnsBuffer)
             delete [] sound_data->m_Buffer;
         sound_data->m_Buffer = new char[sound_buffer_size];
         sound_data->m_BufferSize = sound_buffer_size;
+        sound_data->m_OwnsBuffer = true;
         memcpy(sound_data->m_Buffer, sound_buffer, sound_buffer_size);
         return RESULT_OK;
     }
 
     uint32_t GetSoundResourceSize(HSoundData sound_data)
     {
-        return sizeof(SoundData) + sound_data->m_BufferSize;
+        return sizeof(SoundData) + (sound_data->m_OwnsBuffer ? sound_data->m_BufferSize : 0);
     }
 
     Result DeleteSoundData(HSoundData sound_data)
     {
-        if (sound_data->m_Buffer != 0x0)
+        if (sound_data->m_OwnsBuffer)
             delete [] sound_data->m_Buffer;
         delete sound_data;
         return RESULT_OK;
@@ -1018,6 +1018,43 @@ TEST_P(dmSoundTestPlayTest, Play)
     ASSERT_EQ(dmSound::RESULT_OK, r);
 }
 
+TEST_P(dmSoundTestPlayTest, PlayNoCopy)
+{
+    TestParams params = GetParam();
+    dmSound::Result r;
+    dmSound::HSoundData sd_copy = 0;
+    r = dmSound::NewSoundData(params.m_Sound, params.m_SoundSize, params.m_Type, &sd_copy, 1234);
+    ASSERT_EQ(dmSound::RESULT_OK, r);
+
+    dmSound::HSoundData sd = 0;
+    r = dmSound::NewSoundDataNoCopy(params.m_Sound, params.m_SoundSize, params.m_Type, &sd, 1234);
+    ASSERT_EQ(dmSound::RESULT_OK, r);
+
+    // The referenced data is not counted as owned by the sound data
+    ASSERT_EQ(dmSound::GetSoundResourceSize(sd_copy) - params.m_SoundSize, dmSound::GetSoundResourceSize(sd));
+    r = dmSound::DeleteSoundData(sd_copy);
+    ASSERT_EQ(dmSound::RESULT_OK, r);
+
+    dmSound::HSoundInstance instance = 0;
+    r = dmSound::NewSoundInstance(sd, &instance);
+    ASSERT_EQ(dmSound::RESULT_OK, r);
+    ASSERT_NE((dmSound::HSoundInstance) 0, instance);
+
+    r = dmSound::Play(instance);
+    ASSERT_EQ(dmSound::RESULT_OK, r);
+
+    do {
+        r = dmSound::Update();
+        ASSERT_EQ(dmSound::RESULT_OK, r);
+    } while (dmSound::IsPlaying(instance));
+
+    r = dmSound::DeleteSoundInstance(instance);
+    ASSERT_EQ(dmSound::RESULT_OK, r);
+
+    r = dmSound::DeleteSoundData(sd);
+    ASSERT_EQ(dmSound::RESULT_OK, r);
+}
+
 TEST_P(dmSoundTestPlaySpeedTest, Play)
 {
     TestParams params = GetParam();